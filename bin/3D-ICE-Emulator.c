@@ -173,12 +173,22 @@ int main(int argc, char** argv)
                              TDICE_OUTPUT_INSTANT_SLOT) ;
         }
 
-    } while (sim_result != TDICE_END_OF_SIMULATION && sim_result != TDICE_SOLVER_ERROR) ;
+    } while (sim_result == TDICE_STEP_DONE || sim_result == TDICE_SLOT_DONE) ;
 
-    generate_output (&output, stkd.Dimensions,
-                     tdata.Temperatures, tdata.PowerGrid.Sources,
-                     get_simulated_time (&analysis),
-                     TDICE_OUTPUT_INSTANT_FINAL) ;
+    // Solver and power trace errors stop the simulation before its end:
+    // the results are not complete
+
+    if (sim_result != TDICE_END_OF_SIMULATION)
+
+        fprintf (stderr, "\nerror %d: emulation stopped at %.3f sec\n",
+                 sim_result, get_simulated_time (&analysis)) ;
+
+    else
+
+        generate_output (&output, stkd.Dimensions,
+                         tdata.Temperatures, tdata.PowerGrid.Sources,
+                         get_simulated_time (&analysis),
+                         TDICE_OUTPUT_INSTANT_FINAL) ;
 
     fprintf (stdout, "emulation took %.3f sec\n",
         ( (double)clock() - Time ) / CLOCKS_PER_SEC ) ;
@@ -189,6 +199,7 @@ int main(int argc, char** argv)
     thermal_data_destroy      (&tdata) ;
     stack_description_destroy (&stkd) ;
     output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
 
-    return EXIT_SUCCESS ;
+    return sim_result == TDICE_END_OF_SIMULATION ? EXIT_SUCCESS : EXIT_FAILURE ;
 }
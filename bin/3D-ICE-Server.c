@@ -416,6 +416,7 @@ quit :
     thermal_data_destroy      (&tdata) ;
     stack_description_destroy (&stkd) ;
     output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
 
     return EXIT_SUCCESS ;
 
@@ -84,6 +84,7 @@
 %type <p_powers_queue>      optional_power_values_list ;
 %type <p_powers_queue>      power_values_list ;
 %type <p_icelement>         ic_element ;
+%type <identifier>          optional_power_trace ;
 
 %destructor { string_destroy (&$$) ;   } <identifier>
 %destructor { powers_queue_free ($$) ; } <p_powers_queue>
@@ -92,10 +93,12 @@
 %token POSITION   "keyword position"
 %token POWER      "keyword power"
 %token RECTANGLE  "keywork rectangle"
+%token TRACE      "keyword trace"
 %token VALUES     "keyword values"
 
 %token <power_value> DVALUE     "double value"
 %token <identifier>  IDENTIFIER "identifier"
+%token <identifier>  PATH       "path to file"
 
 %name-prefix "floorplan_parser_"
 %output      "floorplan_parser.c"
@@ -123,19 +126,91 @@
 
 floorplan_file
 
-  : floorplan_element_list
+  : optional_power_trace    // $1
+    floorplan_element_list
     {
         floorplan->NElements = floorplan->ElementsList.Size ;
 
+        if ($1 != NULL && local_abort == false)
+        {
+            // Power values are either listed in the file or streamed
+            // from the trace, one slot at a time
+
+            FloorplanElementListNode_t *flpeln ;
+
+            for (flpeln  = floorplan_element_list_begin (&floorplan->ElementsList) ;
+                 flpeln != NULL ;
+                 flpeln  = floorplan_element_list_next (flpeln))
+            {
+                FloorplanElement_t *flpel = floorplan_element_list_data (flpeln) ;
+
+                if (is_empty_powers_queue (flpel->PowerValues) == false)
+                {
+                    sprintf (error_message,
+                        "Floorplan element %s has power values and a power trace",
+                        flpel->Id) ;
+
+                    floorplan_parser_error (floorplan, dimensions, scanner, error_message) ;
+
+                    local_abort = true ;
+                }
+            }
+
+            floorplan->PowerTrace = power_trace_calloc ( ) ;
+
+            if (floorplan->PowerTrace == NULL)
+            {
+                floorplan_parser_error (floorplan, dimensions, scanner, "Malloc power trace failed") ;
+
+                local_abort = true ;
+            }
+            else if (local_abort == false
+
+                     && power_trace_open
+
+                         (floorplan->PowerTrace, $1, &floorplan->ElementsList)
+
+                        == TDICE_FAILURE)
+            {
+                sprintf (error_message, "Cannot use the power trace %s", $1) ;
+
+                floorplan_parser_error (floorplan, dimensions, scanner, error_message) ;
+
+                local_abort = true ;
+            }
+        }
+
+        string_destroy (&$1) ;
+
         if (local_abort == true)
         {
-            floorplan_free (floorplan) ;
+            // The floorplan belongs to the caller (it is part of a die)
+
+            floorplan_destroy (floorplan) ;
 
             YYABORT ;
         }
     }
   ;
 
+/******************************************************************************/
+/******************************* Power trace **********************************/
+/******************************************************************************/
+
+optional_power_trace
+
+  : // Declaring a power trace is not mandatory
+
+    {
+        $$ = NULL ;
+    }
+
+  | POWER TRACE PATH ';' // $3
+    {
+        $$ = $3 ;
+    }
+  ;
+
 /******************************************************************************/
 /************************* List of floorplan elements *************************/
 /******************************************************************************/
@@ -144,6 +219,8 @@ floorplan_element_list
 
   : floorplan_element
     {
+        $1->Index = floorplan->ElementsList.Size ;
+
         floorplan_element_list_insert_end (&floorplan->ElementsList, $1) ;
 
         floorplan_element_free ($1) ;
@@ -159,6 +236,8 @@ floorplan_element_list
             local_abort = true ;
         }
 
+        $2->Index = floorplan->ElementsList.Size ;
+
         floorplan_element_list_insert_end (&floorplan->ElementsList, $2) ;
 
         floorplan_element_free ($2) ;
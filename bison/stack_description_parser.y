@@ -70,7 +70,19 @@
     StackElement_t       *stack_element_p ;
     InspectionPoint_t    *inspection_point_p ;
     OutputInstant_t       output_instant_v ;
+    struct
+    {
+        OutputInstant_t   Instant ;
+        OutputFormat_t    Format ;
+    }                     map_when_v ;
+    struct
+    {
+        bool              PowerMap ;
+        String_t          Path ;
+    }                     die_power_v ;
     OutputQuantity_t      output_quantity_v ;
+    SolverType_t          solver_type_v ;
+    IntegrationMethod_t   integration_method_v ;
 }
 
 %code
@@ -125,13 +137,22 @@
 %type <stack_element_p>    stack_element
 %type <inspection_point_p> inspection_point
 %type <output_instant_v>   when
+%type <output_instant_v>   instant
+%type <map_when_v>         map_when
+%type <die_power_v>        die_power
 %type <output_quantity_v>  maxminavg
 %type <string_p>           optional_layout
+%type <solver_type_v>      krylov_method
+%type <integration_method_v> integration_method
 
 %token _2RM                  "keyword 2rm"
 %token _4RM                  "keyword 4rm"
+%token ADAPTIVE              "keyword adaptive"
 %token AVERAGE               "keyword average"
+%token BICGSTAB              "keyword bicgstab"
+%token BINARY                "keyword binary"
 %token BOTTOM                "keyword bottom"
+%token CACHE                 "keyword cache"
 %token CAPACITY              "keyword capacity"
 %token CELL                  "keyword cell"
 %token CHANNEL               "keyword channel"
@@ -143,7 +164,10 @@
 %token DIAMETER              "keyword diameter"
 %token DIE                   "keyword die"
 %token DIMENSIONS            "keyword dimensions"
+%token DISSECTION            "keyword dissection"
 %token DISTRIBUTION          "keyword distribution"
+%token EULER                 "keyword euler"
+%token FACTORIZATION         "keyword factorization"
 %token FINAL                 "keyword final"
 %token FIRST                 "keyword first"
 %token FLOORPLAN             "keyword floorplan"
@@ -154,23 +178,35 @@
 %token INCOMING              "keyword incoming"
 %token INITIAL_              "keyword initial"
 %token INLINE                "keyword inline"
+%token ITERATIONS            "keyword iterations"
+%token ITERATIVE             "keyword iterative"
 %token LAST                  "keyword last"
 %token LAYER                 "keyword layer"
 %token LAYOUT                "keyword layout"
 %token LENGTH                "keyword length"
+%token MAP                   "keyword map"
 %token MATERIAL              "keyword material"
 %token MAXIMUM               "keyword maximum"
+%token METHOD                "keyword method"
 %token MICROCHANNEL          "keyword microchannel"
 %token MINIMUM               "keyword minimum"
+%token MULTIFRONTAL          "keyword multifrontal"
+%token MULTIGRID             "keyword multigrid"
+%token NESTED                "keyword nested"
+%token ORDERING              "keyword ordering"
 %token OUTPUT                "keyword output"
+%token PCG                   "keyword pcg"
 %token PIN                   "keyword pin"
 %token PINFIN                "keyword pinfin"
 %token PITCH                 "keyword pitch"
 %token PLUGGABLE             "keyword pluggable"
 %token PLUGIN                "keyword plugin"
 %token PMAP                  "keyword Pmap"
+%token POWER                 "keyword power"
+%token PRECISION             "keyword precision"
 %token RATE                  "keyword rate"
 %token SIDE                  "keyword side"
+%token SINGLE                "keyword single"
 %token SINK                  "keyword sink"
 %token SLOT                  "keyword slot"
 %token SOLVER                "keyword solver"
@@ -187,11 +223,14 @@
 %token TFLP                  "keyword Tflp"
 %token TFLPEL                "keyword Tflpel"
 %token THERMAL               "keyword thermal"
+%token THREADS               "keyword threads"
 %token TMAP                  "keyword Tmap"
 %token TO                    "keyword to"
+%token TOLERANCE             "keyword tolerance"
 %token TOP                   "keyword top"
 %token TRANSFER              "keyword transfer"
 %token TRANSIENT             "keyword transient"
+%token TRAPEZOIDAL           "keyword trapezoidal"
 %token VELOCITY              "keyword velocity"
 %token VOLUMETRIC            "keywork volumetric"
 %token WALL                  "keyword wall"
@@ -203,6 +242,7 @@
 
 %destructor { string_destroy (&$$) ; } <string>
 %destructor { layer_free ($$) ;      } <layer_p>
+%destructor { string_destroy (&$$.Path) ; } <die_power_v>
 
 %name-prefix "stack_description_"
 %output      "stack_description_parser.c"
@@ -1389,9 +1429,9 @@ stack_element
         string_destroy (&$2) ;
     }
 
-  | DIE IDENTIFIER IDENTIFIER FLOORPLAN PATH ';'  // $2 Identifier for the stack element
-                                                  // $3 Identifier of the die
-                                                  // $5 Path of the floorplan file
+  | DIE IDENTIFIER IDENTIFIER die_power ';'  // $2 Identifier for the stack element
+                                             // $3 Identifier of the die
+                                             // $4 Floorplan file or power map
     {
         num_dies++ ;
 
@@ -1403,7 +1443,7 @@ stack_element
 
             string_destroy (&$2) ;
             string_destroy (&$3) ;
-            string_destroy (&$5) ;
+            string_destroy (&$4.Path) ;
 
             YYABORT ;
         }
@@ -1416,7 +1456,7 @@ stack_element
 
             string_destroy (&$2) ;
             string_destroy (&$3) ;
-            string_destroy (&$5) ;
+            string_destroy (&$4.Path) ;
 
             stack_element_free (stack_element) ;
 
@@ -1437,7 +1477,7 @@ stack_element
 
             string_destroy (&$2) ;
             string_destroy (&$3) ;
-            string_destroy (&$5) ;
+            string_destroy (&$4.Path) ;
 
             stack_element_free (stack_element) ;
 
@@ -1446,12 +1486,20 @@ stack_element
 
         die_copy (die, tmp) ;
 
-        if (   fill_floorplan (&die->Floorplan, stkd->Dimensions, $5)
-            == TDICE_FAILURE)
+        Error_t result = $4.PowerMap == true ?
+
+              fill_floorplan_power_map (&die->Floorplan, stkd->Dimensions, $4.Path)
+            : fill_floorplan           (&die->Floorplan, stkd->Dimensions, $4.Path) ;
+
+        if (result == TDICE_FAILURE)
         {
             string_destroy (&$2) ;
             string_destroy (&$3) ;
-            string_destroy (&$5) ;
+            string_destroy (&$4.Path) ;
+
+            die_free (die) ;
+
+            stack_element_free (stack_element) ;
 
             stack_description_destroy (stkd) ;
 
@@ -1466,7 +1514,29 @@ stack_element
 
         string_destroy (&$2) ;
         string_destroy (&$3) ;
-        string_destroy (&$5) ;
+        string_destroy (&$4.Path) ;
+    }
+  ;
+
+die_power
+
+  : FLOORPLAN PATH  // $2 Path of the floorplan file
+    {
+        $$.PowerMap = false ;
+        $$.Path     = $2 ;
+    }
+
+  | POWER MAP PATH  // $3 Path of the power map file
+    {
+        $$.PowerMap = true ;
+        $$.Path     = $3 ;
+    }
+
+  | POWER MAP       // The frames of the power map are inserted
+                    // with insert_power_values (e.g. by a client)
+    {
+        $$.PowerMap = true ;
+        $$.Path     = NULL ;
     }
   ;
 
@@ -1479,6 +1549,7 @@ solver
   : SOLVER ':'
         STEADY ';'
         INITIAL_ TEMPERATURE DVALUE ';' // $7
+        solver_options
 
     {
         // StepTime is set to 1 to avoid division by zero when computing
@@ -1490,12 +1561,23 @@ solver
         analysis->SlotLength   = 1u ; // CHECKME
 
         analysis->InitialTemperature = (Temperature_t) $7;
+
+        // The plugin integrates its own transient with a time step of
+        // StepTime (1 second) between two iterations of the steady state
+
+        if(stkd->TopHeatSink && stkd->TopHeatSink->SinkModel == TDICE_HEATSINK_TOP_PLUGGABLE)
+        {
+            if(initialize_pluggable_heatsink(stkd->TopHeatSink, analysis)!=TDICE_SUCCESS)
+                YYABORT ;
+        }
     }
 
   | SOLVER ':'
-        TRANSIENT STEP DVALUE ',' SLOT DVALUE ';'  // $5 StepTime
+        TRANSIENT STEP DVALUE ',' SLOT DVALUE      // $5 StepTime
                                                    // $8 SlotTime
-        INITIAL_ TEMPERATURE DVALUE ';'            // $12 Initial temperature
+        integration_method ';'                     // $9 Integration method
+        INITIAL_ TEMPERATURE DVALUE ';'            // $13 Initial temperature
+        solver_options
     {
         if ($8 < $5)
         {
@@ -1521,7 +1603,8 @@ solver
         analysis->AnalysisType       = TDICE_ANALYSIS_TYPE_TRANSIENT ;
         analysis->StepTime           = (Time_t) $5 ;
         analysis->SlotTime           = (Time_t) $8 ;
-        analysis->InitialTemperature = (Temperature_t) $12 ;
+        analysis->IntegrationMethod  = $9 ;
+        analysis->InitialTemperature = (Temperature_t) $13 ;
 
         // Execute correct division Slot / Step avoiding floating point issues
         // i.e. both slot and step are mutiplied by 10 until the decimal part
@@ -1543,6 +1626,17 @@ solver
 
         analysis->SlotLength   = (Quantity_t) sl_int / (Quantity_t) st_int ;
 
+        // The pluggable heat sink is simulated with a fixed time step
+
+        if (   analysis->StepTolerance > 0.0
+            && stkd->TopHeatSink != NULL
+            && stkd->TopHeatSink->SinkModel == TDICE_HEATSINK_TOP_PLUGGABLE)
+        {
+            STKERROR ("Adaptive step cannot be used with a pluggable heat sink") ;
+
+            YYABORT ;
+        }
+
         // Cannot be done before as we need the step time and initial temperature
         if(stkd->TopHeatSink && stkd->TopHeatSink->SinkModel == TDICE_HEATSINK_TOP_PLUGGABLE)
         {
@@ -1552,6 +1646,115 @@ solver
     }
   ;
 
+integration_method
+
+  : // Backward Euler is used if the method is not declared
+                           { $$ = TDICE_INTEGRATION_EULER ;       }
+  | ',' METHOD EULER       { $$ = TDICE_INTEGRATION_EULER ;       }
+  | ',' METHOD TRAPEZOIDAL { $$ = TDICE_INTEGRATION_TRAPEZOIDAL ; }
+  ;
+
+solver_options
+
+  : // Solver options are not mandatory
+
+  | solver_options solver_option
+  ;
+
+solver_option
+
+  : FACTORIZATION CACHE PATH ';' // $3 Directory storing the LU factors
+
+    {
+        string_copy (&analysis->FactorizationCache, &$3) ;
+
+        string_destroy (&$3) ;
+    }
+
+  | FACTORIZATION MULTIFRONTAL ';' // Multithreaded direct solver
+
+    {
+        analysis->SolverType = TDICE_SOLVER_MULTIFRONTAL ;
+    }
+
+  | FACTORIZATION SINGLE PRECISION ';' // Factors in single precision
+
+    {
+        analysis->SinglePrecision = true ;
+    }
+
+  | ITERATIVE krylov_method ';' // $2 Krylov method, default settings
+
+    {
+        analysis->SolverType = $2 ;
+    }
+
+  | ITERATIVE krylov_method TOLERANCE DVALUE ',' ITERATIONS DVALUE ';'
+
+    // $2 Krylov method
+    // $4 Relative residual to reach
+    // $7 Maximum number of iterations
+
+    {
+        if ($4 <= 0.0)
+        {
+            STKERROR ("Solver tolerance must be a positive value") ;
+
+            YYABORT ;
+        }
+
+        if ($7 < 1.0)
+        {
+            STKERROR ("Solver iterations must be at least 1") ;
+
+            YYABORT ;
+        }
+
+        analysis->SolverType          = $2 ;
+        analysis->SolverTolerance     = $4 ;
+        analysis->SolverMaxIterations = (Quantity_t) $7 ;
+    }
+
+  | ORDERING NESTED DISSECTION ';' // Geometric fill reducing ordering
+
+    {
+        analysis->Ordering = TDICE_ORDERING_NESTED_DISSECTION ;
+    }
+
+  | THREADS DVALUE ';' // $2 Number of threads
+
+    {
+        if ($2 < 1.0)
+        {
+            STKERROR ("Number of threads must be at least 1") ;
+
+            YYABORT ;
+        }
+
+        analysis->NThreads = (Quantity_t) $2 ;
+    }
+
+  | ADAPTIVE STEP TOLERANCE DVALUE ';' // $4 Maximum local error (K)
+
+    {
+        if ($4 <= 0.0)
+        {
+            STKERROR ("Step tolerance must be a positive value") ;
+
+            YYABORT ;
+        }
+
+        analysis->StepTolerance = (Temperature_t) $4 ;
+    }
+  ;
+
+krylov_method
+
+  : BICGSTAB  { $$ = TDICE_SOLVER_BICGSTAB ;  }
+  | MULTIGRID { $$ = TDICE_SOLVER_MULTIGRID ; }
+  | PCG       { $$ = TDICE_SOLVER_PCG ;       }
+  ;
+
 /******************************************************************************/
 /****************************** Desired Output ********************************/
 /******************************************************************************/
@@ -1687,6 +1890,20 @@ inspection_point
             YYABORT ;
         }
 
+        if (tmp->Pointer.Die->Floorplan.NMapCells != 0u)
+        {
+            sprintf (error_message, "Die %s has a power map, not a floorplan", $3) ;
+
+            STKERROR (error_message) ;
+
+            string_destroy (&$3) ;
+            string_destroy (&$5) ;
+
+            stack_element_destroy (&stack_element) ;
+
+            YYABORT ;
+        }
+
         stack_element_destroy (&stack_element) ;
 
         InspectionPoint_t *ipoint = $$ = inspection_point_calloc () ;
@@ -1804,11 +2021,11 @@ inspection_point
         string_destroy (&$7) ;
      }
 
-  |  TMAP '(' IDENTIFIER ',' PATH when ')' ';'
+  |  TMAP '(' IDENTIFIER ',' PATH map_when ')' ';'
 
      // $3 Identifier of the stack element (layer, channel or die)
      // $5 Path of the output file
-     // $6 when to generate output for this observation
+     // $6 when to generate output for this observation and file format
 
      {
         StackElement_t stack_element ;
@@ -1850,7 +2067,8 @@ inspection_point
         }
 
         ipoint->OType        = TDICE_OUTPUT_TYPE_TMAP ;
-        ipoint->Instant      = $6 ;
+        ipoint->Instant      = $6.Instant ;
+        ipoint->Format       = $6.Format ;
         ipoint->StackElement = tmp ;
 
         string_copy (&ipoint->FileName, &$5) ;
@@ -1859,11 +2077,11 @@ inspection_point
         string_destroy (&$5) ;
      }
 
-  |  PMAP '(' IDENTIFIER ',' PATH when ')' ';'
+  |  PMAP '(' IDENTIFIER ',' PATH map_when ')' ';'
 
      // $3 Identifier of the stack element (must be a die)
      // $5 Path of the output file
-     // $6 when to generate output for this observation
+     // $6 when to generate output for this observation and file format
 
     {
         StackElement_t stack_element ;
@@ -1905,7 +2123,8 @@ inspection_point
         }
 
         ipoint->OType        = TDICE_OUTPUT_TYPE_PMAP ;
-        ipoint->Instant      = $6 ;
+        ipoint->Instant      = $6.Instant ;
+        ipoint->Format       = $6.Format ;
         ipoint->StackElement = tmp ;
 
         string_copy (&ipoint->FileName, &$5) ;
@@ -1997,10 +2216,37 @@ maxminavg
 when
 
   :  // Declaring the instance option is not mandatory (final is assumed)
-                { $$ =  TDICE_OUTPUT_INSTANT_FINAL ; }
-  |  ',' STEP   { $$ =  TDICE_OUTPUT_INSTANT_STEP ;  }
-  |  ',' SLOT   { $$ =  TDICE_OUTPUT_INSTANT_SLOT ;  }
-  |  ',' FINAL  { $$ =  TDICE_OUTPUT_INSTANT_FINAL ; }
+                  { $$ =  TDICE_OUTPUT_INSTANT_FINAL ; }
+  |  ',' instant  { $$ =  $2 ; }
+  ;
+
+instant
+
+  :  STEP   { $$ =  TDICE_OUTPUT_INSTANT_STEP ;  }
+  |  SLOT   { $$ =  TDICE_OUTPUT_INSTANT_SLOT ;  }
+  |  FINAL  { $$ =  TDICE_OUTPUT_INSTANT_FINAL ; }
+  ;
+
+map_when
+
+  :  when                     // Thermal and power maps are printed as text
+                              // if the format is not declared
+     {
+        $$.Instant = $1 ;
+        $$.Format  = TDICE_OUTPUT_FORMAT_TEXT ;
+     }
+
+  |  ',' BINARY
+     {
+        $$.Instant = TDICE_OUTPUT_INSTANT_FINAL ;
+        $$.Format  = TDICE_OUTPUT_FORMAT_BINARY ;
+     }
+
+  |  ',' instant ',' BINARY
+     {
+        $$.Instant = $2 ;
+        $$.Format  = TDICE_OUTPUT_FORMAT_BINARY ;
+     }
   ;
 
 %%
@@ -75,6 +75,13 @@ extern "C"
 
         Time_t SlotTime ;
 
+        /*! The method used to integrate the temperatures over a step.
+         *  The trapezoidal rule is second order accurate but, unlike
+         *  backward Euler, it does not damp the fastest modes (e.g. those
+         *  of the coolant), which may oscillate if the step is too long */
+
+        IntegrationMethod_t IntegrationMethod ;
+
         /*! Number of steps to do to complete a slot */
 
         Quantity_t SlotLength ;
@@ -86,6 +93,44 @@ extern "C"
         /*! Initial Temperature if the IC stack */
 
         Temperature_t InitialTemperature ;
+
+        /*! Directory storing the cached factorizations of the system
+         *  matrix (\c NULL if the cache is not used) */
+
+        String_t FactorizationCache ;
+
+        /*! The linear solver used to compute the temperatures */
+
+        SolverType_t SolverType ;
+
+        /*! The fill reducing ordering used by the direct solvers */
+
+        OrderingType_t Ordering ;
+
+        /*! Stores the factors of the system matrix in single precision.
+         *  The solutions are refined up to the double precision ones */
+
+        bool SinglePrecision ;
+
+        /*! Relative residual to reach with an iterative solver */
+
+        double SolverTolerance ;
+
+        /*! Maximum number of iterations of an iterative solver */
+
+        Quantity_t SolverMaxIterations ;
+
+        /*! Number of threads used to assemble the system matrix and, with
+         *  the multifrontal solver, to factorize it */
+
+        Quantity_t NThreads ;
+
+        /*! Maximum local error (in Kelvin) of a time step. If it is
+         *  positive, the length of every step is chosen between
+         *  \a StepTime and the end of the slot so that the estimated error
+         *  does not exceed it. If it is \c 0 every step lasts \a StepTime */
+
+        Temperature_t StepTolerance ;
     } ;
 
     /*! Definition of the type Analysis_t */
@@ -194,6 +239,23 @@ extern "C"
 
 
 
+    /*! Returns the time that divides the thermal capacities in the system
+     *  matrix and in the system vector
+     *
+     * With the backward Euler method this is the step time. A trapezoidal
+     * step is computed as a backward Euler step of half the length followed
+     * by a linear extrapolation to the end of the step, so the capacities
+     * are divided by half of the step time.
+     *
+     * \param analysis the address of the analysis structure
+     *
+     * \return the time dividing the capacities, in seconds
+     */
+
+    Time_t get_matrix_step_time (Analysis_t *analysis) ;
+
+
+
     /*! Increase the simulation time by a step
      *
      * \param analysis the address of the analysis structure
@@ -203,6 +265,28 @@ extern "C"
 
 
 
+    /*! Increase the simulation time by \a nsteps steps
+     *
+     * \param analysis the address of the analysis structure
+     * \param nsteps   the number of steps (of length \a StepTime ) to add
+     */
+
+    void increase_by_steps (Analysis_t *analysis, Quantity_t nsteps) ;
+
+
+
+    /*! Returns the number of steps left to complete the current slot
+     *
+     * \param analysis the address of the analysis structure
+     *
+     * \return the number of steps (of length \a StepTime ) before the
+     *         next slot boundary
+     */
+
+    Quantity_t get_steps_to_slot_end (Analysis_t *analysis) ;
+
+
+
     /*! Returns the state of the slot simulation
      *
      * \param analysis the address of the analysis structure
@@ -57,6 +57,7 @@ extern "C"
 #include "floorplan_matrix.h"
 #include "floorplan_element_list.h"
 #include "powers_queue.h"
+#include "power_trace.h"
 
 /******************************************************************************/
 
@@ -88,6 +89,69 @@ extern "C"
              to get the source vector */
 
         Power_t *Bpowers ;
+
+        /*! Power vector storing the powers of the next slot while the
+             source vector is updated incrementally */
+
+        Power_t *Npowers ;
+
+        /*! The power trace that feeds the floorplan elements (or the cells
+            of the power map), one slot at a time (\c NULL if power values
+            are listed in the file or inserted) */
+
+        PowerTrace_t *PowerTrace ;
+
+        /*! The number of thermal cells in the source layer if the power is
+            given as a power map, i.e. one value per cell, ( \c 0 if it is
+            given by floorplan elements) */
+
+        CellIndex_t NMapCells ;
+
+        /*! The frames of the power map inserted with
+            \a insert_power_values_floorplan , \a NMapCells values each
+            (\c NULL if the power map is streamed from \a PowerTrace ) */
+
+        PowersQueue_t *MapValues ;
+
+        /*! The offsets (in the layer) of the thermal cells covered by the
+            IC elements, all the cells of every IC element. They are stored
+            IC element after IC element, floorplan element after floorplan
+            element, in the same order as in the floorplan file */
+
+        CellIndex_t *CellOffsets ;
+
+        /*! The position in \a CellOffsets of the first cell of each IC
+            element (plus one for the end of the last IC element) */
+
+        CellIndex_t *ICElementCells ;
+
+        /*! The position in \a ICElementCells of the first IC element of
+            each floorplan element (plus one for the end of the last one) */
+
+        Quantity_t *ElementICElements ;
+
+        /*! The offsets (in the layer) of the thermal cells covered by each
+            floorplan element, once even if more than one of its IC
+            elements cover them, floorplan element after floorplan element */
+
+        CellIndex_t *DistinctCellOffsets ;
+
+        /*! The position in \a DistinctCellOffsets of the first cell of each
+            floorplan element (plus one for the end of the last one) */
+
+        CellIndex_t *ElementDistinctCells ;
+
+        /*! The maximum, minimum, average and gradient temperatures of the
+            floorplan elements, \a NElements values each, computed in a
+            single pass and shared by all the inspection points on the die
+            (allocated on demand) */
+
+        Temperature_t *Statistics ;
+
+        /*! The temperatures \a Statistics have been computed from
+            (\c NULL if they must be computed again) */
+
+        Temperature_t *StatisticsTemperatures ;
     } ;
 
     /*! Definition of the type Floorplan_t */
@@ -202,6 +266,29 @@ extern "C"
 
 
 
+    /*! Fills a floorplan that gives the power of the source layer as a
+     *  power map, one value for each thermal cell
+     *
+     *  The frames of the power map bypass the floorplan elements: they are
+     *  added as they are to the sources of the layer. They are read from the
+     *  power trace \a file_name (see \a power_trace_open_map ) or, if
+     *  \a file_name is \c NULL , inserted with \a insert_power_values .
+     *
+     * \param floorplan  the floorplan structure to fill
+     * \param dimensions pointer to the structure storing the dimensions of the stack
+     * \param file_name  path to the power map file (or \c NULL)
+     *
+     * \return \c TDICE_FAILURE if the file cannot be opened or if the memory
+     *                          allocation fails
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t fill_floorplan_power_map
+
+        (Floorplan_t *floorplan, Dimensions_t *dimensions, String_t file_name) ;
+
+
+
     /*! Fills the source vector corresponding to a floorplan
      *
      *  \param floorplan    pointer to the floorplan placed on the source layer
@@ -212,13 +299,35 @@ extern "C"
      *  \return \c TDICE_SUCCESS if the source vector has been filled correctly
      *  \return \c TDICE_FAILURE if it not possible to fill the source vector
      *                           (at least one floorplan element with no power
-     *                            values in its queue)
+     *                            values in its queue, or no more slots in
+     *                            the power trace of the floorplan)
      */
 
     Error_t fill_sources_floorplan (Floorplan_t *floorplan, Source_t *sources) ;
 
 
 
+    /*! Updates the source vector corresponding to a floorplan
+     *
+     *  The sources must have been set by a previous call to
+     *  \a fill_sources_floorplan (or \a update_sources_floorplan ). Only
+     *  the floorplan elements whose power changed since then update the
+     *  sources, adding the difference between the two powers.
+     *
+     *  \param floorplan pointer to the floorplan placed on the source layer
+     *  \param sources pointer to the location of the source vector
+     *                 that corresponds to the South-West thermal cell
+     *                 of the layer where the floorplan is placed
+     *
+     *  \return \c TDICE_SUCCESS if the source vector has been updated
+     *  \return \c TDICE_FAILURE if it not possible to update the source
+     *                           vector (as for \a fill_sources_floorplan )
+     */
+
+    Error_t update_sources_floorplan (Floorplan_t *floorplan, Source_t *sources) ;
+
+
+
     /*! Returns the total number of floorplan elements in the floorplan
      *
      * \param floorplan address of the Floorplan structure
@@ -232,6 +341,36 @@ extern "C"
 
 
 
+    /*! Returns the number of power values that the floorplan consumes
+     *  in every slot
+     *
+     * \param floorplan address of the Floorplan structure
+     *
+     * \return the number of thermal cells in the source layer if
+     *         \a floorplan is a power map
+     * \return the number of floorplan elements otherwise
+     */
+
+    Quantity_t get_number_of_power_values_floorplan (Floorplan_t *floorplan) ;
+
+
+
+    /*! Tells if the power values of the floorplan cannot be read because
+     *  its power trace (or power map) file has a slot that is not valid
+     *
+     *  It distinguishes a failure of \a fill_sources_floorplan or
+     *  \a update_sources_floorplan from the end of the power values.
+     *
+     * \param floorplan address of the Floorplan structure
+     *
+     * \return \c true if the power trace of \a floorplan failed
+     * \return \c false otherwise
+     */
+
+    bool power_trace_failed_floorplan (Floorplan_t *floorplan) ;
+
+
+
     /*! Returns a pointer to a floorplan element in the floorplan
      *
      * \param floorplan address of the floorplan
@@ -249,6 +388,10 @@ extern "C"
 
 
     /*! Inserts power values from \a pvaluse into each floorplan element
+     *
+     *  If \a floorplan is a power map, a frame of \a NMapCells values
+     *  is popped from \a pvalues instead. A floorplan that reads a power
+     *  trace (or power map) file does not accept inserted power values.
      *
      *  The queue \a pvalues must contain at least as many power values
      *  as floorplan elements in \a floorplan . Floorplan elements are
@@ -260,7 +403,8 @@ extern "C"
      *  \param pvalues pointer to the list of power values
      *
      *  \return \c TDICE_FAILURE if the queue \a pvalues does not contain enough
-     *                           power values
+     *                           power values or if \a floorplan reads a
+     *                           power trace file
      *  \return \c TDICE_SUCCESS otherwise
      */
 
@@ -270,6 +414,52 @@ extern "C"
 
 
 
+    /*! Returns one temperature statistic of every floorplan element
+     *
+     *  The maximum, minimum, average and gradient temperatures of all the
+     *  floorplan elements are computed together, reducing the temperatures
+     *  of the cells listed in the tables \a DistinctCellOffsets (maximum
+     *  and minimum) and \a CellOffsets (average, the same value as
+     *  \a get_avg_temperature_floorplan_element ) built by
+     *  \a fill_floorplan , and stored into a buffer of the floorplan.
+     *  The next calls
+     *  with the same \a temperatures read from it without touching the
+     *  thermal cells, until \a invalidate_temperature_statistics_floorplan
+     *  is called (i.e. the temperatures have changed).
+     *
+     *  \param floorplan pointer to the floorplan
+     *  \param temperatures pointer to the temperature of the first thermal
+     *                      cell in the layer where \a floorplan is placed
+     *  \param quantity the statistic to return
+     *
+     *  \return the address of \a NElements temperatures, in the same order
+     *          as the floorplan elements in the floorplan file. The memory
+     *          belongs to \a floorplan and must not be freed.
+     *  \return \c NULL if \a quantity is not known or if the memory
+     *          allocation fails
+     */
+
+    Temperature_t *get_temperature_statistics_floorplan
+    (
+        Floorplan_t      *floorplan,
+        Temperature_t    *temperatures,
+        OutputQuantity_t  quantity
+    ) ;
+
+
+
+    /*! Marks the temperature statistics of the floorplan as outdated
+     *
+     *  The next call to \a get_temperature_statistics_floorplan will
+     *  compute them again.
+     *
+     *  \param floorplan pointer to the floorplan
+     */
+
+    void invalidate_temperature_statistics_floorplan (Floorplan_t *floorplan) ;
+
+
+
     /*! Returns the maximum temperature of each floorplan element
      *  in the given floorplan
      *
@@ -71,6 +71,11 @@ extern "C"
 
         String_t Id ;
 
+        /*! The position of the floorplan element in the floorplan file
+         *  ( \c 0 for the first one) */
+
+        Quantity_t Index ;
+
         /*! The number of IC elements that defines the surface of
          *  the floorplan element */
 
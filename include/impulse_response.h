@@ -0,0 +1,211 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#ifndef _3DICE_IMPULSE_RESPONSE_H_
+#define _3DICE_IMPULSE_RESPONSE_H_
+
+/*! \file impulse_response.h */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************************************/
+
+#include "types.h"
+
+#include "analysis.h"
+#include "dimensions.h"
+#include "output.h"
+#include "thermal_data.h"
+
+/******************************************************************************/
+
+    /*! \struct ImpulseResponse_t
+     *
+     * \brief Structure storing the transient response of the stack to the
+     *        power dissipated by each floorplan element, on the slot grid
+     *
+     * With a fixed flow rate and heat sink the transient system is linear
+     * and time invariant and the powers are constant within a slot, so the
+     * temperatures at the end of slot \c n are
+     *
+     *     T(n) = T0(n) + sum_j H(n - j) p(j)
+     *
+     * where \c T0 is the response to the initial temperature and to the
+     * ambient and coolant sources (all powers set to zero) and \c H(m) is
+     * the temperature rise at the end of slot \c m due to 1 W dissipated
+     * in every floorplan element during slot \c 0 only. Both are computed
+     * once, with the factorized system matrix and only for the thermal cells
+     * read by the inspection points, until they settle: the responses of
+     * later slots are \c T0 constant and \c H null, so that the convolution
+     * needs at most \a NSlots terms.
+     */
+
+    struct ImpulseResponse_t
+    {
+        /*! The number of floorplan elements in the stack */
+
+        Quantity_t NElements ;
+
+        /*! The number of thermal cells observed */
+
+        CellIndex_t NCells ;
+
+        /*! The offsets in the stack of the thermal cells observed */
+
+        CellIndex_t *Cells ;
+
+        /*! The number of slots stored, i.e. the length of the responses */
+
+        Quantity_t NSlots ;
+
+        /*! The impulse responses \c H (K/W) slot by slot and, within a slot,
+         *  cell by cell: the first \a NElements values are the response of
+         *  the cell \a Cells [0] at the end of slot \c 0 */
+
+        Temperature_t *Responses ;
+
+        /*! The temperatures \c T0 slot by slot (\a NCells values each) */
+
+        Temperature_t *Offsets ;
+    } ;
+
+    /*! Definition of the type ImpulseResponse_t */
+
+    typedef struct ImpulseResponse_t ImpulseResponse_t ;
+
+
+
+/******************************************************************************/
+
+
+
+    /*! Inits the fields of the \a iresponse structure with default values
+     *
+     * \param iresponse the address of the structure to initalize
+     */
+
+    void impulse_response_init (ImpulseResponse_t *iresponse) ;
+
+
+
+    /*! Computes the impulse responses of the cells read by the inspection
+     *  points in \a output
+     *
+     * The responses are computed simulating, with \a tdata , one scenario
+     * for each floorplan element and one for the initial state (see
+     * ThermalBatch_t), for at most \a nslots slots. The simulation stops
+     * earlier if in a slot no response changes by more than \a tolerance
+     * (in K, or in K/W for the impulse responses). The floorplan elements
+     * are counted as in \a insert_power_values . \a tdata and \a analysis
+     * are not modified.
+     *
+     * \param iresponse  the address of the ImpulseResponse to build
+     * \param tdata      the address of the (already built) ThermalData
+     * \param dimensions the dimensions of the IC
+     * \param analysis   the address of the Analysis structure
+     * \param output     the address of the Output structure
+     * \param nslots     the maximum number of slots of the responses
+     * \param tolerance  the change below which the responses are settled
+     *
+     * \return \c TDICE_FAILURE if the analysis is not transient or has an
+     *              adaptive time step, the stack has a pluggable heat
+     *              sink, an inspection point is a Pmap, the memory
+     *              allocation fails or the solver reports an error
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t impulse_response_build
+    (
+        ImpulseResponse_t *iresponse,
+        ThermalData_t     *tdata,
+        Dimensions_t      *dimensions,
+        Analysis_t        *analysis,
+        Output_t          *output,
+        Quantity_t         nslots,
+        Temperature_t      tolerance
+    ) ;
+
+
+
+    /*! Destroys the content of the fields of the structure \a iresponse
+     *
+     * The function releases any dynamic memory used by the structure and
+     * resets its state calling \a impulse_response_init .
+     *
+     * \param iresponse the address of the structure to destroy
+     */
+
+    void impulse_response_destroy (ImpulseResponse_t *iresponse) ;
+
+
+
+    /*! Computes the temperatures at the end of a slot by convolution
+     *
+     * Only the temperatures of the cells observed by \a iresponse are
+     * written in \a temperatures , so that the array can be given to
+     * \a generate_output (as the temperatures of a ThermalData_t) to print
+     * the inspection points used to build \a iresponse . The cost does not
+     * depend on \a slot but only on the number of slots stored.
+     *
+     * \param iresponse    the address of the ImpulseResponse
+     * \param powers       the power trace, slot after slot: the power of
+     *                     every floorplan element (\a NElements values,
+     *                     in W) in the slots \c 0 to \a slot
+     * \param slot         the index of the slot (0 first)
+     * \param temperatures the temperature array to fill (one value for each
+     *                     thermal cell in the stack)
+     */
+
+    void emulate_slot_convolution
+    (
+        ImpulseResponse_t *iresponse,
+        Power_t           *powers,
+        Quantity_t         slot,
+        Temperature_t     *temperatures
+    ) ;
+
+/******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _3DICE_IMPULSE_RESPONSE_H_ */
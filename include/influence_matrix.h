@@ -0,0 +1,194 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#ifndef _3DICE_INFLUENCE_MATRIX_H_
+#define _3DICE_INFLUENCE_MATRIX_H_
+
+/*! \file influence_matrix.h */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************************************/
+
+#include "types.h"
+
+#include "analysis.h"
+#include "dimensions.h"
+#include "output.h"
+#include "thermal_data.h"
+
+/******************************************************************************/
+
+    /*! \struct InfluenceMatrix_t
+     *
+     * \brief Structure storing the steady state response of the stack to
+     *        the power dissipated by each floorplan element
+     *
+     * In steady state the temperatures are linear in the power values of
+     * the floorplan elements: T = T0 + G p. The matrix G (the Green's
+     * function of the stack) and the temperatures T0 (all the powers set
+     * to zero) are computed once, with one solve for each floorplan element
+     * and the factorized system matrix, and only for the thermal cells that
+     * are read by the inspection points. Then the steady state temperatures
+     * of these cells for any power vector are given by a dense matrix vector
+     * product, without solving the linear system again.
+     */
+
+    struct InfluenceMatrix_t
+    {
+        /*! The number of floorplan elements in the stack, i.e. the number
+         *  of columns of the matrix */
+
+        Quantity_t NElements ;
+
+        /*! The number of thermal cells observed, i.e. the number
+         *  of rows of the matrix */
+
+        CellIndex_t NCells ;
+
+        /*! The offsets in the stack of the thermal cells observed */
+
+        CellIndex_t *Cells ;
+
+        /*! The temperature rise of every cell observed due to 1 W in every
+         *  floorplan element (K/W), stored row by row: the first
+         *  \a NElements values belong to the cell \a Cells [0] */
+
+        Temperature_t *Responses ;
+
+        /*! The temperature of every cell observed when all the floorplan
+         *  elements dissipate no power */
+
+        Temperature_t *Offsets ;
+    } ;
+
+    /*! Definition of the type InfluenceMatrix_t */
+
+    typedef struct InfluenceMatrix_t InfluenceMatrix_t ;
+
+
+
+/******************************************************************************/
+
+
+
+    /*! Inits the fields of the \a imatrix structure with default values
+     *
+     * \param imatrix the address of the structure to initalize
+     */
+
+    void influence_matrix_init (InfluenceMatrix_t *imatrix) ;
+
+
+
+    /*! Computes the influence matrix of the cells read by the inspection
+     *  points in \a output
+     *
+     * The floorplan elements are counted as in \a insert_power_values , i.e.
+     * source layers bottom first and, within a floorplan, in the order of
+     * declaration. \a tdata must be built for a steady state analysis so that
+     * its system matrix is already factorized. The power queues of the
+     * floorplan elements are not used.
+     *
+     * \param imatrix    the address of the InfluenceMatrix to build
+     * \param tdata      the address of the (already built) ThermalData
+     * \param dimensions the dimensions of the IC
+     * \param analysis   the address of the Analysis structure
+     * \param output     the address of the Output structure
+     *
+     * \return \c TDICE_FAILURE if the analysis is not steady state, the
+     *              stack has a pluggable heat sink, an inspection point
+     *              is a Pmap (it reads the source vector), the memory
+     *              allocation fails or the solver reports an error
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t influence_matrix_build
+    (
+        InfluenceMatrix_t *imatrix,
+        ThermalData_t     *tdata,
+        Dimensions_t      *dimensions,
+        Analysis_t        *analysis,
+        Output_t          *output
+    ) ;
+
+
+
+    /*! Destroys the content of the fields of the structure \a imatrix
+     *
+     * The function releases any dynamic memory used by the structure and
+     * resets its state calling \a influence_matrix_init .
+     *
+     * \param imatrix the address of the structure to destroy
+     */
+
+    void influence_matrix_destroy (InfluenceMatrix_t *imatrix) ;
+
+
+
+    /*! Computes the steady state temperatures for a set of power values
+     *
+     * Only the temperatures of the cells observed by the influence matrix
+     * are written in \a temperatures , so that the array can be given to
+     * \a generate_output (as the temperatures of a ThermalData_t) to print
+     * the inspection points used to build \a imatrix .
+     *
+     * \param imatrix      the address of the InfluenceMatrix
+     * \param powers       the power of every floorplan element (\a NElements
+     *                     values, in W)
+     * \param temperatures the temperature array to fill (one value for each
+     *                     thermal cell in the stack)
+     */
+
+    void emulate_steady_influence
+    (
+        InfluenceMatrix_t *imatrix,
+        Power_t           *powers,
+        Temperature_t     *temperatures
+    ) ;
+
+/******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _3DICE_INFLUENCE_MATRIX_H_ */
@@ -84,6 +84,10 @@ extern "C"
 
         OutputQuantity_t Quantity ;
 
+        /*! The format of the output file (only for Tmap and Pmap) */
+
+        OutputFormat_t Format ;
+
         /*! X coordinate of the thermal cell as specified in the stack file */
 
         ChipDimension_t Xval ;
@@ -116,6 +120,16 @@ extern "C"
         /*! Pointer to the Floorplan Element */
 
         FloorplanElement_t *FloorplanElement ;
+
+        /*! The stream of the output file. It is opened when the header
+         *  is generated and it stays open until the inspection point
+         *  is destroyed */
+
+        FILE *Stream ;
+
+        /*! The user space buffer given to \a Stream */
+
+        char *StreamBuffer ;
     } ;
 
     /*! definition of the type InspectionPoint_t */
@@ -153,8 +167,9 @@ extern "C"
 
     /*! Destroys the content of the fields of the structure \a ipoint
      *
-     * The function releases any dynamic memory used by the structure and
-     * resets its state calling \a inspection_point_init .
+     * The function releases any dynamic memory used by the structure,
+     * closes its output stream (if open) and resets its state calling
+     * \a inspection_point_init .
      *
      * \param ipoint the address of the structure to destroy
      */
@@ -205,6 +220,19 @@ extern "C"
 
 
 
+    /*! Writes to the output file the content buffered in the stream
+     *
+     * \param ipoint the address of the inspection point
+     *
+     * \return \c TDICE_SUCCESS if the stream is not open or if it has
+     *                          been flushed
+     * \return \c TDICE_FAILURE if the buffered content cannot be written
+     */
+
+    Error_t inspection_point_flush (InspectionPoint_t *ipoint) ;
+
+
+
     /*! Tests if two insection points generates he output into the same file
      *
      * \param ipoint the first inspection point
@@ -275,9 +303,53 @@ extern "C"
 
 
 
+    /*! Marks the thermal cells whose temperature is read by an
+     *  inspection point
+     *
+     * \a marks has one entry for each thermal cell in the stack and the
+     * entries of the cells read by \a ipoint are set to \c true (the
+     * others are not changed). A Pmap inspection point reads only the
+     * source vector and cannot be marked.
+     *
+     * \param ipoint     the address of the InspectionPoint structure
+     * \param dimensions the address of the dimension structure
+     * \param marks      the array of flags, one for each thermal cell
+     *
+     * \return \c TDICE_FAILURE if \a ipoint is a Pmap
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t mark_inspection_point_cells
+    (
+        InspectionPoint_t *ipoint,
+        Dimensions_t      *dimensions,
+        bool              *marks
+    ) ;
+
+
+
     /*! Generates the file in which a particular inspection point
      *  will be printed
      *
+     * The file stays open, with a buffered stream, until the inspection
+     * point is destroyed.
+     *
+     * A Tmap or Pmap inspection point with \c TDICE_OUTPUT_FORMAT_BINARY
+     * writes a binary file (native byte order) that starts with:
+     *  - the 8 characters "3DICEMAP"
+     *  - 8 uint32: format version (1), map type (0 thermal, 1 power),
+     *    number of rows, number of columns, index of the layer in the
+     *    stack, size in bytes of a value (8), size in bytes of the header
+     *    (i.e. offset of the first frame) and length of the stack
+     *    element id
+     *  - the id of the stack element, padded with zeros to 8 bytes
+     *  - 4 arrays of doubles: the x coordinate of the center of every
+     *    column, the y coordinate of the center of every row, the length
+     *    of every column and the width of every row (um)
+     *
+     * and every output appends a frame of doubles: the time followed by
+     * the value of every cell (K or W), row by row, as in the text format.
+     *
      * \param ipoint     the address of the InspectionPoint structure
      * \param dimensions the address of the dimension structure
      * \param prefix string to be printed as suffix for every line in the header
@@ -292,6 +364,14 @@ extern "C"
 
 
     /*! Generates the output implemented by the inspection point
+     *
+     * The output is written into the buffer of the stream opened by
+     * \a generate_inspection_point_header and it reaches the file only when
+     * the buffer is full or when \a inspection_point_flush is called.
+     *
+     * The statistics of the floorplan read by Tflp and Tflpel inspection
+     * points are computed again at every call (see
+     * \a generate_inspection_point_output_shared to share them).
      *
      * \param ipoint the address of the InspectionPoint structure
      * \param dimensions the address of the dimension structure
@@ -314,6 +394,10 @@ extern "C"
 
 
     /*! Fills a message with the output implemented by the inspection point
+     *
+     * As \a generate_inspection_point_output , the statistics of the
+     * floorplan are computed again at every call (see
+     * \a fill_message_inspection_point_shared to share them).
      *
      * \param ipoint the address of the InspectionPoint structure
      * \param output_quantity the quantity to report (max, min, avg)
@@ -333,6 +417,75 @@ extern "C"
         NetworkMessage_t  *message
     ) ;
 
+
+
+    /*! Marks as outdated the floorplan statistics read by the inspection
+     *  point (only Tflp and Tflpel inspection points read them)
+     *
+     * It must be called, once for all the inspection points, every time
+     * the temperatures given to the \c _shared functions change.
+     *
+     * \param ipoint the address of the InspectionPoint structure
+     */
+
+    void invalidate_statistics_inspection_point (InspectionPoint_t *ipoint) ;
+
+
+
+    /*! Generates the output implemented by the inspection point reusing the
+     *  floorplan statistics of the die
+     *
+     * As \a generate_inspection_point_output but the statistics of the
+     * floorplan are computed only if they are outdated (see
+     * \a invalidate_statistics_inspection_point ), so that all the Tflp
+     * and Tflpel inspection points on the same die share them.
+     *
+     * \param ipoint the address of the InspectionPoint structure
+     * \param dimensions the address of the dimension structure
+     * \param temperatures pointer to the first element of the temparature array
+     * \param sources      pointer to the first element of the source array
+     * \param current_time time instant of the measurement
+     *
+     * \return \c TDICE_FAILURE if the output file cannot be written
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t generate_inspection_point_output_shared
+    (
+        InspectionPoint_t *ipoint,
+        Dimensions_t      *dimensions,
+        Temperature_t     *temperatures,
+        Source_t          *sources,
+        Time_t             current_time
+    ) ;
+
+
+
+    /*! Fills a message with the output implemented by the inspection point
+     *  reusing the floorplan statistics of the die
+     *
+     * As \a fill_message_inspection_point but the statistics of the
+     * floorplan are computed only if they are outdated (see
+     * \a invalidate_statistics_inspection_point ).
+     *
+     * \param ipoint the address of the InspectionPoint structure
+     * \param output_quantity the quantity to report (max, min, avg)
+     * \param dimensions the address of the dimension structure
+     * \param temperatures pointer to the first element of the temparature array
+     * \param sources      pointer to the first element of the source array
+     * \param message the message to fill
+     */
+
+    void fill_message_inspection_point_shared
+    (
+        InspectionPoint_t *ipoint,
+        OutputQuantity_t   output_quantity,
+        Dimensions_t      *dimensions,
+        Temperature_t     *temperatures,
+        Source_t          *sources,
+        NetworkMessage_t  *message
+    ) ;
+
 /******************************************************************************/
 
 #ifdef __cplusplus
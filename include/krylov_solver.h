@@ -0,0 +1,222 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#ifndef _3DICE_KRYLOV_SOLVER_H_
+#define _3DICE_KRYLOV_SOLVER_H_
+
+/*! \file krylov_solver.h */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************************************/
+
+#include "types.h"
+#include "multigrid.h"
+
+/******************************************************************************/
+
+    /*! \struct KrylovSolver_t
+     *
+     *  \brief Iterative solver (BiCGSTAB or PCG) for the thermal system
+     *
+     *  The preconditioner is the incomplete LU factorization of the system
+     *  matrix with no fill-in (ILU(0)), stored with the same compressed
+     *  column pattern of the matrix itself. The memory needed is then
+     *  bounded by one more copy of the coefficients plus a few vectors.
+     *  With \c TDICE_SOLVER_MULTIGRID the preconditioner of BiCGSTAB is
+     *  instead one multigrid V-cycle.
+     *  Each solution is kept as the initial guess of the next solve.
+     */
+
+    struct KrylovSolver_t
+    {
+        /*! The relative residual ||b - Ax|| / ||b|| to reach */
+
+        double Tolerance ;
+
+        /*! The maximum number of iterations for a solve */
+
+        Quantity_t MaxIterations ;
+
+        /*! The number of iterations done by the last solve */
+
+        Quantity_t Iterations ;
+
+        /*! The method set by the last factorization */
+
+        SolverType_t Method ;
+
+        /*! The number of rows of the system matrix */
+
+        CellIndex_t Size ;
+
+        /*! The coefficients of the ILU(0) factors, with the same pattern
+         *  of the system matrix: strictly lower part is L (unit diagonal),
+         *  upper part (diagonal included) is U */
+
+        SystemMatrixCoeff_t *Preconditioner ;
+
+        /*! Index of the diagonal coefficient of each column */
+
+        CellIndex_t *Diagonal ;
+
+        /*! Work vectors used by the Krylov iterations */
+
+        double *Work ;
+
+        /*! The solutions of the last solve, used as initial guess */
+
+        double *Guess ;
+
+        /*! The number of columns stored in \a Guess */
+
+        Quantity_t NGuesses ;
+
+        /*! The multigrid preconditioner (\c TDICE_SOLVER_MULTIGRID only).
+         *  Its grid must be set with \a multigrid_set_grid before the
+         *  first factorization */
+
+        Multigrid_t Multigrid ;
+    } ;
+
+    /*! Definition of the type KrylovSolver_t */
+
+    typedef struct KrylovSolver_t KrylovSolver_t ;
+
+
+
+/******************************************************************************/
+
+
+
+    /*! Inits the fields of the \a ksolver structure with default values
+     *
+     * \param ksolver the address of the structure to initalize
+     */
+
+    void krylov_solver_init (KrylovSolver_t *ksolver) ;
+
+
+
+    /*! Destroys the content of the fields of the structure \a ksolver
+     *
+     * The function releases any dynamic memory used by the structure and
+     * resets its state calling \a krylov_solver_init . Tolerance and
+     * maximum number of iterations are preserved.
+     *
+     * \param ksolver the address of the structure to destroy
+     */
+
+    void krylov_solver_destroy (KrylovSolver_t *ksolver) ;
+
+
+
+    /*! Computes the preconditioner of a matrix
+     *
+     * The matrix is given in Compressed Column Storage. Row indices must
+     * be sorted within each column and every column must store its
+     * diagonal coefficient. Memory is allocated at the first call and
+     * reused as long as \a size and \a method do not change. With
+     * \c TDICE_SOLVER_MULTIGRID the multigrid hierarchy is built,
+     * otherwise the ILU(0) factors are computed.
+     *
+     * \param ksolver         the address of the KrylovSolver
+     * \param method          the Krylov method that will be used
+     * \param size            the dimension of the (square) matrix
+     * \param column_pointers the column pointers of the matrix
+     * \param row_indices     the row indices of the matrix
+     * \param values          the coefficients of the matrix
+     *
+     * \return \c TDICE_SUCCESS if the preconditioner has been computed
+     * \return \c TDICE_FAILURE if the memory allocation fails or a zero
+     *                          pivot is found
+     */
+
+    Error_t krylov_solver_factorize
+    (
+        KrylovSolver_t      *ksolver,
+        SolverType_t         method,
+        CellIndex_t          size,
+        CellIndex_t         *column_pointers,
+        CellIndex_t         *row_indices,
+        SystemMatrixCoeff_t *values
+    ) ;
+
+
+
+    /*! Solves the linear system Ax = b for one or more right hand sides
+     *
+     * The solutions overwrite the right hand sides. The method is the
+     * one given to \a krylov_solver_factorize (PCG only for symmetric
+     * matrices). A right hand side equal to zero gives x = 0 without
+     * iterations.
+     *
+     * \param ksolver         the address of the (factorized) KrylovSolver
+     * \param column_pointers the column pointers of the matrix
+     * \param row_indices     the row indices of the matrix
+     * \param values          the coefficients of the matrix
+     * \param b               the right hand sides, column after column
+     * \param nrhs            the number of right hand sides
+     * \param ldb             the distance between two columns of \a b
+     *
+     * \return \c TDICE_SUCCESS if all the systems have been solved
+     * \return \c TDICE_FAILURE if the method breaks down or does not
+     *                          converge within \a MaxIterations
+     */
+
+    Error_t krylov_solver_solve
+    (
+        KrylovSolver_t      *ksolver,
+        CellIndex_t         *column_pointers,
+        CellIndex_t         *row_indices,
+        SystemMatrixCoeff_t *values,
+        double              *b,
+        Quantity_t           nrhs,
+        CellIndex_t          ldb
+    ) ;
+
+/******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _3DICE_KRYLOV_SOLVER_H_ */
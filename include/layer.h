@@ -89,6 +89,17 @@ extern "C"
         /*! The list of the material layout */
 
         MaterialElementList_t MaterialLayout ;
+
+        /*! The material of every cell of the layer, row after row, as
+         *  index in \a LayoutMaterials plus one (\c 0 is \a Material ).
+         *  \c NULL if the map has not been built */
+
+        Quantity_t *MaterialMap ;
+
+        /*! The materials of the elements in \a MaterialLayout, in
+         *  the order of the list */
+
+        Material_t **LayoutMaterials ;
     } ;
 
     /*! Definition of the type Layer_t */
@@ -112,7 +123,8 @@ extern "C"
 
     /*! Copies the structure \a src into \a dst , as an assignement
      *
-     * The function destroys the content of \a dst and then makes the copy
+     * The function destroys the content of \a dst and then makes the copy.
+     * The material map is not copied: it must be built again on \a dst
      *
      * \param dst the address of the left term sructure (destination)
      * \param src the address of the right term structure (source)
@@ -221,6 +233,26 @@ extern "C"
 
 
 
+    /*! Builds the material map of a layer
+     *
+     * The layout is rasterized on the grid of thermal cells: each cell gets
+     * the material of the first element of the layout that contains its
+     * center, or the material of the layer. After this call
+     * \a get_thermal_conductivity and \a get_volumetric_heat_capacity
+     * do not scan the layout anymore. Layers without layout have no map.
+     *
+     * \param layer      the layer structure
+     * \param dimensions pointer to the structure storing the dimensions
+     *                   of the stack
+     *
+     * \return \c TDICE_FAILURE if the memory allocation fails
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t layer_build_material_map (Layer_t *layer, Dimensions_t *dimensions) ;
+
+
+
     /*! Returns the thermal conductivity of a cell in a given location
      *
      * \param layer        the layer structure to query
@@ -0,0 +1,286 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#ifndef _3DICE_MULTIFRONTAL_H_
+#define _3DICE_MULTIFRONTAL_H_
+
+/*! \file multifrontal.h */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************************************/
+
+#include <stddef.h>  // For the type size_t
+#include <stdbool.h> // For the type bool
+
+#include "types.h"
+
+/******************************************************************************/
+
+    /*! \struct MultifrontalSolver_t
+     *
+     *  \brief Direct solver computing the LU factorization of the system
+     *         matrix with the multifrontal method, using several threads
+     *
+     *  The rows and the columns of the matrix are permuted with the same
+     *  fill reducing ordering and the factors have the nonzero pattern of
+     *  the Cholesky factor of the symmetrized matrix. Columns with the same
+     *  pattern (and small subtrees of the elimination tree) are grouped in
+     *  supernodes. The factorization of a supernode is the partial LU of a
+     *  dense frontal matrix that assembles the coefficients of the matrix
+     *  and the update matrices of its children in the assembly tree, so
+     *  that disjoint subtrees are factorized by different threads and the
+     *  update of the large fronts close to the root is split between all
+     *  the threads.
+     *
+     *  If \a Symmetric is set, the matrix must be symmetric positive
+     *  definite and the factorization is the Cholesky factorization
+     *  L L' : only the lower triangle of the matrix is assembled and only
+     *  L is stored, with half the memory and the operations of the LU.
+     *
+     *  If \a SinglePrecision is set, the fronts are still factorized in
+     *  double precision but the factors are stored, and the triangular
+     *  solves read them, in single precision. The solutions are then only
+     *  accurate to single precision and must be refined by the caller.
+     *
+     *  Pivots are taken on the diagonal: the system matrices are
+     *  diagonally dominant except for the convective terms of the liquid
+     *  cells, and SuperLU is also used with a small diagonal pivot
+     *  threshold in 3D-ICE. The factorization fails on a zero pivot.
+     */
+
+    struct MultifrontalSolver_t
+    {
+        /*! The number of threads used by the factorization */
+
+        Quantity_t NThreads ;
+
+        /*! Computes the Cholesky factorization of a symmetric positive
+         *  definite matrix instead of the LU factorization */
+
+        bool Symmetric ;
+
+        /*! Stores the factors in \a SingleFactors instead of \a Factors */
+
+        bool SinglePrecision ;
+
+        /*! The number of rows of the system matrix ( \c 0 before the first
+         *  factorization) */
+
+        CellIndex_t Size ;
+
+        /*! The row (and column) of the matrix eliminated at each step */
+
+        CellIndex_t *Ordering ;
+
+        /*! The number of supernodes */
+
+        Quantity_t NSupernodes ;
+
+        /*! The first (permuted) column of every supernode, followed by
+         *  \a Size ( \a NSupernodes + 1 values) */
+
+        CellIndex_t *SupernodeColumns ;
+
+        /*! The parent of every supernode in the assembly tree
+         *  ( \a NSupernodes for a root). Children come before parents */
+
+        Quantity_t *Parents ;
+
+        /*! The index in \a FrontRows of the first row of every front
+         *  ( \a NSupernodes + 1 values) */
+
+        size_t *FrontPointers ;
+
+        /*! The (permuted) rows of every front: the columns of the
+         *  supernode first, then the rows below it in increasing order */
+
+        CellIndex_t *FrontRows ;
+
+        /*! The position in the front of the parent of every row of
+         *  \a FrontRows below its supernode (same indices as \a FrontRows ) */
+
+        CellIndex_t *ParentPositions ;
+
+        /*! The index in \a Factors of the coefficients of every supernode
+         *  ( \a NSupernodes + 1 values) */
+
+        size_t *FactorPointers ;
+
+        /*! The coefficients of the factors. For a front of \c m rows and
+         *  \c k columns, the \c m x \c k panel (column by column) stores
+         *  \c L below the diagonal (unit diagonal) and \c U above it,
+         *  followed by the \c k x \c m-k block of \c U at the right of the
+         *  supernode, transposed (column by column). With \a Symmetric the
+         *  panel stores only \c L , column \c j from its diagonal ( \c m-j
+         *  values). \c NULL with \a SinglePrecision */
+
+        double *Factors ;
+
+        /*! The coefficients of the factors, as in \a Factors , with
+         *  \a SinglePrecision ( \c NULL otherwise) */
+
+        float *SingleFactors ;
+
+        /*! The index in \a EntryIndices of the coefficients of the matrix
+         *  assembled in every column: \c 2c to \c 2c+1 are those stored in
+         *  the column \c c , \c 2c+1 to \c 2c+2 those stored in the row \c c
+         *  at the right of the supernode ( 2 \a Size + 1 values) */
+
+        size_t *EntryPointers ;
+
+        /*! The position in the front of the row, or column, of every
+         *  coefficient assembled */
+
+        CellIndex_t *EntryIndices ;
+
+        /*! The index in the values of the matrix of every coefficient
+         *  assembled */
+
+        CellIndex_t *EntryValues ;
+
+        /*! Work vector used by the solve */
+
+        double *Work ;
+
+        /*! The number of coefficients of the factors */
+
+        size_t FactorSize ;
+
+        /*! The number of floating point operations of a factorization */
+
+        double Flops ;
+    } ;
+
+    /*! Definition of the type MultifrontalSolver_t */
+
+    typedef struct MultifrontalSolver_t MultifrontalSolver_t ;
+
+
+
+/******************************************************************************/
+
+
+
+    /*! Inits the fields of the \a msolver structure with default values
+     *
+     * \param msolver the address of the structure to initalize
+     */
+
+    void multifrontal_solver_init (MultifrontalSolver_t *msolver) ;
+
+
+
+    /*! Destroys the content of the fields of the structure \a msolver
+     *
+     * The function releases any dynamic memory used by the structure and
+     * resets its state calling \a multifrontal_solver_init . The number
+     * of threads, \a Symmetric and \a SinglePrecision are preserved.
+     *
+     * \param msolver the address of the structure to destroy
+     */
+
+    void multifrontal_solver_destroy (MultifrontalSolver_t *msolver) ;
+
+
+
+    /*! Computes the LU factorization of a matrix
+     *
+     * The matrix is given in Compressed Column Storage and every column
+     * must store its diagonal coefficient. At the first call (or if
+     * \a size changes) the supernodes, the fronts and the memory of the
+     * factors are computed from the pattern of the matrix and from
+     * \a ordering , which is ignored by the following calls: the matrix
+     * can then change its coefficients but not its pattern.
+     *
+     * \param msolver         the address of the MultifrontalSolver
+     * \param size            the dimension of the (square) matrix
+     * \param column_pointers the column pointers of the matrix
+     * \param row_indices     the row indices of the matrix
+     * \param values          the coefficients of the matrix
+     * \param ordering        the fill reducing ordering, as computed by
+     *                        the SuperLU routine \c get_perm_c : the
+     *                        column \c j is eliminated at step
+     *                        \a ordering [j]
+     *
+     * \return \c TDICE_SUCCESS if the factors have been computed
+     * \return \c TDICE_FAILURE if the memory allocation fails or a zero
+     *                          pivot (not positive with \a Symmetric ) is
+     *                          found
+     */
+
+    Error_t multifrontal_solver_factorize
+    (
+        MultifrontalSolver_t *msolver,
+        CellIndex_t           size,
+        CellIndex_t          *column_pointers,
+        CellIndex_t          *row_indices,
+        SystemMatrixCoeff_t  *values,
+        int                  *ordering
+    ) ;
+
+
+
+    /*! Solves the linear system Ax = b for one or more right hand sides
+     *
+     * The solutions overwrite the right hand sides.
+     *
+     * \param msolver the address of the (factorized) MultifrontalSolver
+     * \param b       the right hand sides, column after column
+     * \param nrhs    the number of right hand sides
+     * \param ldb     the distance between two columns of \a b
+     */
+
+    void multifrontal_solver_solve
+    (
+        MultifrontalSolver_t *msolver,
+        double               *b,
+        Quantity_t            nrhs,
+        CellIndex_t           ldb
+    ) ;
+
+/******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _3DICE_MULTIFRONTAL_H_ */
@@ -0,0 +1,268 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#ifndef _3DICE_MULTIGRID_H_
+#define _3DICE_MULTIGRID_H_
+
+/*! \file multigrid.h */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************************************/
+
+#include "types.h"
+
+#include "dimensions.h"
+#include "thermal_grid.h"
+
+/******************************************************************************/
+
+    /*! \struct MultigridLevel_t
+     *
+     *  \brief One level of the multigrid hierarchy
+     *
+     *  The cells of a level are ordered as the thermal cells of the stack:
+     *  layer after layer, row after row, column after column, followed by
+     *  the cells that do not belong to the layers (heat spreader).
+     *  The matrix of the level is stored in Compressed Row Storage.
+     */
+
+    struct MultigridLevel_t
+    {
+        /*! The number of cells of the level */
+
+        CellIndex_t Size ;
+
+        /*! The number of rows of each layer */
+
+        CellIndex_t NRows ;
+
+        /*! The number of columns of each layer */
+
+        CellIndex_t NColumns ;
+
+        /*! Row pointers of the matrix (Size + 1 elements) */
+
+        CellIndex_t *RowPointers ;
+
+        /*! Column indices of the matrix */
+
+        CellIndex_t *ColumnIndices ;
+
+        /*! Coefficients of the matrix */
+
+        SystemMatrixCoeff_t *Values ;
+
+        /*! Index of the diagonal coefficient of each row */
+
+        CellIndex_t *Diagonal ;
+
+        /*! Cell of the next (coarser) level each cell belongs to */
+
+        CellIndex_t *Aggregate ;
+
+        /*! Correction computed on the level (coarse levels only) */
+
+        double *X ;
+
+        /*! Right hand side of the level (coarse levels only) */
+
+        double *B ;
+
+        /*! Residual of the level */
+
+        double *R ;
+    } ;
+
+    /*! Definition of the type MultigridLevel_t */
+
+    typedef struct MultigridLevel_t MultigridLevel_t ;
+
+
+
+    /*! \struct Multigrid_t
+     *
+     *  \brief Geometric multigrid preconditioner for the thermal system
+     *
+     *  Coarse levels merge 2x2 cells (row and column) of the same layer,
+     *  layers are never merged. If the stack has 4RM microchannels, only
+     *  rows are merged (along the coolant flow) so that channel columns
+     *  are never mixed with the walls. The coarse matrices are the Galerkin
+     *  products of the finer ones. The smoother is a block Gauss-Seidel
+     *  that solves together all the cells of a column of the grid (every
+     *  row of every layer), i.e. a plane parallel to the coolant flow.
+     *  The conduction across the thin layers and the advection along the
+     *  channels, the strongest couplings of the grid, are then always
+     *  solved exactly within a block.
+     */
+
+    struct Multigrid_t
+    {
+        /*! The number of layers of the stack */
+
+        CellIndex_t NLayers ;
+
+        /*! The number of rows of the stack */
+
+        CellIndex_t NRows ;
+
+        /*! The number of columns of the stack */
+
+        CellIndex_t NColumns ;
+
+        /*! The number of cells after the layers (heat spreader) */
+
+        CellIndex_t NExtraCells ;
+
+        /*! \c false if columns cannot be merged (4RM channels) */
+
+        bool CoarsenColumns ;
+
+        /*! The number of levels of the hierarchy */
+
+        Quantity_t NLevels ;
+
+        /*! The levels, finest first */
+
+        MultigridLevel_t *Levels ;
+
+        /*! Dense LU factors of the coarsest matrix (NULL if it is too
+         *  big and it is smoothed instead) */
+
+        double *Coarsest ;
+
+        /*! Row permutation of the dense LU factors */
+
+        CellIndex_t *Pivots ;
+
+        /*! Work space for the banded solver of a column plane
+         *  ((2 x NLayers + 2) x NLayers x NRows) */
+
+        double *PlaneWork ;
+    } ;
+
+    /*! Definition of the type Multigrid_t */
+
+    typedef struct Multigrid_t Multigrid_t ;
+
+
+
+/******************************************************************************/
+
+
+
+    /*! Inits the fields of the \a multigrid structure with default values
+     *
+     * \param multigrid the address of the structure to initalize
+     */
+
+    void multigrid_init (Multigrid_t *multigrid) ;
+
+
+
+    /*! Sets the geometry of the grid the multigrid will work on
+     *
+     * \param multigrid    the address of the Multigrid
+     * \param dimensions   the dimensions of the IC
+     * \param thermal_grid the address of the thermal grid
+     */
+
+    void multigrid_set_grid
+
+        (Multigrid_t *multigrid, Dimensions_t *dimensions, ThermalGrid_t *thermal_grid) ;
+
+
+
+    /*! Builds the hierarchy of coarse matrices of a system matrix
+     *
+     * The hierarchy is rebuilt from scratch at every call. The geometry
+     * must have been set with \a multigrid_set_grid .
+     *
+     * \param multigrid       the address of the Multigrid
+     * \param size            the dimension of the (square) matrix
+     * \param column_pointers the column pointers of the matrix
+     * \param row_indices     the row indices of the matrix
+     * \param values          the coefficients of the matrix
+     *
+     * \return \c TDICE_SUCCESS if the hierarchy has been built
+     * \return \c TDICE_FAILURE if the memory allocation fails or the
+     *                          matrix does not match the geometry
+     */
+
+    Error_t multigrid_factorize
+    (
+        Multigrid_t         *multigrid,
+        CellIndex_t          size,
+        CellIndex_t         *column_pointers,
+        CellIndex_t         *row_indices,
+        SystemMatrixCoeff_t *values
+    ) ;
+
+
+
+    /*! Applies one V-cycle to a residual
+     *
+     * \param multigrid the address of the (factorized) Multigrid
+     * \param r         the residual
+     * \param z         the approximated solution of Az = r
+     */
+
+    void multigrid_vcycle (Multigrid_t *multigrid, double *r, double *z) ;
+
+
+
+    /*! Destroys the content of the fields of the structure \a multigrid
+     *
+     * The function releases any dynamic memory used by the structure and
+     * resets its state calling \a multigrid_init .
+     *
+     * \param multigrid the address of the structure to destroy
+     */
+
+    void multigrid_destroy (Multigrid_t *multigrid) ;
+
+/******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _3DICE_MULTIGRID_H_ */
@@ -0,0 +1,95 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#ifndef _3DICE_ORDERING_H_
+#define _3DICE_ORDERING_H_
+
+/*! \file ordering.h */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************************************/
+
+#include "types.h"
+
+#include "dimensions.h"
+#include "thermal_grid.h"
+
+/******************************************************************************/
+
+
+
+    /*! Computes a nested dissection ordering of the thermal cells
+     *
+     * The cells are the nodes of a lattice of layers, rows and columns
+     * (the heat spreader of a pluggable heat sink is one more layer, on
+     * top of the stack) and every cell is connected only to its neighbours
+     * in the lattice. The lattice is split in two halves by a plane of
+     * cells (the separator), cutting the longest side among rows and
+     * columns and, only when rows and columns cannot be split any more,
+     * the layers. The halves are ordered recursively before the separator,
+     * which is eliminated last.
+     *
+     * It is not always better than minimum degree: on the stacks of the
+     * test directory (see test/BenchmarkFactorization) it needs fewer
+     * operations with solid layers and 4-resistor channels, but gives more
+     * fill and more operations with 2-resistor and pin fin channels.
+     *
+     * The result is a column permutation as expected by SuperLU
+     * (with \c ColPerm \c = \c MY_PERMC ): the cell \c i is eliminated at
+     * step \a permutation [i] .
+     *
+     * \param dimensions   the dimensions of the IC
+     * \param thermal_grid the address of the thermal grid
+     * \param permutation  the permutation (one value for every cell)
+     */
+
+    void nested_dissection_ordering
+
+        (Dimensions_t *dimensions, ThermalGrid_t *thermal_grid, int *permutation) ;
+
+/******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _3DICE_ORDERING_H_ */
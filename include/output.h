@@ -117,8 +117,9 @@ extern "C"
 
     /*! Destroys the content of the fields of the structure \a output
      *
-     * The function releases any dynamic memory used by the structure and
-     * resets its state calling \a output_init .
+     * The function releases any dynamic memory used by the structure,
+     * flushes and closes the output files and resets its state calling
+     * \a output_init .
      *
      * \param output the address of the structure to destroy
      */
@@ -159,6 +160,31 @@ extern "C"
 
 
 
+    /*! Returns the thermal cells whose temperature is read by the
+     *  inspection points
+     *
+     * The cells of the inspection points of every instant (final, slot
+     * and step) are collected, each one only once and sorted by offset in
+     * the stack. The array must be released with \a free .
+     *
+     * \param output     the address of the output structure
+     * \param dimensions the address of the dimension structure
+     * \param ncells     the address where the number of cells is stored
+     *
+     * \return the array with the offset in the stack of every cell
+     * \return \c NULL if the memory allocation fails or if an inspection
+     *         point is a Pmap (it reads the source vector)
+     */
+
+    CellIndex_t *get_output_cells
+    (
+        Output_t     *output,
+        Dimensions_t *dimensions,
+        CellIndex_t  *ncells
+    ) ;
+
+
+
     /*! Inserts an inspection point into the corresponding queue
      *
      * \param output   pointer to the output structure
@@ -199,6 +225,10 @@ extern "C"
      * \param current_time the time instant at which the output is printed
      * \param output_instant the instant of the output (slot, step, final)
      *
+     * Outputs are buffered: the files of all the inspection points are
+     * flushed when \a output_instant is \c TDICE_OUTPUT_INSTANT_SLOT or
+     * \c TDICE_OUTPUT_INSTANT_FINAL , i.e. at the end of every time slot.
+     *
      * \return \c TDICE_SUCCESS if the operation terminates with success
      * \return \c TDICE_FAILURE if one of the output cannot be generated
      */
@@ -215,6 +245,18 @@ extern "C"
 
 
 
+    /*! Writes to the files the outputs buffered for every inspection point
+     *
+     * \param output pointer to the output structure
+     *
+     * \return \c TDICE_SUCCESS if the operation terminates with success
+     * \return \c TDICE_FAILURE if one of the files cannot be written
+     */
+
+    Error_t output_flush (Output_t *output) ;
+
+
+
     /*! Fills a network message with thermal outputs for a specific
      *  set of inspection points
      *
@@ -59,6 +59,14 @@ extern "C"
 #include "powers_queue.h"
 #include "dimensions.h"
 
+/******************************************************************************/
+
+    /*! The number of slots after which the source vector is filled again
+     *  from scratch instead of being updated with the power deltas of the
+     *  floorplan elements (this bounds the accumulated round-off) */
+
+#define TDICE_SOURCES_FULL_UPDATE_PERIOD 1024u
+
 /******************************************************************************/
 
     /*! \struct PowerGrid_t
@@ -127,6 +135,19 @@ extern "C"
          */
 
         Capacity_t *CellsCapacities ;
+
+        /*! The source vector when all the floorplan elements dissipate no
+         *  power (heat from the heat sinks and from the coolant inlets).
+         *  It is the base vector of a full update of \a Sources .
+         */
+
+        Source_t *ConstantSources ;
+
+        /*! The number of incremental updates of \a Sources left before
+         *  the next full update. \c 0 forces a full update.
+         */
+
+        Quantity_t IncrementalUpdates ;
     } ;
 
     /*! Definition of the type PowerGrid_t */
@@ -192,6 +213,12 @@ extern "C"
 
 
     /*! Update the source vector
+     *
+     * Every \c TDICE_SOURCES_FULL_UPDATE_PERIOD slots (and at the first
+     * call) \a ConstantSources is computed again and the sources are set
+     * to it plus the power of every floorplan element. Otherwise only the
+     * floorplan elements whose power changed since the previous slot
+     * update the sources, adding the difference.
      *
      * \param pgrid address of the PowerGrid structure storing the sources
      * \param dimensions the dimensions of the IC
@@ -199,14 +226,73 @@ extern "C"
      *  \return \c TDICE_SUCCESS if the source vector has been updated
      *  \return \c TDICE_FAILURE if it not possible to fill the source vector
      *                           (at least one floorplan element with no power
-     *                            values in its queue)
+     *                            values in its queue, or a power trace that
+     *                            failed, see \a power_values_failed )
      */
 
     Error_t update_source_vector (PowerGrid_t *pgrid, Dimensions_t *dimensions) ;
 
 
 
+    /*! Fills a source vector without the power of the floorplan elements
+     *
+     * \a sources stores then only the heat coming from the heat sinks and
+     * from the coolant inlets, i.e. the source vector of the stack when
+     * all the floorplan elements dissipate no power. The power queues of
+     * the floorplan elements are not consumed.
+     *
+     * \param pgrid      address of the PowerGrid structure
+     * \param dimensions the dimensions of the IC
+     * \param sources    the array to fill (one value for each thermal cell)
+     */
+
+    void fill_constant_source_vector
+    (
+        PowerGrid_t  *pgrid,
+        Dimensions_t *dimensions,
+        Source_t     *sources
+    ) ;
+
+
+
+    /*! Returns the number of floorplan elements in the stack
+     *
+     * \param pgrid address of the PowerGrid structure
+     *
+     * \return the number of power values needed by \a insert_power_values
+     */
+
+    Quantity_t get_number_of_floorplan_elements_power_grid (PowerGrid_t *pgrid) ;
+
+
+
+    /*! Adds to a source vector the sources of 1 W dissipated by a
+     *  floorplan element
+     *
+     * \param pgrid      address of the PowerGrid structure
+     * \param dimensions the dimensions of the IC
+     * \param element    the index of the floorplan element, counted as in
+     *                   \a insert_power_values (0 first). The cells of a
+     *                   power map count as floorplan elements.
+     * \param sources    the source vector (one value for each thermal cell)
+     *
+     * \return \c TDICE_FAILURE if \a element is out of range
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t add_floorplan_element_sources
+    (
+        PowerGrid_t  *pgrid,
+        Dimensions_t *dimensions,
+        Quantity_t    element,
+        Source_t     *sources
+    ) ;
+
+
+
     /*! Update channel sources
+     *
+     * The next call to \a update_source_vector is a full update.
      *
      * \param pgrid address of the PowerGrid structure storing the sources
      * \param dimensions the dimensions of the IC
@@ -217,6 +303,21 @@ extern "C"
 
 
 
+    /*! Tells if a power trace of the stack has a slot that is not valid
+     *
+     * It distinguishes a failure of \a update_source_vector from the
+     * end of the power values.
+     *
+     * \param pgrid address of the PowerGrid structure
+     *
+     * \return \c true if the power trace of a floorplan failed
+     * \return \c false otherwise
+     */
+
+    bool power_values_failed (PowerGrid_t *pgrid) ;
+
+
+
     /*! Inserts one power values from a power queue into each
      *  floorplan element in the entire stack
      *
@@ -234,7 +335,8 @@ extern "C"
      *  \param pvalues pointer to the list of power values
      *
      *  \return \c TDICE_FAILURE if the queue \a pvalues does not
-     *                           contain enough power values
+     *                           contain enough power values or if a
+     *                           floorplan reads a power trace file
      *  \return \c TDICE_SUCCESS otherwise
      */
 
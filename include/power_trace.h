@@ -0,0 +1,351 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#ifndef _3DICE_POWER_TRACE_H_
+#define _3DICE_POWER_TRACE_H_
+
+/*! \file power_trace.h */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************************************/
+
+#include <stdio.h>  // For the file type FILE
+#include <stdbool.h> // For the type bool
+#include <stddef.h> // For the type size_t
+
+#include "types.h"
+#include "string_t.h"
+
+#include "floorplan_element_list.h"
+
+/******************************************************************************/
+
+    /*! The number of slots read ahead from a CSV power trace */
+
+#define TDICE_POWER_TRACE_BUFFER_SLOTS 64u
+
+    /*! The magic string at the beginning of a binary power trace */
+
+#define TDICE_POWER_TRACE_MAGIC "3DICE-PT"
+
+    /*! The version of the layout of a binary power trace */
+
+#define TDICE_POWER_TRACE_VERSION 1u
+
+/******************************************************************************/
+
+    /*! \struct PowerTraceHeader_t
+     *
+     *  \brief Header of a binary power trace
+     *
+     *  The header is followed by \a NSlots rows of \a NColumns doubles
+     *  (native byte order), one row per time slot and one column per
+     *  floorplan element, in the same order as they appear in the
+     *  floorplan file.
+     */
+
+    struct PowerTraceHeader_t
+    {
+        /*! Must be equal to \c TDICE_POWER_TRACE_MAGIC */
+
+        char Magic [8] ;
+
+        /*! Must be equal to \c TDICE_POWER_TRACE_VERSION */
+
+        uint32_t Version ;
+
+        /*! The number of power values in every slot */
+
+        uint32_t NColumns ;
+
+        /*! The number of slots stored in the file */
+
+        uint64_t NSlots ;
+    } ;
+
+    /*! Definition of the type PowerTraceHeader_t */
+
+    typedef struct PowerTraceHeader_t PowerTraceHeader_t ;
+
+
+
+    /*! \struct PowerTrace_t
+     *
+     *  \brief A power trace file consumed one slot at a time
+     *
+     *  Only a bounded window of the trace is kept in memory: a CSV file is
+     *  read ahead \c TDICE_POWER_TRACE_BUFFER_SLOTS slots at a time while a
+     *  binary file is memory mapped and its pages are loaded on demand.
+     */
+
+    struct PowerTrace_t
+    {
+        /*! The name of the trace file */
+
+        String_t FileName ;
+
+        /*! The format of the trace file */
+
+        PowerTraceFormat_t Format ;
+
+        /*! The number of floorplan elements fed by the trace */
+
+        Quantity_t NElements ;
+
+        /*! The number of power values in every slot of the file */
+
+        Quantity_t NColumns ;
+
+        /*! For every floorplan element, the column of the file
+         *  that stores its power values */
+
+        Quantity_t *Columns ;
+
+        /*! The number of slots consumed so far */
+
+        uint64_t NextSlot ;
+
+        /*! The CSV file (\c NULL for binary traces) */
+
+        FILE *File ;
+
+        /*! The line of the CSV file being read */
+
+        Quantity_t Line ;
+
+        /*! The slots read ahead from the CSV file
+         *  ( \c TDICE_POWER_TRACE_BUFFER_SLOTS x \a NColumns ) */
+
+        Power_t *Buffer ;
+
+        /*! The number of slots stored in \a Buffer */
+
+        Quantity_t BufferSlots ;
+
+        /*! The index in \a Buffer of the next slot to consume */
+
+        Quantity_t BufferNext ;
+
+        /*! The memory mapped binary file (\c NULL for CSV traces) */
+
+        void *Map ;
+
+        /*! The size in bytes of \a Map */
+
+        size_t MapSize ;
+
+        /*! The number of slots stored in the binary file */
+
+        uint64_t NSlots ;
+
+        /*! Set when a slot of the CSV file is not valid. The slots read
+         *  before it are still consumed, then \a power_trace_read fails */
+
+        bool Failed ;
+    } ;
+
+    /*! Definition of the type PowerTrace_t */
+
+    typedef struct PowerTrace_t PowerTrace_t ;
+
+
+
+/******************************************************************************/
+
+
+
+    /*! Inits the fields of the \a ptrace structure with default values
+     *
+     * \param ptrace the address of the structure to initalize
+     */
+
+    void power_trace_init (PowerTrace_t *ptrace) ;
+
+
+
+    /*! Copies the structure \a src into \a dst , as an assignement
+     *
+     * The function destroys the content of \a dst and then makes the copy.
+     * The file is opened again and \a dst is positioned on the same slot
+     * as \a src .
+     *
+     * \param dst the address of the left term sructure (destination)
+     * \param src the address of the right term structure (source)
+     */
+
+    void power_trace_copy (PowerTrace_t *dst, PowerTrace_t *src) ;
+
+
+
+    /*! Destroys the content of the fields of the structure \a ptrace
+     *
+     * The function closes (or unmaps) the trace file, releases any
+     * dynamic memory used by the structure and resets its state calling
+     * \a power_trace_init .
+     *
+     * \param ptrace the address of the structure to destroy
+     */
+
+    void power_trace_destroy (PowerTrace_t *ptrace) ;
+
+
+
+    /*! Allocates memory for a structure of type PowerTrace_t
+     *
+     * The content of the new structure is set to default values
+     * calling \a power_trace_init
+     *
+     * \return the pointer to the new structure
+     * \return \c NULL if the memory allocation fails
+     */
+
+    PowerTrace_t *power_trace_calloc (void) ;
+
+
+
+    /*! Allocates memory for a new copy of the structure \a ptrace
+     *
+     * \param ptrace the address of the structure to clone
+     *
+     * \return a pointer to a new structure
+     * \return \c NULL if the memory allocation fails
+     * \return \c NULL if the parameter \a ptrace is \c NULL
+     */
+
+    PowerTrace_t *power_trace_clone (PowerTrace_t *ptrace) ;
+
+
+
+    /*! Frees the memory space pointed by \a ptrace
+     *
+     * The function destroys the structure \a ptrace and then frees
+     * its memory. The pointer \a ptrace must have been returned by
+     * a previous call to \a power_trace_calloc or \a power_trace_clone .
+     *
+     * If \a ptrace is \c NULL, no operation is performed.
+     *
+     * \param ptrace the pointer to free
+     */
+
+    void power_trace_free (PowerTrace_t *ptrace) ;
+
+
+
+    /*! Prints the power trace declaration as it looks in the floorplan file
+     *
+     * \param ptrace the address of the structure to print
+     * \param stream the output stream (must be already open)
+     * \param prefix a string to be printed as prefix at the beginning of each line
+     */
+
+    void power_trace_print (PowerTrace_t *ptrace, FILE *stream, String_t prefix) ;
+
+
+
+    /*! Opens a power trace file and matches its columns to floorplan elements
+     *
+     * Files starting with \c TDICE_POWER_TRACE_MAGIC are binary traces and
+     * their columns follow the order of \a list . Any other file is a CSV
+     * trace: if its first line starts with an identifier, it is a header
+     * naming the floorplan element of every column (extra columns are
+     * ignored), otherwise the columns follow the order of \a list .
+     *
+     * Only the header of the file is read.
+     *
+     * \param ptrace    the address of the power trace to open
+     * \param file_name the path of the trace file
+     * \param list      the floorplan elements fed by the trace
+     *
+     * \return \c TDICE_FAILURE if the file cannot be opened or if its
+     *                          header is not valid
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t power_trace_open
+
+        (PowerTrace_t *ptrace, String_t file_name, FloorplanElementList_t *list) ;
+
+
+
+    /*! Opens a power map, i.e. a power trace with one column per thermal cell
+     *
+     * Every slot of the file (a frame) stores the power of the \a ncells
+     * thermal cells of a layer, row by row as in the thermal grid. The
+     * formats are the same as in \a power_trace_open but the names in
+     * the header of a CSV file are ignored.
+     *
+     * \param ptrace    the address of the power trace to open
+     * \param file_name the path of the power map file
+     * \param ncells    the number of thermal cells in a frame
+     *
+     * \return \c TDICE_FAILURE if the file cannot be opened or if its
+     *                          frames do not have \a ncells values
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t power_trace_open_map
+
+        (PowerTrace_t *ptrace, String_t file_name, CellIndex_t ncells) ;
+
+
+
+    /*! Reads the power values of the next slot of the trace
+     *
+     * \param ptrace the address of the power trace
+     * \param powers (\c OUT) the memory where the \a NElements power values
+     *               are written, in the order of the floorplan elements
+     *
+     * \return \c TDICE_FAILURE if the trace has no more slots or if the
+     *                          slot cannot be read. In the second case
+     *                          \a Failed is set (and stays set)
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t power_trace_read (PowerTrace_t *ptrace, Power_t *powers) ;
+
+/******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _3DICE_POWER_TRACE_H_ */
@@ -0,0 +1,295 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#ifndef _3DICE_REDUCED_MODEL_H_
+#define _3DICE_REDUCED_MODEL_H_
+
+/*! \file reduced_model.h */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************************************/
+
+#include "types.h"
+
+#include "analysis.h"
+#include "dimensions.h"
+#include "output.h"
+#include "thermal_data.h"
+
+/******************************************************************************/
+
+    /*! \struct ReducedModel_t
+     *
+     * \brief Reduced order state space model of the transient simulation,
+     *        from the power of the floorplan elements to the temperatures
+     *        of the thermal cells read by the inspection points
+     *
+     * The full model is \c C dT/dt = - G T + B p + S where \c C are the
+     * cell capacities, \c G the conductance matrix (the steady state system
+     * matrix), \c B the floorplan matrices and \c S the constant ambient and
+     * coolant sources. Writing \c T = T_s + V x , with \c T_s = G^-1 S the
+     * temperatures with all the powers set to zero, the state \c x lives in
+     * the block Krylov subspace spanned by \c G^-1 B , by the distance of
+     * the initial temperatures from \c T_s and by their products with
+     * \c (G^-1 C)^k . Projecting the model on an orthonormal basis \c V of
+     * this space matches the first moments (around \c s = 0 ) of its
+     * transfer function, the steady state included.
+     *
+     * The reduced model is integrated as the full one (same step time and
+     * integration method) and it is stored already discretized:
+     *
+     *     x(n+1) = A x(n) + B p(n)        T = T_s + C x(n)
+     */
+
+    struct ReducedModel_t
+    {
+        /*! The number of floorplan elements in the stack (inputs) */
+
+        Quantity_t NElements ;
+
+        /*! The number of thermal cells observed (outputs) */
+
+        CellIndex_t NCells ;
+
+        /*! The offsets in the stack of the thermal cells observed */
+
+        CellIndex_t *Cells ;
+
+        /*! The number of states of the reduced model */
+
+        Quantity_t Order ;
+
+        /*! The state matrix \c A ( \a Order x \a Order , row by row) */
+
+        double *StateMatrix ;
+
+        /*! The input matrix \c B ( \a Order x \a NElements , row by row,
+         *  in K per W) */
+
+        double *InputMatrix ;
+
+        /*! The output matrix \c C ( \a NCells x \a Order , row by row) */
+
+        double *OutputMatrix ;
+
+        /*! The temperatures \c T_s of the observed cells */
+
+        Temperature_t *Offsets ;
+
+        /*! The state at the beginning of the simulation */
+
+        double *InitialState ;
+
+        /*! The current state */
+
+        double *State ;
+
+        /*! Work array used to compute the next state */
+
+        double *NextState ;
+
+        /*! The largest error on the temperatures of the observed cells with
+         *  all the powers set to zero, measured against the full model (K) */
+
+        Temperature_t OffsetError ;
+
+        /*! The largest error on the observed temperatures due to 1 W in
+         *  every floorplan element, measured against the full model (K/W) */
+
+        Temperature_t ResponseError ;
+
+        /*! The number of slots over which the errors have been measured */
+
+        Quantity_t ErrorSlots ;
+    } ;
+
+    /*! Definition of the type ReducedModel_t */
+
+    typedef struct ReducedModel_t ReducedModel_t ;
+
+
+
+/******************************************************************************/
+
+
+
+    /*! Inits the fields of the \a rmodel structure with default values
+     *
+     * \param rmodel the address of the structure to initalize
+     */
+
+    void reduced_model_init (ReducedModel_t *rmodel) ;
+
+
+
+    /*! Builds the reduced model of \a tdata for the inspection points
+     *  in \a output
+     *
+     * The basis has at most \a nmoments blocks of \a NElements + 1 vectors
+     * (fewer if some of them are linearly dependent). Each block costs a
+     * multiple right hand side solve with the steady state system matrix,
+     * which is built and factorized here, and the basis is kept in memory
+     * until the model has been projected.
+     *
+     * If \a nslots is not zero the reduced model is compared with the full
+     * one simulating, as in ImpulseResponse_t, the zero power response and
+     * the response to 1 W dissipated in every floorplan element during the
+     * first slot, for \a nslots slots. Since both models are linear, the
+     * error at the end of each of these slots on the temperatures of
+     * a power trace with no element dissipating more than \c P watts is
+     * at most \a OffsetError + \a ResponseError * \c P , where
+     * \a ResponseError sums the error of the impulse responses over the
+     * slots and the elements. Errors are not measured within a slot.
+     *
+     * \a tdata and \a analysis are not modified.
+     *
+     * \param rmodel     the address of the ReducedModel to build
+     * \param tdata      the address of the (already built) ThermalData
+     * \param dimensions the dimensions of the IC
+     * \param analysis   the address of the Analysis structure
+     * \param output     the address of the Output structure
+     * \param nmoments   the number of blocks of the Krylov basis
+     * \param nslots     the number of slots used to measure the error
+     *
+     * \return \c TDICE_FAILURE if the analysis is not transient or has an
+     *              adaptive time step, the stack has a pluggable heat
+     *              sink, an inspection point is a Pmap, \a nmoments is
+     *              zero, the memory allocation fails or the solver
+     *              reports an error
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t reduced_model_build
+    (
+        ReducedModel_t *rmodel,
+        ThermalData_t  *tdata,
+        Dimensions_t   *dimensions,
+        Analysis_t     *analysis,
+        Output_t       *output,
+        Quantity_t      nmoments,
+        Quantity_t      nslots
+    ) ;
+
+
+
+    /*! Destroys the content of the fields of the structure \a rmodel
+     *
+     * The function releases any dynamic memory used by the structure and
+     * resets its state calling \a reduced_model_init .
+     *
+     * \param rmodel the address of the structure to destroy
+     */
+
+    void reduced_model_destroy (ReducedModel_t *rmodel) ;
+
+
+
+    /*! Reset the state of the reduced model to the initial temperature
+     *
+     * \param rmodel the address of the ReducedModel to reset
+     */
+
+    void reset_reduced_state (ReducedModel_t *rmodel) ;
+
+
+
+    /*! Simulates a time step with the reduced model
+     *
+     * The step has the length and the integration method of the analysis
+     * used to build \a rmodel . Only the temperatures of the cells observed
+     * by \a rmodel are written in \a temperatures , so that the array can be
+     * given to \a generate_output (as the temperatures of a ThermalData_t)
+     * to print the inspection points used to build \a rmodel .
+     *
+     * \param rmodel       the address of the ReducedModel
+     * \param analysis     the address of the Analysis structure
+     * \param powers       the power of every floorplan element ( \a NElements
+     *                     values, in W) during the step
+     * \param temperatures the temperature array to fill (one value for each
+     *                     thermal cell in the stack)
+     *
+     * \return \c TDICE_WRONG_CONFIG if the parameters refers to a steady
+     *                               state simulation
+     * \return \c TDICE_STEP_DONE    if the time step has been simulated
+     * \return \c TDICE_SLOT_DONE    if the time step has been simulated
+     *                               and the slot has been completed
+     */
+
+    SimResult_t emulate_reduced_step
+    (
+        ReducedModel_t *rmodel,
+        Analysis_t     *analysis,
+        Power_t        *powers,
+        Temperature_t  *temperatures
+    ) ;
+
+
+
+    /*! Simulates a time slot with the reduced model
+     *
+     * \param rmodel       the address of the ReducedModel
+     * \param analysis     the address of the Analysis structure
+     * \param powers       the power of every floorplan element ( \a NElements
+     *                     values, in W) during the slot
+     * \param temperatures the temperature array to fill (one value for each
+     *                     thermal cell in the stack)
+     *
+     * \return \c TDICE_WRONG_CONFIG if the parameters refers to a steady
+     *                               state simulation
+     * \return \c TDICE_SLOT_DONE    the slot has been simulated
+     */
+
+    SimResult_t emulate_reduced_slot
+    (
+        ReducedModel_t *rmodel,
+        Analysis_t     *analysis,
+        Power_t        *powers,
+        Temperature_t  *temperatures
+    ) ;
+
+/******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _3DICE_REDUCED_MODEL_H_ */
@@ -284,6 +284,9 @@ extern "C"
 
 
     /*! Returns the total number of floorplan elements
+     *
+     * If \a stkel is a die with a power map, every thermal cell of its
+     * source layer counts as a floorplan element.
      *
      * \param stkel address of the StackElement structure
      *
@@ -54,6 +54,9 @@ extern "C"
 #include "dimensions.h"
 #include "thermal_grid.h"
 #include "analysis.h"
+#include "krylov_solver.h"
+#include "multifrontal.h"
+#include "ordering.h"
 
 #include "slu_ddefs.h"
 
@@ -134,6 +137,60 @@ extern "C"
         /*! SuperLU elimination tree */
 
         int* SLU_Etree ;
+
+        /*! \c true if \a SLUMatrix_L and \a SLUMatrix_U have been read
+         *  from a factorization cache file and not computed by SuperLU */
+
+        bool FactorsFromCache ;
+
+        /*! The linear solver used to factorize the matrix and to solve
+         *  the linear systems (SuperLU by default) */
+
+        SolverType_t SolverType ;
+
+        /*! The iterative solver, used if \a SolverType is
+         *  \c TDICE_SOLVER_BICGSTAB , \c TDICE_SOLVER_PCG or
+         *  \c TDICE_SOLVER_MULTIGRID */
+
+        KrylovSolver_t Krylov ;
+
+        /*! The multifrontal solver, used if \a SolverType is
+         *  \c TDICE_SOLVER_MULTIFRONTAL , or if it is
+         *  \c TDICE_SOLVER_SUPERLU and the matrix is symmetric positive
+         *  definite or the factors are stored in single precision. The
+         *  fill reducing ordering is the column permutation computed for
+         *  SuperLU */
+
+        MultifrontalSolver_t Multifrontal ;
+
+        /*! \c true if \a fill_system_matrix found the matrix symmetric, with
+         *  a positive and dominant diagonal (i.e. the stack has no liquid
+         *  cells). Only its lower triangle is then factorized, as A = L L' */
+
+        bool SymmetricPositiveDefinite ;
+
+        /*! The infinity norm of the matrix, computed by \a do_factorization
+         *  if the multifrontal factors are in single precision. It is used
+         *  to stop the iterative refinement of the solutions */
+
+        double ANorm ;
+
+        /*! The residuals of the iterative refinement, \a RefinementColumns
+         *  columns of \a Size elements */
+
+        double *RefinementResiduals ;
+
+        /*! A copy of the right hand sides of the iterative refinement,
+         *  \a RefinementColumns columns of \a Size elements */
+
+        double *RefinementRhs ;
+
+        /*! The number of columns of \a RefinementResiduals and
+         *  \a RefinementRhs . They are allocated, for one column, by
+         *  \a do_factorization and enlarged if more right hand sides are
+         *  solved together */
+
+        Quantity_t RefinementColumns ;
     } ;
 
     /*! Definition of the type SystemMatrix_t */
@@ -186,7 +243,11 @@ extern "C"
     /*! Fills the system matrix
      *
      *  The function fills, layer by layer, all the columns
-     *  of the system matrix.
+     *  of the system matrix. If \a analysis asks for more than one
+     *  thread, the number of coefficients of every column is counted
+     *  first and then the threads fill disjoint ranges of columns.
+     *  Finally, \a SymmetricPositiveDefinite is set if the matrix can be
+     *  factorized with the Cholesky decomposition.
      *
      *  \param sysmatrix         pointer to the system matrix to fill
      *  \param thermal_grid pointer to the thermal grid structure
@@ -206,7 +267,95 @@ extern "C"
 
 
 
+    /*! Re-fills the columns of the system matrix that depend on the coolant
+     *
+     *  Only the columns of the liquid cells (channel columns in 4RM layers
+     *  and every cell in 2RM channel and pin fin layers) are rewritten.
+     *  Their position in the CCS arrays is taken from the column pointers
+     *  set by \a fill_system_matrix , so the sparsity pattern must not
+     *  have changed since the matrix has been filled.
+     *
+     *  \param sysmatrix    pointer to the (already filled) system matrix
+     *  \param thermal_grid pointer to the thermal grid structure
+     *  \param analysis     pointer to the structure containing info
+     *                      about the type of thermal analysis
+     *  \param dimensions   pointer to the structure containing the
+     *                      dimensions of the IC
+     */
+
+    void update_system_matrix_channel
+    (
+        SystemMatrix_t *sysmatrix,
+        ThermalGrid_t  *thermal_grid,
+        Analysis_t     *analysis,
+        Dimensions_t   *dimensions
+    ) ;
+
+
+
+    /*! Re-fills the columns of the system matrix of the heat spreader
+     *
+     *  Only the columns of the spreader cells of a pluggable top heat sink
+     *  are rewritten, i.e. the only ones that depend on the spreader to
+     *  sink conductances. The function does nothing if the stack has no
+     *  pluggable heat sink.
+     *
+     *  \param sysmatrix    pointer to the (already filled) system matrix
+     *  \param thermal_grid pointer to the thermal grid structure
+     *  \param analysis     pointer to the structure containing info
+     *                      about the type of thermal analysis
+     *  \param dimensions   pointer to the structure containing the
+     *                      dimensions of the IC
+     */
+
+    void update_system_matrix_spreader
+    (
+        SystemMatrix_t *sysmatrix,
+        ThermalGrid_t  *thermal_grid,
+        Analysis_t     *analysis,
+        Dimensions_t   *dimensions
+    ) ;
+
+
+
+    /*! Sets the fill reducing ordering of the next factorization
+     *
+     * With \c TDICE_ORDERING_NESTED_DISSECTION the column permutation is
+     * computed from the geometry of the grid and given to SuperLU as a
+     * user permutation ( \c MY_PERMC ). Otherwise, it is computed by
+     * SuperLU with minimum degree on A'+A during the factorization.
+     * The multifrontal solver uses the same permutation.
+     *
+     * \param sysmatrix    pointer to the (system) matrix \a A
+     * \param ordering     the ordering
+     * \param dimensions   the dimensions of the IC
+     * \param thermal_grid the address of the thermal grid
+     */
+
+    void set_column_ordering
+    (
+        SystemMatrix_t *sysmatrix,
+        OrderingType_t  ordering,
+        Dimensions_t   *dimensions,
+        ThermalGrid_t  *thermal_grid
+    ) ;
+
+
+
     /*! Perform the A=LU decomposition on the system matrix
+     *
+     * With an iterative \a SolverType the (incomplete) decomposition is
+     * the ILU(0) preconditioner of the Krylov solver, or its multigrid
+     * hierarchy. With \c TDICE_SOLVER_MULTIFRONTAL the factors are
+     * computed by the multifrontal solver, with \a Multifrontal.NThreads
+     * threads. If the matrix is \a SymmetricPositiveDefinite the
+     * multifrontal solver computes, also in place of SuperLU, its Cholesky
+     * decomposition A = L L' . If a pivot turns out not to be positive
+     * the flag is cleared and the matrix is factorized again as A = LU .
+     * If \a Multifrontal.SinglePrecision is set, the multifrontal solver
+     * computes the factors (in place of SuperLU) in single precision, and
+     * the infinity norm of \a A and the buffers used to refine the
+     * solutions are prepared as well.
      *
      * \param sysmatrix pointer to the (system) matrix \a A to factorize
      *
@@ -218,7 +367,54 @@ extern "C"
 
 
 
+    /*! Reads the A=LU decomposition of the system matrix from a cache file
+     *
+     * The cache file is searched in \a directory and its name is a hash of
+     * the content of the (already filled) system matrix, i.e. of its column
+     * pointers, row indices and values, and of the SuperLU options used
+     * to factorize it. If the file is found, the L and U factors, the
+     * row and column permutations and the elimination tree are loaded and
+     * the matrix is ready to be used by \a solve_sparse_linear_system
+     * without calling \a do_factorization .
+     *
+     * \param sysmatrix pointer to the (system) matrix \a A
+     * \param directory the directory storing the cache files
+     *
+     * \return \c TDICE_SUCCESS if the factors have been loaded
+     * \return \c TDICE_FAILURE if the file does not exist or it is not valid
+     */
+
+    Error_t system_matrix_load_factors (SystemMatrix_t *sysmatrix, String_t directory) ;
+
+
+
+    /*! Writes the A=LU decomposition of the system matrix to a cache file
+     *
+     * The file is created in \a directory and can be read back with
+     * \a system_matrix_load_factors as long as the system matrix has the
+     * same content.
+     *
+     * \param sysmatrix pointer to the (already factorized) matrix \a A
+     * \param directory the directory storing the cache files
+     *
+     * \return \c TDICE_SUCCESS if the file has been written
+     * \return \c TDICE_FAILURE if some error occured
+     */
+
+    Error_t system_matrix_store_factors (SystemMatrix_t *sysmatrix, String_t directory) ;
+
+
+
     /*! Solve the linear system b = A/b
+     *
+     * \a b can have more than one column. With an iterative \a SolverType
+     * the previous solutions are the initial guess of the new ones.
+     *
+     * With factors in single precision the solutions are refined, using
+     * the residuals computed in double precision, up to the accuracy of
+     * a factorization in double precision. If the refinement does not
+     * converge, the matrix is factorized again in double precision (also
+     * for the next solves).
      *
      * \param sysmatrix pointer to the (system) matrix \a A
      * \param b    pointer to the input vector \a b
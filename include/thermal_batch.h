@@ -0,0 +1,266 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#ifndef _3DICE_THERMAL_BATCH_H_
+#define _3DICE_THERMAL_BATCH_H_
+
+/*! \file thermal_batch.h */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/******************************************************************************/
+
+#include "types.h"
+
+#include "analysis.h"
+#include "dimensions.h"
+#include "powers_queue.h"
+#include "thermal_data.h"
+
+#include "slu_ddefs.h"
+
+/******************************************************************************/
+
+    /*! \struct ThermalBatch_t
+     *
+     * \brief Structure to run several transient simulations of the same
+     *        stack together, each one with its own power trace (scenario)
+     *
+     * All the scenarios share the thermal grid, the power grid and the
+     * factorized system matrix of a ThermalData_t. The temperatures of the
+     * scenarios are the columns of a single dense right hand side matrix,
+     * so that every time step needs only one call to the SuperLU triangular
+     * solver for all of them.
+     */
+
+    struct ThermalBatch_t
+    {
+        /*! The number of scenarios simulated together */
+
+        Quantity_t NScenarios ;
+
+        /*! The number of cells in the 3D grid (rows of each column) */
+
+        CellIndex_t Size ;
+
+        /*! Array containing the temperature of each thermal cell, scenario
+         *  after scenario (the first \a Size values belong to scenario 0)
+         */
+
+        Temperature_t *Temperatures ;
+
+        /*! Array containing the source vector of each scenario, stored
+         *  as \a Temperatures */
+
+        Source_t *Sources ;
+
+        /*! Temperatures of every scenario at the beginning of the current
+         *  step, stored as \a Temperatures (used only with the trapezoidal
+         *  integration method) */
+
+        Temperature_t *StepTemperatures ;
+
+        /*! SuperLU matrix B (wrapper around the Temperatures array) */
+
+        SuperMatrix SLUMatrix_B ;
+    } ;
+
+    /*! Definition of the type ThermalBatch_t */
+
+    typedef struct ThermalBatch_t ThermalBatch_t ;
+
+
+
+/******************************************************************************/
+
+
+
+    /*! Inits the fields of the \a batch structure with default values
+     *
+     * \param batch the address of the structure to initalize
+     */
+
+    void thermal_batch_init (ThermalBatch_t *batch) ;
+
+
+
+    /*! Allocs memory for \a nscenarios scenarios and sets their temperatures
+     *
+     * Every scenario starts from the initial temperature set in \a analysis
+     * and with the source vector currently stored in the power grid of
+     * \a tdata (i.e. only the heat coming from the coolant inlets).
+     *
+     * \param batch      the address of the ThermalBatch to build
+     * \param tdata      the address of the (already built) ThermalData
+     * \param nscenarios the number of scenarios
+     * \param analysis   the address of the Analysis structure
+     *
+     * \return \c TDICE_FAILURE if the memory allocation fails, the stack
+     *              has a pluggable heat sink (its state is not replicated
+     *              for each scenario) or the analysis has an adaptive
+     *              time step
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t thermal_batch_build
+    (
+        ThermalBatch_t *batch,
+        ThermalData_t  *tdata,
+        Quantity_t      nscenarios,
+        Analysis_t     *analysis
+    ) ;
+
+
+
+    /*! Destroys the content of the fields of the structure \a batch
+     *
+     * The function releases any dynamic memory used by the structure and
+     * resets its state calling \a thermal_batch_init .
+     *
+     * \param batch the address of the structure to destroy
+     */
+
+    void thermal_batch_destroy (ThermalBatch_t *batch) ;
+
+
+
+    /*! Reset the thermal state of every scenario to the initial temperature
+     *
+     * \param batch    the address of the ThermalBatch structure to reset
+     * \param analysis the address of the Analysis structure
+     */
+
+    void reset_batch_thermal_state (ThermalBatch_t *batch, Analysis_t *analysis) ;
+
+
+
+    /*! Sets the power values of a scenario for the next time slot
+     *
+     * The values are inserted in the floorplans of the stack as the server
+     * does with the values sent by a client (one power for each floorplan
+     * element, source layers bottom first) and the resulting source vector
+     * is copied in the column of the scenario. The floorplans of the stack
+     * must then not contain power values of their own.
+     *
+     * \param batch      the address of the ThermalBatch
+     * \param tdata      the address of the ThermalData shared by the batch
+     * \param dimensions the dimensions of the IC
+     * \param scenario   the index of the scenario (0 first)
+     * \param pvalues    the power values of the scenario
+     *
+     * \return \c TDICE_FAILURE if \a scenario is out of range or the power
+     *              values do not match the floorplans of the stack
+     * \return \c TDICE_SUCCESS otherwise
+     */
+
+    Error_t update_batch_sources
+    (
+        ThermalBatch_t *batch,
+        ThermalData_t  *tdata,
+        Dimensions_t   *dimensions,
+        Quantity_t      scenario,
+        PowersQueue_t  *pvalues
+    ) ;
+
+
+
+    /*! Returns the temperatures of a scenario
+     *
+     * The array has \a Size elements and can be given to the output
+     * functions as the temperatures of a ThermalData_t
+     *
+     * \param batch    the address of the ThermalBatch
+     * \param scenario the index of the scenario (0 first)
+     *
+     * \return the address of the first temperature of \a scenario
+     */
+
+    Temperature_t *get_batch_temperatures (ThermalBatch_t *batch, Quantity_t scenario) ;
+
+
+
+    /*! Returns the source vector of a scenario
+     *
+     * \param batch    the address of the ThermalBatch
+     * \param scenario the index of the scenario (0 first)
+     *
+     * \return the address of the first source of \a scenario
+     */
+
+    Source_t *get_batch_sources (ThermalBatch_t *batch, Quantity_t scenario) ;
+
+
+
+    /*! Simulates a time step for all the scenarios
+     *
+     * The right hand sides of all the scenarios are filled and then solved
+     * together with the LU factors of the system matrix of \a tdata .
+     * New power values must be given with \a update_batch_sources when a
+     * slot has been completed, otherwise the previous ones are used again.
+     *
+     * \param batch      the address of the ThermalBatch
+     * \param tdata      the address of the ThermalData shared by the batch
+     * \param analysis   the address of the Analysis structure
+     *
+     * \return \c TDICE_WRONG_CONFIG if the parameters refers to a steady
+     *                               state simulation
+     * \return \c TDICE_SOLVER_ERROR if the SLU functions report an error in
+     *                               the structure of the system matrix.
+     * \return \c TDICE_STEP_DONE    if the time step has been simulated
+     *                               correclty
+     * \return \c TDICE_SLOT_DONE    if the time step has been simulated
+     *                               correclty and the slot has been completed
+     */
+
+    SimResult_t emulate_batch_step
+    (
+        ThermalBatch_t *batch,
+        ThermalData_t  *tdata,
+        Analysis_t     *analysis
+    ) ;
+
+/******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _3DICE_THERMAL_BATCH_H_ */
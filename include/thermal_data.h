@@ -60,6 +60,29 @@ extern "C"
 
 #include "slu_ddefs.h"
 
+/******************************************************************************/
+
+    /*! The number of factorized system matrices kept in memory for the
+     *  time steps longer than \a StepTime (adaptive time stepping) */
+
+#   define TDICE_STEP_CACHE_SIZE 4
+
+    /*! The relaxation factor of the sink temperatures computed by a
+     *  pluggable heatsink during a steady state simulation */
+
+#   define TDICE_STEADY_SINK_RELAXATION 0.5
+
+    /*! The largest distance (in Kelvin) of the sink temperatures computed by
+     *  a pluggable heatsink from the steady state, as estimated from the
+     *  rate of convergence of the iterations */
+
+#   define TDICE_STEADY_SINK_TOLERANCE 1e-3
+
+    /*! The maximum number of calls to a pluggable heatsink during a steady
+     *  state simulation */
+
+#   define TDICE_STEADY_SINK_MAX_ITERATIONS 1000
+
 /******************************************************************************/
 
     /*! \struct ThermalData_t
@@ -98,6 +121,45 @@ extern "C"
         /*! SuperLU vector B (wrapper around the Temperatures array) */
 
         SuperMatrix SLUMatrix_B ;
+
+        /*! Temperatures at the beginning of the current step (used only
+         *  with an adaptive time step) */
+
+        Temperature_t *StepTemperatures ;
+
+        /*! Temperatures at the beginning of the previous step (used only
+         *  with an adaptive time step) */
+
+        Temperature_t *PreviousTemperatures ;
+
+        /*! Length, in number of \a StepTime , of the previous step.
+         *  \c 0 if there is no previous step in the current slot */
+
+        Quantity_t PreviousStepLength ;
+
+        /*! Length, in number of \a StepTime , of the next step */
+
+        Quantity_t NextStepLength ;
+
+        /*! The system matrices for steps longer than \a StepTime , i.e.
+         *  \a SM_A with different capacity terms on the diagonal */
+
+        SystemMatrix_t StepMatrices [TDICE_STEP_CACHE_SIZE] ;
+
+        /*! Length, in number of \a StepTime , of the step of every matrix
+         *  in \a StepMatrices ( \c 0 if the entry is not used) */
+
+        Quantity_t StepMatricesLength [TDICE_STEP_CACHE_SIZE] ;
+
+        /*! Number of the step in which every matrix in \a StepMatrices
+         *  has been used for the last time */
+
+        Quantity_t StepMatricesLastUse [TDICE_STEP_CACHE_SIZE] ;
+
+        /*! Number of steps simulated (used to replace the least recently
+         *  used entry of \a StepMatrices ) */
+
+        Quantity_t StepCounter ;
     } ;
 
 
@@ -165,6 +227,18 @@ extern "C"
 
 
     /*! Simulates a time step
+     *
+     * The step is integrated with the method set in \a analysis , i.e.
+     * backward Euler or the trapezoidal rule.
+     *
+     * If \a analysis has a positive \a StepTolerance the step lasts a power
+     * of two multiple of \a StepTime . Its length is doubled (up to the end of
+     * the slot) while the local truncation error, estimated comparing the
+     * temperature changes in the current and in the previous step, stays
+     * well below the tolerance and it is halved (down to \a StepTime ) if
+     * the error exceeds the tolerance, in which case the step is repeated.
+     * Every slot starts with a step of length \a StepTime and it ends
+     * exactly on the slot boundary.
      *
      * \param tdata           the address of the ThermalData to fill
      * \param dimensions     the dimensions of the IC
@@ -175,6 +249,8 @@ extern "C"
      * \return \c TDICE_SOLVER_ERROR if the SLU functions report an error in
      *                               the structure of the system matrix.
      * \return \c TDICE_END_OF_SIMULATION if power values are over.
+     * \return \c TDICE_POWER_ERROR if a power trace has a slot that
+     *                              is not valid
      * \return \c TDICE_STEP_DONE    if the time step has been simulated
      *                               correclty
      * \return \c TDICE_SLOT_DONE    if the time step has been simulated
@@ -201,6 +277,8 @@ extern "C"
      * \return \c TDICE_SOLVER_ERROR if the SLU functions report an error in
      *                               the structure of the system matrix.
      * \return \c TDICE_END_OF_SIMULATION if power values are over.
+     * \return \c TDICE_POWER_ERROR if a power trace has a slot that
+     *                              is not valid
      * \return \c TDICE_SLOT_DONE    the slot has been simulated correclty
      */
 
@@ -214,6 +292,13 @@ extern "C"
 
 
     /*! Execute steady state simulation
+     *
+     * With a pluggable heatsink the temperatures of the stack and of the
+     * sink are computed alternately until the distance of the sink
+     * temperatures from the fixed point, estimated from their changes and
+     * from the rate at which the changes decrease, is less than
+     * \c TDICE_STEADY_SINK_TOLERANCE . The system matrix is factorized
+     * again only when the plugin changes the conductances.
      *
      * \param tdata           the address of the ThermalData to fill
      * \param dimensions     the dimensions of the IC
@@ -222,7 +307,11 @@ extern "C"
      * \return \c TDICE_WRONG_CONFIG if the parameters refers to a transient
      *                               simulation
      * \return \c TDICE_SOLVER_ERROR if the SLU functions report an error in
-     *                               the structure of the system matrix.
+     *                               the structure of the system matrix, or
+     *                               if the pluggable heatsink fails or does
+     *                               not converge.
+     * \return \c TDICE_POWER_ERROR if a power trace has a slot that
+     *                              is not valid
      * \return \c TDICE_END_OF_SIMULATION if no power values are given or if
      *                                    the simulation suceeded
      */
@@ -238,8 +327,10 @@ extern "C"
 
     /*! Update the flow rate
      *
-     * Sets the new value in the Channel structure, re-fill the system
-     * matrix A and then execute the factorization A=LU again. If tdata
+     * Sets the new value in the Channel structure, re-fill the columns of
+     * the system matrix A that belong to the liquid cells and then execute
+     * the factorization A=LU again (reusing the sparsity pattern and the
+     * permutations of the previous factorization). If tdata
      * succeeds then the source vector will be upadted with the new inlet
      * source value.
      *
@@ -90,6 +90,35 @@ extern "C"
         /*! Pointer to the secondary path heat sink structure */
 
         HeatSink_t *BottomHeatSink ;
+
+        /*! The capacity of every cell of the layers, in the same order of
+         *  the cells in the stack (set by \a thermal_grid_fill ) */
+
+        Capacity_t *Capacities ;
+
+        /*! The top conductance of every cell of the layers */
+
+        Conductance_t *ConductancesTop ;
+
+        /*! The bottom conductance of every cell of the layers */
+
+        Conductance_t *ConductancesBottom ;
+
+        /*! The north conductance of every cell of the layers */
+
+        Conductance_t *ConductancesNorth ;
+
+        /*! The south conductance of every cell of the layers */
+
+        Conductance_t *ConductancesSouth ;
+
+        /*! The east conductance of every cell of the layers */
+
+        Conductance_t *ConductancesEast ;
+
+        /*! The west conductance of every cell of the layers */
+
+        Conductance_t *ConductancesWest ;
     } ;
 
     /*! Definition of the type ThermalGrid_t */
@@ -137,13 +166,22 @@ extern "C"
 
 
     /*! Fills a thermal grid
+     *
+     *  Once the layers are known, the capacity and the conductances of
+     *  every cell are computed and stored in the thermal grid, so that the
+     *  get_capacity and get_conductance_* functions only read them.
      *
      *  \param tgrid pointer to the thermal grid
      *  \param list pointer to the list of stack elements
+     *  \param dimensions pointer to the structure storing the dimensions
+     *  \return \c TDICE_FAILURE if the memory allocation fails or the
+     *                           heat sinks are not supported
      *  \return \c TDICE_SUCCESS otherwise
      */
 
-    Error_t thermal_grid_fill (ThermalGrid_t *tgrid, StackElementList_t *list) ;
+    Error_t thermal_grid_fill
+
+        (ThermalGrid_t *tgrid, StackElementList_t *list, Dimensions_t *dimensions) ;
 
 
 
@@ -435,7 +435,11 @@ extern "C"
 
         /*! The time slot has been simulated correctly */
 
-        TDICE_SLOT_DONE
+        TDICE_SLOT_DONE,
+
+        /*! The power values cannot be read (a power trace is not valid) */
+
+        TDICE_POWER_ERROR
     } ;
 
 
@@ -467,6 +471,89 @@ extern "C"
 
 
 
+    /*! \enum SolverType_t
+     *
+     *  Enumeration to collect the linear solvers that can be used to
+     *  compute the temperatures.
+     */
+
+    enum SolverType_t
+    {
+        TDICE_SOLVER_SUPERLU = 0, //!< Direct LU factorization (SuperLU)
+        TDICE_SOLVER_BICGSTAB,    //!< BiCGSTAB preconditioned with ILU(0)
+        TDICE_SOLVER_PCG,         //!< Conjugate gradient preconditioned with ILU(0)
+        TDICE_SOLVER_MULTIGRID,   //!< BiCGSTAB preconditioned with a multigrid V-cycle
+        TDICE_SOLVER_MULTIFRONTAL //!< Direct (multithreaded) multifrontal LU factorization
+    } ;
+
+
+
+    /*! the definition of the type SolverType_t */
+
+    typedef enum SolverType_t SolverType_t ;
+
+
+
+    /*! \enum OrderingType_t
+     *
+     *  Enumeration to collect the fill reducing orderings of the rows and
+     *  columns of the system matrix used by the direct solvers.
+     */
+
+    enum OrderingType_t
+    {
+        TDICE_ORDERING_MINIMUM_DEGREE = 0, //!< Minimum degree on A'+A (SuperLU)
+        TDICE_ORDERING_NESTED_DISSECTION   //!< Geometric nested dissection of the grid
+    } ;
+
+
+
+    /*! the definition of the type OrderingType_t */
+
+    typedef enum OrderingType_t OrderingType_t ;
+
+
+
+    /*! \enum PowerTraceFormat_t
+     *
+     *  Enumeration to collect the file formats of the power traces that
+     *  can be streamed into a floorplan.
+     */
+
+    enum PowerTraceFormat_t
+    {
+        TDICE_POWER_TRACE_CSV = 0, //!< Text, one line of comma separated values per slot
+        TDICE_POWER_TRACE_BINARY   //!< Memory mapped matrix of doubles (slots x elements)
+    } ;
+
+
+
+    /*! the definition of the type PowerTraceFormat_t */
+
+    typedef enum PowerTraceFormat_t PowerTraceFormat_t ;
+
+
+
+    /*! \enum IntegrationMethod_t
+     *
+     *  Enumeration to collect the methods that can be used to integrate
+     *  the temperatures over a time step in a transient analysis.
+     */
+
+    enum IntegrationMethod_t
+    {
+        TDICE_INTEGRATION_EULER = 0,   //!< Backward Euler (first order)
+        TDICE_INTEGRATION_TRAPEZOIDAL  //!< Trapezoidal rule, or Crank-Nicolson (second order)
+    } ;
+
+
+
+    /*! the definition of the type IntegrationMethod_t */
+
+    typedef enum IntegrationMethod_t IntegrationMethod_t ;
+
+
+
     /*! \enum OutputQuantity_t
      *
      *  The "type" of temperature measurement that can be reported with
@@ -516,6 +603,26 @@ extern "C"
 
 
 
+    /*! \enum OutputFormat_t
+     *
+     * The format of the file written by a (thermal or power) map
+     * inspection point.
+     */
+
+    enum OutputFormat_t
+    {
+        TDICE_OUTPUT_FORMAT_TEXT = 0, //!< One line of text for every row of cells
+        TDICE_OUTPUT_FORMAT_BINARY    //!< A binary header followed by raw frames
+    } ;
+
+
+
+    /*! Definition of the type OutputFormat_t */
+
+    typedef enum OutputFormat_t OutputFormat_t ;
+
+
+
     /*! \enum OutputInstant_t
      *
      * Enumeration to collect the possible istant of time at which the
@@ -663,8 +770,10 @@ extern "C"
          * | n + 3 | TDICE_INSERT_POWERS | n | power0 | ... | power n-1 |
          *
          * where n is the total number of floorplan elements in the stack.
-         * The server will access the power vaues received and put them
-         * into the power queue of each floorplan element. The server will
+         * Every thermal cell of a die with a power map counts as a floorplan
+         * element. The server will access the power vaues received and put them
+         * into the power queue of each floorplan element (it fails if a die
+         * reads its power values from a power trace). The server will
          * respond with the message:
          *
          * | 3 | TDICE_INSERT_POWERS | Error_t |
@@ -47,9 +47,20 @@ void analysis_init (Analysis_t *analysis)
     analysis->AnalysisType       = (AnalysisType_t) TDICE_ANALYSIS_TYPE_NONE ;
     analysis->StepTime           = (Time_t) 0.0 ;
     analysis->SlotTime           = (Time_t) 0.0 ;
+    analysis->IntegrationMethod  = TDICE_INTEGRATION_EULER ;
     analysis->SlotLength         = (Quantity_t) 0u ;
     analysis->CurrentTime        = (Quantity_t) 0u ;
     analysis->InitialTemperature = (Temperature_t) 0.0 ;
+
+    string_init (&analysis->FactorizationCache) ;
+
+    analysis->SolverType          = TDICE_SOLVER_SUPERLU ;
+    analysis->Ordering            = TDICE_ORDERING_MINIMUM_DEGREE ;
+    analysis->SinglePrecision     = false ;
+    analysis->SolverTolerance     = 1e-10 ;
+    analysis->SolverMaxIterations = (Quantity_t) 1000u ;
+    analysis->NThreads            = (Quantity_t) 1u ;
+    analysis->StepTolerance       = (Temperature_t) 0.0 ;
 }
 
 /******************************************************************************/
@@ -61,16 +72,27 @@ void analysis_copy (Analysis_t *dst, Analysis_t *src)
     dst->AnalysisType       = src->AnalysisType ;
     dst->StepTime           = src->StepTime ;
     dst->SlotTime           = src->SlotTime ;
+    dst->IntegrationMethod  = src->IntegrationMethod ;
     dst->SlotLength         = src->SlotLength ;
     dst->CurrentTime        = src->CurrentTime ;
     dst->InitialTemperature = src->InitialTemperature ;
+
+    string_copy (&dst->FactorizationCache, &src->FactorizationCache) ;
+
+    dst->SolverType          = src->SolverType ;
+    dst->Ordering            = src->Ordering ;
+    dst->SinglePrecision     = src->SinglePrecision ;
+    dst->SolverTolerance     = src->SolverTolerance ;
+    dst->SolverMaxIterations = src->SolverMaxIterations ;
+    dst->NThreads            = src->NThreads ;
+    dst->StepTolerance       = src->StepTolerance ;
 }
 
 /******************************************************************************/
 
 void analysis_destroy (Analysis_t *analysis)
 {
-    // Nothing to do ...
+    string_destroy (&analysis->FactorizationCache) ;
 
     analysis_init (analysis) ;
 }
@@ -130,12 +152,48 @@ void analysis_print (Analysis_t *analysis, FILE *stream, String_t prefix)
 
     else
 
-        fprintf (stream, "  transient step %.2f, slot %.2f ;\n",
-            analysis->StepTime, analysis->SlotTime) ;
+        fprintf (stream, "  transient step %.2f, slot %.2f%s ;\n",
+            analysis->StepTime, analysis->SlotTime,
+            analysis->IntegrationMethod == TDICE_INTEGRATION_TRAPEZOIDAL ?
+                ", method trapezoidal" : "") ;
 
     fprintf (stream, "%s  initial temperature  %.2f ;\n",
         prefix, analysis->InitialTemperature) ;
 
+    if (analysis->FactorizationCache != NULL)
+
+        fprintf (stream, "%s  factorization cache \"%s\" ;\n",
+            prefix, analysis->FactorizationCache) ;
+
+    if (analysis->SolverType == TDICE_SOLVER_MULTIFRONTAL)
+
+        fprintf (stream, "%s  factorization multifrontal ;\n", prefix) ;
+
+    else if (analysis->SolverType != TDICE_SOLVER_SUPERLU)
+
+        fprintf (stream, "%s  iterative %s tolerance %.2e , iterations %d ;\n",
+            prefix,
+            analysis->SolverType == TDICE_SOLVER_PCG       ? "pcg"       :
+            analysis->SolverType == TDICE_SOLVER_MULTIGRID ? "multigrid" : "bicgstab",
+            analysis->SolverTolerance, analysis->SolverMaxIterations) ;
+
+    if (analysis->SinglePrecision == true)
+
+        fprintf (stream, "%s  factorization single precision ;\n", prefix) ;
+
+    if (analysis->Ordering == TDICE_ORDERING_NESTED_DISSECTION)
+
+        fprintf (stream, "%s  ordering nested dissection ;\n", prefix) ;
+
+    if (analysis->NThreads != 1u)
+
+        fprintf (stream, "%s  threads %d ;\n", prefix, analysis->NThreads) ;
+
+    if (analysis->StepTolerance > 0.0)
+
+        fprintf (stream, "%s  adaptive step tolerance %.2e ;\n",
+            prefix, analysis->StepTolerance) ;
+
     fprintf (stream, "%s\n", prefix) ;
 }
 
@@ -149,6 +207,17 @@ Time_t get_simulated_time (Analysis_t *analysis
 
 /******************************************************************************/
 
+Time_t get_matrix_step_time (Analysis_t *analysis)
+{
+    if (analysis->IntegrationMethod == TDICE_INTEGRATION_TRAPEZOIDAL)
+
+        return analysis->StepTime / 2.0 ;
+
+    return analysis->StepTime ;
+}
+
+/******************************************************************************/
+
 void increase_by_step_time (Analysis_t *analysis)
 {
     analysis->CurrentTime++ ;
@@ -156,6 +225,20 @@ void increase_by_step_time (Analysis_t *analysis)
 
 /******************************************************************************/
 
+void increase_by_steps (Analysis_t *analysis, Quantity_t nsteps)
+{
+    analysis->CurrentTime += nsteps ;
+}
+
+/******************************************************************************/
+
+Quantity_t get_steps_to_slot_end (Analysis_t *analysis)
+{
+    return analysis->SlotLength - analysis->CurrentTime % analysis->SlotLength ;
+}
+
+/******************************************************************************/
+
 bool slot_completed (Analysis_t *analysis)
 {
     if (analysis->CurrentTime % analysis->SlotLength == 0u)
@@ -41,6 +41,7 @@
 
 #include "floorplan.h"
 #include "floorplan_file_parser.h"
+#include "macros.h"
 
 /******************************************************************************/
 
@@ -50,6 +51,20 @@ void floorplan_init (Floorplan_t *floorplan)
 
     floorplan->NElements    = (Quantity_t) 0u ;
     floorplan->Bpowers      = NULL ;
+    floorplan->Npowers      = NULL ;
+    floorplan->PowerTrace   = NULL ;
+    floorplan->NMapCells    = (CellIndex_t) 0u ;
+    floorplan->MapValues    = NULL ;
+
+    floorplan->CellOffsets       = NULL ;
+    floorplan->ICElementCells    = NULL ;
+    floorplan->ElementICElements = NULL ;
+
+    floorplan->DistinctCellOffsets  = NULL ;
+    floorplan->ElementDistinctCells = NULL ;
+
+    floorplan->Statistics             = NULL ;
+    floorplan->StatisticsTemperatures = NULL ;
 
     floorplan_element_list_init (&floorplan->ElementsList) ;
     floorplan_matrix_init       (&floorplan->SurfaceCoefficients) ;
@@ -69,6 +84,73 @@ void floorplan_copy (Floorplan_t *dst, Floorplan_t *src)
 
     floorplan_matrix_copy (&dst->SurfaceCoefficients, &src->SurfaceCoefficients) ;
 
+    dst->PowerTrace = power_trace_clone (src->PowerTrace) ;
+
+    dst->NMapCells = src->NMapCells ;
+    dst->MapValues = powers_queue_clone (src->MapValues) ;
+
+    // Statistics is a work buffer, allocated on demand by dst
+
+    if (src->ElementICElements != NULL)
+    {
+        Quantity_t  nicelements = src->ElementICElements [src->NElements] ;
+        CellIndex_t ncells      = src->ICElementCells [nicelements] ;
+
+        dst->ElementICElements =
+
+            (Quantity_t *) malloc (sizeof (Quantity_t) * (src->NElements + 1u)) ;
+
+        dst->ICElementCells =
+
+            (CellIndex_t *) malloc (sizeof (CellIndex_t) * (nicelements + 1u)) ;
+
+        dst->CellOffsets =
+
+            (CellIndex_t *) malloc (sizeof (CellIndex_t) * ncells) ;
+
+        if (   dst->ElementICElements == NULL
+            || dst->ICElementCells    == NULL
+            || dst->CellOffsets       == NULL)
+        {
+            fprintf (stderr, "ERROR: malloc cell offsets in floorplan copy\n") ;
+
+            return ;
+        }
+
+        memcpy (dst->ElementICElements, src->ElementICElements,
+                sizeof (Quantity_t) * (src->NElements + 1u)) ;
+
+        memcpy (dst->ICElementCells, src->ICElementCells,
+                sizeof (CellIndex_t) * (nicelements + 1u)) ;
+
+        memcpy (dst->CellOffsets, src->CellOffsets,
+                sizeof (CellIndex_t) * ncells) ;
+
+        CellIndex_t ndistinct = src->ElementDistinctCells [src->NElements] ;
+
+        dst->ElementDistinctCells =
+
+            (CellIndex_t *) malloc (sizeof (CellIndex_t) * (src->NElements + 1u)) ;
+
+        dst->DistinctCellOffsets =
+
+            (CellIndex_t *) malloc (sizeof (CellIndex_t) * (ndistinct + 1u)) ;
+
+        if (   dst->ElementDistinctCells == NULL
+            || dst->DistinctCellOffsets  == NULL)
+        {
+            fprintf (stderr, "ERROR: malloc cell offsets in floorplan copy\n") ;
+
+            return ;
+        }
+
+        memcpy (dst->ElementDistinctCells, src->ElementDistinctCells,
+                sizeof (CellIndex_t) * (src->NElements + 1u)) ;
+
+        memcpy (dst->DistinctCellOffsets, src->DistinctCellOffsets,
+                sizeof (CellIndex_t) * ndistinct) ;
+    }
+
     if (src->Bpowers == NULL)
     {
         dst->Bpowers = NULL ;
@@ -76,7 +158,9 @@ void floorplan_copy (Floorplan_t *dst, Floorplan_t *src)
         return ;
     }
 
-    dst->Bpowers = (Power_t *) malloc (sizeof (Power_t) * src->NElements) ;
+    Quantity_t npowers = get_number_of_power_values_floorplan (src) ;
+
+    dst->Bpowers = (Power_t *) malloc (sizeof (Power_t) * npowers) ;
 
     if (dst->Bpowers == NULL)
     {
@@ -85,7 +169,15 @@ void floorplan_copy (Floorplan_t *dst, Floorplan_t *src)
         return ;
     }
 
-    memcpy (dst->Bpowers, src->Bpowers, sizeof (Power_t) * src->NElements) ;
+    memcpy (dst->Bpowers, src->Bpowers, sizeof (Power_t) * npowers) ;
+
+    // Npowers is a work vector, its content is not copied
+
+    dst->Npowers = (Power_t *) malloc (sizeof (Power_t) * npowers) ;
+
+    if (dst->Npowers == NULL)
+
+        fprintf (stderr, "ERROR: malloc Npowers in floorplan copy\n") ;
 }
 
 /******************************************************************************/
@@ -98,6 +190,37 @@ void floorplan_destroy (Floorplan_t *floorplan)
 
         free (floorplan->Bpowers) ;
 
+    if (floorplan->Npowers != NULL)
+
+        free (floorplan->Npowers) ;
+
+    power_trace_free  (floorplan->PowerTrace) ;
+    powers_queue_free (floorplan->MapValues) ;
+
+    if (floorplan->CellOffsets != NULL)
+
+        free (floorplan->CellOffsets) ;
+
+    if (floorplan->ICElementCells != NULL)
+
+        free (floorplan->ICElementCells) ;
+
+    if (floorplan->ElementICElements != NULL)
+
+        free (floorplan->ElementICElements) ;
+
+    if (floorplan->DistinctCellOffsets != NULL)
+
+        free (floorplan->DistinctCellOffsets) ;
+
+    if (floorplan->ElementDistinctCells != NULL)
+
+        free (floorplan->ElementDistinctCells) ;
+
+    if (floorplan->Statistics != NULL)
+
+        free (floorplan->Statistics) ;
+
     floorplan_element_list_destroy (&floorplan->ElementsList) ;
     floorplan_matrix_destroy       (&floorplan->SurfaceCoefficients) ;
 
@@ -151,6 +274,13 @@ void floorplan_free (Floorplan_t *floorplan)
 
 void floorplan_print (Floorplan_t *floorplan, FILE *stream, String_t prefix)
 {
+    if (floorplan->PowerTrace != NULL)
+    {
+        power_trace_print (floorplan->PowerTrace, stream, prefix) ;
+
+        fprintf (stream, "%s\n", prefix) ;
+    }
+
     FloorplanElementListNode_t *flpeln ;
 
     for (flpeln  = floorplan_element_list_begin (&floorplan->ElementsList) ;
@@ -167,6 +297,132 @@ void floorplan_print (Floorplan_t *floorplan, FILE *stream, String_t prefix)
 
 /******************************************************************************/
 
+// Flattens the IC elements of the floorplan into the tables CellOffsets,
+// ICElementCells and ElementICElements, with all the cells of every IC
+// element (the averages). The cells of every floorplan element are also
+// stored once in DistinctCellOffsets (the maxima and minima), even if they
+// are covered by more than one of its IC elements.
+
+static Error_t fill_cell_offsets
+(
+    Floorplan_t  *floorplan,
+    Dimensions_t *dimensions,
+    CellIndex_t   ncells
+)
+{
+    Quantity_t nicelements = 0u ;
+
+    FloorplanElementListNode_t *flpeln ;
+
+    for (flpeln  = floorplan_element_list_begin (&floorplan->ElementsList) ;
+         flpeln != NULL ;
+         flpeln  = floorplan_element_list_next (flpeln))
+
+        nicelements += floorplan_element_list_data (flpeln)->NICElements ;
+
+    floorplan->ElementICElements =
+
+        (Quantity_t *) malloc (sizeof (Quantity_t) * (floorplan->NElements + 1u)) ;
+
+    floorplan->ICElementCells =
+
+        (CellIndex_t *) malloc (sizeof (CellIndex_t) * (nicelements + 1u)) ;
+
+    floorplan->CellOffsets =
+
+        (CellIndex_t *) malloc (sizeof (CellIndex_t) * ncells) ;
+
+    floorplan->ElementDistinctCells =
+
+        (CellIndex_t *) malloc (sizeof (CellIndex_t) * (floorplan->NElements + 1u)) ;
+
+    floorplan->DistinctCellOffsets =
+
+        (CellIndex_t *) malloc (sizeof (CellIndex_t) * ncells) ;
+
+    bool *marks = (bool *) calloc (get_layer_area (dimensions), sizeof (bool)) ;
+
+    if (   floorplan->ElementICElements    == NULL
+        || floorplan->ICElementCells       == NULL
+        || floorplan->CellOffsets          == NULL
+        || floorplan->ElementDistinctCells == NULL
+        || floorplan->DistinctCellOffsets  == NULL
+        || marks                           == NULL)
+    {
+        fprintf (stderr, "Malloc cell offsets failed\n") ;
+
+        free (marks) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    Quantity_t  element  = 0u, icelement = 0u ;
+    CellIndex_t cell     = 0u ;
+    CellIndex_t distinct = 0u ;
+
+    for (flpeln  = floorplan_element_list_begin (&floorplan->ElementsList) ;
+         flpeln != NULL ;
+         flpeln  = floorplan_element_list_next (flpeln))
+    {
+        FloorplanElement_t *flpel = floorplan_element_list_data (flpeln) ;
+
+        CellIndex_t first_distinct = distinct ;
+
+        floorplan->ElementDistinctCells [element] = distinct ;
+        floorplan->ElementICElements    [element] = icelement ;
+
+        element++ ;
+
+        ICElementListNode_t *iceln ;
+
+        for (iceln  = ic_element_list_begin (&flpel->ICElements) ;
+             iceln != NULL ;
+             iceln  = ic_element_list_next (iceln))
+        {
+            ICElement_t *icel = ic_element_list_data (iceln) ;
+
+            CellIndex_t row, column ;
+
+            floorplan->ICElementCells [icelement++] = cell ;
+
+            for (row = icel->SW_Row ; row <= icel->NE_Row ; row++)
+            {
+                for (column = icel->SW_Column ; column <= icel->NE_Column ; column++)
+                {
+                    CellIndex_t offset =
+
+                        get_cell_offset_in_layer (dimensions, row, column) ;
+
+                    floorplan->CellOffsets [cell++] = offset ;
+
+                    if (marks [offset] == false)
+                    {
+                        marks [offset] = true ;
+
+                        floorplan->DistinctCellOffsets [distinct++] = offset ;
+                    }
+                }
+            }
+        }
+
+        // The next floorplan elements may cover the same cells
+
+        for ( ; first_distinct != distinct ; first_distinct++)
+
+            marks [floorplan->DistinctCellOffsets [first_distinct]] = false ;
+    }
+
+    floorplan->ElementDistinctCells [element]   = distinct ;
+    floorplan->ElementICElements    [element]   = icelement ;
+    floorplan->ICElementCells       [icelement] = cell ;
+
+    free (marks) ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
 Error_t fill_floorplan
 (
     Floorplan_t  *floorplan,
@@ -193,6 +449,17 @@ Error_t fill_floorplan
         return TDICE_FAILURE ;
     }
 
+    floorplan->Npowers =
+
+        (Power_t *) malloc (sizeof (Power_t) * floorplan->NElements) ;
+
+    if (floorplan->Npowers == NULL)
+    {
+        fprintf (stderr, "Malloc Npowers failed\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
     CellIndex_t nnz = 0u ;
 
     FloorplanElementListNode_t *flpeln ;
@@ -229,6 +496,72 @@ Error_t fill_floorplan
 
         (&floorplan->SurfaceCoefficients, &floorplan->ElementsList, dimensions) ;
 
+    return fill_cell_offsets (floorplan, dimensions, nnz) ;
+}
+
+/******************************************************************************/
+
+Error_t fill_floorplan_power_map
+(
+    Floorplan_t  *floorplan,
+    Dimensions_t *dimensions,
+    String_t      file_name
+)
+{
+    floorplan->NMapCells = get_layer_area (dimensions) ;
+
+    if (file_name != NULL)
+    {
+        floorplan->PowerTrace = power_trace_calloc ( ) ;
+
+        if (floorplan->PowerTrace == NULL)
+        {
+            fprintf (stderr, "Malloc power map failed\n") ;
+
+            return TDICE_FAILURE ;
+        }
+
+        if (   power_trace_open_map (floorplan->PowerTrace, file_name, floorplan->NMapCells)
+            == TDICE_FAILURE)
+
+            return TDICE_FAILURE ;
+    }
+    else
+    {
+        floorplan->MapValues = powers_queue_calloc ( ) ;
+
+        if (floorplan->MapValues == NULL)
+        {
+            fprintf (stderr, "Malloc power map queue failed\n") ;
+
+            return TDICE_FAILURE ;
+        }
+
+        powers_queue_build (floorplan->MapValues, floorplan->NMapCells) ;
+    }
+
+    floorplan->Bpowers =
+
+        (Power_t *) malloc (sizeof (Power_t) * floorplan->NMapCells) ;
+
+    if (floorplan->Bpowers == NULL)
+    {
+        fprintf (stderr, "Malloc Bpowers failed\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    floorplan->Npowers =
+
+        (Power_t *) malloc (sizeof (Power_t) * floorplan->NMapCells) ;
+
+    if (floorplan->Npowers == NULL)
+    {
+        fprintf (stderr, "Malloc Npowers failed\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
     return TDICE_SUCCESS ;
 }
 
@@ -241,6 +574,13 @@ Quantity_t get_number_of_floorplan_elements_floorplan (Floorplan_t *floorplan)
 
 /******************************************************************************/
 
+Quantity_t get_number_of_power_values_floorplan (Floorplan_t *floorplan)
+{
+    return floorplan->NMapCells != 0u ? floorplan->NMapCells : floorplan->NElements ;
+}
+
+/******************************************************************************/
+
 FloorplanElement_t *get_floorplan_element
 (
     Floorplan_t *floorplan,
@@ -264,10 +604,32 @@ FloorplanElement_t *get_floorplan_element
 
 /******************************************************************************/
 
-Error_t fill_sources_floorplan (Floorplan_t *floorplan, Source_t *sources)
+/* Reads the power of every floorplan element for the next slot into
+ * \a powers , from the power trace or from the queues of the elements */
+
+static Error_t get_next_powers (Floorplan_t *floorplan, Power_t *powers)
 {
+    if (floorplan->PowerTrace != NULL)
+
+        // The trace is read lazily, one slot per call
+
+        return power_trace_read (floorplan->PowerTrace, powers) ;
+
     Quantity_t index = 0u ;
 
+    if (floorplan->NMapCells != 0u)
+    {
+        if (floorplan->MapValues->Size < floorplan->NMapCells)
+
+            return TDICE_FAILURE ;
+
+        for (index = 0u ; index != floorplan->NMapCells ; index++)
+
+            powers [ index ] = get_from_powers_queue (floorplan->MapValues) ;
+
+        return TDICE_SUCCESS ;
+    }
+
     FloorplanElementListNode_t *flpeln ;
 
     for (flpeln  = floorplan_element_list_begin (&floorplan->ElementsList) ;
@@ -280,7 +642,31 @@ Error_t fill_sources_floorplan (Floorplan_t *floorplan, Source_t *sources)
 
             return TDICE_FAILURE ;
 
-        floorplan->Bpowers [ index++ ] = get_from_powers_queue (flpel->PowerValues) ;
+        powers [ index++ ] = get_from_powers_queue (flpel->PowerValues) ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+Error_t fill_sources_floorplan (Floorplan_t *floorplan, Source_t *sources)
+{
+    if (get_next_powers (floorplan, floorplan->Bpowers) == TDICE_FAILURE)
+
+        return TDICE_FAILURE ;
+
+    if (floorplan->NMapCells != 0u)
+    {
+        // A frame of the power map stores the sources as they are
+
+        CellIndex_t cell ;
+
+        for (cell = 0u ; cell != floorplan->NMapCells ; cell++)
+
+            sources [cell] += floorplan->Bpowers [cell] ;
+
+        return TDICE_SUCCESS ;
     }
 
     // Does the mv multiplication to compute the source vector
@@ -294,6 +680,60 @@ Error_t fill_sources_floorplan (Floorplan_t *floorplan, Source_t *sources)
 
 /******************************************************************************/
 
+Error_t update_sources_floorplan (Floorplan_t *floorplan, Source_t *sources)
+{
+    if (get_next_powers (floorplan, floorplan->Npowers) == TDICE_FAILURE)
+
+        return TDICE_FAILURE ;
+
+    FloorplanMatrix_t *flpmatrix = &floorplan->SurfaceCoefficients ;
+
+    Quantity_t  element ;
+    CellIndex_t index ;
+
+    if (floorplan->NMapCells != 0u)
+    {
+        for (index = 0u ; index != floorplan->NMapCells ; index++)
+        {
+            sources [index] += floorplan->Npowers [index] - floorplan->Bpowers [index] ;
+
+            floorplan->Bpowers [index] = floorplan->Npowers [index] ;
+        }
+
+        return TDICE_SUCCESS ;
+    }
+
+    for (element = 0u ; element != floorplan->NElements ; element++)
+    {
+        Power_t delta = floorplan->Npowers [element] - floorplan->Bpowers [element] ;
+
+        if (delta == 0.0)
+
+            continue ;
+
+        // Only the cells covered by the element (its column
+        // in the surface coefficients) change their sources
+
+        for (index  = flpmatrix->ColumnPointers [element] ;
+             index != flpmatrix->ColumnPointers [element + 1] ; index++)
+
+            sources [flpmatrix->RowIndices [index]] += delta * flpmatrix->Values [index] ;
+
+        floorplan->Bpowers [element] = floorplan->Npowers [element] ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+bool power_trace_failed_floorplan (Floorplan_t *floorplan)
+{
+    return floorplan->PowerTrace != NULL && floorplan->PowerTrace->Failed == true ;
+}
+
+/******************************************************************************/
+
 Error_t insert_power_values_floorplan
 (
     Floorplan_t   *floorplan,
@@ -302,6 +742,34 @@ Error_t insert_power_values_floorplan
 {
     Error_t result ;
 
+    if (floorplan->PowerTrace != NULL)
+    {
+        // The values would never be used: the trace overwrites them
+
+        fprintf (stderr,
+            "Cannot insert power values: they are read from the power trace %s\n",
+            floorplan->PowerTrace->FileName) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    if (floorplan->NMapCells != 0u)
+    {
+        if (pvalues->Size < floorplan->NMapCells)
+
+            return TDICE_FAILURE ;
+
+        CellIndex_t cell ;
+
+        for (cell = 0u ; cell != floorplan->NMapCells ; cell++)
+
+            put_into_powers_queue
+
+                (floorplan->MapValues, get_from_powers_queue (pvalues)) ;
+
+        return TDICE_SUCCESS ;
+    }
+
     FloorplanElementListNode_t *flpeln ;
 
     for (flpeln  = floorplan_element_list_begin (&floorplan->ElementsList) ;
@@ -322,6 +790,216 @@ Error_t insert_power_values_floorplan
 
 /******************************************************************************/
 
+// Reductions over the temperatures of a set of thermal cells given by their
+// offsets in the layer (ncells must be greater than zero). The four
+// independent accumulators break the dependency between consecutive cells
+// so that the loops can be vectorized.
+
+static Temperature_t max_temperature_cells
+(
+    Temperature_t *temperatures,
+    CellIndex_t   *offsets,
+    CellIndex_t    ncells
+)
+{
+    Temperature_t max0, max1, max2, max3 ;
+
+    max0 = max1 = max2 = max3 = temperatures [offsets [0]] ;
+
+    CellIndex_t cell ;
+
+    for (cell = 0u ; cell + 4u <= ncells ; cell += 4u)
+    {
+        max0 = MAX (max0, temperatures [offsets [cell     ]]) ;
+        max1 = MAX (max1, temperatures [offsets [cell + 1u]]) ;
+        max2 = MAX (max2, temperatures [offsets [cell + 2u]]) ;
+        max3 = MAX (max3, temperatures [offsets [cell + 3u]]) ;
+    }
+
+    for ( ; cell != ncells ; cell++)
+
+        max0 = MAX (max0, temperatures [offsets [cell]]) ;
+
+    return MAX (MAX (max0, max1), MAX (max2, max3)) ;
+}
+
+static Temperature_t min_temperature_cells
+(
+    Temperature_t *temperatures,
+    CellIndex_t   *offsets,
+    CellIndex_t    ncells
+)
+{
+    Temperature_t min0, min1, min2, min3 ;
+
+    min0 = min1 = min2 = min3 = temperatures [offsets [0]] ;
+
+    CellIndex_t cell ;
+
+    for (cell = 0u ; cell + 4u <= ncells ; cell += 4u)
+    {
+        min0 = MIN (min0, temperatures [offsets [cell     ]]) ;
+        min1 = MIN (min1, temperatures [offsets [cell + 1u]]) ;
+        min2 = MIN (min2, temperatures [offsets [cell + 2u]]) ;
+        min3 = MIN (min3, temperatures [offsets [cell + 3u]]) ;
+    }
+
+    for ( ; cell != ncells ; cell++)
+
+        min0 = MIN (min0, temperatures [offsets [cell]]) ;
+
+    return MIN (MIN (min0, min1), MIN (min2, min3)) ;
+}
+
+static Temperature_t sum_temperature_cells
+(
+    Temperature_t *temperatures,
+    CellIndex_t   *offsets,
+    CellIndex_t    ncells
+)
+{
+    Temperature_t sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0 ;
+
+    CellIndex_t cell ;
+
+    for (cell = 0u ; cell + 4u <= ncells ; cell += 4u)
+    {
+        sum0 += temperatures [offsets [cell     ]] ;
+        sum1 += temperatures [offsets [cell + 1u]] ;
+        sum2 += temperatures [offsets [cell + 2u]] ;
+        sum3 += temperatures [offsets [cell + 3u]] ;
+    }
+
+    for ( ; cell != ncells ; cell++)
+
+        sum0 += temperatures [offsets [cell]] ;
+
+    return (sum0 + sum1) + (sum2 + sum3) ;
+}
+
+/******************************************************************************/
+
+Temperature_t *get_temperature_statistics_floorplan
+(
+    Floorplan_t      *floorplan,
+    Temperature_t    *temperatures,
+    OutputQuantity_t  quantity
+)
+{
+    Quantity_t nelements = floorplan->NElements ;
+
+    if (   quantity != TDICE_OUTPUT_QUANTITY_MAXIMUM
+        && quantity != TDICE_OUTPUT_QUANTITY_MINIMUM
+        && quantity != TDICE_OUTPUT_QUANTITY_AVERAGE
+        && quantity != TDICE_OUTPUT_QUANTITY_GRADIENT)
+    {
+        fprintf (stderr, "Error: Wrong floorplan statistic %d\n", quantity) ;
+
+        return NULL ;
+    }
+
+    if (floorplan->Statistics == NULL)
+    {
+        floorplan->Statistics =
+
+            (Temperature_t *) malloc (sizeof (Temperature_t) * 4u * nelements) ;
+
+        if (floorplan->Statistics == NULL)
+        {
+            fprintf (stderr, "ERROR: malloc statistics in floorplan\n") ;
+
+            return NULL ;
+        }
+
+        floorplan->StatisticsTemperatures = NULL ;
+    }
+
+    Temperature_t *max_temperatures = floorplan->Statistics ;
+    Temperature_t *min_temperatures = max_temperatures + nelements ;
+    Temperature_t *avg_temperatures = min_temperatures + nelements ;
+    Temperature_t *gra_temperatures = avg_temperatures + nelements ;
+
+    if (floorplan->StatisticsTemperatures != temperatures)
+    {
+        // The same reductions of get_*_temperature_floorplan_element,
+        // computed together over the flattened table of the cells
+
+        Quantity_t element ;
+
+        for (element = 0u ; element != nelements ; element++)
+        {
+            Quantity_t first = floorplan->ElementICElements [element] ;
+            Quantity_t last  = floorplan->ElementICElements [element + 1u] ;
+
+            Quantity_t nicelements = last - first ;
+
+            // Maximum and minimum over the cells of the element, each
+            // cell once
+
+            CellIndex_t *offsets = floorplan->DistinctCellOffsets
+
+                                   + floorplan->ElementDistinctCells [element] ;
+
+            CellIndex_t ncells = floorplan->ElementDistinctCells [element + 1u]
+
+                                 - floorplan->ElementDistinctCells [element] ;
+
+            Temperature_t max = max_temperature_cells (temperatures, offsets, ncells) ;
+            Temperature_t min = min_temperature_cells (temperatures, offsets, ncells) ;
+
+            // The average of the averages of the IC elements, each one
+            // over all its cells, as get_avg_temperature_floorplan_element
+
+            Temperature_t avg = 0.0 ;
+
+            for ( ; first != last ; first++)
+            {
+                offsets = floorplan->CellOffsets + floorplan->ICElementCells [first] ;
+
+                ncells  = floorplan->ICElementCells [first + 1u]
+
+                          - floorplan->ICElementCells [first] ;
+
+                avg += sum_temperature_cells (temperatures, offsets, ncells)
+
+                       / (Temperature_t) ncells ;
+            }
+
+            max_temperatures [element] = max ;
+            min_temperatures [element] = min ;
+            avg_temperatures [element] = avg / (Temperature_t) nicelements ;
+            gra_temperatures [element] = max - min ;
+        }
+
+        floorplan->StatisticsTemperatures = temperatures ;
+    }
+
+    if (quantity == TDICE_OUTPUT_QUANTITY_MAXIMUM)
+
+        return max_temperatures ;
+
+    else if (quantity == TDICE_OUTPUT_QUANTITY_MINIMUM)
+
+        return min_temperatures ;
+
+    else if (quantity == TDICE_OUTPUT_QUANTITY_AVERAGE)
+
+        return avg_temperatures ;
+
+    else
+
+        return gra_temperatures ;
+}
+
+/******************************************************************************/
+
+void invalidate_temperature_statistics_floorplan (Floorplan_t *floorplan)
+{
+    floorplan->StatisticsTemperatures = NULL ;
+}
+
+/******************************************************************************/
+
 Temperature_t *get_all_max_temperatures_floorplan
 (
     Floorplan_t   *floorplan,
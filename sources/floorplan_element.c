@@ -47,6 +47,7 @@ void floorplan_element_init (FloorplanElement_t *flpel)
 {
     string_init (&flpel->Id) ;
 
+    flpel->Index          = (Quantity_t) 0u ;
     flpel->NICElements    = (Quantity_t) 0u ;
 
     ic_element_list_init (&flpel->ICElements) ;
@@ -67,6 +68,7 @@ void floorplan_element_copy
 
     string_copy (&dst->Id, &src->Id) ;
 
+    dst->Index       = src->Index ;
     dst->NICElements = src->NICElements ;
     dst->Area        = src->Area ;
 
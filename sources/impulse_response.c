@@ -0,0 +1,291 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <stdio.h>  // For the file type FILE
+#include <stdlib.h> // For the memory functions malloc/free
+#include <string.h> // For the memory function memset
+#include <math.h>   // For the math function fabs
+
+#include "impulse_response.h"
+#include "thermal_batch.h"
+#include "macros.h"
+
+/******************************************************************************/
+
+void impulse_response_init (ImpulseResponse_t *iresponse)
+{
+    iresponse->NElements = (Quantity_t) 0u ;
+    iresponse->NCells    = (CellIndex_t) 0u ;
+    iresponse->Cells     = NULL ;
+    iresponse->NSlots    = (Quantity_t) 0u ;
+    iresponse->Responses = NULL ;
+    iresponse->Offsets   = NULL ;
+}
+
+/******************************************************************************/
+
+Error_t impulse_response_build
+(
+    ImpulseResponse_t *iresponse,
+    ThermalData_t     *tdata,
+    Dimensions_t      *dimensions,
+    Analysis_t        *analysis,
+    Output_t          *output,
+    Quantity_t         nslots,
+    Temperature_t      tolerance
+)
+{
+    if (analysis->AnalysisType != TDICE_ANALYSIS_TYPE_TRANSIENT)
+    {
+        fprintf (stderr, "Impulse responses need a transient analysis\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    if (analysis->StepTolerance > 0.0)
+    {
+        fprintf (stderr, "Impulse responses need a fixed time step\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    if (nslots == 0u)
+    {
+        fprintf (stderr, "Impulse responses need at least one slot\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    /* Collects the cells read by the inspection points */
+
+    iresponse->Cells = get_output_cells (output, dimensions, &iresponse->NCells) ;
+
+    if (iresponse->Cells == NULL)
+    {
+        fprintf (stderr, "Impulse responses: cannot collect the output cells (Pmap is not supported)\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    iresponse->NElements = get_number_of_floorplan_elements_power_grid (&tdata->PowerGrid) ;
+
+    CellIndex_t ncells    = iresponse->NCells ;
+    Quantity_t  nelements = iresponse->NElements ;
+
+    iresponse->Offsets   = (Temperature_t *) malloc
+
+        (sizeof (Temperature_t) * MAX ((size_t) nslots * ncells, 1u)) ;
+
+    iresponse->Responses = (Temperature_t *) malloc
+
+        (sizeof (Temperature_t) * MAX ((size_t) nslots * ncells * nelements, 1u)) ;
+
+    if (iresponse->Offsets == NULL || iresponse->Responses == NULL)
+    {
+        fprintf (stderr, "Cannot malloc impulse responses\n") ;
+
+        impulse_response_destroy (iresponse) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    /* Scenario 0 starts from the initial temperature with the ambient and
+     * coolant sources, scenario e + 1 starts from zero with 1 W in the
+     * floorplan element e (during the first slot only). The analysis is
+     * copied to keep the time of the caller */
+
+    Analysis_t local = *analysis ;
+
+    local.CurrentTime = (Quantity_t) 0u ;
+
+    ThermalBatch_t batch ;
+
+    thermal_batch_init (&batch) ;
+
+    if (thermal_batch_build (&batch, tdata, nelements + 1u, &local) != TDICE_SUCCESS)
+    {
+        impulse_response_destroy (iresponse) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    fill_constant_source_vector
+
+        (&tdata->PowerGrid, dimensions, get_batch_sources (&batch, 0u)) ;
+
+    Quantity_t element ;
+
+    for (element = 0u ; element != nelements ; element++)
+    {
+        Source_t *sources = get_batch_sources (&batch, element + 1u) ;
+
+        memset (sources, 0, sizeof (Source_t) * batch.Size) ;
+        memset (get_batch_temperatures (&batch, element + 1u), 0,
+                sizeof (Temperature_t) * batch.Size) ;
+
+        add_floorplan_element_sources (&tdata->PowerGrid, dimensions, element, sources) ;
+    }
+
+    Quantity_t  slot ;
+    CellIndex_t cell ;
+
+    for (slot = 0u ; slot != nslots ; slot++)
+    {
+        SimResult_t result ;
+
+        do
+
+            result = emulate_batch_step (&batch, tdata, &local) ;
+
+        while (result == TDICE_STEP_DONE) ;
+
+        if (result != TDICE_SLOT_DONE)
+        {
+            fprintf (stderr, "Impulse responses: error solving the linear system\n") ;
+
+            thermal_batch_destroy (&batch) ;
+
+            impulse_response_destroy (iresponse) ;
+
+            return TDICE_FAILURE ;
+        }
+
+        Temperature_t *offsets   = iresponse->Offsets   + (size_t) slot * ncells ;
+        Temperature_t *responses = iresponse->Responses + (size_t) slot * ncells * nelements ;
+        Temperature_t *previous  = offsets - ncells ;
+        Temperature_t *initial   = get_batch_temperatures (&batch, 0u) ;
+        Temperature_t  change    = 0.0 ;
+
+        for (cell = 0u ; cell != ncells ; cell++)
+        {
+            offsets [cell] = initial [iresponse->Cells [cell]] ;
+
+            if (slot > 0u)
+
+                change = MAX (change, fabs (offsets [cell] - previous [cell])) ;
+
+            for (element = 0u ; element != nelements ; element++)
+            {
+                Temperature_t response =
+
+                    get_batch_temperatures (&batch, element + 1u) [iresponse->Cells [cell]] ;
+
+                responses [(size_t) cell * nelements + element] = response ;
+
+                change = MAX (change, fabs (response)) ;
+            }
+        }
+
+        // The floorplan elements dissipate power only in the first slot
+
+        if (slot == 0u)
+
+            for (element = 0u ; element != nelements ; element++)
+
+                memset (get_batch_sources (&batch, element + 1u), 0,
+                        sizeof (Source_t) * batch.Size) ;
+
+        else if (change <= tolerance)
+        {
+            slot++ ;
+
+            break ;
+        }
+    }
+
+    iresponse->NSlots = slot ;
+
+    thermal_batch_destroy (&batch) ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+void impulse_response_destroy (ImpulseResponse_t *iresponse)
+{
+    free (iresponse->Cells) ;
+    free (iresponse->Responses) ;
+    free (iresponse->Offsets) ;
+
+    impulse_response_init (iresponse) ;
+}
+
+/******************************************************************************/
+
+void emulate_slot_convolution
+(
+    ImpulseResponse_t *iresponse,
+    Power_t           *powers,
+    Quantity_t         slot,
+    Temperature_t     *temperatures
+)
+{
+    CellIndex_t ncells    = iresponse->NCells ;
+    Quantity_t  nelements = iresponse->NElements ;
+
+    // After the last slot stored the offsets are constant and the
+    // impulse responses are null
+
+    Quantity_t last = MIN (slot, iresponse->NSlots - 1u) ;
+
+    CellIndex_t cell ;
+    Quantity_t  delay, element ;
+
+    for (cell = 0u ; cell != ncells ; cell++)
+    {
+        Temperature_t temperature = iresponse->Offsets [(size_t) last * ncells + cell] ;
+
+        for (delay = 0u ; delay <= last ; delay++)
+        {
+            Temperature_t *response =
+
+                iresponse->Responses + ((size_t) delay * ncells + cell) * nelements ;
+
+            Power_t *power = powers + (size_t) (slot - delay) * nelements ;
+
+            for (element = 0u ; element != nelements ; element++)
+
+                temperature += response [element] * power [element] ;
+        }
+
+        temperatures [iresponse->Cells [cell]] = temperature ;
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,252 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <stdio.h>  // For the file type FILE
+#include <stdlib.h> // For the memory functions malloc/free
+#include <string.h> // For the memory function memset
+
+#include "influence_matrix.h"
+#include "macros.h"
+
+/* Number of unit power vectors solved together with the LU factors of the
+ * system matrix (columns of the right hand side matrix) */
+
+#define INFLUENCE_SOLVE_COLUMNS 32u
+
+/******************************************************************************/
+
+void influence_matrix_init (InfluenceMatrix_t *imatrix)
+{
+    imatrix->NElements = (Quantity_t) 0u ;
+    imatrix->NCells    = (CellIndex_t) 0u ;
+    imatrix->Cells     = NULL ;
+    imatrix->Responses = NULL ;
+    imatrix->Offsets   = NULL ;
+}
+
+/******************************************************************************/
+
+/* Solves the system for the \a ncolumns vectors stored (one after the other)
+ * in \a vectors and copies the temperatures of the observed cells in
+ * \a results , with a distance of \a stride between two consecutive cells */
+
+static Error_t solve_columns
+(
+    InfluenceMatrix_t *imatrix,
+    ThermalData_t     *tdata,
+    double            *vectors,
+    Quantity_t         ncolumns,
+    Temperature_t     *results,
+    Quantity_t         stride
+)
+{
+    SuperMatrix b ;
+
+    dCreate_Dense_Matrix
+
+        (&b, tdata->Size, ncolumns, vectors, tdata->Size,
+         SLU_DN, SLU_D, SLU_GE) ;
+
+    Error_t result = solve_sparse_linear_system (&tdata->SM_A, &b) ;
+
+    Destroy_SuperMatrix_Store (&b) ;
+
+    if (result != TDICE_SUCCESS)
+
+        return TDICE_FAILURE ;
+
+    Quantity_t  column ;
+    CellIndex_t cell ;
+
+    for (column = 0u ; column != ncolumns ; column++)
+
+        for (cell = 0u ; cell != imatrix->NCells ; cell++)
+
+            results [cell * stride + column] =
+
+                vectors [(size_t) column * tdata->Size + imatrix->Cells [cell]] ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+Error_t influence_matrix_build
+(
+    InfluenceMatrix_t *imatrix,
+    ThermalData_t     *tdata,
+    Dimensions_t      *dimensions,
+    Analysis_t        *analysis,
+    Output_t          *output
+)
+{
+    if (analysis->AnalysisType != TDICE_ANALYSIS_TYPE_STEADY)
+    {
+        fprintf (stderr, "Influence matrix needs a steady state analysis\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    HeatSink_t *sink = tdata->ThermalGrid.TopHeatSink ;
+
+    if (sink != NULL && sink->SinkModel == TDICE_HEATSINK_TOP_PLUGGABLE)
+    {
+        fprintf (stderr, "Influence matrix does not support pluggable heat sinks\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    /* Collects the cells read by the inspection points */
+
+    imatrix->Cells = get_output_cells (output, dimensions, &imatrix->NCells) ;
+
+    if (imatrix->Cells == NULL)
+    {
+        fprintf (stderr, "Influence matrix: cannot collect the output cells (Pmap is not supported)\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    imatrix->NElements = get_number_of_floorplan_elements_power_grid (&tdata->PowerGrid) ;
+
+    Quantity_t ncolumns = MIN (MAX (imatrix->NElements, 1u), INFLUENCE_SOLVE_COLUMNS) ;
+
+    imatrix->Offsets   = (Temperature_t *) malloc (sizeof (Temperature_t) * MAX (imatrix->NCells, 1u)) ;
+    imatrix->Responses = (Temperature_t *) malloc
+
+        (sizeof (Temperature_t) * MAX ((size_t) imatrix->NCells * imatrix->NElements, 1u)) ;
+
+    double *vectors = (double *) malloc (sizeof (double) * tdata->Size * ncolumns) ;
+
+    if (imatrix->Offsets == NULL || imatrix->Responses == NULL || vectors == NULL)
+    {
+        fprintf (stderr, "Cannot malloc influence matrix\n") ;
+
+        free (vectors) ;
+
+        influence_matrix_destroy (imatrix) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    /* Temperatures with no power, i.e. due to the ambient and the coolant */
+
+    fill_constant_source_vector (&tdata->PowerGrid, dimensions, vectors) ;
+
+    if (solve_columns (imatrix, tdata, vectors, 1u, imatrix->Offsets, 1u) != TDICE_SUCCESS)
+
+        goto solver_error ;
+
+    /* Temperature rise due to 1 W in every floorplan element. The sources
+     * are the columns of the surface coefficients of the floorplans alone,
+     * so that the solutions do not include the temperatures above */
+
+    Quantity_t element, first ;
+
+    for (first = 0u ; first < imatrix->NElements ; first += ncolumns)
+    {
+        Quantity_t nsolve = MIN (ncolumns, imatrix->NElements - first) ;
+
+        memset (vectors, 0, sizeof (double) * tdata->Size * nsolve) ;
+
+        for (element = 0u ; element != nsolve ; element++)
+
+            add_floorplan_element_sources
+
+                (&tdata->PowerGrid, dimensions, first + element,
+                 vectors + (size_t) element * tdata->Size) ;
+
+        if (solve_columns (imatrix, tdata, vectors, nsolve,
+                           imatrix->Responses + first, imatrix->NElements) != TDICE_SUCCESS)
+
+            goto solver_error ;
+    }
+
+    free (vectors) ;
+
+    return TDICE_SUCCESS ;
+
+solver_error :
+
+    fprintf (stderr, "Influence matrix: error solving the linear system\n") ;
+
+    free (vectors) ;
+
+    influence_matrix_destroy (imatrix) ;
+
+    return TDICE_FAILURE ;
+}
+
+/******************************************************************************/
+
+void influence_matrix_destroy (InfluenceMatrix_t *imatrix)
+{
+    free (imatrix->Cells) ;
+    free (imatrix->Responses) ;
+    free (imatrix->Offsets) ;
+
+    influence_matrix_init (imatrix) ;
+}
+
+/******************************************************************************/
+
+void emulate_steady_influence
+(
+    InfluenceMatrix_t *imatrix,
+    Power_t           *powers,
+    Temperature_t     *temperatures
+)
+{
+    Temperature_t *response = imatrix->Responses ;
+
+    CellIndex_t cell ;
+    Quantity_t  element ;
+
+    for (cell = 0u ; cell != imatrix->NCells ; cell++)
+    {
+        Temperature_t temperature = imatrix->Offsets [cell] ;
+
+        for (element = 0u ; element != imatrix->NElements ; element++)
+
+            temperature += *response++ * powers [element] ;
+
+        temperatures [imatrix->Cells [cell]] = temperature ;
+    }
+}
+
+/******************************************************************************/
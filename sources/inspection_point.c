@@ -37,9 +37,23 @@
  ******************************************************************************/
 
 #include <stdlib.h> // For the memory functions malloc/free
+#include <string.h> // For the string function strlen
 
 #include "inspection_point.h"
 
+/* Size of the user space buffer of the output streams of thermal and power
+ * maps. A thermal map of a 100x100 grid is about 90KB of text, so that a
+ * full slot of step outputs is usually written to the file with a few
+ * system calls. */
+
+#define IPOINT_MAP_BUFFER_SIZE (1u << 20)
+
+/* Size of the buffer of the other output streams, that write one line per
+ * output. Every inspection point keeps its stream open, so the buffers of
+ * many probes must stay small. */
+
+#define IPOINT_LINE_BUFFER_SIZE (1u << 13)
+
 /******************************************************************************/
 
 void inspection_point_init (InspectionPoint_t *ipoint)
@@ -49,6 +63,7 @@ void inspection_point_init (InspectionPoint_t *ipoint)
     ipoint->Instant          = (OutputInstant_t)  TDICE_OUTPUT_INSTANT_NONE ;
     ipoint->OType            = (OutputType_t)     TDICE_OUTPUT_TYPE_NONE ;
     ipoint->Quantity         = (OutputQuantity_t) TDICE_OUTPUT_QUANTITY_NONE ;
+    ipoint->Format           = (OutputFormat_t)   TDICE_OUTPUT_FORMAT_TEXT ;
     ipoint->Xval             = (ChipDimension_t) 0.0 ;
     ipoint->ActualXval       = (ChipDimension_t) 0.0 ;
     ipoint->Yval             = (ChipDimension_t) 0.0 ;
@@ -57,6 +72,8 @@ void inspection_point_init (InspectionPoint_t *ipoint)
     ipoint->ColumnIndex      = (CellIndex_t) 0u ;
     ipoint->StackElement     = NULL ;
     ipoint->FloorplanElement = NULL ;
+    ipoint->Stream           = NULL ;
+    ipoint->StreamBuffer     = NULL ;
 }
 
 /******************************************************************************/
@@ -68,6 +85,7 @@ void inspection_point_copy (InspectionPoint_t *dst, InspectionPoint_t *src)
     dst->Instant          = src->Instant ;
     dst->OType            = src->OType ;
     dst->Quantity         = src->Quantity ;
+    dst->Format           = src->Format ;
     dst->Xval             = src->Xval ;
     dst->ActualXval       = src->ActualXval ;
     dst->Yval             = src->Yval ;
@@ -84,6 +102,12 @@ void inspection_point_copy (InspectionPoint_t *dst, InspectionPoint_t *src)
 
 void inspection_point_destroy (InspectionPoint_t *ipoint)
 {
+    if (ipoint->Stream != NULL)
+
+        fclose (ipoint->Stream) ;
+
+    free (ipoint->StreamBuffer) ;
+
     string_destroy (&ipoint->FileName) ;
 
     inspection_point_init (ipoint) ;
@@ -136,6 +160,77 @@ void inspection_point_free (InspectionPoint_t *ipoint)
 
 /******************************************************************************/
 
+Error_t inspection_point_flush (InspectionPoint_t *ipoint)
+{
+    if (ipoint->Stream == NULL)
+
+        return TDICE_SUCCESS ;
+
+    if (fflush (ipoint->Stream) != 0)
+    {
+        fprintf (stderr,
+            "Inspection Point: Cannot write output file %s\n",
+            ipoint->FileName);
+
+        return TDICE_FAILURE ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+/* Opens the output file of the inspection point, with \a mode "w" (header)
+ * or "a" (outputs), and gives to its stream a buffer sized for its type of
+ * output. If the stream is already open and \a mode is "a" the function
+ * does nothing. */
+
+static Error_t open_stream (InspectionPoint_t *ipoint, const char *mode)
+{
+    if (ipoint->Stream != NULL)
+    {
+        if (mode [0] == 'a')
+
+            return TDICE_SUCCESS ;
+
+        fclose (ipoint->Stream) ;
+
+        ipoint->Stream = NULL ;
+    }
+
+    ipoint->Stream = fopen (ipoint->FileName, mode) ;
+
+    if (ipoint->Stream == NULL)
+    {
+        fprintf (stderr,
+            "Inspection Point: Cannot open output file %s\n",
+            ipoint->FileName);
+
+        return TDICE_FAILURE ;
+    }
+
+    size_t size =
+
+           ipoint->OType == TDICE_OUTPUT_TYPE_TMAP
+        || ipoint->OType == TDICE_OUTPUT_TYPE_PMAP ?
+
+        IPOINT_MAP_BUFFER_SIZE : IPOINT_LINE_BUFFER_SIZE ;
+
+    if (ipoint->StreamBuffer == NULL)
+
+        ipoint->StreamBuffer = (char *) malloc (size) ;
+
+    // Without the buffer the stream keeps the (small) default one
+
+    if (ipoint->StreamBuffer != NULL)
+
+        setvbuf (ipoint->Stream, ipoint->StreamBuffer, _IOFBF, size) ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
 bool inspection_point_same_filename
 (
     InspectionPoint_t *ipoint,
@@ -250,15 +345,21 @@ void inspection_point_print
 
     if (ipoint->Instant == TDICE_OUTPUT_INSTANT_SLOT)
 
-        fprintf(stream, "slot );\n");
+        fprintf(stream, "slot");
 
     else if (ipoint->Instant == TDICE_OUTPUT_INSTANT_STEP)
 
-        fprintf(stream, "step );\n");
+        fprintf(stream, "step");
 
     else
 
-        fprintf(stream, "final );\n");
+        fprintf(stream, "final");
+
+    if (ipoint->Format == TDICE_OUTPUT_FORMAT_BINARY)
+
+        fprintf(stream, ", binary");
+
+    fprintf(stream, " );\n");
 }
 
 /******************************************************************************/
@@ -346,24 +447,145 @@ bool is_inspection_point
 
 /******************************************************************************/
 
-Error_t generate_inspection_point_header
+/* Writes the header of a binary thermal (or power) map. The layout is
+ * described in inspection_point.h, near generate_inspection_point_header */
+
+static Error_t write_binary_map_header
+(
+    InspectionPoint_t *ipoint,
+    Dimensions_t      *dimensions
+)
+{
+    FILE *stream = ipoint->Stream ;
+
+    CellIndex_t nrows    = get_number_of_rows    (dimensions) ;
+    CellIndex_t ncolumns = get_number_of_columns (dimensions) ;
+
+    uint32_t id_length = (uint32_t) strlen (ipoint->StackElement->Id) ;
+    uint32_t padded    = (id_length + 7u) & ~7u ;
+
+    uint32_t fields [8] ;
+
+    fields [0] = 1u ;
+    fields [1] = ipoint->OType == TDICE_OUTPUT_TYPE_TMAP ? 0u : 1u ;
+    fields [2] = nrows ;
+    fields [3] = ncolumns ;
+    fields [4] = get_source_layer_offset (ipoint->StackElement) ;
+    fields [5] = sizeof (Temperature_t) ;
+    fields [6] = 40u + padded + 2u * (nrows + ncolumns) * sizeof (ChipDimension_t) ;
+    fields [7] = id_length ;
+
+    static const char zeros [8] = { 0 } ;
+
+    if (   fwrite ("3DICEMAP", sizeof (char), 8u, stream) != 8u
+        || fwrite (fields, sizeof (uint32_t), 8u, stream) != 8u
+        || fwrite (ipoint->StackElement->Id, sizeof (char), id_length, stream) != id_length
+        || fwrite (zeros, sizeof (char), padded - id_length, stream) != padded - id_length)
+
+        return TDICE_FAILURE ;
+
+    CellIndex_t index ;
+    ChipDimension_t value ;
+
+    for (index = first_column (dimensions) ; index <= last_column (dimensions) ; index++)
+    {
+        value = get_cell_center_x (dimensions, index) ;
+
+        if (fwrite (&value, sizeof (value), 1u, stream) != 1u) return TDICE_FAILURE ;
+    }
+
+    for (index = first_row (dimensions) ; index <= last_row (dimensions) ; index++)
+    {
+        value = get_cell_center_y (dimensions, index) ;
+
+        if (fwrite (&value, sizeof (value), 1u, stream) != 1u) return TDICE_FAILURE ;
+    }
+
+    for (index = first_column (dimensions) ; index <= last_column (dimensions) ; index++)
+    {
+        value = get_cell_length (dimensions, index) ;
+
+        if (fwrite (&value, sizeof (value), 1u, stream) != 1u) return TDICE_FAILURE ;
+    }
+
+    for (index = first_row (dimensions) ; index <= last_row (dimensions) ; index++)
+    {
+        value = get_cell_width (dimensions, index) ;
+
+        if (fwrite (&value, sizeof (value), 1u, stream) != 1u) return TDICE_FAILURE ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+/* Appends a frame (the time followed by the values of all the cells of the
+ * layer, row by row) to a binary thermal (or power) map */
+
+static Error_t write_binary_map_frame
 (
     InspectionPoint_t *ipoint,
     Dimensions_t      *dimensions,
-    String_t           prefix
+    double            *values,
+    Time_t             current_time
 )
 {
-    FILE *output_stream = fopen (ipoint->FileName, "w") ;
+    values += get_cell_offset_in_stack
+
+        (dimensions,
+         get_source_layer_offset (ipoint->StackElement),
+         first_row (dimensions), first_column (dimensions)) ;
 
-    if (output_stream == NULL)
+    size_t ncells = (size_t) get_number_of_rows (dimensions)
+                  * (size_t) get_number_of_columns (dimensions) ;
+
+    if (   fwrite (&current_time, sizeof (Time_t), 1u, ipoint->Stream) != 1u
+        || fwrite (values, sizeof (double), ncells, ipoint->Stream) != ncells)
     {
         fprintf (stderr,
-            "Inspection Point: Cannot open output file %s\n",
+            "Inspection Point: Cannot write output file %s\n",
             ipoint->FileName);
 
         return TDICE_FAILURE ;
     }
 
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+Error_t generate_inspection_point_header
+(
+    InspectionPoint_t *ipoint,
+    Dimensions_t      *dimensions,
+    String_t           prefix
+)
+{
+    if (ipoint->Format == TDICE_OUTPUT_FORMAT_BINARY)
+    {
+        if (open_stream (ipoint, "wb") != TDICE_SUCCESS)
+
+            return TDICE_FAILURE ;
+
+        if (write_binary_map_header (ipoint, dimensions) != TDICE_SUCCESS)
+        {
+            fprintf (stderr,
+                "Inspection Point: Cannot write output file %s\n",
+                ipoint->FileName);
+
+            return TDICE_FAILURE ;
+        }
+
+        return TDICE_SUCCESS ;
+    }
+
+    if (open_stream (ipoint, "w") != TDICE_SUCCESS)
+
+        return TDICE_FAILURE ;
+
+    FILE *output_stream = ipoint->Stream ;
+
     switch (ipoint->OType)
     {
         case TDICE_OUTPUT_TYPE_TCELL :
@@ -537,20 +759,20 @@ Error_t generate_inspection_point_header
             goto header_error ;
     }
 
-    fclose (output_stream) ;
-
     return TDICE_SUCCESS ;
 
 header_error :
 
     fclose (output_stream) ;
 
+    ipoint->Stream = NULL ;
+
     return TDICE_FAILURE ;
 }
 
 /******************************************************************************/
 
-Error_t generate_inspection_point_output
+Error_t generate_inspection_point_output_shared
 (
     InspectionPoint_t *ipoint,
     Dimensions_t      *dimensions,
@@ -562,17 +784,31 @@ Error_t generate_inspection_point_output
     Quantity_t index, n_flp_el ;
     Temperature_t temperature, *result ;
 
-    FILE *output_stream = fopen (ipoint->FileName, "a") ;
-
-    if (output_stream == NULL)
+    if (ipoint->Format == TDICE_OUTPUT_FORMAT_BINARY)
     {
-        fprintf (stderr,
-            "Inspection Point: Cannot open output file %s\n",
-            ipoint->FileName);
+        if (open_stream (ipoint, "ab") != TDICE_SUCCESS)
 
-        return TDICE_FAILURE ;
+            return TDICE_FAILURE ;
+
+        if (ipoint->OType == TDICE_OUTPUT_TYPE_TMAP)
+
+            return write_binary_map_frame
+
+                (ipoint, dimensions, temperatures, current_time) ;
+
+        else
+
+            return write_binary_map_frame
+
+                (ipoint, dimensions, sources, current_time) ;
     }
 
+    if (open_stream (ipoint, "a") != TDICE_SUCCESS)
+
+        return TDICE_FAILURE ;
+
+    FILE *output_stream = ipoint->Stream ;
+
     switch (ipoint->OType)
     {
         case TDICE_OUTPUT_TYPE_TCELL :
@@ -598,37 +834,12 @@ Error_t generate_inspection_point_output
                  get_source_layer_offset(ipoint->StackElement),
                  first_row (dimensions), first_column (dimensions)) ;
 
-            result = NULL ;
-
-            if (ipoint->Quantity == TDICE_OUTPUT_QUANTITY_MAXIMUM)
-
-                result = get_all_max_temperatures_floorplan
-
-                    (&ipoint->StackElement->Pointer.Die->Floorplan,
-                     dimensions, temperatures, &n_flp_el, NULL) ;
-
-            else if (ipoint->Quantity == TDICE_OUTPUT_QUANTITY_MINIMUM)
-
-                result = get_all_min_temperatures_floorplan
-
-                    (&ipoint->StackElement->Pointer.Die->Floorplan,
-                     dimensions, temperatures, &n_flp_el, NULL) ;
-
-            else if (ipoint->Quantity == TDICE_OUTPUT_QUANTITY_AVERAGE)
-
-                result = get_all_avg_temperatures_floorplan
+            result = get_temperature_statistics_floorplan
 
-                    (&ipoint->StackElement->Pointer.Die->Floorplan,
-                     dimensions, temperatures, &n_flp_el, NULL) ;
+                (&ipoint->StackElement->Pointer.Die->Floorplan,
+                 temperatures, ipoint->Quantity) ;
 
-            else if (ipoint->Quantity == TDICE_OUTPUT_QUANTITY_GRADIENT)
-
-                result = get_all_gradient_temperatures_floorplan
-
-                    (&ipoint->StackElement->Pointer.Die->Floorplan,
-                     dimensions, temperatures, &n_flp_el, NULL) ;
-
-            else
+            if (result == NULL)
             {
                 fprintf (stderr,
                     "Inspection Point: Error reading output quantity for Tflp\n") ;
@@ -636,14 +847,14 @@ Error_t generate_inspection_point_output
                 break ;
             }
 
+            n_flp_el = ipoint->StackElement->Pointer.Die->Floorplan.NElements ;
+
             for (index = 0 ; index != n_flp_el ; index++)
 
                 fprintf (output_stream, "%5.3f \t ", result [index]) ;
 
             fprintf (output_stream, "\n") ;
 
-            free (result) ;
-
             break ;
 
         case TDICE_OUTPUT_TYPE_TFLPEL :
@@ -654,31 +865,12 @@ Error_t generate_inspection_point_output
                  get_source_layer_offset(ipoint->StackElement),
                  first_row (dimensions), first_column (dimensions)) ;
 
-            if (ipoint->Quantity == TDICE_OUTPUT_QUANTITY_MAXIMUM)
-
-                temperature = get_max_temperature_floorplan_element
-
-                    (ipoint->FloorplanElement, dimensions, temperatures) ;
-
-            else if (ipoint->Quantity == TDICE_OUTPUT_QUANTITY_MINIMUM)
-
-                temperature = get_min_temperature_floorplan_element
-
-                    (ipoint->FloorplanElement, dimensions, temperatures) ;
-
-            else if (ipoint->Quantity == TDICE_OUTPUT_QUANTITY_AVERAGE)
-
-                temperature = get_avg_temperature_floorplan_element
-
-                    (ipoint->FloorplanElement, dimensions, temperatures) ;
-
-            else if (ipoint->Quantity == TDICE_OUTPUT_QUANTITY_GRADIENT)
-
-                temperature = get_gradient_temperature_floorplan_element
+            result = get_temperature_statistics_floorplan
 
-                    (ipoint->FloorplanElement, dimensions, temperatures) ;
+                (&ipoint->StackElement->Pointer.Die->Floorplan,
+                 temperatures, ipoint->Quantity) ;
 
-            else
+            if (result == NULL)
             {
                 fprintf (stderr,
                     "Inspection Point: Error reading output quantity for Tflpel\n") ;
@@ -686,6 +878,8 @@ Error_t generate_inspection_point_output
                 break ;
             }
 
+            temperature = result [ipoint->FloorplanElement->Index] ;
+
             fprintf (output_stream,
                 "%5.3f \t %7.3f\n", current_time, temperature) ;
 
@@ -765,20 +959,16 @@ Error_t generate_inspection_point_output
             goto output_error ;
     }
 
-    fclose (output_stream) ;
-
     return TDICE_SUCCESS ;
 
 output_error :
 
-    fclose (output_stream) ;
-
     return TDICE_FAILURE ;
 }
 
 /******************************************************************************/
 
-void fill_message_inspection_point
+void fill_message_inspection_point_shared
 (
     InspectionPoint_t *ipoint,
     OutputQuantity_t   output_quantity,
@@ -812,38 +1002,12 @@ void fill_message_inspection_point
                  get_source_layer_offset(ipoint->StackElement),
                  first_row (dimensions), first_column (dimensions)) ;
 
-            Temperature_t *tmp ;
-            Quantity_t nflp, index ;
-
-            if (output_quantity == TDICE_OUTPUT_QUANTITY_MAXIMUM)
-
-                tmp = get_all_max_temperatures_floorplan
-
-                    (&ipoint->StackElement->Pointer.Die->Floorplan, dimensions,
-                      temperatures, &nflp, NULL) ;
-
-            else if (output_quantity == TDICE_OUTPUT_QUANTITY_MINIMUM)
-
-                tmp = get_all_min_temperatures_floorplan
-
-                    (&ipoint->StackElement->Pointer.Die->Floorplan, dimensions,
-                      temperatures, &nflp, NULL) ;
-
-            else if (output_quantity == TDICE_OUTPUT_QUANTITY_AVERAGE)
+            Temperature_t *tmp = get_temperature_statistics_floorplan
 
-                tmp = get_all_avg_temperatures_floorplan
+                (&ipoint->StackElement->Pointer.Die->Floorplan,
+                 temperatures, output_quantity) ;
 
-                    (&ipoint->StackElement->Pointer.Die->Floorplan, dimensions,
-                      temperatures, &nflp, NULL) ;
-
-            else if (output_quantity == TDICE_OUTPUT_QUANTITY_GRADIENT)
-
-                tmp = get_all_gradient_temperatures_floorplan
-
-                    (&ipoint->StackElement->Pointer.Die->Floorplan, dimensions,
-                      temperatures, &nflp, NULL) ;
-
-            else
+            if (tmp == NULL)
             {
                 fprintf (stderr,
                     "Inspection Point: Error reading output quantity for Tflp\n") ;
@@ -851,17 +1015,18 @@ void fill_message_inspection_point
                 break ;
             }
 
+            Quantity_t nflp = ipoint->StackElement->Pointer.Die->Floorplan.NElements ;
+            Quantity_t index ;
+
             insert_message_word (message, &nflp) ;
 
             for (index = 0 ; index != nflp ; index++)
             {
-                Temperature_t t = tmp [ index ] ;
+                float t = tmp [ index ] ; // A message word stores a float
 
                 insert_message_word (message, &t) ;
             }
 
-            free (tmp) ;
-
             break ;
         }
         case TDICE_OUTPUT_TYPE_TFLPEL :
@@ -873,33 +1038,12 @@ void fill_message_inspection_point
                  first_row (dimensions), first_column (dimensions)) ;
 
 
-            float temperature ;
-
-            if (output_quantity == TDICE_OUTPUT_QUANTITY_MAXIMUM)
+            Temperature_t *tmp = get_temperature_statistics_floorplan
 
-                temperature = get_max_temperature_floorplan_element
+                (&ipoint->StackElement->Pointer.Die->Floorplan,
+                 temperatures, output_quantity) ;
 
-                    (ipoint->FloorplanElement, dimensions, temperatures) ;
-
-            else if (output_quantity == TDICE_OUTPUT_QUANTITY_MINIMUM)
-
-                temperature = get_min_temperature_floorplan_element
-
-                    (ipoint->FloorplanElement, dimensions, temperatures) ;
-
-            else if (output_quantity == TDICE_OUTPUT_QUANTITY_AVERAGE)
-
-                temperature = get_avg_temperature_floorplan_element
-
-                    (ipoint->FloorplanElement, dimensions, temperatures) ;
-
-            else if (output_quantity == TDICE_OUTPUT_QUANTITY_GRADIENT)
-
-                temperature = get_gradient_temperature_floorplan_element
-
-                    (ipoint->FloorplanElement, dimensions, temperatures) ;
-
-            else
+            if (tmp == NULL)
             {
                 fprintf (stderr,
                     "Inspection Point: Error reading output quantity for Tflpel\n") ;
@@ -907,6 +1051,8 @@ void fill_message_inspection_point
                 break ;
             }
 
+            float temperature = tmp [ipoint->FloorplanElement->Index] ;
+
             insert_message_word (message, &temperature) ;
 
             break ;
@@ -1034,3 +1180,171 @@ void fill_message_inspection_point
 }
 
 /******************************************************************************/
+
+/* Marks the thermal cells covered by the ic elements of a floorplan element.
+ * \a marks points to the first cell of the layer of the floorplan. */
+
+static void mark_floorplan_element_cells
+(
+    FloorplanElement_t *flpel,
+    Dimensions_t       *dimensions,
+    bool               *marks
+)
+{
+    ICElementListNode_t *iceln ;
+
+    for (iceln  = ic_element_list_begin (&flpel->ICElements) ;
+         iceln != NULL ;
+         iceln  = ic_element_list_next (iceln))
+    {
+        ICElement_t *icel = ic_element_list_data (iceln) ;
+
+        CellIndex_t row ;
+        CellIndex_t column ;
+
+        for (row = icel->SW_Row ; row <= icel->NE_Row ; row++)
+
+            for (column = icel->SW_Column ; column <= icel->NE_Column ; column++)
+
+                marks [ get_cell_offset_in_layer (dimensions, row, column) ] = true ;
+    }
+}
+
+/******************************************************************************/
+
+Error_t mark_inspection_point_cells
+(
+    InspectionPoint_t *ipoint,
+    Dimensions_t      *dimensions,
+    bool              *marks
+)
+{
+    CellIndex_t row ;
+    CellIndex_t column ;
+
+    if (ipoint->OType == TDICE_OUTPUT_TYPE_PMAP)
+
+        return TDICE_FAILURE ;
+
+    marks += get_cell_offset_in_stack
+
+        (dimensions,
+         get_source_layer_offset (ipoint->StackElement),
+         first_row (dimensions), first_column (dimensions)) ;
+
+    switch (ipoint->OType)
+    {
+        case TDICE_OUTPUT_TYPE_TCELL :
+
+            marks [ get_cell_offset_in_layer
+
+                (dimensions, ipoint->RowIndex, ipoint->ColumnIndex) ] = true ;
+
+            break ;
+
+        case TDICE_OUTPUT_TYPE_TFLP :
+        {
+            FloorplanElementListNode_t *flpeln ;
+
+            for (flpeln  = floorplan_element_list_begin
+
+                               (&ipoint->StackElement->Pointer.Die->Floorplan.ElementsList) ;
+                 flpeln != NULL ;
+                 flpeln  = floorplan_element_list_next (flpeln))
+
+                mark_floorplan_element_cells
+
+                    (floorplan_element_list_data (flpeln), dimensions, marks) ;
+
+            break ;
+        }
+        case TDICE_OUTPUT_TYPE_TFLPEL :
+
+            mark_floorplan_element_cells (ipoint->FloorplanElement, dimensions, marks) ;
+
+            break ;
+
+        case TDICE_OUTPUT_TYPE_TMAP :
+
+            for (row = first_row (dimensions) ; row <= last_row (dimensions) ; row++)
+
+                for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
+
+                    marks [ get_cell_offset_in_layer (dimensions, row, column) ] = true ;
+
+            break ;
+
+        case TDICE_OUTPUT_TYPE_TCOOLANT :
+
+            // The outlet temperatures are read in the last row
+
+            for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
+
+                marks [ get_cell_offset_in_layer (dimensions, last_row (dimensions), column) ] = true ;
+
+            break ;
+
+        default :
+
+            fprintf (stderr, "Error reading inspection point instruction\n") ;
+
+            return TDICE_FAILURE ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+/******************************************************************************/
+
+void invalidate_statistics_inspection_point (InspectionPoint_t *ipoint)
+{
+    if (   ipoint->OType == TDICE_OUTPUT_TYPE_TFLP
+        || ipoint->OType == TDICE_OUTPUT_TYPE_TFLPEL)
+
+        invalidate_temperature_statistics_floorplan
+
+            (&ipoint->StackElement->Pointer.Die->Floorplan) ;
+}
+
+/******************************************************************************/
+
+Error_t generate_inspection_point_output
+(
+    InspectionPoint_t *ipoint,
+    Dimensions_t      *dimensions,
+    Temperature_t     *temperatures,
+    Source_t          *sources,
+    Time_t             current_time
+)
+{
+    // The temperatures may have changed since the previous call
+
+    invalidate_statistics_inspection_point (ipoint) ;
+
+    return generate_inspection_point_output_shared
+
+        (ipoint, dimensions, temperatures, sources, current_time) ;
+}
+
+/******************************************************************************/
+
+void fill_message_inspection_point
+(
+    InspectionPoint_t *ipoint,
+    OutputQuantity_t   output_quantity,
+    Dimensions_t      *dimensions,
+    Temperature_t     *temperatures,
+    Source_t          *sources,
+    NetworkMessage_t  *message
+)
+{
+    invalidate_statistics_inspection_point (ipoint) ;
+
+    fill_message_inspection_point_shared
+
+        (ipoint, output_quantity, dimensions, temperatures, sources, message) ;
+}
+
+/******************************************************************************/
@@ -0,0 +1,576 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <stdio.h>  // For the file type FILE
+#include <stdlib.h> // For the memory functions malloc/free
+#include <string.h> // For the memory functions memcpy/memset
+#include <math.h>   // For the math function sqrt
+
+#include "krylov_solver.h"
+
+/******************************************************************************/
+
+void krylov_solver_init (KrylovSolver_t *ksolver)
+{
+    ksolver->Tolerance      = 1e-10 ;
+    ksolver->MaxIterations  = (Quantity_t) 1000u ;
+    ksolver->Iterations     = (Quantity_t) 0u ;
+    ksolver->Method         = TDICE_SOLVER_BICGSTAB ;
+    ksolver->Size           = (CellIndex_t) 0u ;
+    ksolver->Preconditioner = NULL ;
+    ksolver->Diagonal       = NULL ;
+    ksolver->Work           = NULL ;
+    ksolver->Guess          = NULL ;
+    ksolver->NGuesses       = (Quantity_t) 0u ;
+
+    multigrid_init (&ksolver->Multigrid) ;
+}
+
+/******************************************************************************/
+
+/* Releases the vectors but not the multigrid hierarchy, whose grid
+ * must survive a change of size */
+
+static void free_vectors (KrylovSolver_t *ksolver)
+{
+    free (ksolver->Preconditioner) ;
+    free (ksolver->Diagonal) ;
+    free (ksolver->Work) ;
+    free (ksolver->Guess) ;
+
+    ksolver->Size           = (CellIndex_t) 0u ;
+    ksolver->Preconditioner = NULL ;
+    ksolver->Diagonal       = NULL ;
+    ksolver->Work           = NULL ;
+    ksolver->Guess          = NULL ;
+    ksolver->NGuesses       = (Quantity_t) 0u ;
+}
+
+/******************************************************************************/
+
+void krylov_solver_destroy (KrylovSolver_t *ksolver)
+{
+    double     tolerance      = ksolver->Tolerance ;
+    Quantity_t max_iterations = ksolver->MaxIterations ;
+
+    free_vectors (ksolver) ;
+
+    multigrid_destroy (&ksolver->Multigrid) ;
+
+    krylov_solver_init (ksolver) ;
+
+    ksolver->Tolerance     = tolerance ;
+    ksolver->MaxIterations = max_iterations ;
+}
+
+/******************************************************************************/
+
+Error_t krylov_solver_factorize
+(
+    KrylovSolver_t      *ksolver,
+    SolverType_t         method,
+    CellIndex_t          size,
+    CellIndex_t         *column_pointers,
+    CellIndex_t         *row_indices,
+    SystemMatrixCoeff_t *values
+)
+{
+    CellIndex_t nnz = column_pointers [size] ;
+
+    if (ksolver->Size != size || ksolver->Method != method)
+
+        free_vectors (ksolver) ;
+
+    ksolver->Method = method ;
+
+    if (ksolver->Work == NULL)
+    {
+        ksolver->Size = size ;
+
+        ksolver->Work = (double *) malloc (sizeof (double) * size * 8) ;
+
+        if (method != TDICE_SOLVER_MULTIGRID)
+        {
+            ksolver->Preconditioner = (SystemMatrixCoeff_t *) malloc (sizeof (SystemMatrixCoeff_t) * nnz) ;
+            ksolver->Diagonal       = (CellIndex_t *)         malloc (sizeof (CellIndex_t) * size) ;
+        }
+
+        if (   ksolver->Work == NULL
+            || (   method != TDICE_SOLVER_MULTIGRID
+                && (ksolver->Preconditioner == NULL || ksolver->Diagonal == NULL)))
+        {
+            fprintf (stderr, "Cannot malloc Krylov preconditioner\n") ;
+
+            free_vectors (ksolver) ;
+
+            return TDICE_FAILURE ;
+        }
+    }
+
+    if (method == TDICE_SOLVER_MULTIGRID)
+
+        return multigrid_factorize
+
+            (&ksolver->Multigrid, size, column_pointers, row_indices, values) ;
+
+    SystemMatrixCoeff_t *lu = ksolver->Preconditioner ;
+
+    memcpy (lu, values, sizeof (SystemMatrixCoeff_t) * nnz) ;
+
+    // position [row] is the index in lu of the coefficient (row, j) of
+    // the current column j, or nnz if the coefficient is not stored.
+    // The first work vector is borrowed for it.
+
+    CellIndex_t *position = (CellIndex_t *) ksolver->Work ;
+
+    CellIndex_t row, column, index, other ;
+
+    for (row = 0u ; row != size ; row++)
+
+        position [row] = nnz ;
+
+    for (column = 0u ; column != size ; column++)
+    {
+        CellIndex_t first = column_pointers [column] ;
+        CellIndex_t last  = column_pointers [column + 1] ;
+
+        ksolver->Diagonal [column] = nnz ;
+
+        for (index = first ; index != last ; index++)
+        {
+            if (index != first && row_indices [index] <= row_indices [index - 1])
+            {
+                fprintf (stderr, "ILU: unsorted row indices in column %d\n", column) ;
+
+                return TDICE_FAILURE ;
+            }
+
+            position [row_indices [index]] = index ;
+
+            if (row_indices [index] == column)
+
+                ksolver->Diagonal [column] = index ;
+        }
+
+        if (ksolver->Diagonal [column] == nnz)
+        {
+            fprintf (stderr, "ILU: missing diagonal in column %d\n", column) ;
+
+            return TDICE_FAILURE ;
+        }
+
+        // Left looking update: U(k, column) is final when reached since
+        // rows are sorted, then L(:, k) is applied to the rest of the
+        // column (only on coefficients that belong to the pattern)
+
+        for (index = first ; row_indices [index] < column ; index++)
+        {
+            CellIndex_t k = row_indices [index] ;
+
+            for (other  = ksolver->Diagonal [k] + 1u ;
+                 other != column_pointers [k + 1] ; other++)
+            {
+                CellIndex_t target = position [row_indices [other]] ;
+
+                if (target != nnz)
+
+                    lu [target] -= lu [other] * lu [index] ;
+            }
+        }
+
+        SystemMatrixCoeff_t pivot = lu [ksolver->Diagonal [column]] ;
+
+        if (pivot == 0.0)
+        {
+            fprintf (stderr, "ILU: zero pivot in column %d\n", column) ;
+
+            return TDICE_FAILURE ;
+        }
+
+        for (index = ksolver->Diagonal [column] + 1u ; index != last ; index++)
+
+            lu [index] /= pivot ;
+
+        for (index = first ; index != last ; index++)
+
+            position [row_indices [index]] = nnz ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+/* y = A x */
+
+static void multiply
+(
+    CellIndex_t          size,
+    CellIndex_t         *column_pointers,
+    CellIndex_t         *row_indices,
+    SystemMatrixCoeff_t *values,
+    double              *x,
+    double              *y
+)
+{
+    CellIndex_t column, index ;
+
+    memset (y, 0, sizeof (double) * size) ;
+
+    for (column = 0u ; column != size ; column++)
+
+        for (index = column_pointers [column] ; index != column_pointers [column + 1] ; index++)
+
+            y [row_indices [index]] += values [index] * x [column] ;
+}
+
+/******************************************************************************/
+
+/* z = (LU)^-1 r, or z = one V-cycle on Az = r */
+
+static void precondition
+(
+    KrylovSolver_t *ksolver,
+    CellIndex_t    *column_pointers,
+    CellIndex_t    *row_indices,
+    double         *r,
+    double         *z
+)
+{
+    SystemMatrixCoeff_t *lu = ksolver->Preconditioner ;
+
+    CellIndex_t column, index ;
+
+    if (ksolver->Method == TDICE_SOLVER_MULTIGRID)
+    {
+        multigrid_vcycle (&ksolver->Multigrid, r, z) ;
+
+        return ;
+    }
+
+    memcpy (z, r, sizeof (double) * ksolver->Size) ;
+
+    for (column = 0u ; column != ksolver->Size ; column++)
+
+        for (index = ksolver->Diagonal [column] + 1u ; index != column_pointers [column + 1] ; index++)
+
+            z [row_indices [index]] -= lu [index] * z [column] ;
+
+    for (column = ksolver->Size ; column-- != 0u ; )
+    {
+        z [column] /= lu [ksolver->Diagonal [column]] ;
+
+        for (index = column_pointers [column] ; index != ksolver->Diagonal [column] ; index++)
+
+            z [row_indices [index]] -= lu [index] * z [column] ;
+    }
+}
+
+/******************************************************************************/
+
+static double dot (CellIndex_t size, double *x, double *y)
+{
+    double result = 0.0 ;
+
+    while (size-- != 0u)
+
+        result += *x++ * *y++ ;
+
+    return result ;
+}
+
+/******************************************************************************/
+
+/* y = y + alpha x */
+
+static void axpy (CellIndex_t size, double alpha, double *x, double *y)
+{
+    while (size-- != 0u)
+
+        *y++ += alpha * *x++ ;
+}
+
+/******************************************************************************/
+
+static Error_t bicgstab
+(
+    KrylovSolver_t      *ksolver,
+    CellIndex_t         *column_pointers,
+    CellIndex_t         *row_indices,
+    SystemMatrixCoeff_t *values,
+    double              *b,
+    double              *x
+)
+{
+    CellIndex_t size = ksolver->Size, i ;
+
+    double *r    = ksolver->Work ;
+    double *rhat = r    + size ;
+    double *p    = rhat + size ;
+    double *v    = p    + size ;
+    double *s    = v    + size ;
+    double *t    = s    + size ;
+    double *phat = t    + size ;
+    double *shat = phat + size ;
+
+    double threshold = ksolver->Tolerance * sqrt (dot (size, b, b)) ;
+
+    double rho = 1.0, alpha = 1.0, omega = 1.0 ;
+
+    multiply (size, column_pointers, row_indices, values, x, r) ;
+
+    for (i = 0u ; i != size ; i++)
+    {
+        r [i]    = b [i] - r [i] ;
+        rhat [i] = r [i] ;
+        p [i]    = 0.0 ;
+        v [i]    = 0.0 ;
+    }
+
+    for (ksolver->Iterations = 0u ;
+         ksolver->Iterations != ksolver->MaxIterations ;
+         ksolver->Iterations++)
+    {
+        if (sqrt (dot (size, r, r)) <= threshold)
+
+            return TDICE_SUCCESS ;
+
+        double rho_new = dot (size, rhat, r) ;
+
+        if (rho_new == 0.0 || omega == 0.0)
+
+            break ;
+
+        double beta = (rho_new / rho) * (alpha / omega) ;
+
+        rho = rho_new ;
+
+        for (i = 0u ; i != size ; i++)
+
+            p [i] = r [i] + beta * (p [i] - omega * v [i]) ;
+
+        precondition (ksolver, column_pointers, row_indices, p, phat) ;
+
+        multiply (size, column_pointers, row_indices, values, phat, v) ;
+
+        alpha = rho / dot (size, rhat, v) ;
+
+        for (i = 0u ; i != size ; i++)
+
+            s [i] = r [i] - alpha * v [i] ;
+
+        axpy (size, alpha, phat, x) ;
+
+        if (sqrt (dot (size, s, s)) <= threshold)
+        {
+            ksolver->Iterations++ ;
+
+            return TDICE_SUCCESS ;
+        }
+
+        precondition (ksolver, column_pointers, row_indices, s, shat) ;
+
+        multiply (size, column_pointers, row_indices, values, shat, t) ;
+
+        double tt = dot (size, t, t) ;
+
+        omega = tt == 0.0 ? 0.0 : dot (size, t, s) / tt ;
+
+        axpy (size, omega, shat, x) ;
+
+        for (i = 0u ; i != size ; i++)
+
+            r [i] = s [i] - omega * t [i] ;
+    }
+
+    return TDICE_FAILURE ;
+}
+
+/******************************************************************************/
+
+static Error_t pcg
+(
+    KrylovSolver_t      *ksolver,
+    CellIndex_t         *column_pointers,
+    CellIndex_t         *row_indices,
+    SystemMatrixCoeff_t *values,
+    double              *b,
+    double              *x
+)
+{
+    CellIndex_t size = ksolver->Size, i ;
+
+    double *r = ksolver->Work ;
+    double *z = r + size ;
+    double *p = z + size ;
+    double *q = p + size ;
+
+    double threshold = ksolver->Tolerance * sqrt (dot (size, b, b)) ;
+
+    multiply (size, column_pointers, row_indices, values, x, r) ;
+
+    for (i = 0u ; i != size ; i++)
+
+        r [i] = b [i] - r [i] ;
+
+    precondition (ksolver, column_pointers, row_indices, r, z) ;
+
+    memcpy (p, z, sizeof (double) * size) ;
+
+    double rz = dot (size, r, z) ;
+
+    for (ksolver->Iterations = 0u ;
+         ksolver->Iterations != ksolver->MaxIterations ;
+         ksolver->Iterations++)
+    {
+        if (sqrt (dot (size, r, r)) <= threshold)
+
+            return TDICE_SUCCESS ;
+
+        multiply (size, column_pointers, row_indices, values, p, q) ;
+
+        double pq = dot (size, p, q) ;
+
+        if (pq == 0.0)
+
+            break ;
+
+        double alpha = rz / pq ;
+
+        axpy (size,  alpha, p, x) ;
+        axpy (size, -alpha, q, r) ;
+
+        precondition (ksolver, column_pointers, row_indices, r, z) ;
+
+        double rz_new = dot (size, r, z) ;
+
+        for (i = 0u ; i != size ; i++)
+
+            p [i] = z [i] + (rz_new / rz) * p [i] ;
+
+        rz = rz_new ;
+    }
+
+    return TDICE_FAILURE ;
+}
+
+/******************************************************************************/
+
+Error_t krylov_solver_solve
+(
+    KrylovSolver_t      *ksolver,
+    CellIndex_t         *column_pointers,
+    CellIndex_t         *row_indices,
+    SystemMatrixCoeff_t *values,
+    double              *b,
+    Quantity_t           nrhs,
+    CellIndex_t          ldb
+)
+{
+    CellIndex_t size = ksolver->Size ;
+
+    if (ksolver->Work == NULL)
+    {
+        fprintf (stderr, "Krylov solver used before factorization\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    // One initial guess for every right hand side. New columns start from 0
+
+    if (nrhs > ksolver->NGuesses)
+    {
+        double *guess = (double *) realloc (ksolver->Guess, sizeof (double) * size * nrhs) ;
+
+        if (guess == NULL)
+        {
+            fprintf (stderr, "Cannot malloc Krylov initial guess\n") ;
+
+            return TDICE_FAILURE ;
+        }
+
+        memset (guess + (size_t) size * ksolver->NGuesses, 0,
+                sizeof (double) * size * (nrhs - ksolver->NGuesses)) ;
+
+        ksolver->Guess    = guess ;
+        ksolver->NGuesses = nrhs ;
+    }
+
+    Quantity_t rhs ;
+
+    for (rhs = 0u ; rhs != nrhs ; rhs++)
+    {
+        double *x  = ksolver->Guess + (size_t) rhs * size ;
+        double *bc = b + (size_t) rhs * ldb ;
+
+        // The threshold of the methods is relative to the norm of b: with
+        // b = 0 it would be 0 and the methods could never stop. The
+        // solution is x = 0, already in bc
+
+        if (dot (size, bc, bc) == 0.0)
+        {
+            memset (x, 0, sizeof (double) * size) ;
+
+            ksolver->Iterations = 0u ;
+
+            continue ;
+        }
+
+        Error_t result = ksolver->Method == TDICE_SOLVER_PCG
+
+            ? pcg      (ksolver, column_pointers, row_indices, values, bc, x)
+            : bicgstab (ksolver, column_pointers, row_indices, values, bc, x) ;
+
+        if (result == TDICE_FAILURE)
+        {
+            fprintf (stderr,
+                "Krylov solver did not converge in %d iterations\n",
+                ksolver->Iterations) ;
+
+            memset (x, 0, sizeof (double) * size) ;
+
+            return TDICE_FAILURE ;
+        }
+
+        memcpy (bc, x, sizeof (double) * size) ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
@@ -53,6 +53,9 @@ void layer_init (Layer_t *layer)
     material_init (&layer->Material) ;
 
     material_element_list_init (&layer->MaterialLayout) ;
+
+    layer->MaterialMap     = NULL ;
+    layer->LayoutMaterials = NULL ;
 }
 
 /******************************************************************************/
@@ -82,6 +85,9 @@ void layer_destroy (Layer_t *layer)
 
     material_element_list_destroy (&layer->MaterialLayout) ;
 
+    free (layer->MaterialMap) ;
+    free (layer->LayoutMaterials) ;
+
     layer_init (layer) ;
 }
 
@@ -179,6 +185,89 @@ Error_t fill_layout
 
 /******************************************************************************/
 
+Error_t layer_build_material_map (Layer_t *layer, Dimensions_t *dimensions)
+{
+    free (layer->MaterialMap) ;
+    free (layer->LayoutMaterials) ;
+
+    layer->MaterialMap     = NULL ;
+    layer->LayoutMaterials = NULL ;
+
+    if (layer->MaterialLayout.Size == 0u)
+
+        return TDICE_SUCCESS ;
+
+    CellIndex_t nrows    = get_number_of_rows    (dimensions) ;
+    CellIndex_t ncolumns = get_number_of_columns (dimensions) ;
+
+    layer->MaterialMap     = (Quantity_t *)  calloc (nrows * ncolumns, sizeof (Quantity_t)) ;
+    layer->LayoutMaterials = (Material_t **) malloc (sizeof (Material_t *) * layer->MaterialLayout.Size) ;
+
+    if (layer->MaterialMap == NULL || layer->LayoutMaterials == NULL)
+    {
+        fprintf (stderr, "Cannot malloc material map\n") ;
+
+        free (layer->MaterialMap) ;
+        free (layer->LayoutMaterials) ;
+
+        layer->MaterialMap     = NULL ;
+        layer->LayoutMaterials = NULL ;
+
+        return TDICE_FAILURE ;
+    }
+
+    // Elements are visited in the order of the list and a cell keeps the
+    // first material found, as the scan in get_material_at_location
+
+    Quantity_t index = 0u ;
+
+    MaterialElementListNode_t *melementn ;
+
+    for (melementn  = material_element_list_begin (&layer->MaterialLayout) ;
+         melementn != NULL ;
+         melementn  = material_element_list_next (melementn))
+    {
+        MaterialElement_t *melement = material_element_list_data (melementn) ;
+
+        layer->LayoutMaterials [index++] = &melement->Material ;
+
+        ICElementListNode_t *icelementn ;
+
+        for (icelementn  = ic_element_list_begin (&melement->MElements) ;
+             icelementn != NULL ;
+             icelementn  = ic_element_list_next (icelementn))
+        {
+            ICElement_t *icelement = ic_element_list_data (icelementn) ;
+
+            CellIndex_t row, column ;
+
+            for (row = first_row (dimensions) ; row <= last_row (dimensions) ; row++)
+            {
+                CellDimension_t celly = get_cell_center_y (dimensions, row) ;
+
+                if (celly < icelement->SW_Y || celly >= icelement->SW_Y + icelement->Width)
+
+                    continue ;
+
+                for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
+                {
+                    Quantity_t *cell = layer->MaterialMap + row * ncolumns + column ;
+
+                    if (*cell == 0u && ic_element_has_center
+
+                            (icelement, get_cell_center_x (dimensions, column), celly) == true)
+
+                        *cell = index ;
+                }
+            }
+        }
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
 SolidTC_t get_thermal_conductivity
 (
     Layer_t      *layer,
@@ -189,6 +278,17 @@ SolidTC_t get_thermal_conductivity
 {
     Material_t *tmp = NULL ;
 
+    if (layer->MaterialMap != NULL)
+    {
+        Quantity_t index = layer->MaterialMap
+
+            [row_index * get_number_of_columns (dimensions) + column_index] ;
+
+        tmp = index == 0u ? &layer->Material : layer->LayoutMaterials [index - 1u] ;
+
+        return tmp->ThermalConductivity ;
+    }
+
     MaterialElementListNode_t *melementn ;
 
     for (melementn  = material_element_list_begin (&layer->MaterialLayout) ;
@@ -217,6 +317,17 @@ SolidTC_t get_volumetric_heat_capacity
 {
     Material_t *tmp = NULL ;
 
+    if (layer->MaterialMap != NULL)
+    {
+        Quantity_t index = layer->MaterialMap
+
+            [row_index * get_number_of_columns (dimensions) + column_index] ;
+
+        tmp = index == 0u ? &layer->Material : layer->LayoutMaterials [index - 1u] ;
+
+        return tmp->VolumetricHeatCapacity ;
+    }
+
     MaterialElementListNode_t *melementn ;
 
     for (melementn  = material_element_list_begin (&layer->MaterialLayout) ;
@@ -0,0 +1,1693 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <stdio.h>   // For the file type FILE
+#include <stdlib.h>  // For the memory functions malloc/free and qsort
+#include <string.h>  // For the memory functions memset/memcpy
+#include <math.h>    // For the math functions sqrt and fabs
+#include <float.h>   // For the constant DBL_EPSILON
+#include <pthread.h> // For the thread functions pthread_create/join
+#include <stdbool.h> // For the type bool
+
+#include "multifrontal.h"
+#include "macros.h"
+
+/* Subtrees of the elimination tree with fewer nodes than this are merged
+ * in a single supernode (as the relaxed supernodes of SuperLU) */
+
+#define MULTIFRONTAL_RELAX 16u
+
+/* Number of columns of a front factorized before updating the others */
+
+#define MULTIFRONTAL_BLOCK 64u
+
+/* Minimum number of multiply-add operations of the update of a block of
+ * columns of a front for splitting it between several threads */
+
+#define MULTIFRONTAL_PARALLEL_WORK 4194304.0
+
+/******************************************************************************/
+
+void multifrontal_solver_init (MultifrontalSolver_t *msolver)
+{
+    msolver->NThreads         = (Quantity_t) 1u ;
+    msolver->Symmetric        = false ;
+    msolver->SinglePrecision  = false ;
+    msolver->Size             = (CellIndex_t) 0u ;
+    msolver->Ordering         = NULL ;
+    msolver->NSupernodes      = (Quantity_t) 0u ;
+    msolver->SupernodeColumns = NULL ;
+    msolver->Parents          = NULL ;
+    msolver->FrontPointers    = NULL ;
+    msolver->FrontRows        = NULL ;
+    msolver->ParentPositions  = NULL ;
+    msolver->FactorPointers   = NULL ;
+    msolver->Factors          = NULL ;
+    msolver->SingleFactors    = NULL ;
+    msolver->EntryPointers    = NULL ;
+    msolver->EntryIndices     = NULL ;
+    msolver->EntryValues      = NULL ;
+    msolver->Work             = NULL ;
+    msolver->FactorSize       = (size_t) 0u ;
+    msolver->Flops            = 0.0 ;
+}
+
+/******************************************************************************/
+
+void multifrontal_solver_destroy (MultifrontalSolver_t *msolver)
+{
+    Quantity_t nthreads  = msolver->NThreads ;
+    bool       symmetric = msolver->Symmetric ;
+    bool       single    = msolver->SinglePrecision ;
+
+    free (msolver->Ordering) ;
+    free (msolver->SupernodeColumns) ;
+    free (msolver->Parents) ;
+    free (msolver->FrontPointers) ;
+    free (msolver->FrontRows) ;
+    free (msolver->ParentPositions) ;
+    free (msolver->FactorPointers) ;
+    free (msolver->Factors) ;
+    free (msolver->SingleFactors) ;
+    free (msolver->EntryPointers) ;
+    free (msolver->EntryIndices) ;
+    free (msolver->EntryValues) ;
+    free (msolver->Work) ;
+
+    multifrontal_solver_init (msolver) ;
+
+    msolver->NThreads        = nthreads ;
+    msolver->Symmetric       = symmetric ;
+    msolver->SinglePrecision = single ;
+}
+
+/******************************************************************************/
+
+/* Builds the adjacency lists of the pattern of A + A' (diagonal excluded,
+ * no duplicates) with the rows and the columns of A moved to \a position */
+
+static Error_t build_graph
+(
+    CellIndex_t   size,
+    CellIndex_t  *column_pointers,
+    CellIndex_t  *row_indices,
+    CellIndex_t  *position,
+    size_t      **pointers,
+    CellIndex_t **neighbours
+)
+{
+    size_t       nnz   = (size_t) column_pointers [size] ;
+    size_t      *ptr   = (size_t *)      calloc (size + 1u, sizeof (size_t)) ;
+    size_t      *next  = (size_t *)      malloc (sizeof (size_t) * (size + 1u)) ;
+    CellIndex_t *adj   = (CellIndex_t *) malloc (sizeof (CellIndex_t) * MAX (2u * nnz, 1u)) ;
+    CellIndex_t *mark  = (CellIndex_t *) malloc (sizeof (CellIndex_t) * MAX (size, 1u)) ;
+
+    if (ptr == NULL || next == NULL || adj == NULL || mark == NULL)
+    {
+        free (ptr) ; free (next) ; free (adj) ; free (mark) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    CellIndex_t column, node ;
+    size_t      index, count = 0u ;
+
+    for (column = 0u ; column != size ; column++)
+
+        for (index = column_pointers [column] ; index != column_pointers [column + 1] ; index++)
+
+            if (row_indices [index] != column)
+            {
+                ptr [position [row_indices [index]] + 1u]++ ;
+                ptr [position [column] + 1u]++ ;
+            }
+
+    for (node = 0u ; node != size ; node++)
+
+        ptr [node + 1u] += ptr [node] ;
+
+    memcpy (next, ptr, sizeof (size_t) * (size + 1u)) ;
+
+    for (column = 0u ; column != size ; column++)
+
+        for (index = column_pointers [column] ; index != column_pointers [column + 1] ; index++)
+
+            if (row_indices [index] != column)
+            {
+                CellIndex_t row = position [row_indices [index]] ;
+                CellIndex_t col = position [column] ;
+
+                adj [next [row]++] = col ;
+                adj [next [col]++] = row ;
+            }
+
+    // Removes the duplicates (both A(i,j) and A(j,i) are usually stored)
+
+    for (node = 0u ; node != size ; node++)
+
+        mark [node] = size ;
+
+    for (node = 0u ; node != size ; node++)
+    {
+        size_t begin = ptr [node] ;
+
+        ptr [node] = count ;
+
+        for (index = begin ; index != next [node] ; index++)
+
+            if (mark [adj [index]] != node)
+            {
+                mark [adj [index]] = node ;
+
+                adj [count++] = adj [index] ;
+            }
+    }
+
+    ptr [size] = count ;
+
+    free (next) ;
+    free (mark) ;
+
+    *pointers   = ptr ;
+    *neighbours = adj ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+/* Computes the elimination tree of a symmetric pattern (Liu's algorithm with
+ * path compression). \a size is the parent of the roots */
+
+static void elimination_tree
+(
+    CellIndex_t  size,
+    size_t      *pointers,
+    CellIndex_t *neighbours,
+    CellIndex_t *parent,
+    CellIndex_t *ancestor
+)
+{
+    CellIndex_t node ;
+    size_t      index ;
+
+    for (node = 0u ; node != size ; node++)
+    {
+        parent   [node] = size ;
+        ancestor [node] = size ;
+
+        for (index = pointers [node] ; index != pointers [node + 1u] ; index++)
+        {
+            CellIndex_t other = neighbours [index] ;
+
+            if (other >= node)
+
+                continue ;
+
+            while (ancestor [other] != size && ancestor [other] != node)
+            {
+                CellIndex_t next = ancestor [other] ;
+
+                ancestor [other] = node ;
+
+                other = next ;
+            }
+
+            if (ancestor [other] == size)
+            {
+                ancestor [other] = node ;
+                parent   [other] = node ;
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+
+/* Computes the position of every node of the tree in a postorder (children
+ * visited in increasing order) */
+
+static void tree_postorder
+(
+    CellIndex_t  size,
+    CellIndex_t *parent,
+    CellIndex_t *position,
+    CellIndex_t *head,
+    CellIndex_t *next,
+    CellIndex_t *stack
+)
+{
+    CellIndex_t node, counter = 0u ;
+
+    for (node = 0u ; node != size ; node++)
+
+        head [node] = size ;
+
+    for (node = size ; node-- != 0u ; )
+
+        if (parent [node] != size)
+        {
+            next [node]          = head [parent [node]] ;
+            head [parent [node]] = node ;
+        }
+
+    for (node = 0u ; node != size ; node++)
+    {
+        if (parent [node] != size)
+
+            continue ;
+
+        CellIndex_t top = 0u ;
+
+        stack [top++] = node ;
+
+        while (top != 0u)
+        {
+            CellIndex_t current = stack [top - 1u] ;
+            CellIndex_t child   = head [current] ;
+
+            if (child == size)
+            {
+                position [current] = counter++ ;
+
+                top-- ;
+            }
+            else
+            {
+                head  [current] = next [child] ;
+                stack [top++]   = child ;
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+
+static int compare_cell_index (const void *a, const void *b)
+{
+    CellIndex_t x = *(const CellIndex_t *) a ;
+    CellIndex_t y = *(const CellIndex_t *) b ;
+
+    return (x > y) - (x < y) ;
+}
+
+/******************************************************************************/
+
+/* Computes the supernodes, the fronts and the assembly of the coefficients
+ * of the matrix. The arrays of the solver are allocated here */
+
+static Error_t analyze
+(
+    MultifrontalSolver_t *msolver,
+    CellIndex_t           size,
+    CellIndex_t          *column_pointers,
+    CellIndex_t          *row_indices,
+    int                  *ordering
+)
+{
+    Error_t result = TDICE_FAILURE ;
+
+    CellIndex_t *position = (CellIndex_t *) malloc (sizeof (CellIndex_t) * size) ;
+    CellIndex_t *parent   = (CellIndex_t *) malloc (sizeof (CellIndex_t) * size) ;
+    CellIndex_t *work1    = (CellIndex_t *) malloc (sizeof (CellIndex_t) * size) ;
+    CellIndex_t *work2    = (CellIndex_t *) malloc (sizeof (CellIndex_t) * size) ;
+    CellIndex_t *work3    = (CellIndex_t *) malloc (sizeof (CellIndex_t) * size) ;
+    CellIndex_t *counts   = (CellIndex_t *) malloc (sizeof (CellIndex_t) * size) ;
+    CellIndex_t *snodes   = (CellIndex_t *) malloc (sizeof (CellIndex_t) * size) ;
+    size_t      *pointers   = NULL ;
+    CellIndex_t *neighbours = NULL ;
+    size_t      *children   = NULL ;
+    Quantity_t  *child_list = NULL ;
+
+    msolver->Ordering         = (CellIndex_t *) malloc (sizeof (CellIndex_t) * size) ;
+    msolver->SupernodeColumns = (CellIndex_t *) malloc (sizeof (CellIndex_t) * (size + 1u)) ;
+    msolver->EntryPointers    = (size_t *)      calloc (2u * (size_t) size + 1u, sizeof (size_t)) ;
+    msolver->Work             = (double *)      malloc (sizeof (double) * size) ;
+
+    if (   position == NULL || parent == NULL || counts == NULL || snodes == NULL
+        || work1 == NULL || work2 == NULL || work3 == NULL
+        || msolver->Ordering == NULL || msolver->SupernodeColumns == NULL
+        || msolver->EntryPointers == NULL || msolver->Work == NULL)
+
+        goto release ;
+
+    CellIndex_t node, other ;
+    size_t      index ;
+
+    for (node = 0u ; node != size ; node++)
+    {
+        if (ordering [node] < 0 || (CellIndex_t) ordering [node] >= size)
+        {
+            fprintf (stderr, "Multifrontal: wrong ordering\n") ;
+
+            goto release ;
+        }
+
+        position [node] = (CellIndex_t) ordering [node] ;
+    }
+
+    /* The ordering is followed by a postorder of its elimination tree, so
+     * that every subtree is a range of consecutive columns */
+
+    if (build_graph (size, column_pointers, row_indices, position, &pointers, &neighbours) != TDICE_SUCCESS)
+
+        goto release ;
+
+    elimination_tree (size, pointers, neighbours, parent, work1) ;
+
+    tree_postorder (size, parent, work1, work2, work3, counts) ;
+
+    for (node = 0u ; node != size ; node++)
+
+        position [node] = work1 [position [node]] ;
+
+    free (pointers) ;
+    free (neighbours) ;
+
+    if (build_graph (size, column_pointers, row_indices, position, &pointers, &neighbours) != TDICE_SUCCESS)
+    {
+        pointers = NULL ; neighbours = NULL ;
+
+        goto release ;
+    }
+
+    elimination_tree (size, pointers, neighbours, parent, work1) ;
+
+    for (node = 0u ; node != size ; node++)
+
+        msolver->Ordering [position [node]] = node ;
+
+    /* Column counts of the factor L (row subtrees) */
+
+    CellIndex_t *mark = work1 ;
+
+    for (node = 0u ; node != size ; node++)
+    {
+        counts [node] = 1u ;
+        mark   [node] = size ;
+    }
+
+    for (node = 0u ; node != size ; node++)
+    {
+        mark [node] = node ;
+
+        for (index = pointers [node] ; index != pointers [node + 1u] ; index++)
+
+            for (other = neighbours [index] ;
+                 other < node && mark [other] != node ;
+                 other = parent [other])
+            {
+                counts [other]++ ;
+                mark   [other] = node ;
+            }
+    }
+
+    /* Supernodes: relaxed subtrees first, then chains of columns with
+     * the same pattern */
+
+    CellIndex_t *descendants = work2 ;
+    CellIndex_t *nchildren   = work3 ;
+    CellIndex_t *relax_end   = mark ;
+
+    for (node = 0u ; node != size ; node++)
+    {
+        descendants [node] = 0u ;
+        nchildren   [node] = 0u ;
+        relax_end   [node] = size ;
+    }
+
+    for (node = 0u ; node != size ; node++)
+
+        if (parent [node] != size)
+        {
+            descendants [parent [node]] += descendants [node] + 1u ;
+            nchildren   [parent [node]]++ ;
+        }
+
+    node = 0u ;
+
+    while (node < size)
+    {
+        CellIndex_t start = node ;
+
+        while (parent [node] != size && descendants [parent [node]] < MULTIFRONTAL_RELAX)
+
+            node = parent [node] ;
+
+        relax_end [start] = node++ ;
+
+        while (node < size && descendants [node] != 0u)
+
+            node++ ;
+    }
+
+    Quantity_t nsnodes = 0u ;
+
+    node = 0u ;
+
+    while (node < size)
+    {
+        msolver->SupernodeColumns [nsnodes] = node ;
+
+        if (relax_end [node] != size)
+
+            node = relax_end [node] ;
+
+        else
+
+            while (   node + 1u < size
+                   && parent    [node]      == node + 1u
+                   && nchildren [node + 1u] == 1u
+                   && counts    [node]      == counts [node + 1u] + 1u
+                   && relax_end [node + 1u] == size)
+
+                node++ ;
+
+        for (other = msolver->SupernodeColumns [nsnodes] ; other <= node ; other++)
+
+            snodes [other] = nsnodes ;
+
+        node++ ;
+        nsnodes++ ;
+    }
+
+    msolver->SupernodeColumns [nsnodes] = size ;
+    msolver->NSupernodes                = nsnodes ;
+
+    msolver->Parents        = (Quantity_t *) malloc (sizeof (Quantity_t) * MAX (nsnodes, 1u)) ;
+    msolver->FrontPointers  = (size_t *)     malloc (sizeof (size_t) * (nsnodes + 1u)) ;
+    msolver->FactorPointers = (size_t *)     malloc (sizeof (size_t) * (nsnodes + 1u)) ;
+    children                = (size_t *)     calloc (nsnodes + 1u, sizeof (size_t)) ;
+    child_list              = (Quantity_t *) malloc (sizeof (Quantity_t) * MAX (nsnodes, 1u)) ;
+
+    if (   msolver->Parents == NULL || msolver->FrontPointers == NULL
+        || msolver->FactorPointers == NULL || children == NULL || child_list == NULL)
+
+        goto release ;
+
+    Quantity_t snode, child ;
+
+    for (snode = 0u ; snode != nsnodes ; snode++)
+    {
+        CellIndex_t last = msolver->SupernodeColumns [snode + 1u] - 1u ;
+
+        msolver->Parents [snode] =
+
+            parent [last] == size ? nsnodes : snodes [parent [last]] ;
+
+        if (msolver->Parents [snode] != nsnodes)
+
+            children [msolver->Parents [snode] + 1u]++ ;
+    }
+
+    for (snode = 0u ; snode != nsnodes ; snode++)
+
+        children [snode + 1u] += children [snode] ;
+
+    for (snode = 0u ; snode != nsnodes ; snode++)
+
+        if (msolver->Parents [snode] != nsnodes)
+
+            child_list [children [msolver->Parents [snode]]++] = snode ;
+
+    for (snode = nsnodes ; snode != 0u ; snode--)
+
+        children [snode] = children [snode - 1u] ;
+
+    children [0] = 0u ;
+
+    /* Rows of the fronts: the columns of the supernode, the rows of the
+     * matrix below them and the rows of the update matrices of the
+     * children. The rows of the parent front are numbered first */
+
+    size_t capacity = (size_t) size + 1u, used = 0u ;
+
+    msolver->FrontRows = (CellIndex_t *) malloc (sizeof (CellIndex_t) * capacity) ;
+
+    if (msolver->FrontRows == NULL)
+
+        goto release ;
+
+    for (node = 0u ; node != size ; node++)
+
+        mark [node] = (CellIndex_t) nsnodes ;
+
+    msolver->FactorPointers [0] = 0u ;
+    msolver->Flops              = 0.0 ;
+
+    for (snode = 0u ; snode != nsnodes ; snode++)
+    {
+        CellIndex_t first = msolver->SupernodeColumns [snode] ;
+        CellIndex_t last  = msolver->SupernodeColumns [snode + 1u] - 1u ;
+        size_t      bound = last - first + 1u ;
+
+        for (node = first ; node <= last ; node++)
+
+            bound += pointers [node + 1u] - pointers [node] ;
+
+        for (index = children [snode] ; index != children [snode + 1u] ; index++)
+
+            bound += msolver->FrontPointers [child_list [index] + 1u]
+                     - msolver->FrontPointers [child_list [index]] ;
+
+        if (used + bound > capacity)
+        {
+            capacity = MAX (2u * capacity, used + bound) ;
+
+            CellIndex_t *rows = (CellIndex_t *) realloc
+
+                (msolver->FrontRows, sizeof (CellIndex_t) * capacity) ;
+
+            if (rows == NULL)
+
+                goto release ;
+
+            msolver->FrontRows = rows ;
+        }
+
+        CellIndex_t *rows = msolver->FrontRows ;
+
+        msolver->FrontPointers [snode] = used ;
+
+        for (node = first ; node <= last ; node++)
+        {
+            rows [used++] = node ;
+            mark [node]   = (CellIndex_t) snode ;
+        }
+
+        size_t below = used ;
+
+        for (node = first ; node <= last ; node++)
+
+            for (index = pointers [node] ; index != pointers [node + 1u] ; index++)
+            {
+                other = neighbours [index] ;
+
+                if (other > last && mark [other] != snode)
+                {
+                    rows [used++] = other ;
+                    mark [other]  = (CellIndex_t) snode ;
+                }
+            }
+
+        for (index = children [snode] ; index != children [snode + 1u] ; index++)
+        {
+            size_t row ;
+
+            child = child_list [index] ;
+
+            for (row  = msolver->FrontPointers [child] ;
+                 row != msolver->FrontPointers [child + 1u] ; row++)
+            {
+                other = rows [row] ;
+
+                if (other > last && mark [other] != snode)
+                {
+                    rows [used++] = other ;
+                    mark [other]  = (CellIndex_t) snode ;
+                }
+            }
+        }
+
+        qsort (rows + below, used - below, sizeof (CellIndex_t), compare_cell_index) ;
+
+        // The front of a supernode ends where the next one begins
+
+        msolver->FrontPointers [snode + 1u] = used ;
+
+        size_t ncolumns = last - first + 1u ;
+        size_t nrows    = used - msolver->FrontPointers [snode] ;
+
+        // The Cholesky factor is the lower trapezoid of the panel
+
+        msolver->FactorPointers [snode + 1u] = msolver->FactorPointers [snode] +
+
+            (msolver->Symmetric == true ? ncolumns * nrows - ncolumns * (ncolumns - 1u) / 2u
+                                        : ncolumns * (2u * nrows - ncolumns)) ;
+
+        for (index = 0u ; index != ncolumns ; index++)
+        {
+            double trailing = (double) (nrows - index - 1u) ;
+
+            msolver->Flops += msolver->Symmetric == true ?
+
+                trailing + trailing * (trailing + 1.0) : trailing + 2.0 * trailing * trailing ;
+        }
+    }
+
+    msolver->FactorSize = msolver->FactorPointers [nsnodes] ;
+
+    msolver->ParentPositions = (CellIndex_t *) malloc (sizeof (CellIndex_t) * MAX (used, 1u)) ;
+
+    if (msolver->SinglePrecision == true)
+
+        msolver->SingleFactors = (float *)  malloc (sizeof (float)  * MAX (msolver->FactorSize, 1u)) ;
+
+    else
+
+        msolver->Factors       = (double *) malloc (sizeof (double) * MAX (msolver->FactorSize, 1u)) ;
+
+    if (   msolver->ParentPositions == NULL
+        || (msolver->Factors == NULL && msolver->SingleFactors == NULL))
+    {
+        fprintf (stderr, "Multifrontal: cannot malloc %zu coefficients of the factors\n",
+                 msolver->FactorSize) ;
+
+        goto release ;
+    }
+
+    /* Positions of the rows of the children in the front of the parent */
+
+    for (snode = 0u ; snode != nsnodes ; snode++)
+    {
+        size_t row, begin = msolver->FrontPointers [snode] ;
+
+        for (row = begin ; row != msolver->FrontPointers [snode + 1u] ; row++)
+
+            position [msolver->FrontRows [row]] = (CellIndex_t) (row - begin) ;
+
+        for (index = children [snode] ; index != children [snode + 1u] ; index++)
+        {
+            child = child_list [index] ;
+
+            for (row  = msolver->FrontPointers [child] ;
+                 row != msolver->FrontPointers [child + 1u] ; row++)
+
+                msolver->ParentPositions [row] = position [msolver->FrontRows [row]] ;
+        }
+    }
+
+    /* Coefficients of the matrix assembled in each front: column c from the
+     * first row of its supernode, row c after the last column of its
+     * supernode (only the lower triangle if the matrix is symmetric).
+     * Position now maps rows to (permuted) columns */
+
+    CellIndex_t column ;
+
+    for (node = 0u ; node != size ; node++)
+
+        position [msolver->Ordering [node]] = node ;
+
+    size_t *entries = msolver->EntryPointers ;
+
+    for (column = 0u ; column != size ; column++)
+
+        for (index = column_pointers [column] ; index != column_pointers [column + 1] ; index++)
+        {
+            CellIndex_t row = position [row_indices [index]] ;
+            CellIndex_t col = position [column] ;
+
+            if (msolver->Symmetric == true)
+            {
+                if (row >= col)
+
+                    entries [2u * col + 1u]++ ;
+
+                continue ;
+            }
+
+            if (row >= msolver->SupernodeColumns [snodes [col]])
+
+                entries [2u * col + 1u]++ ;
+
+            if (col >= msolver->SupernodeColumns [snodes [row] + 1u])
+
+                entries [2u * row + 2u]++ ;
+        }
+
+    for (index = 0u ; index != 2u * (size_t) size ; index++)
+
+        entries [index + 1u] += entries [index] ;
+
+    msolver->EntryIndices = (CellIndex_t *) malloc (sizeof (CellIndex_t) * MAX (entries [2u * size], 1u)) ;
+    msolver->EntryValues  = (CellIndex_t *) malloc (sizeof (CellIndex_t) * MAX (entries [2u * size], 1u)) ;
+
+    if (msolver->EntryIndices == NULL || msolver->EntryValues == NULL)
+
+        goto release ;
+
+    for (column = 0u ; column != size ; column++)
+
+        for (index = column_pointers [column] ; index != column_pointers [column + 1] ; index++)
+        {
+            CellIndex_t row = position [row_indices [index]] ;
+            CellIndex_t col = position [column] ;
+
+            if (msolver->Symmetric == true)
+            {
+                if (row >= col)
+                {
+                    msolver->EntryIndices [entries [2u * col]] = row ;
+                    msolver->EntryValues  [entries [2u * col]] = (CellIndex_t) index ;
+                    entries [2u * col]++ ;
+                }
+
+                continue ;
+            }
+
+            if (row >= msolver->SupernodeColumns [snodes [col]])
+            {
+                msolver->EntryIndices [entries [2u * col]] = row ;
+                msolver->EntryValues  [entries [2u * col]] = (CellIndex_t) index ;
+                entries [2u * col]++ ;
+            }
+
+            if (col >= msolver->SupernodeColumns [snodes [row] + 1u])
+            {
+                msolver->EntryIndices [entries [2u * row + 1u]] = col ;
+                msolver->EntryValues  [entries [2u * row + 1u]] = (CellIndex_t) index ;
+                entries [2u * row + 1u]++ ;
+            }
+        }
+
+    for (index = 2u * (size_t) size ; index != 0u ; index--)
+
+        entries [index] = entries [index - 1u] ;
+
+    entries [0] = 0u ;
+
+    // From (permuted) rows and columns to positions in the front
+
+    for (snode = 0u ; snode != nsnodes ; snode++)
+    {
+        size_t row, begin = msolver->FrontPointers [snode] ;
+
+        for (row = begin ; row != msolver->FrontPointers [snode + 1u] ; row++)
+
+            position [msolver->FrontRows [row]] = (CellIndex_t) (row - begin) ;
+
+        for (column  = msolver->SupernodeColumns [snode] ;
+             column != msolver->SupernodeColumns [snode + 1u] ; column++)
+
+            for (index = entries [2u * column] ; index != entries [2u * column + 2u] ; index++)
+
+                msolver->EntryIndices [index] = position [msolver->EntryIndices [index]] ;
+    }
+
+    msolver->Size = size ;
+
+    result = TDICE_SUCCESS ;
+
+release :
+
+    if (result == TDICE_FAILURE)
+
+        fprintf (stderr, "Multifrontal: cannot analyze the system matrix\n") ;
+
+    free (position) ;
+    free (parent) ;
+    free (work1) ;
+    free (work2) ;
+    free (work3) ;
+    free (counts) ;
+    free (snodes) ;
+    free (pointers) ;
+    free (neighbours) ;
+    free (children) ;
+    free (child_list) ;
+
+    return result ;
+}
+
+/******************************************************************************/
+
+/* Columns \a Begin to \a End of a front updated by a block of pivots */
+
+typedef struct
+{
+    double      *Front ;
+    size_t       NRows ;
+    size_t       FirstPivot ;
+    size_t       NPivots ;
+    size_t       Begin ;
+    size_t       End ;
+    bool         Symmetric ;
+
+} FrontUpdate_t ;
+
+/******************************************************************************/
+
+/* Applies the pivots of a block to the columns of a task: forward
+ * substitution with the (unit) L of the block and update of the rows
+ * below it. With a Cholesky factorization only the rows from the diagonal
+ * down are updated, using the rows of L as the rows of L' */
+
+static void *update_front_columns (void *argument)
+{
+    FrontUpdate_t *task = (FrontUpdate_t *) argument ;
+
+    size_t nrows = task->NRows ;
+    size_t column, pivot, row ;
+
+    for (column = task->Begin ; column != task->End ; column++)
+    {
+        double *target = task->Front + column * nrows ;
+
+        for (pivot = task->FirstPivot ; pivot != task->FirstPivot + task->NPivots ; pivot++)
+        {
+            double *l     = task->Front + pivot * nrows ;
+            double  value = task->Symmetric == true ? l [column] : target [pivot] ;
+
+            if (value == 0.0)
+
+                continue ;
+
+            for (row = task->Symmetric == true ? column : pivot + 1u ; row != nrows ; row++)
+
+                target [row] -= l [row] * value ;
+        }
+    }
+
+    return NULL ;
+}
+
+/******************************************************************************/
+
+/* Partial LU factorization (no pivoting), or Cholesky factorization of the
+ * lower triangle if \a symmetric is true, of the first \a ncolumns columns
+ * of a dense \a nrows x \a nrows front, by blocks of columns. The update of
+ * the columns at the right of a block is split between \a nthreads.
+ * Without pivoting, a pivot smaller than DBL_EPSILON times the largest
+ * coefficient of the front is a failure, not only an exact zero */
+
+static Error_t factorize_dense_front
+(
+    double     *front,
+    size_t      nrows,
+    size_t      ncolumns,
+    bool        symmetric,
+    Quantity_t  nthreads
+)
+{
+    FrontUpdate_t tasks   [nthreads] ;
+    pthread_t     threads [nthreads] ;
+    bool          started [nthreads] ;
+
+    size_t first, pivot, column, row ;
+    Quantity_t index ;
+
+    double norm = 0.0 ;
+
+    for (row = 0u ; row != nrows * nrows ; row++)
+
+        norm = MAX (norm, fabs (front [row])) ;
+
+    double threshold = DBL_EPSILON * norm ;
+
+    for (first = 0u ; first < ncolumns ; first += MULTIFRONTAL_BLOCK)
+    {
+        size_t npivots = MIN (MULTIFRONTAL_BLOCK, ncolumns - first) ;
+
+        // Unblocked factorization of the columns of the block
+
+        for (pivot = first ; pivot != first + npivots ; pivot++)
+        {
+            double *l = front + pivot * nrows ;
+
+            if (symmetric == true)
+            {
+                if (l [pivot] <= threshold)
+                {
+                    fprintf (stderr,
+                        "Multifrontal: matrix not positive definite (pivot %g, front norm %g)\n",
+                        l [pivot], norm) ;
+
+                    return TDICE_FAILURE ;
+                }
+
+                l [pivot] = sqrt (l [pivot]) ;
+            }
+            else if (fabs (l [pivot]) <= threshold)
+            {
+                fprintf (stderr,
+                    "Multifrontal: pivot %g too small for a front norm %g\n",
+                    l [pivot], norm) ;
+
+                return TDICE_FAILURE ;
+            }
+
+            for (row = pivot + 1u ; row != nrows ; row++)
+
+                l [row] /= l [pivot] ;
+
+            for (column = pivot + 1u ; column != first + npivots ; column++)
+            {
+                double *target = front + column * nrows ;
+                double  value  = symmetric == true ? l [column] : target [pivot] ;
+
+                if (value != 0.0)
+
+                    for (row = symmetric == true ? column : pivot + 1u ; row != nrows ; row++)
+
+                        target [row] -= l [row] * value ;
+            }
+        }
+
+        // Update of the columns at the right of the block
+
+        size_t begin   = first + npivots ;
+        size_t ntotal  = nrows - begin ;
+        double work    = (double) npivots * (double) ntotal * (double) (nrows - first) ;
+
+        Quantity_t ntasks = 1u ;
+
+        if (nthreads > 1u && work >= MULTIFRONTAL_PARALLEL_WORK)
+
+            ntasks = (Quantity_t) MIN ((size_t) nthreads, ntotal) ;
+
+        for (index = 0u ; index != ntasks ; index++)
+        {
+            tasks [index].Front      = front ;
+            tasks [index].NRows      = nrows ;
+            tasks [index].FirstPivot = first ;
+            tasks [index].NPivots    = npivots ;
+            tasks [index].Begin      = begin + (ntotal *  index      ) / ntasks ;
+            tasks [index].End        = begin + (ntotal * (index + 1u)) / ntasks ;
+            tasks [index].Symmetric  = symmetric ;
+
+            // The columns of the lower triangle get shorter: the tasks
+            // take the same number of coefficients, not of columns
+
+            if (symmetric == true)
+            {
+                tasks [index].Begin = nrows - (size_t) ((double) ntotal
+
+                    * sqrt ((double) (ntasks - index) / ntasks)) ;
+
+                tasks [index].End   = nrows - (size_t) ((double) ntotal
+
+                    * sqrt ((double) (ntasks - index - 1u) / ntasks)) ;
+            }
+
+            started [index] = index != 0u
+
+                && pthread_create (threads + index, NULL, update_front_columns, tasks + index) == 0 ;
+
+            if (started [index] == false && index != 0u)
+
+                update_front_columns (tasks + index) ;
+        }
+
+        update_front_columns (tasks) ;
+
+        for (index = 1u ; index < ntasks ; index++)
+
+            if (started [index] == true)
+
+                pthread_join (threads [index], NULL) ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+/* State of a (multithreaded) numerical factorization. The supernodes whose
+ * children have all been factorized wait in \a Ready */
+
+typedef struct
+{
+    MultifrontalSolver_t *MSolver ;
+    SystemMatrixCoeff_t  *Values ;
+    double              **Updates ;
+    Quantity_t           *Pending ;
+    size_t               *Children ;
+    Quantity_t           *ChildList ;
+    Quantity_t           *Ready ;
+    Quantity_t            NReady ;
+    Quantity_t            NDone ;
+    Quantity_t            NBusy ;
+    bool                  Failed ;
+    pthread_mutex_t       Lock ;
+    pthread_cond_t        Wakeup ;
+
+} Factorization_t ;
+
+/******************************************************************************/
+
+/* Copies count coefficients of a front, at distance stride from each other,
+ * into the factors from the index offset, rounding them in single precision
+ * if requested */
+
+static void store_factors
+(
+    MultifrontalSolver_t *msolver,
+    size_t                offset,
+    double               *from,
+    size_t                count,
+    size_t                stride
+)
+{
+    size_t index ;
+
+    if (msolver->SinglePrecision == true)
+
+        for (index = 0u ; index != count ; index++)
+
+            msolver->SingleFactors [offset + index] = (float) from [index * stride] ;
+
+    else if (stride == 1u)
+
+        memcpy (msolver->Factors + offset, from, sizeof (double) * count) ;
+
+    else
+
+        for (index = 0u ; index != count ; index++)
+
+            msolver->Factors [offset + index] = from [index * stride] ;
+}
+
+/******************************************************************************/
+
+/* Work of the update after the first block of columns of the front of a
+ * supernode, the largest one: if it is below MULTIFRONTAL_PARALLEL_WORK,
+ * factorize_dense_front never splits an update between threads */
+
+static double front_work (MultifrontalSolver_t *msolver, Quantity_t snode)
+{
+    size_t ncolumns = msolver->SupernodeColumns [snode + 1u] - msolver->SupernodeColumns [snode] ;
+    size_t nrows    = msolver->FrontPointers [snode + 1u] - msolver->FrontPointers [snode] ;
+    size_t npivots  = MIN (MULTIFRONTAL_BLOCK, ncolumns) ;
+
+    return (double) npivots * (double) (nrows - npivots) * (double) nrows ;
+}
+
+/******************************************************************************/
+
+/* Factorizes the front of a supernode, leaving its update matrix for the
+ * parent. The update matrices of the children are released */
+
+static Error_t factorize_front
+
+    (Factorization_t *fact, Quantity_t snode, Quantity_t nthreads)
+{
+    MultifrontalSolver_t *msolver = fact->MSolver ;
+
+    CellIndex_t first    = msolver->SupernodeColumns [snode] ;
+    size_t      ncolumns = msolver->SupernodeColumns [snode + 1u] - first ;
+    size_t      nrows    = msolver->FrontPointers [snode + 1u] - msolver->FrontPointers [snode] ;
+    size_t      nbelow   = nrows - ncolumns ;
+    size_t      index, row, column ;
+
+    double *front  = (double *) calloc (nrows * nrows, sizeof (double)) ;
+    double *update = nbelow != 0u ? (double *) malloc (sizeof (double) * nbelow * nbelow) : NULL ;
+
+    Error_t result = TDICE_FAILURE ;
+
+    if (front == NULL || (nbelow != 0u && update == NULL))
+    {
+        fprintf (stderr, "Multifrontal: cannot malloc a front of %zu rows\n", nrows) ;
+
+        goto release ;
+    }
+
+    /* Coefficients of the matrix */
+
+    for (column = 0u ; column != ncolumns ; column++)
+    {
+        size_t *entries = msolver->EntryPointers + 2u * (first + column) ;
+
+        for (index = entries [0] ; index != entries [1] ; index++)
+
+            front [msolver->EntryIndices [index] + column * nrows]
+
+                += fact->Values [msolver->EntryValues [index]] ;
+
+        for (index = entries [1] ; index != entries [2] ; index++)
+
+            front [column + msolver->EntryIndices [index] * nrows]
+
+                += fact->Values [msolver->EntryValues [index]] ;
+    }
+
+    /* Update matrices of the children (extend-add) */
+
+    for (index = fact->Children [snode] ; index != fact->Children [snode + 1u] ; index++)
+    {
+        Quantity_t child = fact->ChildList [index] ;
+
+        size_t       first_row = msolver->FrontPointers [child]
+                                 + msolver->SupernodeColumns [child + 1u]
+                                 - msolver->SupernodeColumns [child] ;
+        size_t       nchild    = msolver->FrontPointers [child + 1u] - first_row ;
+        CellIndex_t *positions = msolver->ParentPositions + first_row ;
+        double      *source    = fact->Updates [child] ;
+
+        // The positions in the parent increase with the rows, so that the
+        // lower triangle goes to the lower triangle
+
+        for (column = 0u ; column != nchild ; column++)
+        {
+            double *target = front  + positions [column] * nrows ;
+            double *from   = source + column * nchild ;
+
+            for (row = msolver->Symmetric == true ? column : 0u ; row != nchild ; row++)
+
+                target [positions [row]] += from [row] ;
+        }
+    }
+
+    if (factorize_dense_front
+
+            (front, nrows, ncolumns, msolver->Symmetric, nthreads) != TDICE_SUCCESS)
+
+        goto release ;
+
+    /* Panel (L only, from the diagonal, for a Cholesky factorization),
+     * transposed block of U at its right and update matrix */
+
+    size_t panel = msolver->FactorPointers [snode] ;
+    size_t upper = panel + nrows * ncolumns ;
+
+    if (msolver->Symmetric == true)
+
+        for (column = 0u ; column != ncolumns ; column++)
+        {
+            store_factors (msolver, panel, front + column + column * nrows,
+                           nrows - column, 1u) ;
+
+            panel += nrows - column ;
+        }
+
+    else
+    {
+        store_factors (msolver, panel, front, nrows * ncolumns, 1u) ;
+
+        for (column = 0u ; column != ncolumns ; column++)
+
+            store_factors (msolver, upper + column * nbelow,
+                           front + column + ncolumns * nrows, nbelow, nrows) ;
+    }
+
+    for (column = 0u ; column != nbelow ; column++)
+
+        memcpy (update + column * nbelow,
+                front + ncolumns + (ncolumns + column) * nrows,
+                sizeof (double) * nbelow) ;
+
+    result = TDICE_SUCCESS ;
+
+release :
+
+    free (front) ;
+
+    for (index = fact->Children [snode] ; index != fact->Children [snode + 1u] ; index++)
+    {
+        free (fact->Updates [fact->ChildList [index]]) ;
+
+        fact->Updates [fact->ChildList [index]] = NULL ;
+    }
+
+    if (result == TDICE_SUCCESS)
+
+        fact->Updates [snode] = update ;
+
+    else
+
+        free (update) ;
+
+    return result ;
+}
+
+/******************************************************************************/
+
+/* Factorizes the supernodes that are ready until all of them are done.
+ * After a failure the remaining supernodes are only released */
+
+static void *factorization_worker (void *argument)
+{
+    Factorization_t *fact    = (Factorization_t *) argument ;
+    Quantity_t       nsnodes = fact->MSolver->NSupernodes ;
+    Quantity_t       ncores  = MAX (fact->MSolver->NThreads, 1u) ;
+
+    pthread_mutex_lock (&fact->Lock) ;
+
+    while (fact->NDone != nsnodes)
+    {
+        // NBusy counts the threads in use, including the ones lent to the
+        // update of a large front: nobody starts a supernode while they
+        // are all taken, so that the cores are never oversubscribed
+
+        if (fact->NReady == 0u || fact->NBusy >= ncores)
+        {
+            pthread_cond_wait (&fact->Wakeup, &fact->Lock) ;
+
+            continue ;
+        }
+
+        Quantity_t snode  = fact->Ready [--fact->NReady] ;
+        bool       failed = fact->Failed ;
+
+        // The threads of the workers waiting for a supernode (the tree
+        // is too narrow) help to update the large fronts, and are reserved
+        // until the front is factorized
+
+        Quantity_t nthreads = 1u ;
+
+        if (failed == false && front_work (fact->MSolver, snode) >= MULTIFRONTAL_PARALLEL_WORK)
+
+            nthreads = ncores - fact->NBusy ;
+
+        fact->NBusy += nthreads ;
+
+        pthread_mutex_unlock (&fact->Lock) ;
+
+        Error_t result = TDICE_FAILURE ;
+
+        if (failed == false)
+
+            result = factorize_front (fact, snode, nthreads) ;
+
+        else
+        {
+            size_t index ;
+
+            for (index = fact->Children [snode] ; index != fact->Children [snode + 1u] ; index++)
+            {
+                free (fact->Updates [fact->ChildList [index]]) ;
+
+                fact->Updates [fact->ChildList [index]] = NULL ;
+            }
+        }
+
+        pthread_mutex_lock (&fact->Lock) ;
+
+        fact->NBusy -= nthreads ;
+        fact->NDone++ ;
+
+        if (result != TDICE_SUCCESS)
+
+            fact->Failed = true ;
+
+        Quantity_t parent = fact->MSolver->Parents [snode] ;
+
+        if (parent != nsnodes && --fact->Pending [parent] == 0u)
+
+            fact->Ready [fact->NReady++] = parent ;
+
+        pthread_cond_broadcast (&fact->Wakeup) ;
+    }
+
+    pthread_mutex_unlock (&fact->Lock) ;
+
+    return NULL ;
+}
+
+/******************************************************************************/
+
+Error_t multifrontal_solver_factorize
+(
+    MultifrontalSolver_t *msolver,
+    CellIndex_t           size,
+    CellIndex_t          *column_pointers,
+    CellIndex_t          *row_indices,
+    SystemMatrixCoeff_t  *values,
+    int                  *ordering
+)
+{
+    if (msolver->Size != size)
+    {
+        multifrontal_solver_destroy (msolver) ;
+
+        if (analyze (msolver, size, column_pointers, row_indices, ordering) != TDICE_SUCCESS)
+        {
+            multifrontal_solver_destroy (msolver) ;
+
+            return TDICE_FAILURE ;
+        }
+    }
+
+    Quantity_t nsnodes  = msolver->NSupernodes ;
+    Quantity_t nthreads = MAX (msolver->NThreads, 1u) ;
+    Quantity_t snode, index ;
+
+    Factorization_t fact ;
+
+    fact.MSolver   = msolver ;
+    fact.Values    = values ;
+    fact.Updates   = (double **)    calloc (MAX (nsnodes, 1u), sizeof (double *)) ;
+    fact.Pending   = (Quantity_t *) calloc (MAX (nsnodes, 1u), sizeof (Quantity_t)) ;
+    fact.Children  = (size_t *)     calloc (nsnodes + 1u, sizeof (size_t)) ;
+    fact.ChildList = (Quantity_t *) malloc (sizeof (Quantity_t) * MAX (nsnodes, 1u)) ;
+    fact.Ready     = (Quantity_t *) malloc (sizeof (Quantity_t) * MAX (nsnodes, 1u)) ;
+    fact.NReady    = 0u ;
+    fact.NDone     = 0u ;
+    fact.NBusy     = 0u ;
+    fact.Failed    = false ;
+
+    if (   fact.Updates == NULL || fact.Pending == NULL || fact.Children == NULL
+        || fact.ChildList == NULL || fact.Ready == NULL)
+    {
+        fprintf (stderr, "Multifrontal: cannot malloc the assembly tree\n") ;
+
+        free (fact.Updates) ; free (fact.Pending) ; free (fact.Children) ;
+        free (fact.ChildList) ; free (fact.Ready) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    // Children of every supernode and leaves of the assembly tree
+
+    for (snode = 0u ; snode != nsnodes ; snode++)
+
+        if (msolver->Parents [snode] != nsnodes)
+        {
+            fact.Pending  [msolver->Parents [snode]]++ ;
+            fact.Children [msolver->Parents [snode] + 1u]++ ;
+        }
+
+    for (snode = 0u ; snode != nsnodes ; snode++)
+
+        fact.Children [snode + 1u] += fact.Children [snode] ;
+
+    for (snode = 0u ; snode != nsnodes ; snode++)
+
+        if (msolver->Parents [snode] != nsnodes)
+
+            fact.ChildList [fact.Children [msolver->Parents [snode]]++] = snode ;
+
+    for (snode = nsnodes ; snode != 0u ; snode--)
+
+        fact.Children [snode] = fact.Children [snode - 1u] ;
+
+    fact.Children [0] = 0u ;
+
+    // Leaves are pushed in reverse order so that the first leaves are
+    // the first to be factorized
+
+    for (snode = nsnodes ; snode-- != 0u ; )
+
+        if (fact.Pending [snode] == 0u)
+
+            fact.Ready [fact.NReady++] = snode ;
+
+    pthread_mutex_init (&fact.Lock,   NULL) ;
+    pthread_cond_init  (&fact.Wakeup, NULL) ;
+
+    pthread_t threads [nthreads] ;
+    bool      started [nthreads] ;
+
+    for (index = 1u ; index < nthreads ; index++)
+
+        started [index] =
+
+            pthread_create (threads + index, NULL, factorization_worker, &fact) == 0 ;
+
+    factorization_worker (&fact) ;
+
+    for (index = 1u ; index < nthreads ; index++)
+
+        if (started [index] == true)
+
+            pthread_join (threads [index], NULL) ;
+
+    pthread_mutex_destroy (&fact.Lock) ;
+    pthread_cond_destroy  (&fact.Wakeup) ;
+
+    for (snode = 0u ; snode != nsnodes ; snode++)
+
+        free (fact.Updates [snode]) ;
+
+    free (fact.Updates) ;
+    free (fact.Pending) ;
+    free (fact.Children) ;
+    free (fact.ChildList) ;
+    free (fact.Ready) ;
+
+    return fact.Failed == true ? TDICE_FAILURE : TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+/* Returns the coefficient of the factors with the given index */
+
+static double get_factor (MultifrontalSolver_t *msolver, size_t index)
+{
+    return msolver->SinglePrecision == true ?
+
+        (double) msolver->SingleFactors [index] : msolver->Factors [index] ;
+}
+
+/******************************************************************************/
+
+/* Subtracts from x [rows [i]] the product of value and the count coefficients
+ * of the factors stored from the index offset */
+
+static void scatter_column
+(
+    MultifrontalSolver_t *msolver,
+    size_t                offset,
+    CellIndex_t          *rows,
+    size_t                count,
+    double                value,
+    double               *x
+)
+{
+    size_t index ;
+
+    if (msolver->SinglePrecision == true)
+    {
+        float *factors = msolver->SingleFactors + offset ;
+
+        for (index = 0u ; index != count ; index++)
+
+            x [rows [index]] -= (double) factors [index] * value ;
+    }
+    else
+    {
+        double *factors = msolver->Factors + offset ;
+
+        for (index = 0u ; index != count ; index++)
+
+            x [rows [index]] -= factors [index] * value ;
+    }
+}
+
+/******************************************************************************/
+
+/* Returns the product of x [rows [i]] and the count coefficients of the
+ * factors stored from the index offset */
+
+static double gather_column
+(
+    MultifrontalSolver_t *msolver,
+    size_t                offset,
+    CellIndex_t          *rows,
+    size_t                count,
+    double               *x
+)
+{
+    double product = 0.0 ;
+    size_t index ;
+
+    if (msolver->SinglePrecision == true)
+    {
+        float *factors = msolver->SingleFactors + offset ;
+
+        for (index = 0u ; index != count ; index++)
+
+            product += (double) factors [index] * x [rows [index]] ;
+    }
+    else
+    {
+        double *factors = msolver->Factors + offset ;
+
+        for (index = 0u ; index != count ; index++)
+
+            product += factors [index] * x [rows [index]] ;
+    }
+
+    return product ;
+}
+
+/******************************************************************************/
+
+/* Solves L U x = b in place, with the rows and the columns of x permuted */
+
+static void solve_lu (MultifrontalSolver_t *msolver, double *x)
+{
+    Quantity_t snode ;
+    size_t     row, column ;
+
+    /* Forward substitution (children first) */
+
+    for (snode = 0u ; snode != msolver->NSupernodes ; snode++)
+    {
+        CellIndex_t  first    = msolver->SupernodeColumns [snode] ;
+        size_t       ncolumns = msolver->SupernodeColumns [snode + 1u] - first ;
+        size_t       nrows    = msolver->FrontPointers [snode + 1u] - msolver->FrontPointers [snode] ;
+        CellIndex_t *rows     = msolver->FrontRows + msolver->FrontPointers [snode] ;
+        size_t       panel    = msolver->FactorPointers [snode] ;
+
+        for (column = 0u ; column != ncolumns ; column++)
+        {
+            double value = x [first + column] ;
+
+            if (value != 0.0)
+
+                scatter_column
+
+                    (msolver, panel + column * nrows + column + 1u,
+                     rows + column + 1u, nrows - column - 1u, value, x) ;
+        }
+    }
+
+    /* Backward substitution (parents first) */
+
+    for (snode = msolver->NSupernodes ; snode-- != 0u ; )
+    {
+        CellIndex_t  first    = msolver->SupernodeColumns [snode] ;
+        size_t       ncolumns = msolver->SupernodeColumns [snode + 1u] - first ;
+        size_t       nrows    = msolver->FrontPointers [snode + 1u] - msolver->FrontPointers [snode] ;
+        size_t       nbelow   = nrows - ncolumns ;
+        CellIndex_t *rows     = msolver->FrontRows + msolver->FrontPointers [snode] + ncolumns ;
+        size_t       panel    = msolver->FactorPointers [snode] ;
+        size_t       upper    = panel + nrows * ncolumns ;
+
+        for (column = ncolumns ; column-- != 0u ; )
+        {
+            double value = x [first + column]
+
+                - gather_column (msolver, upper + column * nbelow, rows, nbelow, x) ;
+
+            for (row = column + 1u ; row != ncolumns ; row++)
+
+                value -= get_factor (msolver, panel + column + row * nrows) * x [first + row] ;
+
+            x [first + column] = value / get_factor (msolver, panel + column + column * nrows) ;
+        }
+    }
+}
+
+/******************************************************************************/
+
+/* Solves L L' x = b in place, with the rows and the columns of x permuted */
+
+static void solve_cholesky (MultifrontalSolver_t *msolver, double *x)
+{
+    Quantity_t snode ;
+    size_t     column ;
+
+    /* Forward substitution with L (children first) */
+
+    for (snode = 0u ; snode != msolver->NSupernodes ; snode++)
+    {
+        CellIndex_t  first    = msolver->SupernodeColumns [snode] ;
+        size_t       ncolumns = msolver->SupernodeColumns [snode + 1u] - first ;
+        size_t       nrows    = msolver->FrontPointers [snode + 1u] - msolver->FrontPointers [snode] ;
+        CellIndex_t *rows     = msolver->FrontRows + msolver->FrontPointers [snode] ;
+        size_t       l        = msolver->FactorPointers [snode] ;
+
+        for (column = 0u ; column != ncolumns ; column++)
+        {
+            double value = x [first + column] / get_factor (msolver, l) ;
+
+            x [first + column] = value ;
+
+            if (value != 0.0)
+
+                scatter_column
+
+                    (msolver, l + 1u, rows + column + 1u, nrows - column - 1u, value, x) ;
+
+            l += nrows - column ;
+        }
+    }
+
+    /* Backward substitution with L' (parents first) */
+
+    for (snode = msolver->NSupernodes ; snode-- != 0u ; )
+    {
+        CellIndex_t  first    = msolver->SupernodeColumns [snode] ;
+        size_t       ncolumns = msolver->SupernodeColumns [snode + 1u] - first ;
+        size_t       nrows    = msolver->FrontPointers [snode + 1u] - msolver->FrontPointers [snode] ;
+        CellIndex_t *rows     = msolver->FrontRows + msolver->FrontPointers [snode] ;
+        size_t       l        = msolver->FactorPointers [snode + 1u] ;
+
+        for (column = ncolumns ; column-- != 0u ; )
+        {
+            l -= nrows - column ;
+
+            double value = x [first + column]
+
+                - gather_column (msolver, l + 1u, rows + column + 1u, nrows - column - 1u, x) ;
+
+            x [first + column] = value / get_factor (msolver, l) ;
+        }
+    }
+}
+
+/******************************************************************************/
+
+void multifrontal_solver_solve
+(
+    MultifrontalSolver_t *msolver,
+    double               *b,
+    Quantity_t            nrhs,
+    CellIndex_t           ldb
+)
+{
+    CellIndex_t size = msolver->Size ;
+    double     *x    = msolver->Work ;
+
+    Quantity_t  rhs ;
+    CellIndex_t node ;
+
+    for (rhs = 0u ; rhs != nrhs ; rhs++)
+    {
+        double *vector = b + (size_t) rhs * ldb ;
+
+        for (node = 0u ; node != size ; node++)
+
+            x [node] = vector [msolver->Ordering [node]] ;
+
+        if (msolver->Symmetric == true)
+
+            solve_cholesky (msolver, x) ;
+
+        else
+
+            solve_lu (msolver, x) ;
+
+        for (node = 0u ; node != size ; node++)
+
+            vector [msolver->Ordering [node]] = x [node] ;
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,818 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <stdio.h>  // For the file type FILE
+#include <stdlib.h> // For the memory functions malloc/free
+#include <string.h> // For the memory functions memcpy/memset
+#include <math.h>   // For the math function fabs
+
+#include "multigrid.h"
+
+/* Maximum number of levels of the hierarchy */
+
+#define MULTIGRID_MAX_LEVELS      20u
+
+/* Coarsening stops when a level has at most this number of cells */
+
+#define MULTIGRID_COARSEST_SIZE   1000u
+
+/* The coarsest matrix is factorized (dense) up to this size, otherwise
+ * it is approximately solved with some smoothing sweeps */
+
+#define MULTIGRID_MAX_DENSE_SIZE  2000u
+#define MULTIGRID_COARSEST_SWEEPS 20u
+
+/******************************************************************************/
+
+static void level_init (MultigridLevel_t *level)
+{
+    level->Size          = (CellIndex_t) 0u ;
+    level->NRows         = (CellIndex_t) 0u ;
+    level->NColumns      = (CellIndex_t) 0u ;
+    level->RowPointers   = NULL ;
+    level->ColumnIndices = NULL ;
+    level->Values        = NULL ;
+    level->Diagonal      = NULL ;
+    level->Aggregate     = NULL ;
+    level->X             = NULL ;
+    level->B             = NULL ;
+    level->R             = NULL ;
+}
+
+/******************************************************************************/
+
+static void level_destroy (MultigridLevel_t *level)
+{
+    free (level->RowPointers) ;
+    free (level->ColumnIndices) ;
+    free (level->Values) ;
+    free (level->Diagonal) ;
+    free (level->Aggregate) ;
+    free (level->X) ;
+    free (level->B) ;
+    free (level->R) ;
+
+    level_init (level) ;
+}
+
+/******************************************************************************/
+
+static void free_hierarchy (Multigrid_t *multigrid)
+{
+    Quantity_t index ;
+
+    for (index = 0u ; index != multigrid->NLevels ; index++)
+
+        level_destroy (multigrid->Levels + index) ;
+
+    free (multigrid->Levels) ;
+    free (multigrid->Coarsest) ;
+    free (multigrid->Pivots) ;
+    free (multigrid->PlaneWork) ;
+
+    multigrid->NLevels  = (Quantity_t) 0u ;
+    multigrid->Levels   = NULL ;
+    multigrid->Coarsest = NULL ;
+    multigrid->Pivots   = NULL ;
+    multigrid->PlaneWork = NULL ;
+}
+
+/******************************************************************************/
+
+void multigrid_init (Multigrid_t *multigrid)
+{
+    multigrid->NLayers        = (CellIndex_t) 0u ;
+    multigrid->NRows          = (CellIndex_t) 0u ;
+    multigrid->NColumns       = (CellIndex_t) 0u ;
+    multigrid->NExtraCells    = (CellIndex_t) 0u ;
+    multigrid->CoarsenColumns = true ;
+    multigrid->NLevels        = (Quantity_t) 0u ;
+    multigrid->Levels         = NULL ;
+    multigrid->Coarsest       = NULL ;
+    multigrid->Pivots         = NULL ;
+    multigrid->PlaneWork       = NULL ;
+}
+
+/******************************************************************************/
+
+void multigrid_set_grid
+
+    (Multigrid_t *multigrid, Dimensions_t *dimensions, ThermalGrid_t *thermal_grid)
+{
+    multigrid->NLayers  = get_number_of_layers  (dimensions) ;
+    multigrid->NRows    = get_number_of_rows    (dimensions) ;
+    multigrid->NColumns = get_number_of_columns (dimensions) ;
+
+    multigrid->NExtraCells = get_number_of_cells (dimensions)
+
+        - multigrid->NLayers * multigrid->NRows * multigrid->NColumns ;
+
+    multigrid->CoarsenColumns = true ;
+
+    CellIndex_t layer ;
+
+    for (layer = 0u ; layer != thermal_grid->NLayers ; layer++)
+
+        if (thermal_grid->LayersTypeProfile [layer] == TDICE_LAYER_CHANNEL_4RM)
+
+            multigrid->CoarsenColumns = false ;
+}
+
+/******************************************************************************/
+
+/* Index of the cell (layer, row, column) in a level */
+
+static CellIndex_t level_cell
+(
+    MultigridLevel_t *level,
+    CellIndex_t       layer,
+    CellIndex_t       row,
+    CellIndex_t       column
+)
+{
+    return (layer * level->NRows + row) * level->NColumns + column ;
+}
+
+/******************************************************************************/
+
+static Error_t find_diagonal (MultigridLevel_t *level)
+{
+    CellIndex_t row, index ;
+
+    level->Diagonal = (CellIndex_t *) malloc (sizeof (CellIndex_t) * level->Size) ;
+
+    if (level->Diagonal == NULL)
+
+        return TDICE_FAILURE ;
+
+    for (row = 0u ; row != level->Size ; row++)
+    {
+        for (index  = level->RowPointers [row] ;
+             index != level->RowPointers [row + 1] ; index++)
+
+            if (level->ColumnIndices [index] == row)
+
+                break ;
+
+        if (index == level->RowPointers [row + 1] || level->Values [index] == 0.0)
+        {
+            fprintf (stderr, "Multigrid: zero diagonal in row %d\n", row) ;
+
+            return TDICE_FAILURE ;
+        }
+
+        level->Diagonal [row] = index ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+/* The finest level is the transpose of the (CCS) system matrix */
+
+static Error_t build_finest_level
+(
+    Multigrid_t         *multigrid,
+    CellIndex_t          size,
+    CellIndex_t         *column_pointers,
+    CellIndex_t         *row_indices,
+    SystemMatrixCoeff_t *values
+)
+{
+    MultigridLevel_t *level = multigrid->Levels ;
+
+    CellIndex_t nnz = column_pointers [size] ;
+    CellIndex_t row, column, index ;
+
+    level->Size     = size ;
+    level->NRows    = multigrid->NRows ;
+    level->NColumns = multigrid->NColumns ;
+
+    level->RowPointers   = (CellIndex_t *)         calloc (size + 1, sizeof (CellIndex_t)) ;
+    level->ColumnIndices = (CellIndex_t *)         malloc (sizeof (CellIndex_t) * nnz) ;
+    level->Values        = (SystemMatrixCoeff_t *) malloc (sizeof (SystemMatrixCoeff_t) * nnz) ;
+    level->R             = (double *)              malloc (sizeof (double) * size) ;
+
+    if (   level->RowPointers == NULL || level->ColumnIndices == NULL
+        || level->Values      == NULL || level->R             == NULL)
+
+        return TDICE_FAILURE ;
+
+    for (index = 0u ; index != nnz ; index++)
+
+        level->RowPointers [row_indices [index] + 1]++ ;
+
+    for (row = 0u ; row != size ; row++)
+
+        level->RowPointers [row + 1] += level->RowPointers [row] ;
+
+    // R is borrowed as insertion cursor (cell indices fit in a double)
+
+    for (row = 0u ; row != size ; row++)
+
+        level->R [row] = (double) level->RowPointers [row] ;
+
+    for (column = 0u ; column != size ; column++)
+
+        for (index = column_pointers [column] ; index != column_pointers [column + 1] ; index++)
+        {
+            CellIndex_t position = (CellIndex_t) level->R [row_indices [index]]++ ;
+
+            level->ColumnIndices [position] = column ;
+            level->Values        [position] = values [index] ;
+        }
+
+    return find_diagonal (level) ;
+}
+
+/******************************************************************************/
+
+/* Builds level + 1 from level (aggregates and Galerkin product) */
+
+static Error_t build_coarse_level (Multigrid_t *multigrid, MultigridLevel_t *level)
+{
+    MultigridLevel_t *coarse = level + 1 ;
+
+    CellIndex_t nlayers = multigrid->NLayers ;
+    CellIndex_t layer, row, column, cell, index ;
+
+    coarse->NRows    = (level->NRows + 1u) / 2u ;
+    coarse->NColumns = multigrid->CoarsenColumns == true
+
+        ? (level->NColumns + 1u) / 2u : level->NColumns ;
+
+    CellIndex_t layers_size = nlayers * coarse->NRows * coarse->NColumns ;
+
+    coarse->Size = layers_size + multigrid->NExtraCells ;
+
+    level->Aggregate = (CellIndex_t *) malloc (sizeof (CellIndex_t) * level->Size) ;
+
+    if (level->Aggregate == NULL)
+
+        return TDICE_FAILURE ;
+
+    for (layer = 0u ; layer != nlayers ; layer++)
+
+        for (row = 0u ; row != level->NRows ; row++)
+
+            for (column = 0u ; column != level->NColumns ; column++)
+
+                level->Aggregate [level_cell (level, layer, row, column)] =
+
+                    level_cell (coarse, layer, row / 2u,
+                        multigrid->CoarsenColumns == true ? column / 2u : column) ;
+
+    for (cell = 0u ; cell != multigrid->NExtraCells ; cell++)
+
+        level->Aggregate [level->Size - multigrid->NExtraCells + cell] = layers_size + cell ;
+
+    // Fine cells grouped by aggregate (counting sort)
+
+    CellIndex_t *first = (CellIndex_t *) calloc (coarse->Size + 1, sizeof (CellIndex_t)) ;
+    CellIndex_t *cells = (CellIndex_t *) malloc (sizeof (CellIndex_t) * level->Size) ;
+    CellIndex_t *where = (CellIndex_t *) malloc (sizeof (CellIndex_t) * coarse->Size) ;
+
+    CellIndex_t fine_nnz = level->RowPointers [level->Size] ;
+
+    coarse->RowPointers   = (CellIndex_t *)         malloc (sizeof (CellIndex_t) * (coarse->Size + 1)) ;
+    coarse->ColumnIndices = (CellIndex_t *)         malloc (sizeof (CellIndex_t) * fine_nnz) ;
+    coarse->Values        = (SystemMatrixCoeff_t *) malloc (sizeof (SystemMatrixCoeff_t) * fine_nnz) ;
+    coarse->X             = (double *)              malloc (sizeof (double) * coarse->Size) ;
+    coarse->B             = (double *)              malloc (sizeof (double) * coarse->Size) ;
+    coarse->R             = (double *)              malloc (sizeof (double) * coarse->Size) ;
+
+    if (   first == NULL || cells == NULL || where == NULL
+        || coarse->RowPointers == NULL || coarse->ColumnIndices == NULL
+        || coarse->Values == NULL || coarse->X == NULL
+        || coarse->B == NULL || coarse->R == NULL)
+    {
+        free (first) ;
+        free (cells) ;
+        free (where) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    for (cell = 0u ; cell != level->Size ; cell++)
+
+        first [level->Aggregate [cell] + 1]++ ;
+
+    for (cell = 0u ; cell != coarse->Size ; cell++)
+
+        first [cell + 1] += first [cell] ;
+
+    for (cell = 0u ; cell != coarse->Size ; cell++)
+
+        where [cell] = first [cell] ;
+
+    for (cell = 0u ; cell != level->Size ; cell++)
+
+        cells [where [level->Aggregate [cell]]++] = cell ;
+
+    // Galerkin product P^T A P with P piecewise constant: the coarse row
+    // of an aggregate sums the fine rows of its cells, merging columns
+    // that belong to the same aggregate. "where" marks the position of
+    // the coarse columns already inserted in the current row.
+
+    for (cell = 0u ; cell != coarse->Size ; cell++)
+
+        where [cell] = fine_nnz ;
+
+    CellIndex_t nnz = 0u, aggregate, position ;
+
+    for (aggregate = 0u ; aggregate != coarse->Size ; aggregate++)
+    {
+        coarse->RowPointers [aggregate] = nnz ;
+
+        for (position = first [aggregate] ; position != first [aggregate + 1] ; position++)
+        {
+            CellIndex_t fine_row = cells [position] ;
+
+            for (index  = level->RowPointers [fine_row] ;
+                 index != level->RowPointers [fine_row + 1] ; index++)
+            {
+                CellIndex_t coarse_column = level->Aggregate [level->ColumnIndices [index]] ;
+
+                if (where [coarse_column] == fine_nnz)
+                {
+                    where [coarse_column] = nnz ;
+
+                    coarse->ColumnIndices [nnz] = coarse_column ;
+                    coarse->Values        [nnz] = 0.0 ;
+
+                    nnz++ ;
+                }
+
+                coarse->Values [where [coarse_column]] += level->Values [index] ;
+            }
+        }
+
+        for (index = coarse->RowPointers [aggregate] ; index != nnz ; index++)
+
+            where [coarse->ColumnIndices [index]] = fine_nnz ;
+    }
+
+    coarse->RowPointers [coarse->Size] = nnz ;
+
+    free (first) ;
+    free (cells) ;
+    free (where) ;
+
+    return find_diagonal (coarse) ;
+}
+
+/******************************************************************************/
+
+static Error_t factorize_coarsest (Multigrid_t *multigrid)
+{
+    MultigridLevel_t *level = multigrid->Levels + multigrid->NLevels - 1 ;
+
+    CellIndex_t n = level->Size, row, column, k, index ;
+
+    if (n > MULTIGRID_MAX_DENSE_SIZE)
+
+        return TDICE_SUCCESS ;
+
+    double *a = multigrid->Coarsest = (double *) calloc ((size_t) n * n, sizeof (double)) ;
+
+    multigrid->Pivots = (CellIndex_t *) malloc (sizeof (CellIndex_t) * n) ;
+
+    if (a == NULL || multigrid->Pivots == NULL)
+
+        return TDICE_FAILURE ;
+
+    for (row = 0u ; row != n ; row++)
+
+        for (index = level->RowPointers [row] ; index != level->RowPointers [row + 1] ; index++)
+
+            a [(size_t) row * n + level->ColumnIndices [index]] = level->Values [index] ;
+
+    // LU with partial pivoting, row major
+
+    for (k = 0u ; k != n ; k++)
+    {
+        CellIndex_t pivot = k ;
+
+        for (row = k + 1u ; row < n ; row++)
+
+            if (fabs (a [(size_t) row * n + k]) > fabs (a [(size_t) pivot * n + k]))
+
+                pivot = row ;
+
+        multigrid->Pivots [k] = pivot ;
+
+        if (pivot != k)
+
+            for (column = 0u ; column != n ; column++)
+            {
+                double tmp = a [(size_t) k * n + column] ;
+
+                a [(size_t) k * n + column]     = a [(size_t) pivot * n + column] ;
+                a [(size_t) pivot * n + column] = tmp ;
+            }
+
+        if (a [(size_t) k * n + k] == 0.0)
+        {
+            fprintf (stderr, "Multigrid: singular coarsest matrix\n") ;
+
+            return TDICE_FAILURE ;
+        }
+
+        for (row = k + 1u ; row < n ; row++)
+        {
+            double factor = a [(size_t) row * n + k] /= a [(size_t) k * n + k] ;
+
+            if (factor != 0.0)
+
+                for (column = k + 1u ; column != n ; column++)
+
+                    a [(size_t) row * n + column] -= factor * a [(size_t) k * n + column] ;
+        }
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+Error_t multigrid_factorize
+(
+    Multigrid_t         *multigrid,
+    CellIndex_t          size,
+    CellIndex_t         *column_pointers,
+    CellIndex_t         *row_indices,
+    SystemMatrixCoeff_t *values
+)
+{
+    free_hierarchy (multigrid) ;
+
+    if (size != multigrid->NLayers * multigrid->NRows * multigrid->NColumns
+                + multigrid->NExtraCells)
+    {
+        fprintf (stderr, "Multigrid: the system matrix does not match the grid\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    multigrid->Levels = (MultigridLevel_t *)
+
+        malloc (sizeof (MultigridLevel_t) * MULTIGRID_MAX_LEVELS) ;
+
+    multigrid->PlaneWork = (double *) malloc
+
+        (sizeof (double) * (2u * multigrid->NLayers + 2u)
+                         * multigrid->NLayers * multigrid->NRows) ;
+
+    if (multigrid->Levels == NULL || multigrid->PlaneWork == NULL)
+    {
+        fprintf (stderr, "Cannot malloc multigrid levels\n") ;
+
+        free_hierarchy (multigrid) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    Quantity_t index ;
+
+    for (index = 0u ; index != MULTIGRID_MAX_LEVELS ; index++)
+
+        level_init (multigrid->Levels + index) ;
+
+    multigrid->NLevels = 1u ;
+
+    Error_t result = build_finest_level
+
+        (multigrid, size, column_pointers, row_indices, values) ;
+
+    while (result == TDICE_SUCCESS && multigrid->NLevels != MULTIGRID_MAX_LEVELS)
+    {
+        MultigridLevel_t *level = multigrid->Levels + multigrid->NLevels - 1 ;
+
+        bool can_coarsen =
+
+               level->NRows > 1u
+            || (level->NColumns > 1u && multigrid->CoarsenColumns == true) ;
+
+        if (level->Size <= MULTIGRID_COARSEST_SIZE || can_coarsen == false)
+
+            break ;
+
+        multigrid->NLevels++ ;
+
+        result = build_coarse_level (multigrid, level) ;
+    }
+
+    if (result == TDICE_SUCCESS)
+
+        result = factorize_coarsest (multigrid) ;
+
+    if (result == TDICE_FAILURE)
+    {
+        fprintf (stderr, "Cannot build multigrid hierarchy\n") ;
+
+        free_hierarchy (multigrid) ;
+    }
+
+    return result ;
+}
+
+/******************************************************************************/
+
+/* Solves together the cells of the plane of a column. The cells of the
+ * plane are ordered row after row, layer after layer within a row, so the
+ * matrix of the plane is banded with NLayers diagonals on each side. The
+ * coefficients coupling the plane with the other cells are moved to the
+ * right hand side. The band is factorized without pivoting, as the
+ * symmetric part of the matrix is positive definite. */
+
+static void relax_plane
+(
+    Multigrid_t      *multigrid,
+    MultigridLevel_t *level,
+    CellIndex_t       column,
+    double           *x,
+    double           *b
+)
+{
+    CellIndex_t nlayers = multigrid->NLayers ;
+    CellIndex_t ncols   = level->NColumns ;
+    CellIndex_t size    = nlayers * level->NRows ;
+    CellIndex_t width   = 2u * nlayers + 1u ;
+    CellIndex_t last    = level->Size - multigrid->NExtraCells ;
+    CellIndex_t area    = level->NRows * ncols ;
+    CellIndex_t layer, row, index, i, j, k ;
+
+    double *band = multigrid->PlaneWork ;   // band [i * width + j - i + nlayers]
+    double *rhs  = band + (size_t) size * width ;
+
+    memset (band, 0, sizeof (double) * size * width) ;
+
+    for (row = 0u ; row != level->NRows ; row++)
+
+        for (layer = 0u ; layer != nlayers ; layer++)
+        {
+            CellIndex_t cell = level_cell (level, layer, row, column) ;
+
+            i = row * nlayers + layer ;
+
+            rhs [i] = b [cell] ;
+
+            for (index = level->RowPointers [cell] ; index != level->RowPointers [cell + 1] ; index++)
+            {
+                CellIndex_t other = level->ColumnIndices [index] ;
+
+                if (other < last && other % ncols == column)
+                {
+                    j = (other % area) / ncols * nlayers + other / area ;
+
+                    band [(size_t) i * width + j + nlayers - i] += level->Values [index] ;
+                }
+                else
+
+                    rhs [i] -= level->Values [index] * x [other] ;
+            }
+        }
+
+    for (k = 0u ; k != size ; k++)
+    {
+        double *pivot_row = band + (size_t) k * width + nlayers ;
+
+        for (i = k + 1u ; i < size && i <= k + nlayers ; i++)
+        {
+            double *target = band + (size_t) i * width + nlayers - i ;
+
+            double factor = target [k] / pivot_row [0] ;
+
+            if (factor == 0.0)
+
+                continue ;
+
+            for (j = k + 1u ; j < size && j <= k + nlayers ; j++)
+
+                target [j] -= factor * pivot_row [j - k] ;
+
+            rhs [i] -= factor * rhs [k] ;
+        }
+    }
+
+    for (k = size ; k-- != 0u ; )
+    {
+        double *pivot_row = band + (size_t) k * width + nlayers ;
+
+        for (j = k + 1u ; j < size && j <= k + nlayers ; j++)
+
+            rhs [k] -= pivot_row [j - k] * rhs [j] ;
+
+        rhs [k] /= pivot_row [0] ;
+
+        x [level_cell (level, k % nlayers, k / nlayers, column)] = rhs [k] ;
+    }
+}
+
+/******************************************************************************/
+
+static void relax_extra_cells
+(
+    Multigrid_t      *multigrid,
+    MultigridLevel_t *level,
+    double           *x,
+    double           *b
+)
+{
+    CellIndex_t cell, index ;
+
+    for (cell = level->Size - multigrid->NExtraCells ; cell != level->Size ; cell++)
+    {
+        double rhs = b [cell] ;
+
+        for (index = level->RowPointers [cell] ; index != level->RowPointers [cell + 1] ; index++)
+
+            if (level->ColumnIndices [index] != cell)
+
+                rhs -= level->Values [index] * x [level->ColumnIndices [index]] ;
+
+        x [cell] = rhs / level->Values [level->Diagonal [cell]] ;
+    }
+}
+
+/******************************************************************************/
+
+/* Block Gauss-Seidel sweep over the column planes, forward or backward */
+
+static void smooth
+(
+    Multigrid_t      *multigrid,
+    MultigridLevel_t *level,
+    double           *x,
+    double           *b,
+    bool              forward
+)
+{
+    CellIndex_t column ;
+
+    if (forward == false)
+
+        relax_extra_cells (multigrid, level, x, b) ;
+
+    for (column = 0u ; column != level->NColumns ; column++)
+
+        relax_plane (multigrid, level,
+                     forward == true ? column : level->NColumns - 1u - column,
+                     x, b) ;
+
+    if (forward == true)
+
+        relax_extra_cells (multigrid, level, x, b) ;
+}
+
+/******************************************************************************/
+
+static void solve_coarsest (Multigrid_t *multigrid, double *x, double *b)
+{
+    MultigridLevel_t *level = multigrid->Levels + multigrid->NLevels - 1 ;
+
+    CellIndex_t n = level->Size, row, column ;
+
+    if (multigrid->Coarsest == NULL)
+    {
+        Quantity_t sweep ;
+
+        for (sweep = 0u ; sweep != MULTIGRID_COARSEST_SWEEPS ; sweep++)
+        {
+            smooth (multigrid, level, x, b, true) ;
+            smooth (multigrid, level, x, b, false) ;
+        }
+
+        return ;
+    }
+
+    double *a = multigrid->Coarsest ;
+
+    memcpy (x, b, sizeof (double) * n) ;
+
+    for (row = 0u ; row != n ; row++)
+    {
+        CellIndex_t pivot = multigrid->Pivots [row] ;
+
+        if (pivot != row)
+        {
+            double tmp = x [row] ; x [row] = x [pivot] ; x [pivot] = tmp ;
+        }
+    }
+
+    for (row = 0u ; row != n ; row++)
+
+        for (column = 0u ; column != row ; column++)
+
+            x [row] -= a [(size_t) row * n + column] * x [column] ;
+
+    for (row = n ; row-- != 0u ; )
+    {
+        for (column = row + 1u ; column != n ; column++)
+
+            x [row] -= a [(size_t) row * n + column] * x [column] ;
+
+        x [row] /= a [(size_t) row * n + row] ;
+    }
+}
+
+/******************************************************************************/
+
+static void vcycle (Multigrid_t *multigrid, Quantity_t depth, double *x, double *b)
+{
+    MultigridLevel_t *level = multigrid->Levels + depth ;
+
+    memset (x, 0, sizeof (double) * level->Size) ;
+
+    if (depth + 1u == multigrid->NLevels)
+    {
+        solve_coarsest (multigrid, x, b) ;
+
+        return ;
+    }
+
+    MultigridLevel_t *coarse = level + 1 ;
+
+    CellIndex_t cell, index ;
+
+    smooth (multigrid, level, x, b, true) ;
+
+    // Residual, restricted summing over the aggregates
+
+    memset (coarse->B, 0, sizeof (double) * coarse->Size) ;
+
+    for (cell = 0u ; cell != level->Size ; cell++)
+    {
+        double r = b [cell] ;
+
+        for (index = level->RowPointers [cell] ; index != level->RowPointers [cell + 1] ; index++)
+
+            r -= level->Values [index] * x [level->ColumnIndices [index]] ;
+
+        coarse->B [level->Aggregate [cell]] += r ;
+    }
+
+    vcycle (multigrid, depth + 1u, coarse->X, coarse->B) ;
+
+    // Piecewise constant prolongation
+
+    for (cell = 0u ; cell != level->Size ; cell++)
+
+        x [cell] += coarse->X [level->Aggregate [cell]] ;
+
+    smooth (multigrid, level, x, b, false) ;
+}
+
+/******************************************************************************/
+
+void multigrid_vcycle (Multigrid_t *multigrid, double *r, double *z)
+{
+    vcycle (multigrid, 0u, z, r) ;
+}
+
+/******************************************************************************/
+
+void multigrid_destroy (Multigrid_t *multigrid)
+{
+    free_hierarchy (multigrid) ;
+
+    multigrid_init (multigrid) ;
+}
+
+/******************************************************************************/
@@ -0,0 +1,223 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include "ordering.h"
+#include "macros.h"
+
+/* Boxes with at most this number of cells are not split any more */
+
+#define ORDERING_LEAF_SIZE 16u
+
+/* Boxes are split along an axis only if it has at least this number of
+ * cells (a separator and two non empty halves) */
+
+#define ORDERING_MIN_EXTENT 3u
+
+/******************************************************************************/
+
+/* The lattice of the cells: axis 0 are the layers (the spreader of the
+ * pluggable heat sink, if any, is the last one), axis 1 the rows and axis 2
+ * the columns. Rows and columns are those of the spreader, if it is wider
+ * than the chip */
+
+typedef struct
+{
+    Dimensions_t *Dimensions ;
+    HeatSink_t   *Spreader ;
+    CellIndex_t   Extent [3] ;
+    int          *Permutation ;
+    int           Counter ;
+
+} Lattice_t ;
+
+/******************************************************************************/
+
+/* Returns the index of the cell at a position of the lattice (or the number
+ * of cells if there is no cell there) */
+
+static CellIndex_t lattice_cell
+
+    (Lattice_t *lattice, CellIndex_t layer, CellIndex_t row, CellIndex_t column)
+{
+    Dimensions_t *dimensions = lattice->Dimensions ;
+    HeatSink_t   *spreader   = lattice->Spreader ;
+
+    if (spreader != NULL)
+    {
+        if (layer == get_number_of_layers (dimensions))
+        {
+            if (row >= spreader->NRows || column >= spreader->NColumns)
+
+                return get_number_of_cells (dimensions) ;
+
+            return get_spreader_cell_offset (dimensions, spreader, row, column) ;
+        }
+
+        if (row < spreader->NumRowsBorder || column < spreader->NumColumnsBorder)
+
+            return get_number_of_cells (dimensions) ;
+
+        row    -= spreader->NumRowsBorder ;
+        column -= spreader->NumColumnsBorder ;
+    }
+
+    if (   row    >= get_number_of_rows    (dimensions)
+        || column >= get_number_of_columns (dimensions))
+
+        return get_number_of_cells (dimensions) ;
+
+    return get_cell_offset_in_stack (dimensions, layer, row, column) ;
+}
+
+/******************************************************************************/
+
+/* Numbers the cells of a box, layer after layer, row after row */
+
+static void number_box (Lattice_t *lattice, CellIndex_t *begin, CellIndex_t *end)
+{
+    CellIndex_t layer, row, column ;
+
+    for (layer = begin [0] ; layer != end [0] ; layer++)
+
+        for (row = begin [1] ; row != end [1] ; row++)
+
+            for (column = begin [2] ; column != end [2] ; column++)
+            {
+                CellIndex_t cell = lattice_cell (lattice, layer, row, column) ;
+
+                if (cell != get_number_of_cells (lattice->Dimensions))
+
+                    lattice->Permutation [cell] = lattice->Counter++ ;
+            }
+}
+
+/******************************************************************************/
+
+static void dissect (Lattice_t *lattice, CellIndex_t *begin, CellIndex_t *end)
+{
+    CellIndex_t extent [3], half_end [3], half_begin [3] ;
+    Quantity_t  axis ;
+
+    for (axis = 0u ; axis != 3u ; axis++)
+    {
+        extent     [axis] = end [axis] - begin [axis] ;
+        half_begin [axis] = begin [axis] ;
+        half_end   [axis] = end   [axis] ;
+    }
+
+    // Rows and columns first, the layers only when the box is a pile
+
+    axis = extent [1] >= extent [2] ? 1u : 2u ;
+
+    if (extent [axis] < ORDERING_MIN_EXTENT)
+
+        axis = 0u ;
+
+    if (   extent [axis] < ORDERING_MIN_EXTENT
+        || (size_t) extent [0] * extent [1] * extent [2] <= ORDERING_LEAF_SIZE)
+    {
+        number_box (lattice, begin, end) ;
+
+        return ;
+    }
+
+    CellIndex_t middle = begin [axis] + extent [axis] / 2u ;
+
+    half_end [axis] = middle ;
+
+    dissect (lattice, begin, half_end) ;
+
+    half_begin [axis] = middle + 1u ;
+
+    dissect (lattice, half_begin, end) ;
+
+    // The separator
+
+    half_begin [axis] = middle ;
+    half_end   [axis] = middle + 1u ;
+
+    number_box (lattice, half_begin, half_end) ;
+}
+
+/******************************************************************************/
+
+void nested_dissection_ordering
+
+    (Dimensions_t *dimensions, ThermalGrid_t *thermal_grid, int *permutation)
+{
+    Lattice_t   lattice ;
+    CellIndex_t cell, begin [3] = { 0u, 0u, 0u } ;
+
+    lattice.Dimensions  = dimensions ;
+    lattice.Spreader    = NULL ;
+    lattice.Permutation = permutation ;
+    lattice.Counter     = 0 ;
+
+    lattice.Extent [0] = get_number_of_layers  (dimensions) ;
+    lattice.Extent [1] = get_number_of_rows    (dimensions) ;
+    lattice.Extent [2] = get_number_of_columns (dimensions) ;
+
+    if (   thermal_grid->TopHeatSink != NULL
+        && thermal_grid->TopHeatSink->SinkModel == TDICE_HEATSINK_TOP_PLUGGABLE)
+    {
+        lattice.Spreader = thermal_grid->TopHeatSink ;
+
+        lattice.Extent [0] += 1u ;
+
+        lattice.Extent [1] = MAX (lattice.Spreader->NRows,
+                                  lattice.Extent [1] + lattice.Spreader->NumRowsBorder) ;
+        lattice.Extent [2] = MAX (lattice.Spreader->NColumns,
+                                  lattice.Extent [2] + lattice.Spreader->NumColumnsBorder) ;
+    }
+
+    for (cell = 0u ; cell != get_number_of_cells (dimensions) ; cell++)
+
+        permutation [cell] = -1 ;
+
+    dissect (&lattice, begin, lattice.Extent) ;
+
+    // Cells outside the lattice (if any) are eliminated last
+
+    for (cell = 0u ; cell != get_number_of_cells (dimensions) ; cell++)
+
+        if (permutation [cell] < 0)
+
+            permutation [cell] = lattice.Counter++ ;
+}
+
+/******************************************************************************/
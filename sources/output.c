@@ -40,6 +40,7 @@
 #include <string.h> // For strlen
 
 #include "output.h"
+#include "macros.h"
 
 /******************************************************************************/
 
@@ -131,6 +132,95 @@ Quantity_t get_number_of_inspection_points
 
 /******************************************************************************/
 
+/* Marks the cells read by every inspection point of a list */
+
+static Error_t mark_inspection_point_list
+(
+    InspectionPointList_t *list,
+    Dimensions_t          *dimensions,
+    bool                  *marks
+)
+{
+    InspectionPointListNode_t *ipn ;
+
+    for (ipn  = inspection_point_list_begin (list) ;
+         ipn != NULL ;
+         ipn  = inspection_point_list_next (ipn))
+
+        if (mark_inspection_point_cells
+
+                (inspection_point_list_data (ipn), dimensions, marks) != TDICE_SUCCESS)
+
+            return TDICE_FAILURE ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+CellIndex_t *get_output_cells
+(
+    Output_t     *output,
+    Dimensions_t *dimensions,
+    CellIndex_t  *ncells
+)
+{
+    CellIndex_t size = get_number_of_cells (dimensions) ;
+
+    bool *marks = (bool *) calloc (size, sizeof (bool)) ;
+
+    if (marks == NULL)
+    {
+        fprintf (stderr, "Cannot malloc output cell flags\n") ;
+
+        return NULL ;
+    }
+
+    if (   mark_inspection_point_list (&output->InspectionPointListFinal, dimensions, marks) != TDICE_SUCCESS
+        || mark_inspection_point_list (&output->InspectionPointListSlot,  dimensions, marks) != TDICE_SUCCESS
+        || mark_inspection_point_list (&output->InspectionPointListStep,  dimensions, marks) != TDICE_SUCCESS)
+    {
+        free (marks) ;
+
+        return NULL ;
+    }
+
+    CellIndex_t cell ;
+
+    *ncells = 0u ;
+
+    for (cell = 0u ; cell != size ; cell++)
+
+        if (marks [cell] == true)
+
+            (*ncells)++ ;
+
+    CellIndex_t *cells = (CellIndex_t *) malloc (sizeof (CellIndex_t) * MAX (*ncells, 1u)) ;
+
+    if (cells == NULL)
+    {
+        fprintf (stderr, "Cannot malloc output cells\n") ;
+
+        free (marks) ;
+
+        return NULL ;
+    }
+
+    *ncells = 0u ;
+
+    for (cell = 0u ; cell != size ; cell++)
+
+        if (marks [cell] == true)
+
+            cells [(*ncells)++] = cell ;
+
+    free (marks) ;
+
+    return cells ;
+}
+
+/******************************************************************************/
+
 void output_print (Output_t *output, FILE *stream, String_t prefix)
 {
     fprintf (stream, "%soutput :\n", prefix) ;
@@ -234,6 +324,23 @@ Error_t generate_output_headers
 
 /******************************************************************************/
 
+static void invalidate_floorplan_statistics (InspectionPointList_t *list)
+{
+    // The temperatures may have changed since the last output. The statistics
+    // of a floorplan are computed again (once) by the first Tflp or Tflpel
+    // inspection point on the die that needs them
+
+    InspectionPointListNode_t *ipn ;
+
+    for (ipn  = inspection_point_list_begin (list) ;
+         ipn != NULL ;
+         ipn  = inspection_point_list_next (ipn))
+
+        invalidate_statistics_inspection_point (inspection_point_list_data (ipn)) ;
+}
+
+/******************************************************************************/
+
 Error_t generate_output
 (
     Output_t        *output,
@@ -265,6 +372,8 @@ Error_t generate_output
         return TDICE_FAILURE ;
     }
 
+    invalidate_floorplan_statistics (list) ;
+
     InspectionPointListNode_t *ipn ;
 
     for (ipn  = inspection_point_list_begin (list) ;
@@ -273,7 +382,7 @@ Error_t generate_output
     {
         InspectionPoint_t *ipoint = inspection_point_list_data (ipn) ;
 
-        Error_t error = generate_inspection_point_output
+        Error_t error = generate_inspection_point_output_shared
 
             (ipoint, dimensions, temperatures, sources, current_time) ;
 
@@ -282,11 +391,47 @@ Error_t generate_output
             return TDICE_FAILURE ;
     }
 
+    if (   output_instant == TDICE_OUTPUT_INSTANT_SLOT
+        || output_instant == TDICE_OUTPUT_INSTANT_FINAL)
+
+        return output_flush (output) ;
+
    return TDICE_SUCCESS ;
 }
 
 /******************************************************************************/
 
+Error_t output_flush (Output_t *output)
+{
+    Error_t result = TDICE_SUCCESS ;
+
+    InspectionPointList_t *lists [3] =
+    {
+        &output->InspectionPointListFinal,
+        &output->InspectionPointListSlot,
+        &output->InspectionPointListStep
+    } ;
+
+    Quantity_t index ;
+
+    for (index = 0u ; index != 3u ; index++)
+    {
+        InspectionPointListNode_t *ipn ;
+
+        for (ipn  = inspection_point_list_begin (lists [index]) ;
+             ipn != NULL ;
+             ipn  = inspection_point_list_next (ipn))
+
+            if (inspection_point_flush (inspection_point_list_data (ipn)) != TDICE_SUCCESS)
+
+                result = TDICE_FAILURE ;
+    }
+
+    return result ;
+}
+
+/******************************************************************************/
+
 Error_t fill_output_message
 (
     Output_t         *output,
@@ -320,6 +465,8 @@ Error_t fill_output_message
         return TDICE_FAILURE ;
     }
 
+    invalidate_floorplan_statistics (list) ;
+
     InspectionPointListNode_t *ipn ;
 
     for (ipn  = inspection_point_list_begin (list) ;
@@ -330,7 +477,7 @@ Error_t fill_output_message
 
         if (output_type == ipoint->OType)
 
-            fill_message_inspection_point
+            fill_message_inspection_point_shared
 
                 (ipoint, output_quantity, dimensions, temperatures, sources, message) ;
     }
@@ -38,6 +38,7 @@
  ******************************************************************************/
 
 #include <stdlib.h> // For the memory functions malloc/calloc/free
+#include <string.h> // For the memory function memcpy
 
 #include "power_grid.h"
 #include "macros.h"
@@ -58,6 +59,9 @@ void power_grid_init (PowerGrid_t *pgrid)
     pgrid->HeatSinkTopTcs    = NULL ;
     pgrid->HeatSinkBottomTcs = NULL ;
     pgrid->CellsCapacities   = NULL ;
+    pgrid->ConstantSources   = NULL ;
+
+    pgrid->IncrementalUpdates = (Quantity_t) 0u ;
 }
 
 /******************************************************************************/
@@ -135,6 +139,22 @@ Error_t power_grid_build (PowerGrid_t *pgrid, Dimensions_t *dimensions)
         return TDICE_FAILURE ;
     }
 
+    pgrid->ConstantSources = (Source_t *) calloc (pgrid->NCells, sizeof(Source_t)) ;
+
+    if (pgrid->ConstantSources == NULL)
+    {
+        fprintf (stderr, "Cannot malloc constant source vector\n") ;
+
+        free (pgrid->LayersTypeProfile) ;
+        free (pgrid->FloorplansProfile) ;
+        free (pgrid->Sources) ;
+        free (pgrid->HeatSinkTopTcs) ;
+        free (pgrid->HeatSinkBottomTcs) ;
+        free (pgrid->CellsCapacities) ;
+
+        return TDICE_FAILURE ;
+    }
+
 
     CellIndex_t lindex = 0 ;
 
@@ -165,6 +185,8 @@ void power_grid_destroy (PowerGrid_t *pgrid)
 
     if (pgrid->CellsCapacities != NULL)    free (pgrid->CellsCapacities) ;
 
+    if (pgrid->ConstantSources != NULL)    free (pgrid->ConstantSources) ;
+
     power_grid_init (pgrid) ;
 }
 
@@ -403,10 +425,15 @@ void power_grid_fill
 
 /******************************************************************************/
 
-Error_t update_source_vector
+/* Fills \a vector with the heat coming from the heat sinks and from the
+ * coolant inlets, i.e. the sources of the stack when all the floorplan
+ * elements dissipate no power. */
+
+static Error_t fill_constant_sources
 (
     PowerGrid_t    *pgrid,
-    Dimensions_t   *dimensions
+    Dimensions_t   *dimensions,
+    Source_t       *vector
 )
 {
     // reset all the source vector to 0
@@ -415,32 +442,18 @@ Error_t update_source_vector
     CellIndex_t  ccounter ;
     Source_t    *sources ;
 
-    for (ccounter  = 0u,            sources = pgrid->Sources ;
+    for (ccounter  = 0u,            sources = vector ;
          ccounter != pgrid->NCells ;
          ccounter++,                sources++)
 
         *sources = (Source_t) 0.0 ;
 
-    for (layer  = 0u,             sources = pgrid->Sources ;
+    for (layer  = 0u,             sources = vector ;
          layer != pgrid->NLayers ;
          layer++,                 sources += get_layer_area (dimensions))
     {
         switch (pgrid->LayersTypeProfile [layer])
         {
-            case TDICE_LAYER_SOURCE :
-            case TDICE_LAYER_SOURCE_CONNECTED_TO_SPREADER :
-            {
-                Error_t error = fill_sources_floorplan
-
-                    (pgrid->FloorplansProfile [layer], sources) ;
-
-                if (error == TDICE_FAILURE)
-
-                    return TDICE_FAILURE ;
-
-                break ;
-            }
-
             case TDICE_LAYER_SOLID_CONNECTED_TO_AMBIENT :
             {
                 Source_t  *tmpS = sources ;
@@ -468,14 +481,6 @@ Error_t update_source_vector
 
                         *tmpS++ += pgrid->TopHeatSink->AmbientTemperature * *tmpT++ ;
 
-                Error_t error = fill_sources_floorplan
-
-                    (pgrid->FloorplansProfile [layer], sources) ;
-
-                if (error == TDICE_FAILURE)
-
-                    return TDICE_FAILURE ;
-
                 break ;
             }
 
@@ -506,14 +511,6 @@ Error_t update_source_vector
 
                         *tmpS++ += pgrid->BottomHeatSink->AmbientTemperature * *tmpT++ ;
 
-                Error_t error = fill_sources_floorplan
-
-                    (pgrid->FloorplansProfile [layer], sources) ;
-
-                if (error == TDICE_FAILURE)
-
-                    return TDICE_FAILURE ;
-
                 break ;
             }
 
@@ -547,6 +544,8 @@ Error_t update_source_vector
                 break ;
             }
 
+            case TDICE_LAYER_SOURCE :
+            case TDICE_LAYER_SOURCE_CONNECTED_TO_SPREADER :
             case TDICE_LAYER_SOLID :
             case TDICE_LAYER_SOLID_CONNECTED_TO_SPREADER :
             case TDICE_LAYER_VWALL_CHANNEL :
@@ -576,8 +575,159 @@ Error_t update_source_vector
 
 /******************************************************************************/
 
+Error_t update_source_vector
+(
+    PowerGrid_t    *pgrid,
+    Dimensions_t   *dimensions
+)
+{
+    bool full_update = pgrid->IncrementalUpdates == 0u ;
+
+    if (full_update == true)
+    {
+        if (fill_constant_sources (pgrid, dimensions, pgrid->ConstantSources) == TDICE_FAILURE)
+
+            return TDICE_FAILURE ;
+
+        memcpy (pgrid->Sources, pgrid->ConstantSources, sizeof (Source_t) * pgrid->NCells) ;
+
+        pgrid->IncrementalUpdates = TDICE_SOURCES_FULL_UPDATE_PERIOD ;
+    }
+    else
+    {
+        pgrid->IncrementalUpdates-- ;
+    }
+
+    Quantity_t   layer ;
+    Source_t    *sources ;
+
+    for (layer  = 0u,             sources = pgrid->Sources ;
+         layer != pgrid->NLayers ;
+         layer++,                 sources += get_layer_area (dimensions))
+    {
+        Floorplan_t *floorplan = pgrid->FloorplansProfile [layer] ;
+
+        if (floorplan == NULL)
+
+            continue ;
+
+        Error_t error = full_update == true ?
+
+              fill_sources_floorplan   (floorplan, sources)
+            : update_sources_floorplan (floorplan, sources) ;
+
+        if (error == TDICE_FAILURE)
+        {
+            // The sources are not consistent with the powers of the elements
+
+            pgrid->IncrementalUpdates = (Quantity_t) 0u ;
+
+            return TDICE_FAILURE ;
+        }
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+void fill_constant_source_vector
+(
+    PowerGrid_t    *pgrid,
+    Dimensions_t   *dimensions,
+    Source_t       *sources
+)
+{
+    fill_constant_sources (pgrid, dimensions, sources) ;
+}
+
+/******************************************************************************/
+
+Quantity_t get_number_of_floorplan_elements_power_grid (PowerGrid_t *pgrid)
+{
+    Quantity_t layer, nelements = 0u ;
+
+    for (layer = 0u ; layer != pgrid->NLayers ; layer++)
+
+        if (pgrid->FloorplansProfile [layer] != NULL)
+
+            nelements += get_number_of_power_values_floorplan
+
+                             (pgrid->FloorplansProfile [layer]) ;
+
+    return nelements ;
+}
+
+/******************************************************************************/
+
+Error_t add_floorplan_element_sources
+(
+    PowerGrid_t  *pgrid,
+    Dimensions_t *dimensions,
+    Quantity_t    element,
+    Source_t     *sources
+)
+{
+    Quantity_t layer ;
+
+    for (layer = 0u ; layer != pgrid->NLayers ; layer++)
+    {
+        Floorplan_t *floorplan = pgrid->FloorplansProfile [layer] ;
+
+        if (floorplan == NULL)
+
+            continue ;
+
+        Quantity_t nvalues = get_number_of_power_values_floorplan (floorplan) ;
+
+        if (element >= nvalues)
+        {
+            element -= nvalues ;
+
+            continue ;
+        }
+
+        sources += get_cell_offset_in_stack
+
+            (dimensions, layer, first_row (dimensions), first_column (dimensions)) ;
+
+        // The power of a cell of a power map is its source
+
+        if (floorplan->NMapCells != 0u)
+        {
+            sources [element] += (Source_t) 1.0 ;
+
+            return TDICE_SUCCESS ;
+        }
+
+        // The sources are the column of the element in the surface
+        // coefficients of the floorplan
+
+        FloorplanMatrix_t *flpmatrix = &floorplan->SurfaceCoefficients ;
+
+        CellIndex_t index ;
+
+        for (index  = flpmatrix->ColumnPointers [element] ;
+             index != flpmatrix->ColumnPointers [element + 1] ; index++)
+
+            sources [flpmatrix->RowIndices [index]] += flpmatrix->Values [index] ;
+
+        return TDICE_SUCCESS ;
+    }
+
+    fprintf (stderr, "Floorplan element %d out of range\n", element) ;
+
+    return TDICE_FAILURE ;
+}
+
+/******************************************************************************/
+
 void update_channel_sources (PowerGrid_t *pgrid, Dimensions_t *dimensions)
 {
+    // The constant sources must be computed again with the new flow rate
+
+    pgrid->IncrementalUpdates = (Quantity_t) 0u ;
+
     Quantity_t   layer ;
     Source_t    *sources ;
 
@@ -650,6 +800,22 @@ void update_channel_sources (PowerGrid_t *pgrid, Dimensions_t *dimensions)
 
 /******************************************************************************/
 
+bool power_values_failed (PowerGrid_t *pgrid)
+{
+    Quantity_t layer ;
+
+    for (layer = 0u ; layer != pgrid->NLayers ; layer++)
+
+        if (   pgrid->FloorplansProfile [layer] != NULL
+            && power_trace_failed_floorplan (pgrid->FloorplansProfile [layer]) == true)
+
+            return true ;
+
+    return false ;
+}
+
+/******************************************************************************/
+
 Error_t insert_power_values (PowerGrid_t *pgrid, PowersQueue_t *pvalues)
 {
     Quantity_t layer ;
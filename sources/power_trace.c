@@ -0,0 +1,762 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <stdlib.h>   // For the memory functions malloc/free
+#include <string.h>   // For the string functions memcmp/strcmp
+#include <ctype.h>    // For the function isalpha
+#include <sys/mman.h> // For the functions mmap/munmap/madvise
+#include <sys/stat.h> // For the function fstat
+
+#include "power_trace.h"
+
+/******************************************************************************/
+
+#define POWER_TRACE_NAME_LENGTH 256u
+
+#define POWER_TRACE_NO_COLUMN   ((Quantity_t) ~0u)
+
+/******************************************************************************/
+
+void power_trace_init (PowerTrace_t *ptrace)
+{
+    string_init (&ptrace->FileName) ;
+
+    ptrace->Format      = TDICE_POWER_TRACE_CSV ;
+    ptrace->NElements   = (Quantity_t) 0u ;
+    ptrace->NColumns    = (Quantity_t) 0u ;
+    ptrace->Columns     = NULL ;
+    ptrace->NextSlot    = (uint64_t) 0u ;
+    ptrace->File        = NULL ;
+    ptrace->Line        = (Quantity_t) 0u ;
+    ptrace->Buffer      = NULL ;
+    ptrace->BufferSlots = (Quantity_t) 0u ;
+    ptrace->BufferNext  = (Quantity_t) 0u ;
+    ptrace->Map         = NULL ;
+    ptrace->MapSize     = (size_t) 0u ;
+    ptrace->NSlots      = (uint64_t) 0u ;
+    ptrace->Failed      = false ;
+}
+
+/******************************************************************************/
+
+void power_trace_destroy (PowerTrace_t *ptrace)
+{
+    string_destroy (&ptrace->FileName) ;
+
+    if (ptrace->Columns != NULL)
+
+        free (ptrace->Columns) ;
+
+    if (ptrace->File != NULL)
+
+        fclose (ptrace->File) ;
+
+    if (ptrace->Buffer != NULL)
+
+        free (ptrace->Buffer) ;
+
+    if (ptrace->Map != NULL)
+
+        munmap (ptrace->Map, ptrace->MapSize) ;
+
+    power_trace_init (ptrace) ;
+}
+
+/******************************************************************************/
+
+PowerTrace_t *power_trace_calloc (void)
+{
+    PowerTrace_t *ptrace = (PowerTrace_t *) malloc (sizeof (PowerTrace_t)) ;
+
+    if (ptrace != NULL)
+
+        power_trace_init (ptrace) ;
+
+    return ptrace ;
+}
+
+/******************************************************************************/
+
+PowerTrace_t *power_trace_clone (PowerTrace_t *ptrace)
+{
+    if (ptrace == NULL)
+
+        return NULL ;
+
+    PowerTrace_t *newpt = power_trace_calloc ( ) ;
+
+    if (newpt != NULL)
+
+        power_trace_copy (newpt, ptrace) ;
+
+    return newpt ;
+}
+
+/******************************************************************************/
+
+void power_trace_free (PowerTrace_t *ptrace)
+{
+    if (ptrace == NULL)
+
+        return ;
+
+    power_trace_destroy (ptrace) ;
+
+    free (ptrace) ;
+}
+
+/******************************************************************************/
+
+void power_trace_print (PowerTrace_t *ptrace, FILE *stream, String_t prefix)
+{
+    fprintf (stream, "%spower trace \"%s\" ;\n", prefix, ptrace->FileName) ;
+}
+
+/******************************************************************************/
+
+// Skips spaces and tabs and returns the first other character of the line
+
+static int skip_blanks (FILE *file)
+{
+    int c ;
+
+    do
+
+        c = getc (file) ;
+
+    while (c == ' ' || c == '\t' || c == '\r') ;
+
+    return c ;
+}
+
+/******************************************************************************/
+
+static Error_t open_binary (PowerTrace_t *ptrace)
+{
+    FILE *file = fopen (ptrace->FileName, "rb") ;
+
+    if (file == NULL)
+    {
+        fprintf (stderr, "Cannot open power trace %s\n", ptrace->FileName) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    struct stat file_stat ;
+
+    if (fstat (fileno (file), &file_stat) != 0)
+    {
+        fprintf (stderr, "Cannot stat power trace %s\n", ptrace->FileName) ;
+
+        fclose (file) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    ptrace->MapSize = (size_t) file_stat.st_size ;
+
+    if (ptrace->MapSize < sizeof (PowerTraceHeader_t))
+    {
+        fprintf (stderr, "Power trace %s: truncated header\n", ptrace->FileName) ;
+
+        fclose (file) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    // The mapping stays valid after the file has been closed
+
+    ptrace->Map = mmap (NULL, ptrace->MapSize, PROT_READ, MAP_PRIVATE, fileno (file), 0) ;
+
+    fclose (file) ;
+
+    if (ptrace->Map == MAP_FAILED)
+    {
+        fprintf (stderr, "Cannot map power trace %s\n", ptrace->FileName) ;
+
+        ptrace->Map = NULL ;
+
+        return TDICE_FAILURE ;
+    }
+
+    // Slots are consumed in order: let the kernel read ahead
+    // and drop the pages already used
+
+    madvise (ptrace->Map, ptrace->MapSize, MADV_SEQUENTIAL) ;
+
+    PowerTraceHeader_t header ;
+
+    memcpy (&header, ptrace->Map, sizeof (PowerTraceHeader_t)) ;
+
+    if (header.Version != TDICE_POWER_TRACE_VERSION)
+    {
+        fprintf (stderr, "Power trace %s: unsupported version %u\n",
+                 ptrace->FileName, header.Version) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    uint64_t size = (ptrace->MapSize - sizeof (PowerTraceHeader_t)) / sizeof (Power_t) ;
+
+    if (header.NColumns == 0u
+        || header.NSlots > size / header.NColumns
+        || header.NSlots * header.NColumns * sizeof (Power_t)
+           != ptrace->MapSize - sizeof (PowerTraceHeader_t))
+    {
+        fprintf (stderr,
+            "Power trace %s: the size of the file does not match"
+            " %llu slots of %u values\n",
+            ptrace->FileName, (unsigned long long) header.NSlots, header.NColumns) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    ptrace->Format   = TDICE_POWER_TRACE_BINARY ;
+    ptrace->NColumns = header.NColumns ;
+    ptrace->NSlots   = header.NSlots ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+// Reads the name of a column of the CSV header into name (surrounding
+// blanks and quotes are removed) and returns the character that ends it
+
+static int read_column_name (FILE *file, char *name)
+{
+    size_t length = 0u ;
+
+    int c = skip_blanks (file) ;
+
+    while (c != ',' && c != '\n' && c != EOF)
+    {
+        if (c != '"' && length < POWER_TRACE_NAME_LENGTH - 1u)
+
+            name [length++] = (char) c ;
+
+        c = getc (file) ;
+    }
+
+    while (length > 0u && (name [length - 1u] == ' '  || name [length - 1u] == '\t'
+                                                      || name [length - 1u] == '\r'))
+        length-- ;
+
+    name [length] = '\0' ;
+
+    return c ;
+}
+
+/******************************************************************************/
+
+// Reads the CSV header and, if list is not NULL, sets the column of
+// every floorplan element. Returns the number of columns (0 on errors)
+
+static Quantity_t read_csv_header (PowerTrace_t *ptrace, FloorplanElementList_t *list)
+{
+    char name [POWER_TRACE_NAME_LENGTH] ;
+
+    Quantity_t column = 0u ;
+
+    int c ;
+
+    do
+    {
+        c = read_column_name (ptrace->File, name) ;
+
+        if (name [0] == '\0')
+        {
+            fprintf (stderr, "Power trace %s:%u: empty column name\n",
+                     ptrace->FileName, ptrace->Line) ;
+
+            return 0u ;
+        }
+
+        if (list != NULL)
+        {
+            Quantity_t index = 0u ;
+
+            FloorplanElementListNode_t *flpeln ;
+
+            for (flpeln  = floorplan_element_list_begin (list) ;
+                 flpeln != NULL ;
+                 flpeln  = floorplan_element_list_next (flpeln), index++)
+
+                if (strcmp (floorplan_element_list_data (flpeln)->Id, name) == 0)
+
+                    break ;
+
+            if (flpeln != NULL)
+            {
+                if (ptrace->Columns [index] != POWER_TRACE_NO_COLUMN)
+                {
+                    fprintf (stderr, "Power trace %s:%u: column %s repeated\n",
+                             ptrace->FileName, ptrace->Line, name) ;
+
+                    return 0u ;
+                }
+
+                ptrace->Columns [index] = column ;
+            }
+        }
+
+        column++ ;
+
+    } while (c == ',') ;
+
+    ptrace->Line++ ;
+
+    return column ;
+}
+
+/******************************************************************************/
+
+static Error_t open_csv (PowerTrace_t *ptrace, FloorplanElementList_t *list)
+{
+    ptrace->File = fopen (ptrace->FileName, "r") ;
+
+    if (ptrace->File == NULL)
+    {
+        fprintf (stderr, "Cannot open power trace %s\n", ptrace->FileName) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    ptrace->Format = TDICE_POWER_TRACE_CSV ;
+    ptrace->Line   = 1u ;
+
+    // Blank lines before the first slot (or the header) are ignored
+
+    int c ;
+
+    while ((c = skip_blanks (ptrace->File)) == '\n')
+
+        ptrace->Line++ ;
+
+    if (c != EOF)
+
+        ungetc (c, ptrace->File) ;
+
+    if (isalpha (c) || c == '"' || c == '_')
+    {
+        ptrace->NColumns = read_csv_header (ptrace, list) ;
+
+        if (ptrace->NColumns == 0u)
+
+            return TDICE_FAILURE ;
+    }
+    else
+    {
+        ptrace->NColumns = ptrace->NElements ;
+
+        if (list != NULL)
+        {
+            Quantity_t index ;
+
+            for (index = 0u ; index != ptrace->NElements ; index++)
+
+                ptrace->Columns [index] = index ;
+        }
+    }
+
+    ptrace->Buffer = (Power_t *) malloc
+
+        (sizeof (Power_t) * TDICE_POWER_TRACE_BUFFER_SLOTS * ptrace->NColumns) ;
+
+    if (ptrace->Buffer == NULL)
+    {
+        fprintf (stderr, "Malloc power trace buffer failed\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+// Reads the next line of a CSV trace into row. Returns 1 if a slot has
+// been read, 0 at the end of the file and -1 if the line is not valid
+
+static int read_csv_slot (PowerTrace_t *ptrace, Power_t *row)
+{
+    int c ;
+
+    while ((c = skip_blanks (ptrace->File)) == '\n')
+
+        ptrace->Line++ ;
+
+    if (c == EOF)
+
+        return 0 ;
+
+    ungetc (c, ptrace->File) ;
+
+    Quantity_t column ;
+
+    for (column = 0u ; column != ptrace->NColumns ; column++)
+    {
+        c = skip_blanks (ptrace->File) ;
+
+        if (c == '\n' || c == EOF)
+        {
+            fprintf (stderr, "Power trace %s:%u: %u power values expected\n",
+                     ptrace->FileName, ptrace->Line, ptrace->NColumns) ;
+
+            return -1 ;
+        }
+
+        ungetc (c, ptrace->File) ;
+
+        if (fscanf (ptrace->File, "%lf", row + column) != 1)
+        {
+            fprintf (stderr, "Power trace %s:%u: power value expected\n",
+                     ptrace->FileName, ptrace->Line) ;
+
+            return -1 ;
+        }
+
+        c = skip_blanks (ptrace->File) ;
+
+        if (column + 1u != ptrace->NColumns ? c != ',' : (c != '\n' && c != EOF))
+        {
+            fprintf (stderr, "Power trace %s:%u: %u power values expected\n",
+                     ptrace->FileName, ptrace->Line, ptrace->NColumns) ;
+
+            return -1 ;
+        }
+    }
+
+    ptrace->Line++ ;
+
+    return 1 ;
+}
+
+/******************************************************************************/
+
+static Error_t fill_buffer (PowerTrace_t *ptrace)
+{
+    ptrace->BufferSlots = 0u ;
+    ptrace->BufferNext  = 0u ;
+
+    while (ptrace->BufferSlots != TDICE_POWER_TRACE_BUFFER_SLOTS)
+    {
+        int result = read_csv_slot
+
+            (ptrace, ptrace->Buffer + ptrace->BufferSlots * ptrace->NColumns) ;
+
+        if (result <= 0)
+        {
+            // Nothing else can be read from this file: the slots
+            // already in the buffer are still consumed
+
+            fclose (ptrace->File) ;
+
+            ptrace->File = NULL ;
+
+            if (result < 0)
+
+                ptrace->Failed = true ;
+
+            return result == 0 || ptrace->BufferSlots != 0u ?
+
+                TDICE_SUCCESS : TDICE_FAILURE ;
+        }
+
+        ptrace->BufferSlots++ ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+static Error_t open_file (PowerTrace_t *ptrace, FloorplanElementList_t *list)
+{
+    FILE *file = fopen (ptrace->FileName, "rb") ;
+
+    if (file == NULL)
+    {
+        fprintf (stderr, "Cannot open power trace %s\n", ptrace->FileName) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    char magic [8] ;
+
+    bool binary = fread (magic, sizeof (magic), 1u, file) == 1u
+                  && memcmp (magic, TDICE_POWER_TRACE_MAGIC, sizeof (magic)) == 0 ;
+
+    fclose (file) ;
+
+    if (binary == false)
+
+        return open_csv (ptrace, list) ;
+
+    if (open_binary (ptrace) == TDICE_FAILURE)
+
+        return TDICE_FAILURE ;
+
+    // A binary trace has no header naming its columns
+
+    if (ptrace->NColumns != ptrace->NElements)
+    {
+        fprintf (stderr,
+            "Power trace %s: %u power values per slot but %u floorplan elements\n",
+            ptrace->FileName, ptrace->NColumns, ptrace->NElements) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    if (list != NULL)
+    {
+        Quantity_t index ;
+
+        for (index = 0u ; index != ptrace->NElements ; index++)
+
+            ptrace->Columns [index] = index ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+Error_t power_trace_open
+
+    (PowerTrace_t *ptrace, String_t file_name, FloorplanElementList_t *list)
+{
+    power_trace_destroy (ptrace) ;
+
+    string_copy (&ptrace->FileName, &file_name) ;
+
+    ptrace->NElements = list->Size ;
+
+    ptrace->Columns = (Quantity_t *) malloc (sizeof (Quantity_t) * ptrace->NElements) ;
+
+    if (ptrace->Columns == NULL)
+    {
+        fprintf (stderr, "Malloc power trace columns failed\n") ;
+
+        power_trace_destroy (ptrace) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    Quantity_t index ;
+
+    for (index = 0u ; index != ptrace->NElements ; index++)
+
+        ptrace->Columns [index] = POWER_TRACE_NO_COLUMN ;
+
+    if (open_file (ptrace, list) == TDICE_FAILURE)
+    {
+        power_trace_destroy (ptrace) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    FloorplanElementListNode_t *flpeln ;
+
+    for (flpeln  = floorplan_element_list_begin (list), index = 0u ;
+         flpeln != NULL ;
+         flpeln  = floorplan_element_list_next (flpeln), index++)
+
+        if (ptrace->Columns [index] == POWER_TRACE_NO_COLUMN)
+        {
+            fprintf (stderr, "Power trace %s: no column for floorplan element %s\n",
+                     ptrace->FileName, floorplan_element_list_data (flpeln)->Id) ;
+
+            power_trace_destroy (ptrace) ;
+
+            return TDICE_FAILURE ;
+        }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+Error_t power_trace_open_map
+
+    (PowerTrace_t *ptrace, String_t file_name, CellIndex_t ncells)
+{
+    power_trace_destroy (ptrace) ;
+
+    string_copy (&ptrace->FileName, &file_name) ;
+
+    ptrace->NElements = ncells ;
+
+    ptrace->Columns = (Quantity_t *) malloc (sizeof (Quantity_t) * ptrace->NElements) ;
+
+    if (ptrace->Columns == NULL)
+    {
+        fprintf (stderr, "Malloc power trace columns failed\n") ;
+
+        power_trace_destroy (ptrace) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    // Frames store the cells in the same order as the thermal grid
+
+    Quantity_t index ;
+
+    for (index = 0u ; index != ptrace->NElements ; index++)
+
+        ptrace->Columns [index] = index ;
+
+    if (open_file (ptrace, NULL) == TDICE_FAILURE)
+    {
+        power_trace_destroy (ptrace) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    if (ptrace->NColumns != ptrace->NElements)
+    {
+        fprintf (stderr,
+            "Power map %s: %u power values per frame but %u thermal cells\n",
+            ptrace->FileName, ptrace->NColumns, ptrace->NElements) ;
+
+        power_trace_destroy (ptrace) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+Error_t power_trace_read (PowerTrace_t *ptrace, Power_t *powers)
+{
+    Power_t *row ;
+
+    if (ptrace->Format == TDICE_POWER_TRACE_BINARY)
+    {
+        if (ptrace->NextSlot == ptrace->NSlots)
+
+            return TDICE_FAILURE ;
+
+        row = (Power_t *) ((char *) ptrace->Map + sizeof (PowerTraceHeader_t))
+              + ptrace->NextSlot * ptrace->NColumns ;
+    }
+    else
+    {
+        if (ptrace->BufferNext == ptrace->BufferSlots)
+        {
+            if (ptrace->File == NULL
+
+                || fill_buffer (ptrace) == TDICE_FAILURE
+
+                || ptrace->BufferSlots == 0u)
+
+                return TDICE_FAILURE ;
+        }
+
+        row = ptrace->Buffer + ptrace->BufferNext++ * ptrace->NColumns ;
+    }
+
+    Quantity_t index ;
+
+    for (index = 0u ; index != ptrace->NElements ; index++)
+
+        powers [index] = row [ ptrace->Columns [index] ] ;
+
+    ptrace->NextSlot++ ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+void power_trace_copy (PowerTrace_t *dst, PowerTrace_t *src)
+{
+    power_trace_destroy (dst) ;
+
+    if (src->FileName == NULL)
+
+        return ;
+
+    string_copy (&dst->FileName, &src->FileName) ;
+
+    dst->NElements = src->NElements ;
+
+    dst->Columns = (Quantity_t *) malloc (sizeof (Quantity_t) * dst->NElements) ;
+
+    Power_t *powers = (Power_t *) malloc (sizeof (Power_t) * dst->NElements) ;
+
+    if (dst->Columns == NULL || powers == NULL)
+    {
+        fprintf (stderr, "ERROR: malloc power trace in power trace copy\n") ;
+
+        free (powers) ;
+
+        return ;
+    }
+
+    memcpy (dst->Columns, src->Columns, sizeof (Quantity_t) * dst->NElements) ;
+
+    // The file is opened again and read up to the slot reached by src
+
+    if (open_file (dst, NULL) == TDICE_FAILURE)
+    {
+        fprintf (stderr, "ERROR: cannot open again power trace %s\n", src->FileName) ;
+
+        free (powers) ;
+
+        return ;
+    }
+
+    if (dst->Format == TDICE_POWER_TRACE_BINARY)
+
+        dst->NextSlot = src->NextSlot ;
+
+    else
+
+        while (dst->NextSlot != src->NextSlot)
+
+            if (power_trace_read (dst, powers) == TDICE_FAILURE)
+
+                break ;
+
+    free (powers) ;
+}
+
+/******************************************************************************/
@@ -0,0 +1,892 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <stdio.h>  // For the file type FILE
+#include <stdlib.h> // For the memory functions malloc/free
+#include <string.h> // For the memory function memset
+#include <math.h>   // For the math functions fabs and sqrt
+
+#include "reduced_model.h"
+#include "thermal_batch.h"
+#include "macros.h"
+
+/* Relative norm below which a new basis vector, once orthogonalized, is
+ * considered linearly dependent from the previous ones and is dropped */
+
+#define REDUCED_DEFLATION_TOLERANCE 1.0e-10
+
+/******************************************************************************/
+
+void reduced_model_init (ReducedModel_t *rmodel)
+{
+    rmodel->NElements     = (Quantity_t) 0u ;
+    rmodel->NCells        = (CellIndex_t) 0u ;
+    rmodel->Cells         = NULL ;
+    rmodel->Order         = (Quantity_t) 0u ;
+    rmodel->StateMatrix   = NULL ;
+    rmodel->InputMatrix   = NULL ;
+    rmodel->OutputMatrix  = NULL ;
+    rmodel->Offsets       = NULL ;
+    rmodel->InitialState  = NULL ;
+    rmodel->State         = NULL ;
+    rmodel->NextState     = NULL ;
+    rmodel->OffsetError   = (Temperature_t) 0.0 ;
+    rmodel->ResponseError = (Temperature_t) 0.0 ;
+    rmodel->ErrorSlots    = (Quantity_t) 0u ;
+}
+
+/******************************************************************************/
+
+static double dot (CellIndex_t size, double *x, double *y)
+{
+    double result = 0.0 ;
+
+    while (size--) result += *x++ * *y++ ;
+
+    return result ;
+}
+
+/******************************************************************************/
+
+/* Computes y = A x for the (CCS) system matrix A */
+
+static void multiply (SystemMatrix_t *sysmatrix, double *x, double *y)
+{
+    CellIndex_t column, index ;
+
+    memset (y, 0, sizeof (double) * sysmatrix->Size) ;
+
+    for (column = 0u ; column != sysmatrix->Size ; column++)
+
+        for (index  = sysmatrix->ColumnPointers [column] ;
+             index != sysmatrix->ColumnPointers [column + 1] ; index++)
+
+            y [sysmatrix->RowIndices [index]] += sysmatrix->Values [index] * x [column] ;
+}
+
+/******************************************************************************/
+
+/* Solves the system for the \a ncolumns vectors stored (one after the other)
+ * in \a vectors , overwriting them with the solutions */
+
+static Error_t solve_columns
+(
+    SystemMatrix_t *sysmatrix,
+    double         *vectors,
+    Quantity_t      ncolumns
+)
+{
+    SuperMatrix b ;
+
+    dCreate_Dense_Matrix
+
+        (&b, sysmatrix->Size, ncolumns, vectors, sysmatrix->Size,
+         SLU_DN, SLU_D, SLU_GE) ;
+
+    Error_t result = solve_sparse_linear_system (sysmatrix, &b) ;
+
+    Destroy_SuperMatrix_Store (&b) ;
+
+    return result ;
+}
+
+/******************************************************************************/
+
+/* Orthonormalizes (Gram-Schmidt, repeated twice) the \a ncandidates vectors
+ * that follow the first \a order vectors of the \a basis and moves the ones
+ * that are not linearly dependent next to the basis. Returns the new number
+ * of vectors in the basis. */
+
+static Quantity_t orthonormalize
+(
+    double      *basis,
+    CellIndex_t  size,
+    Quantity_t   order,
+    Quantity_t   ncandidates
+)
+{
+    Quantity_t candidate, index, pass, first = order ;
+
+    for (candidate = 0u ; candidate != ncandidates ; candidate++)
+    {
+        double *vector = basis + (size_t) (first + candidate) * size ;
+        double  norm   = sqrt (dot (size, vector, vector)) ;
+
+        if (norm == 0.0)
+
+            continue ;
+
+        for (pass = 0u ; pass != 2u ; pass++)
+
+            for (index = 0u ; index != order ; index++)
+            {
+                double *previous = basis + (size_t) index * size ;
+                double  product  = dot (size, previous, vector) ;
+                CellIndex_t cell ;
+
+                for (cell = 0u ; cell != size ; cell++)
+
+                    vector [cell] -= product * previous [cell] ;
+            }
+
+        double residual = sqrt (dot (size, vector, vector)) ;
+
+        if (residual <= REDUCED_DEFLATION_TOLERANCE * norm)
+
+            continue ;
+
+        double *target = basis + (size_t) order * size ;
+        CellIndex_t cell ;
+
+        for (cell = 0u ; cell != size ; cell++)
+
+            target [cell] = vector [cell] / residual ;
+
+        order++ ;
+    }
+
+    return order ;
+}
+
+/******************************************************************************/
+
+/* Solves the dense system M X = R (Gaussian elimination with partial
+ * pivoting). \a matrix is n x n and \a rhs is n x ncolumns , both stored
+ * row by row. Both are overwritten and \a rhs stores the solution X. */
+
+static Error_t dense_solve
+(
+    double     *matrix,
+    Quantity_t  n,
+    double     *rhs,
+    Quantity_t  ncolumns
+)
+{
+    Quantity_t row, column, pivot, index ;
+
+    for (pivot = 0u ; pivot != n ; pivot++)
+    {
+        Quantity_t best = pivot ;
+
+        for (row = pivot + 1u ; row != n ; row++)
+
+            if (fabs (matrix [row * n + pivot]) > fabs (matrix [best * n + pivot]))
+
+                best = row ;
+
+        if (matrix [best * n + pivot] == 0.0)
+
+            return TDICE_FAILURE ;
+
+        if (best != pivot)
+        {
+            for (column = 0u ; column != n ; column++)
+            {
+                double tmp = matrix [pivot * n + column] ;
+                matrix [pivot * n + column] = matrix [best * n + column] ;
+                matrix [best  * n + column] = tmp ;
+            }
+
+            for (column = 0u ; column != ncolumns ; column++)
+            {
+                double tmp = rhs [pivot * ncolumns + column] ;
+                rhs [pivot * ncolumns + column] = rhs [best * ncolumns + column] ;
+                rhs [best  * ncolumns + column] = tmp ;
+            }
+        }
+
+        for (row = pivot + 1u ; row != n ; row++)
+        {
+            double factor = matrix [row * n + pivot] / matrix [pivot * n + pivot] ;
+
+            if (factor == 0.0)
+
+                continue ;
+
+            for (column = pivot ; column != n ; column++)
+
+                matrix [row * n + column] -= factor * matrix [pivot * n + column] ;
+
+            for (column = 0u ; column != ncolumns ; column++)
+
+                rhs [row * ncolumns + column] -= factor * rhs [pivot * ncolumns + column] ;
+        }
+    }
+
+    for (index = n ; index != 0u ; index--)
+    {
+        row = index - 1u ;
+
+        for (column = 0u ; column != ncolumns ; column++)
+        {
+            double value = rhs [row * ncolumns + column] ;
+
+            for (pivot = row + 1u ; pivot != n ; pivot++)
+
+                value -= matrix [row * n + pivot] * rhs [pivot * ncolumns + column] ;
+
+            rhs [row * ncolumns + column] = value / matrix [row * n + row] ;
+        }
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+/* Computes next = A state + B powers and copies it in \a state */
+
+static void advance_state
+(
+    ReducedModel_t *rmodel,
+    double         *state,
+    Power_t        *powers
+)
+{
+    Quantity_t order = rmodel->Order ;
+    Quantity_t row, column ;
+
+    for (row = 0u ; row != order ; row++)
+    {
+        double  value  = 0.0 ;
+        double *matrix = rmodel->StateMatrix + (size_t) row * order ;
+        double *input  = rmodel->InputMatrix + (size_t) row * rmodel->NElements ;
+
+        for (column = 0u ; column != order ; column++)
+
+            value += matrix [column] * state [column] ;
+
+        for (column = 0u ; column != rmodel->NElements ; column++)
+
+            value += input [column] * powers [column] ;
+
+        rmodel->NextState [row] = value ;
+    }
+
+    memcpy (state, rmodel->NextState, sizeof (double) * order) ;
+}
+
+/******************************************************************************/
+
+/* Returns the temperature rise C x of the observed cell \a cell */
+
+static Temperature_t get_output (ReducedModel_t *rmodel, double *state, CellIndex_t cell)
+{
+    return dot (rmodel->Order,
+
+                rmodel->OutputMatrix + (size_t) cell * rmodel->Order, state) ;
+}
+
+/******************************************************************************/
+
+/* Builds, factorizes and projects the system matrices on the Krylov basis */
+
+static Error_t project_model
+(
+    ReducedModel_t *rmodel,
+    ThermalData_t  *tdata,
+    Dimensions_t   *dimensions,
+    Analysis_t     *analysis,
+    Quantity_t      nmoments
+)
+{
+    CellIndex_t size      = tdata->Size ;
+    Quantity_t  nelements = rmodel->NElements ;
+    Quantity_t  width     = nelements + 1u ;
+    Capacity_t *capacities = tdata->PowerGrid.CellsCapacities ;
+
+    /* The conductance matrix G is the steady state system matrix */
+
+    Analysis_t steady = *analysis ;
+
+    steady.AnalysisType = TDICE_ANALYSIS_TYPE_STEADY ;
+
+    SystemMatrix_t gmatrix ;
+
+    system_matrix_init (&gmatrix) ;
+
+    if (system_matrix_build
+
+            (&gmatrix, size, get_number_of_connections (dimensions))
+        == TDICE_FAILURE)
+    {
+        fprintf (stderr, "Cannot malloc system matrix\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    fill_system_matrix (&gmatrix, &tdata->ThermalGrid, &steady, dimensions) ;
+
+    gmatrix.SolverType            = analysis->SolverType ;
+    gmatrix.Krylov.Tolerance      = analysis->SolverTolerance ;
+    gmatrix.Krylov.MaxIterations  = analysis->SolverMaxIterations ;
+    gmatrix.Multifrontal.NThreads = analysis->NThreads ;
+
+    gmatrix.Multifrontal.SinglePrecision = analysis->SinglePrecision ;
+
+    if (analysis->SolverType == TDICE_SOLVER_MULTIGRID)
+
+        multigrid_set_grid (&gmatrix.Krylov.Multigrid, dimensions, &tdata->ThermalGrid) ;
+
+    set_column_ordering (&gmatrix, analysis->Ordering, dimensions, &tdata->ThermalGrid) ;
+
+    double *basis  = (double *) malloc (sizeof (double) * (size_t) nmoments * width * size) ;
+    double *work   = (double *) malloc (sizeof (double) * size) ;
+    double *offset = (double *) malloc (sizeof (double) * size) ;
+
+    Error_t result = TDICE_FAILURE ;
+
+    if (basis == NULL || work == NULL || offset == NULL)
+    {
+        fprintf (stderr, "Cannot malloc the Krylov basis\n") ;
+
+        goto release ;
+    }
+
+    if (do_factorization (&gmatrix) != TDICE_SUCCESS)
+
+        goto release ;
+
+    /* Temperatures T_s with the ambient and coolant sources only */
+
+    fill_constant_source_vector (&tdata->PowerGrid, dimensions, offset) ;
+
+    if (solve_columns (&gmatrix, offset, 1u) != TDICE_SUCCESS)
+
+        goto solver_error ;
+
+    /* First block: G^-1 B and the initial temperatures minus T_s */
+
+    Quantity_t  element, first = 0u, order = 0u, moment ;
+    CellIndex_t cell ;
+
+    for (element = 0u ; element != nelements ; element++)
+    {
+        double *vector = basis + (size_t) element * size ;
+
+        memset (vector, 0, sizeof (double) * size) ;
+
+        add_floorplan_element_sources (&tdata->PowerGrid, dimensions, element, vector) ;
+    }
+
+    if (nelements != 0u && solve_columns (&gmatrix, basis, nelements) != TDICE_SUCCESS)
+
+        goto solver_error ;
+
+    for (cell = 0u ; cell != size ; cell++)
+
+        basis [(size_t) nelements * size + cell] = analysis->InitialTemperature - offset [cell] ;
+
+    order = orthonormalize (basis, size, 0u, width) ;
+
+    /* Next blocks: G^-1 C times the previous block */
+
+    for (moment = 1u ; moment != nmoments && order != first ; moment++)
+    {
+        Quantity_t nvectors = order - first, vector ;
+        double    *block    = basis + (size_t) order * size ;
+
+        for (vector = 0u ; vector != nvectors ; vector++)
+
+            for (cell = 0u ; cell != size ; cell++)
+
+                block [(size_t) vector * size + cell] =
+
+                    capacities [cell] * basis [(size_t) (first + vector) * size + cell] ;
+
+        if (solve_columns (&gmatrix, block, nvectors) != TDICE_SUCCESS)
+
+            goto solver_error ;
+
+        first = order ;
+        order = orthonormalize (basis, size, order, nvectors) ;
+    }
+
+    /* Projections C_r = V' C V , G_r = V' G V and B_r = V' B, stored in
+     * the system [ C_r / h + G_r ] X = [ C_r / h | B_r ] (row by row) */
+
+    Time_t     step_time = get_matrix_step_time (analysis) ;
+    Quantity_t ncolumns  = order + nelements ;
+    Quantity_t row, column ;
+
+    double *matrix = (double *) malloc (sizeof (double) * MAX ((size_t) order * order, 1u)) ;
+    double *rhs    = (double *) malloc (sizeof (double) * MAX ((size_t) order * ncolumns, 1u)) ;
+
+    rmodel->Order        = order ;
+    rmodel->StateMatrix  = (double *) malloc (sizeof (double) * MAX ((size_t) order * order, 1u)) ;
+    rmodel->InputMatrix  = (double *) malloc (sizeof (double) * MAX ((size_t) order * nelements, 1u)) ;
+    rmodel->OutputMatrix = (double *) malloc (sizeof (double) * MAX ((size_t) rmodel->NCells * order, 1u)) ;
+    rmodel->InitialState = (double *) malloc (sizeof (double) * MAX (order, 1u)) ;
+    rmodel->State        = (double *) malloc (sizeof (double) * MAX (order, 1u)) ;
+    rmodel->NextState    = (double *) malloc (sizeof (double) * MAX (order, 1u)) ;
+
+    if (   matrix == NULL || rhs == NULL
+        || rmodel->StateMatrix  == NULL || rmodel->InputMatrix == NULL
+        || rmodel->OutputMatrix == NULL || rmodel->InitialState == NULL
+        || rmodel->State        == NULL || rmodel->NextState   == NULL)
+    {
+        fprintf (stderr, "Cannot malloc the reduced model\n") ;
+
+        free (matrix) ;
+        free (rhs) ;
+
+        goto release ;
+    }
+
+    for (column = 0u ; column != order ; column++)
+    {
+        double *vector = basis + (size_t) column * size ;
+
+        multiply (&gmatrix, vector, work) ;
+
+        for (row = 0u ; row != order ; row++)
+
+            matrix [row * order + column] = dot (size, basis + (size_t) row * size, work) ;
+
+        for (cell = 0u ; cell != size ; cell++)
+
+            work [cell] = capacities [cell] * vector [cell] ;
+
+        for (row = 0u ; row != order ; row++)
+        {
+            double capacity = dot (size, basis + (size_t) row * size, work) / step_time ;
+
+            matrix [row * order    + column] += capacity ;
+            rhs    [row * ncolumns + column]  = capacity ;
+        }
+    }
+
+    for (element = 0u ; element != nelements ; element++)
+    {
+        memset (work, 0, sizeof (double) * size) ;
+
+        add_floorplan_element_sources (&tdata->PowerGrid, dimensions, element, work) ;
+
+        for (row = 0u ; row != order ; row++)
+
+            rhs [row * ncolumns + order + element] = dot (size, basis + (size_t) row * size, work) ;
+    }
+
+    /* Outputs, offsets and initial state */
+
+    for (cell = 0u ; cell != rmodel->NCells ; cell++)
+    {
+        rmodel->Offsets [cell] = offset [rmodel->Cells [cell]] ;
+
+        for (column = 0u ; column != order ; column++)
+
+            rmodel->OutputMatrix [(size_t) cell * order + column] =
+
+                basis [(size_t) column * size + rmodel->Cells [cell]] ;
+    }
+
+    for (cell = 0u ; cell != size ; cell++)
+
+        work [cell] = analysis->InitialTemperature - offset [cell] ;
+
+    for (row = 0u ; row != order ; row++)
+
+        rmodel->InitialState [row] = dot (size, basis + (size_t) row * size, work) ;
+
+    /* Discretization: x(n+1) = X x(n) + X' p with backward Euler while the
+     * trapezoidal rule extrapolates 2 X - I (see solve_time_step) */
+
+    if (dense_solve (matrix, order, rhs, ncolumns) != TDICE_SUCCESS)
+    {
+        fprintf (stderr, "Reduced model: singular system matrix\n") ;
+
+        free (matrix) ;
+        free (rhs) ;
+
+        goto release ;
+    }
+
+    double scale = analysis->IntegrationMethod == TDICE_INTEGRATION_TRAPEZOIDAL ? 2.0 : 1.0 ;
+
+    for (row = 0u ; row != order ; row++)
+    {
+        for (column = 0u ; column != order ; column++)
+
+            rmodel->StateMatrix [row * order + column] =
+
+                scale * rhs [row * ncolumns + column] - (scale - 1.0) * (row == column) ;
+
+        for (element = 0u ; element != nelements ; element++)
+
+            rmodel->InputMatrix [row * nelements + element] =
+
+                scale * rhs [row * ncolumns + order + element] ;
+    }
+
+    free (matrix) ;
+    free (rhs) ;
+
+    result = TDICE_SUCCESS ;
+
+    goto release ;
+
+solver_error :
+
+    fprintf (stderr, "Reduced model: error solving the linear system\n") ;
+
+release :
+
+    free (basis) ;
+    free (work) ;
+    free (offset) ;
+
+    system_matrix_destroy (&gmatrix) ;
+
+    return result ;
+}
+
+/******************************************************************************/
+
+/* Measures the error of the reduced model against the full one on the zero
+ * power response and on the impulse responses (see ImpulseResponse_t) */
+
+static Error_t measure_error
+(
+    ReducedModel_t *rmodel,
+    ThermalData_t  *tdata,
+    Dimensions_t   *dimensions,
+    Analysis_t     *analysis,
+    Quantity_t      nslots
+)
+{
+    CellIndex_t ncells    = rmodel->NCells ;
+    Quantity_t  nelements = rmodel->NElements ;
+    Quantity_t  order     = rmodel->Order ;
+
+    double        *states = (double *)        malloc (sizeof (double) * MAX ((size_t) (nelements + 1u) * order, 1u)) ;
+    Power_t       *powers = (Power_t *)       calloc (MAX (nelements, 1u), sizeof (Power_t)) ;
+    Temperature_t *errors = (Temperature_t *) calloc (MAX (ncells, 1u), sizeof (Temperature_t)) ;
+
+    if (states == NULL || powers == NULL || errors == NULL)
+    {
+        fprintf (stderr, "Cannot malloc the reduced model states\n") ;
+
+        free (states) ;
+        free (powers) ;
+        free (errors) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    /* Same scenarios of impulse_response_build , the analysis is copied to
+     * keep the time of the caller */
+
+    Analysis_t local = *analysis ;
+
+    local.CurrentTime = (Quantity_t) 0u ;
+
+    ThermalBatch_t batch ;
+
+    thermal_batch_init (&batch) ;
+
+    if (thermal_batch_build (&batch, tdata, nelements + 1u, &local) != TDICE_SUCCESS)
+    {
+        free (states) ;
+        free (powers) ;
+        free (errors) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    fill_constant_source_vector
+
+        (&tdata->PowerGrid, dimensions, get_batch_sources (&batch, 0u)) ;
+
+    memcpy (states, rmodel->InitialState, sizeof (double) * order) ;
+    memset (states + order, 0, sizeof (double) * nelements * order) ;
+
+    Quantity_t element, slot ;
+    CellIndex_t cell ;
+
+    for (element = 0u ; element != nelements ; element++)
+    {
+        Source_t *sources = get_batch_sources (&batch, element + 1u) ;
+
+        memset (sources, 0, sizeof (Source_t) * batch.Size) ;
+        memset (get_batch_temperatures (&batch, element + 1u), 0,
+                sizeof (Temperature_t) * batch.Size) ;
+
+        add_floorplan_element_sources (&tdata->PowerGrid, dimensions, element, sources) ;
+    }
+
+    Error_t result = TDICE_SUCCESS ;
+
+    rmodel->OffsetError = (Temperature_t) 0.0 ;
+
+    for (slot = 0u ; slot != nslots ; slot++)
+    {
+        SimResult_t res ;
+
+        do
+        {
+            // The impulse is given during the first slot only
+
+            for (element = 0u ; element != nelements ; element++)
+            {
+                powers [element] = slot == 0u ? 1.0 : 0.0 ;
+
+                advance_state (rmodel, states + (size_t) (element + 1u) * order, powers) ;
+
+                powers [element] = 0.0 ;
+            }
+
+            advance_state (rmodel, states, powers) ;
+
+            res = emulate_batch_step (&batch, tdata, &local) ;
+        }
+        while (res == TDICE_STEP_DONE) ;
+
+        if (res != TDICE_SLOT_DONE)
+        {
+            fprintf (stderr, "Reduced model: error solving the linear system\n") ;
+
+            result = TDICE_FAILURE ;
+
+            break ;
+        }
+
+        for (cell = 0u ; cell != ncells ; cell++)
+        {
+            CellIndex_t index = rmodel->Cells [cell] ;
+
+            rmodel->OffsetError = MAX (rmodel->OffsetError,
+
+                fabs (  rmodel->Offsets [cell] + get_output (rmodel, states, cell)
+                      - get_batch_temperatures (&batch, 0u) [index])) ;
+
+            for (element = 0u ; element != nelements ; element++)
+
+                errors [cell] += fabs
+
+                    (  get_output (rmodel, states + (size_t) (element + 1u) * order, cell)
+                     - get_batch_temperatures (&batch, element + 1u) [index]) ;
+        }
+
+        if (slot == 0u)
+
+            for (element = 0u ; element != nelements ; element++)
+
+                memset (get_batch_sources (&batch, element + 1u), 0,
+                        sizeof (Source_t) * batch.Size) ;
+    }
+
+    rmodel->ResponseError = (Temperature_t) 0.0 ;
+
+    for (cell = 0u ; cell != ncells ; cell++)
+
+        rmodel->ResponseError = MAX (rmodel->ResponseError, errors [cell]) ;
+
+    rmodel->ErrorSlots = nslots ;
+
+    thermal_batch_destroy (&batch) ;
+
+    free (states) ;
+    free (powers) ;
+    free (errors) ;
+
+    return result ;
+}
+
+/******************************************************************************/
+
+Error_t reduced_model_build
+(
+    ReducedModel_t *rmodel,
+    ThermalData_t  *tdata,
+    Dimensions_t   *dimensions,
+    Analysis_t     *analysis,
+    Output_t       *output,
+    Quantity_t      nmoments,
+    Quantity_t      nslots
+)
+{
+    if (analysis->AnalysisType != TDICE_ANALYSIS_TYPE_TRANSIENT)
+    {
+        fprintf (stderr, "Reduced models need a transient analysis\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    if (analysis->StepTolerance > 0.0)
+    {
+        fprintf (stderr, "Reduced models need a fixed time step\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    HeatSink_t *sink = tdata->ThermalGrid.TopHeatSink ;
+
+    if (sink != NULL && sink->SinkModel == TDICE_HEATSINK_TOP_PLUGGABLE)
+    {
+        fprintf (stderr, "Reduced models do not support pluggable heat sinks\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    if (nmoments == 0u)
+    {
+        fprintf (stderr, "Reduced models need at least one moment\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    /* Collects the cells read by the inspection points */
+
+    rmodel->Cells = get_output_cells (output, dimensions, &rmodel->NCells) ;
+
+    if (rmodel->Cells == NULL)
+    {
+        fprintf (stderr, "Reduced model: cannot collect the output cells (Pmap is not supported)\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    rmodel->NElements = get_number_of_floorplan_elements_power_grid (&tdata->PowerGrid) ;
+
+    rmodel->Offsets = (Temperature_t *) malloc
+
+        (sizeof (Temperature_t) * MAX (rmodel->NCells, 1u)) ;
+
+    if (rmodel->Offsets == NULL)
+    {
+        fprintf (stderr, "Cannot malloc the reduced model\n") ;
+
+        reduced_model_destroy (rmodel) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    if (   project_model (rmodel, tdata, dimensions, analysis, nmoments) != TDICE_SUCCESS
+        || (nslots != 0u
+            && measure_error (rmodel, tdata, dimensions, analysis, nslots) != TDICE_SUCCESS))
+    {
+        reduced_model_destroy (rmodel) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    reset_reduced_state (rmodel) ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+void reduced_model_destroy (ReducedModel_t *rmodel)
+{
+    free (rmodel->Cells) ;
+    free (rmodel->StateMatrix) ;
+    free (rmodel->InputMatrix) ;
+    free (rmodel->OutputMatrix) ;
+    free (rmodel->Offsets) ;
+    free (rmodel->InitialState) ;
+    free (rmodel->State) ;
+    free (rmodel->NextState) ;
+
+    reduced_model_init (rmodel) ;
+}
+
+/******************************************************************************/
+
+void reset_reduced_state (ReducedModel_t *rmodel)
+{
+    memcpy (rmodel->State, rmodel->InitialState, sizeof (double) * rmodel->Order) ;
+}
+
+/******************************************************************************/
+
+SimResult_t emulate_reduced_step
+(
+    ReducedModel_t *rmodel,
+    Analysis_t     *analysis,
+    Power_t        *powers,
+    Temperature_t  *temperatures
+)
+{
+    if (analysis->AnalysisType != TDICE_ANALYSIS_TYPE_TRANSIENT)
+
+        return TDICE_WRONG_CONFIG ;
+
+    advance_state (rmodel, rmodel->State, powers) ;
+
+    CellIndex_t cell ;
+
+    for (cell = 0u ; cell != rmodel->NCells ; cell++)
+
+        temperatures [rmodel->Cells [cell]] =
+
+            rmodel->Offsets [cell] + get_output (rmodel, rmodel->State, cell) ;
+
+    increase_by_step_time (analysis) ;
+
+    if (slot_completed (analysis) == false)
+
+        return TDICE_STEP_DONE ;
+
+    else
+
+        return TDICE_SLOT_DONE ;
+}
+
+/******************************************************************************/
+
+SimResult_t emulate_reduced_slot
+(
+    ReducedModel_t *rmodel,
+    Analysis_t     *analysis,
+    Power_t        *powers,
+    Temperature_t  *temperatures
+)
+{
+    SimResult_t result ;
+
+    do
+
+        result = emulate_reduced_step (rmodel, analysis, powers, temperatures) ;
+
+    while (result == TDICE_STEP_DONE) ;
+
+    return result ;
+}
+
+/******************************************************************************/
@@ -37,11 +37,65 @@
  ******************************************************************************/
 
 #include <stdlib.h> // For the memory functions malloc/free
+#include <math.h>   // For the math functions floor/fabs/signbit
 
 #include "stack_element.h"
 
 /******************************************************************************/
 
+/* Prints \a value as fprintf (stream, "%7.3f  ", value) does. Thermal and
+ * power maps print thousands of values per output and the digits are
+ * generated here with integer arithmetics. Values too large or too close
+ * to a rounding tie (where the product by 1000 could round differently
+ * than printf) are still printed with fprintf. */
+
+static void print_map_value (FILE *stream, double value)
+{
+    double scaled = fabs (value) * 1000.0 ;
+
+    double integral = floor (scaled) ;
+
+    if (! (scaled < 1e9) || fabs (scaled - integral - 0.5) < 1e-4)
+    {
+        fprintf (stream, "%7.3f  ", value) ;
+
+        return ;
+    }
+
+    unsigned long digits = (unsigned long) integral + (scaled - integral > 0.5) ;
+
+    char buffer [24], *end = buffer + sizeof (buffer), *begin = end ;
+
+    *--begin = ' ' ;
+    *--begin = ' ' ;
+
+    int count ;
+
+    for (count = 0 ; count != 3 ; count++, digits /= 10u)
+
+        *--begin = (char) ('0' + digits % 10u) ;
+
+    *--begin = '.' ;
+
+    do
+
+        *--begin = (char) ('0' + digits % 10u) ;
+
+    while ((digits /= 10u) != 0u) ;
+
+    if (signbit (value))
+
+        *--begin = '-' ;
+
+    while (end - begin < 7 + 2)
+
+        *--begin = ' ' ;
+
+    fwrite (begin, sizeof (char), (size_t) (end - begin), stream) ;
+}
+
+/******************************************************************************/
+
 void stack_element_init (StackElement_t *stkel)
 {
     stkel->SEType           = (StackElementType_t) TDICE_STACK_ELEMENT_NONE ;
@@ -177,15 +231,37 @@ void stack_element_print
             break ;
 
         case TDICE_STACK_ELEMENT_DIE :
+        {
+            Floorplan_t *floorplan = &stkel->Pointer.Die->Floorplan ;
 
-            fprintf (stream,
-                "%s   die      %s %s floorplan \"%s\" ;\n",
-                prefix,
-                stkel->Id,
-                stkel->Pointer.Die->Id,
-                stkel->Pointer.Die->Floorplan.FileName) ;
+            if (floorplan->NMapCells == 0u)
+
+                fprintf (stream,
+                    "%s   die      %s %s floorplan \"%s\" ;\n",
+                    prefix,
+                    stkel->Id,
+                    stkel->Pointer.Die->Id,
+                    floorplan->FileName) ;
+
+            else if (floorplan->PowerTrace != NULL)
+
+                fprintf (stream,
+                    "%s   die      %s %s power map \"%s\" ;\n",
+                    prefix,
+                    stkel->Id,
+                    stkel->Pointer.Die->Id,
+                    floorplan->PowerTrace->FileName) ;
+
+            else
+
+                fprintf (stream,
+                    "%s   die      %s %s power map ;\n",
+                    prefix,
+                    stkel->Id,
+                    stkel->Pointer.Die->Id) ;
 
             break ;
+        }
 
         case TDICE_STACK_ELEMENT_LAYER :
 
@@ -247,7 +323,7 @@ void stack_element_print_thermal_map
     {
         for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
         {
-            fprintf (stream, "%7.3f  ", *temperatures++) ;
+            print_map_value (stream, *temperatures++) ;
         }
 
         fprintf (stream, "\n") ;
@@ -276,7 +352,7 @@ void stack_element_print_power_map
     {
         for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
         {
-            fprintf (stream, "%7.3f  ", *sources++) ;
+            print_map_value (stream, *sources++) ;
         }
 
         fprintf (stream, "\n") ;
@@ -292,7 +368,7 @@ Quantity_t get_number_of_floorplan_elements_stack_element
 {
     if (stkel->SEType == TDICE_STACK_ELEMENT_DIE)
 
-        return get_number_of_floorplan_elements_floorplan
+        return get_number_of_power_values_floorplan
 
             (&stkel->Pointer.Die->Floorplan) ;
 
@@ -38,6 +38,12 @@
  ******************************************************************************/
 
 #include <stdlib.h> // For the memory functions malloc/free
+#include <string.h> // For the string functions strlen/memcmp
+#include <math.h>   // For the math functions fabs/sqrt
+#include <float.h>  // For the constant DBL_EPSILON
+#include <pthread.h> // For the thread functions pthread_create/join
+#include <unistd.h>   // For the function close
+#include <sys/stat.h> // For the function fchmod
 
 #include "system_matrix.h"
 #include "macros.h"
@@ -56,6 +62,21 @@ void system_matrix_init (SystemMatrix_t* sysmatrix)
     sysmatrix->SLU_PermutationMatrixC = NULL ;
     sysmatrix->SLU_Etree              = NULL ;
 
+    sysmatrix->FactorsFromCache = false ;
+
+    sysmatrix->SolverType = TDICE_SOLVER_SUPERLU ;
+
+    krylov_solver_init (&sysmatrix->Krylov) ;
+
+    multifrontal_solver_init (&sysmatrix->Multifrontal) ;
+
+    sysmatrix->SymmetricPositiveDefinite = false ;
+
+    sysmatrix->ANorm               = 0.0 ;
+    sysmatrix->RefinementResiduals = NULL ;
+    sysmatrix->RefinementRhs       = NULL ;
+    sysmatrix->RefinementColumns   = (Quantity_t) 0u ;
+
     sysmatrix->SLUMatrix_A.Store          = NULL ;
     sysmatrix->SLUMatrix_A_Permuted.Store = NULL ;
     sysmatrix->SLUMatrix_L.Store          = NULL ;
@@ -175,275 +196,912 @@ Error_t system_matrix_build
 
 /******************************************************************************/
 
-Error_t do_factorization (SystemMatrix_t *sysmatrix)
+static bool is_symmetric (SystemMatrix_t *sysmatrix)
 {
-    if (sysmatrix->SLU_Options.Fact == DOFACT)
+    CellIndex_t column, index, other ;
+
+    for (column = 0u ; column != sysmatrix->Size ; column++)
     {
-        get_perm_c
+        for (index  = sysmatrix->ColumnPointers [column] ;
+             index != sysmatrix->ColumnPointers [column + 1] ; index++)
+        {
+            CellIndex_t row = sysmatrix->RowIndices [index] ;
 
-            (sysmatrix->SLU_Options.ColPerm, &sysmatrix->SLUMatrix_A,
-            sysmatrix->SLU_PermutationMatrixC) ;
+            for (other  = sysmatrix->ColumnPointers [row] ;
+                 other != sysmatrix->ColumnPointers [row + 1] ; other++)
 
-        sp_preorder
+                if (sysmatrix->RowIndices [other] == column)
 
-            (&sysmatrix->SLU_Options, &sysmatrix->SLUMatrix_A,
-            sysmatrix->SLU_PermutationMatrixC, sysmatrix->SLU_Etree,
-            &sysmatrix->SLUMatrix_A_Permuted) ;
-    }
-    else if (sysmatrix->SLU_Options.Fact == FACTORED)
-    {
-         sysmatrix->SLU_Options.Fact = SamePattern_SameRowPerm ;
-    }
-    else
-    {
-        fprintf (stderr, "ERROR: wrong factorization status %d\n",
-            sysmatrix->SLU_Options.Fact) ;
+                    break ;
 
-        return TDICE_FAILURE ;
+            if (   other == sysmatrix->ColumnPointers [row + 1]
+                || fabs (sysmatrix->Values [other] - sysmatrix->Values [index])
+                   > 1e-12 * fabs (sysmatrix->Values [index]))
+
+                return false ;
+        }
     }
 
-    dgstrf
+    return true ;
+}
 
-        (&sysmatrix->SLU_Options, &sysmatrix->SLUMatrix_A_Permuted,
-         sp_ienv(2), sp_ienv(1), /* relax and panel size */
-         sysmatrix->SLU_Etree,
-         NULL, 0,                /* work and lwork */
-         sysmatrix->SLU_PermutationMatrixC, sysmatrix->SLU_PermutationMatrixR,
-         &sysmatrix->SLUMatrix_L, &sysmatrix->SLUMatrix_U,
-         &sysmatrix->SLU_Stat, &sysmatrix->SLU_Info) ;
+/******************************************************************************/
 
-    if (sysmatrix->SLU_Info == 0)
-    {
-        sysmatrix->SLU_Options.Fact = FACTORED ;
+// A symmetric matrix with a positive and (weakly) dominant diagonal is positive
+// semidefinite, and definite if it is also irreducible, as the system matrix.
 
-        return TDICE_SUCCESS ;
-    }
-    else
+static bool is_diagonally_dominant (SystemMatrix_t *sysmatrix)
+{
+    CellIndex_t column, index ;
+
+    for (column = 0u ; column != sysmatrix->Size ; column++)
     {
-        fprintf (stderr, "SuperLu factorization error %d\n", sysmatrix->SLU_Info) ;
+        double diagonal = 0.0, others = 0.0 ;
 
-        return TDICE_FAILURE ;
+        for (index  = sysmatrix->ColumnPointers [column] ;
+             index != sysmatrix->ColumnPointers [column + 1] ; index++)
+
+            if (sysmatrix->RowIndices [index] == column)
+
+                diagonal += sysmatrix->Values [index] ;
+
+            else
+
+                others += fabs (sysmatrix->Values [index]) ;
+
+        if (diagonal <= 0.0 || diagonal < others * (1.0 - 1e-12))
+
+            return false ;
     }
+
+    return true ;
 }
 
 /******************************************************************************/
 
-void system_matrix_destroy (SystemMatrix_t *sysmatrix)
+// SuperLU factorizes only unsymmetric matrices in double precision: the
+// multifrontal solver is used in its place to compute the Cholesky
+// decomposition of the symmetric ones and the factors in single precision
+
+static bool use_multifrontal (SystemMatrix_t *sysmatrix)
 {
-    free (sysmatrix->ColumnPointers) ;
-    free (sysmatrix->RowIndices) ;
-    free (sysmatrix->Values) ;
+    return    sysmatrix->SolverType == TDICE_SOLVER_MULTIFRONTAL
+           || (   sysmatrix->SolverType == TDICE_SOLVER_SUPERLU
+               && (   sysmatrix->SymmetricPositiveDefinite == true
+                   || sysmatrix->Multifrontal.SinglePrecision == true)) ;
+}
 
-    free (sysmatrix->SLU_PermutationMatrixR) ;
-    free (sysmatrix->SLU_PermutationMatrixC) ;
-    free (sysmatrix->SLU_Etree) ;
+/******************************************************************************/
 
-    StatFree (&sysmatrix->SLU_Stat) ;
+void set_column_ordering
+(
+    SystemMatrix_t *sysmatrix,
+    OrderingType_t  ordering,
+    Dimensions_t   *dimensions,
+    ThermalGrid_t  *thermal_grid
+)
+{
+    if (ordering == TDICE_ORDERING_NESTED_DISSECTION)
+    {
+        nested_dissection_ordering
 
-    Destroy_SuperMatrix_Store (&sysmatrix->SLUMatrix_A) ;
+            (dimensions, thermal_grid, sysmatrix->SLU_PermutationMatrixC) ;
 
-    if (sysmatrix->SLU_Options.Fact != DOFACT )
-    {
-        Destroy_CompCol_Permuted (&sysmatrix->SLUMatrix_A_Permuted) ;
-        Destroy_SuperNode_Matrix (&sysmatrix->SLUMatrix_L) ;
-        Destroy_CompCol_Matrix   (&sysmatrix->SLUMatrix_U) ;
+        sysmatrix->SLU_Options.ColPerm = MY_PERMC ;
     }
+    else
 
-    system_matrix_init (sysmatrix) ;
+        sysmatrix->SLU_Options.ColPerm = MMD_AT_PLUS_A ;
 }
 
 /******************************************************************************/
 
-static SystemMatrix_t add_solid_column
+// Makes the work buffers of the iterative refinement large enough for
+// ncolumns right hand sides
+
+static Error_t reserve_refinement_buffers
 (
-    SystemMatrix_t  sysmatrix,
-    ThermalGrid_t  *thermal_grid,
-    Analysis_t     *analysis,
-    Dimensions_t   *dimensions,
-    CellIndex_t     layer_index,
-    CellIndex_t     row_index,
-    CellIndex_t     column_index
+    SystemMatrix_t *sysmatrix,
+    Quantity_t      ncolumns
 )
 {
-    Conductance_t conductance = 0.0 ;
-    SystemMatrixCoeff_t  diagonal_value   = 0.0 ;
-    SystemMatrixCoeff_t *diagonal_pointer = NULL ;
+    if (ncolumns <= sysmatrix->RefinementColumns)
 
-    Conductance_t g_bottom, g_top, g_north, g_south, g_east, g_west ;
+        return TDICE_SUCCESS ;
 
-#ifdef PRINT_SYSTEM_MATRIX
-    fpos_t diag_fposition, last_fpos ;
+    size_t size = sizeof (double) * sysmatrix->Size * ncolumns ;
 
-    fprintf (stderr,
-        "add_solid_column   l %2d r %4d c %4d [%7d]\n",
-        layer_index, row_index, column_index,
-        get_cell_offset_in_stack (dimensions, layer_index, row_index, column_index)) ;
-#endif
+    double *residuals = (double *) realloc (sysmatrix->RefinementResiduals, size) ;
 
-    *sysmatrix.ColumnPointers = *(sysmatrix.ColumnPointers - 1) ;
+    if (residuals == NULL)
+    {
+        fprintf (stderr, "Cannot malloc the residuals of the refinement\n") ;
 
-    /********************************* BOTTOM *********************************/
+        return TDICE_FAILURE ;
+    }
 
-    if (layer_index == first_layer (dimensions))
+    sysmatrix->RefinementResiduals = residuals ;
 
-        goto skip_bottom ;
+    double *rhs = (double *) realloc (sysmatrix->RefinementRhs, size) ;
 
-    *sysmatrix.RowIndices++ = get_cell_offset_in_stack
+    if (rhs == NULL)
+    {
+        fprintf (stderr, "Cannot malloc the right hand sides of the refinement\n") ;
 
-        (dimensions, layer_index - 1, row_index, column_index) ;
+        return TDICE_FAILURE ;
+    }
 
-    g_bottom = get_conductance_bottom
+    sysmatrix->RefinementRhs     = rhs ;
+    sysmatrix->RefinementColumns = ncolumns ;
 
-        (thermal_grid, dimensions, layer_index    , row_index, column_index) ;
+    return TDICE_SUCCESS ;
+}
 
-    g_top = get_conductance_top
+/******************************************************************************/
 
-        (thermal_grid, dimensions, layer_index - 1, row_index, column_index) ;
+// Allocates the work buffers of the iterative refinement and computes the
+// infinity norm of A (the largest sum of a row)
 
-    if (g_top == 0)
+static Error_t prepare_refinement (SystemMatrix_t *sysmatrix)
+{
+    CellIndex_t cell, index ;
 
-        conductance = g_bottom ;
+    if (reserve_refinement_buffers (sysmatrix, 1u) != TDICE_SUCCESS)
 
-    else
+        return TDICE_FAILURE ;
 
-        conductance = PARALLEL (g_bottom, g_top) ;
+    double *rowsum = sysmatrix->RefinementResiduals ;
 
-    *sysmatrix.Values++  = -conductance ;
-    diagonal_value +=  conductance ;
+    for (cell = 0u ; cell != sysmatrix->Size ; cell++)
 
-    (*sysmatrix.ColumnPointers)++ ;
+        rowsum [cell] = 0.0 ;
 
-#ifdef PRINT_SYSTEM_MATRIX
-    fprintf (stderr,
-        "  bottom  \t%d\t% .4e = % .4e (B) || % .4e (T)\n",
-        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_bottom, g_top) ;
-#endif
+    for (cell = 0u ; cell != sysmatrix->Size ; cell++)
 
-skip_bottom :
+        for (index  = sysmatrix->ColumnPointers [cell] ;
+             index != sysmatrix->ColumnPointers [cell + 1] ; index++)
 
-    /********************************* SOUTH **********************************/
+            rowsum [sysmatrix->RowIndices [index]] += fabs (sysmatrix->Values [index]) ;
 
-    if (row_index == first_row (dimensions))    goto skip_south ;
+    sysmatrix->ANorm = 0.0 ;
 
-    *sysmatrix.RowIndices++ = get_cell_offset_in_stack
+    for (cell = 0u ; cell != sysmatrix->Size ; cell++)
 
-        (dimensions, layer_index, row_index - 1, column_index) ;
+        sysmatrix->ANorm = MAX (sysmatrix->ANorm, rowsum [cell]) ;
 
-    g_south = get_conductance_south
+    return TDICE_SUCCESS ;
+}
 
-        (thermal_grid, dimensions, layer_index, row_index    , column_index) ;
+/******************************************************************************/
 
-    g_north = get_conductance_north
+Error_t do_factorization (SystemMatrix_t *sysmatrix)
+{
+    if (use_multifrontal (sysmatrix) == true)
+    {
+        // The fronts of the Cholesky and of the LU decompositions differ
 
-        (thermal_grid, dimensions, layer_index, row_index - 1, column_index) ;
+        if (   sysmatrix->Multifrontal.Size != 0u
+            && sysmatrix->Multifrontal.Symmetric != sysmatrix->SymmetricPositiveDefinite)
 
-    conductance = PARALLEL (g_south, g_north) ;
+            multifrontal_solver_destroy (&sysmatrix->Multifrontal) ;
 
-    *sysmatrix.Values++  = -conductance ;
-    diagonal_value +=  conductance ;
+        // The ordering is computed only for the first factorization, the
+        // following ones reuse the supernodes and the fronts
 
-    (*sysmatrix.ColumnPointers)++ ;
+        if (   sysmatrix->Multifrontal.Size == 0u
+            && sysmatrix->SLU_Options.ColPerm != MY_PERMC)
 
-#ifdef PRINT_SYSTEM_MATRIX
-    fprintf (stderr,
-        "  south   \t%d\t% .4e = % .4e (S) || % .4e (N)\n",
-        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_south, g_north) ;
-#endif
+            get_perm_c
 
-skip_south :
+                (sysmatrix->SLU_Options.ColPerm, &sysmatrix->SLUMatrix_A,
+                sysmatrix->SLU_PermutationMatrixC) ;
 
-    /********************************* WEST ***********************************/
+        sysmatrix->Multifrontal.Symmetric = sysmatrix->SymmetricPositiveDefinite ;
 
-    if (column_index == first_column (dimensions))    goto skip_west ;
+        if (multifrontal_solver_factorize
 
-    *sysmatrix.RowIndices++ = get_cell_offset_in_stack
+                (&sysmatrix->Multifrontal, sysmatrix->Size,
+                 sysmatrix->ColumnPointers, sysmatrix->RowIndices, sysmatrix->Values,
+                 sysmatrix->SLU_PermutationMatrixC)
+            == TDICE_SUCCESS)
+        {
+            if (sysmatrix->Multifrontal.SinglePrecision == true)
 
-        (dimensions, layer_index, row_index, column_index - 1) ;
+                return prepare_refinement (sysmatrix) ;
 
-    g_west = get_conductance_west
+            return TDICE_SUCCESS ;
+        }
 
-        (thermal_grid, dimensions, layer_index, row_index, column_index    ) ;
+        if (sysmatrix->SymmetricPositiveDefinite == false)
 
-    g_east = get_conductance_east
+            return TDICE_FAILURE ;
 
-        (thermal_grid, dimensions, layer_index, row_index, column_index - 1) ;
+        fprintf (stderr, "WARNING: Cholesky decomposition failed, using LU\n") ;
 
-    conductance = PARALLEL (g_west, g_east) ;
+        sysmatrix->SymmetricPositiveDefinite = false ;
 
-    *sysmatrix.Values++  = -conductance ;
-    diagonal_value +=  conductance ;
+        return do_factorization (sysmatrix) ;
+    }
 
-    (*sysmatrix.ColumnPointers)++ ;
+    if (sysmatrix->SolverType != TDICE_SOLVER_SUPERLU)
+    {
+        if (sysmatrix->SolverType == TDICE_SOLVER_PCG && is_symmetric (sysmatrix) == false)
+        {
+            fprintf (stderr, "ERROR: pcg needs a symmetric system matrix, use bicgstab\n") ;
 
-#ifdef PRINT_SYSTEM_MATRIX
-    fprintf (stderr,
-        "  west    \t%d\t% .4e = % .4e (W) || % .4e (E)\n",
-        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_west, g_east) ;
-#endif
+            return TDICE_FAILURE ;
+        }
 
-skip_west :
+        return krylov_solver_factorize
 
-    /********************************* DIAGONAL *******************************/
+            (&sysmatrix->Krylov, sysmatrix->SolverType, sysmatrix->Size,
+             sysmatrix->ColumnPointers, sysmatrix->RowIndices, sysmatrix->Values) ;
+    }
 
-    *sysmatrix.RowIndices++ = get_cell_offset_in_stack
+    if (sysmatrix->SLU_Options.Fact == DOFACT)
+    {
+        // A user permutation has already been set by set_column_ordering
 
-        (dimensions, layer_index, row_index, column_index) ;
+        if (sysmatrix->SLU_Options.ColPerm != MY_PERMC)
 
-    *sysmatrix.Values = 0.0 ;
+            get_perm_c
 
-    if (analysis->AnalysisType == TDICE_ANALYSIS_TYPE_TRANSIENT)
-    {
-        *sysmatrix.Values = get_capacity
+                (sysmatrix->SLU_Options.ColPerm, &sysmatrix->SLUMatrix_A,
+                sysmatrix->SLU_PermutationMatrixC) ;
 
-            (thermal_grid, dimensions, layer_index, row_index, column_index) ;
+        sp_preorder
 
-        *sysmatrix.Values /= analysis->StepTime ;
+            (&sysmatrix->SLU_Options, &sysmatrix->SLUMatrix_A,
+            sysmatrix->SLU_PermutationMatrixC, sysmatrix->SLU_Etree,
+            &sysmatrix->SLUMatrix_A_Permuted) ;
     }
-
-    if (   thermal_grid->LayersTypeProfile [layer_index] == TDICE_LAYER_SOLID_CONNECTED_TO_AMBIENT
-        || thermal_grid->LayersTypeProfile [layer_index] == TDICE_LAYER_SOURCE_CONNECTED_TO_AMBIENT)
+    else if (sysmatrix->SLU_Options.Fact == FACTORED)
     {
-        *sysmatrix.Values += get_conductance_top
+        if (sysmatrix->FactorsFromCache == true)
+        {
+            // SuperLU can reuse the storage of L and U only if it allocated
+            // it. Factors read from a cache file are released and computed
+            // again keeping the column permutation and the elimination tree
 
-            (thermal_grid, dimensions, layer_index, row_index, column_index) ;
+            Destroy_SuperNode_Matrix (&sysmatrix->SLUMatrix_L) ;
+            Destroy_CompCol_Matrix   (&sysmatrix->SLUMatrix_U) ;
+
+            sysmatrix->FactorsFromCache = false ;
+
+            sysmatrix->SLU_Options.Fact = SamePattern ;
+        }
+        else
+
+            sysmatrix->SLU_Options.Fact = SamePattern_SameRowPerm ;
     }
-    else if (   thermal_grid->LayersTypeProfile [layer_index] == TDICE_LAYER_SOLID_CONNECTED_TO_PCB
-             || thermal_grid->LayersTypeProfile [layer_index] == TDICE_LAYER_SOURCE_CONNECTED_TO_PCB)
+    else
     {
-        *sysmatrix.Values += get_conductance_bottom
+        fprintf (stderr, "ERROR: wrong factorization status %d\n",
+            sysmatrix->SLU_Options.Fact) ;
 
-            (thermal_grid, dimensions, layer_index, row_index, column_index) ;
+        return TDICE_FAILURE ;
     }
-    
-    diagonal_pointer = sysmatrix.Values++ ;
 
-    (*sysmatrix.ColumnPointers)++ ;
+    dgstrf
 
-#ifdef PRINT_SYSTEM_MATRIX
-    fprintf (stderr, "  diagonal\t%d\t", *(sysmatrix.RowIndices-1)) ;
-    fgetpos (stderr, &diag_fposition) ;
-    fprintf (stderr, "            ( + % .4e [capacity] )\n", *(sysmatrix.Values-1)) ;
-#endif
+        (&sysmatrix->SLU_Options, &sysmatrix->SLUMatrix_A_Permuted,
+         sp_ienv(2), sp_ienv(1), /* relax and panel size */
+         sysmatrix->SLU_Etree,
+         NULL, 0,                /* work and lwork */
+         sysmatrix->SLU_PermutationMatrixC, sysmatrix->SLU_PermutationMatrixR,
+         &sysmatrix->SLUMatrix_L, &sysmatrix->SLUMatrix_U,
+         &sysmatrix->SLU_Stat, &sysmatrix->SLU_Info) ;
 
-    /********************************* EAST ***********************************/
+    if (sysmatrix->SLU_Info == 0)
+    {
+        sysmatrix->SLU_Options.Fact = FACTORED ;
 
-    if (column_index == last_column (dimensions))    goto skip_east ;
+        return TDICE_SUCCESS ;
+    }
+    else
+    {
+        fprintf (stderr, "SuperLu factorization error %d\n", sysmatrix->SLU_Info) ;
 
-    *sysmatrix.RowIndices++ = get_cell_offset_in_stack
+        return TDICE_FAILURE ;
+    }
+}
 
-        (dimensions, layer_index, row_index, column_index + 1) ;
+/******************************************************************************/
 
-    g_east = get_conductance_east
+#define FACTORS_CACHE_MAGIC   "3DICE-LU"
+#define FACTORS_CACHE_VERSION 1u
 
-        (thermal_grid, dimensions, layer_index, row_index, column_index    ) ;
+/* Header of a factorization cache file. It is followed by the arrays
+ * PermutationMatrixR [Size], PermutationMatrixC [Size], Etree [Size],
+ * L nzval [LNzval], L nzval_colptr [Size+1], L rowind [LRowind],
+ * L rowind_colptr [Size+1], L col_to_sup [Size+1], L sup_to_col [LNSuper+2],
+ * U nzval [UNzval], U rowind [UNzval] and U colptr [Size+1] */
 
-    g_west = get_conductance_west
+typedef struct
+{
+    char     Magic [8] ;
+    uint32_t Version ;
+    uint32_t Size ;
+    uint64_t Key ;
+    int32_t  LNNz ;
+    int32_t  LNSuper ;
+    int32_t  LNzval ;
+    int32_t  LRowind ;
+    int32_t  UNNz ;
+    int32_t  UNzval ;
+
+} FactorsCacheHeader_t ;
 
-        (thermal_grid, dimensions, layer_index, row_index, column_index + 1) ;
+/******************************************************************************/
 
-    conductance = PARALLEL (g_east, g_west) ;
+static uint64_t hash_bytes (uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *byte = (const unsigned char *) data ;
 
-    *sysmatrix.Values++  = -conductance ;
+    // 64 bit FNV-1a
+
+    while (size-- > 0u)
+    {
+        hash ^= (uint64_t) *byte++ ;
+        hash *= (uint64_t) 0x100000001b3ull ;
+    }
+
+    return hash ;
+}
+
+/******************************************************************************/
+
+static uint64_t get_factors_cache_key (SystemMatrix_t *sysmatrix)
+{
+    // NNz is an upper bound: only the first ColumnPointers [Size]
+    // row indices and values have been set by fill_system_matrix
+
+    CellIndex_t nnz  = sysmatrix->ColumnPointers [sysmatrix->Size] ;
+    uint64_t    hash = (uint64_t) 0xcbf29ce484222325ull ;
+
+    hash = hash_bytes (hash, &sysmatrix->Size, sizeof (CellIndex_t)) ;
+    hash = hash_bytes (hash, &nnz,             sizeof (CellIndex_t)) ;
+
+    hash = hash_bytes (hash, sysmatrix->ColumnPointers,
+                       sizeof (CellIndex_t) * (sysmatrix->Size + 1)) ;
+
+    hash = hash_bytes (hash, sysmatrix->RowIndices, sizeof (CellIndex_t) * nnz) ;
+
+    hash = hash_bytes (hash, sysmatrix->Values, sizeof (SystemMatrixCoeff_t) * nnz) ;
+
+    // The factors depend also on how SuperLU has been asked to compute them
+
+    hash = hash_bytes (hash, &sysmatrix->SLU_Options.ColPerm,
+                       sizeof (sysmatrix->SLU_Options.ColPerm)) ;
+
+    hash = hash_bytes (hash, &sysmatrix->SLU_Options.RowPerm,
+                       sizeof (sysmatrix->SLU_Options.RowPerm)) ;
+
+    hash = hash_bytes (hash, &sysmatrix->SLU_Options.SymmetricMode,
+                       sizeof (sysmatrix->SLU_Options.SymmetricMode)) ;
+
+    hash = hash_bytes (hash, &sysmatrix->SLU_Options.DiagPivotThresh,
+                       sizeof (sysmatrix->SLU_Options.DiagPivotThresh)) ;
+
+    return hash ;
+}
+
+/******************************************************************************/
+
+static String_t get_factors_cache_file_name (String_t directory, uint64_t key)
+{
+    // directory + '/' + 16 hex digits + ".lu" + '\0'
+
+    size_t length = strlen (directory) + 1 + 16 + 3 + 1 ;
+
+    String_t file_name = (String_t) malloc (sizeof (char) * length) ;
+
+    if (file_name != NULL)
+
+        sprintf (file_name, "%s/%016llx.lu", directory, (unsigned long long) key) ;
+
+    return file_name ;
+}
+
+/******************************************************************************/
+
+static bool read_block (FILE *file, void *data, size_t size, size_t count)
+{
+    return fread (data, size, count, file) == count ;
+}
+
+static bool write_block (FILE *file, const void *data, size_t size, size_t count)
+{
+    return fwrite (data, size, count, file) == count ;
+}
+
+/******************************************************************************/
+
+Error_t system_matrix_load_factors (SystemMatrix_t *sysmatrix, String_t directory)
+{
+    if (sysmatrix->SLU_Options.Fact != DOFACT)
+    {
+        fprintf (stderr, "ERROR: the system matrix has already been factorized\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    uint64_t key = get_factors_cache_key (sysmatrix) ;
+
+    String_t file_name = get_factors_cache_file_name (directory, key) ;
+
+    if (file_name == NULL)
+
+        return TDICE_FAILURE ;
+
+    FILE *file = fopen (file_name, "rb") ;
+
+    if (file == NULL)
+    {
+        free (file_name) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    FactorsCacheHeader_t header ;
+
+    int size = (int) sysmatrix->Size ;
+
+    if (   read_block (file, &header, sizeof (header), 1u) == false
+        || memcmp (header.Magic, FACTORS_CACHE_MAGIC, sizeof (header.Magic)) != 0
+        || header.Version != FACTORS_CACHE_VERSION
+        || header.Size    != sysmatrix->Size
+        || header.Key     != key
+        || header.LNSuper <  0 || header.LNSuper >= size
+        || header.LNzval  <  0 || header.LRowind <  0 || header.UNzval < 0)
+    {
+        fprintf (stderr, "Warning: ignoring invalid factorization cache %s\n", file_name) ;
+
+        fclose (file) ;
+        free (file_name) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    double *l_nzval         = doubleMalloc (header.LNzval) ;
+    int    *l_nzval_colptr  = intMalloc    (size + 1) ;
+    int    *l_rowind        = intMalloc    (header.LRowind) ;
+    int    *l_rowind_colptr = intMalloc    (size + 1) ;
+    int    *l_col_to_sup    = intMalloc    (size + 1) ;
+    int    *l_sup_to_col    = intMalloc    (header.LNSuper + 2) ;
+    double *u_nzval         = doubleMalloc (header.UNzval) ;
+    int    *u_rowind        = intMalloc    (header.UNzval) ;
+    int    *u_colptr        = intMalloc    (size + 1) ;
+
+    bool loaded =
+
+           l_nzval  != NULL && l_nzval_colptr  != NULL
+        && l_rowind != NULL && l_rowind_colptr != NULL
+        && l_col_to_sup != NULL && l_sup_to_col != NULL
+        && u_nzval  != NULL && u_rowind != NULL && u_colptr != NULL
+
+        && read_block (file, sysmatrix->SLU_PermutationMatrixR, sizeof (int), size)
+        && read_block (file, sysmatrix->SLU_PermutationMatrixC, sizeof (int), size)
+        && read_block (file, sysmatrix->SLU_Etree,              sizeof (int), size)
+
+        && read_block (file, l_nzval,         sizeof (double), header.LNzval)
+        && read_block (file, l_nzval_colptr,  sizeof (int),    size + 1)
+        && read_block (file, l_rowind,        sizeof (int),    header.LRowind)
+        && read_block (file, l_rowind_colptr, sizeof (int),    size + 1)
+        && read_block (file, l_col_to_sup,    sizeof (int),    size + 1)
+        && read_block (file, l_sup_to_col,    sizeof (int),    header.LNSuper + 2)
+
+        && read_block (file, u_nzval,  sizeof (double), header.UNzval)
+        && read_block (file, u_rowind, sizeof (int),    header.UNzval)
+        && read_block (file, u_colptr, sizeof (int),    size + 1)
+
+        && l_nzval_colptr  [size] == header.LNzval
+        && l_rowind_colptr [size] == header.LRowind
+        && u_colptr        [size] == header.UNzval ;
+
+    fclose (file) ;
+
+    if (loaded == false)
+    {
+        fprintf (stderr, "Warning: ignoring invalid factorization cache %s\n", file_name) ;
+
+        SUPERLU_FREE (l_nzval) ;
+        SUPERLU_FREE (l_nzval_colptr) ;
+        SUPERLU_FREE (l_rowind) ;
+        SUPERLU_FREE (l_rowind_colptr) ;
+        SUPERLU_FREE (l_col_to_sup) ;
+        SUPERLU_FREE (l_sup_to_col) ;
+        SUPERLU_FREE (u_nzval) ;
+        SUPERLU_FREE (u_rowind) ;
+        SUPERLU_FREE (u_colptr) ;
+
+        free (file_name) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    free (file_name) ;
+
+    dCreate_SuperNode_Matrix
+
+        (&sysmatrix->SLUMatrix_L, size, size, header.LNNz,
+         l_nzval, l_nzval_colptr, l_rowind, l_rowind_colptr,
+         l_col_to_sup, l_sup_to_col,
+         SLU_SC, SLU_D, SLU_TRLU) ;
+
+    ((SCformat *) sysmatrix->SLUMatrix_L.Store)->nsuper = header.LNSuper ;
+
+    dCreate_CompCol_Matrix
+
+        (&sysmatrix->SLUMatrix_U, size, size, header.UNNz,
+         u_nzval, u_rowind, u_colptr,
+         SLU_NC, SLU_D, SLU_TRU) ;
+
+    // The column permutation read from the file is already postordered:
+    // with Fact != DOFACT sp_preorder only applies it to the column
+    // pointers of A, as needed by later refactorizations
+
+    sysmatrix->SLU_Options.Fact = SamePattern ;
+
+    sp_preorder
+
+        (&sysmatrix->SLU_Options, &sysmatrix->SLUMatrix_A,
+         sysmatrix->SLU_PermutationMatrixC, sysmatrix->SLU_Etree,
+         &sysmatrix->SLUMatrix_A_Permuted) ;
+
+    sysmatrix->SLU_Options.Fact = FACTORED ;
+    sysmatrix->FactorsFromCache = true ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+Error_t system_matrix_store_factors (SystemMatrix_t *sysmatrix, String_t directory)
+{
+    if (sysmatrix->SLU_Options.Fact != FACTORED)
+    {
+        fprintf (stderr, "ERROR: the system matrix has not been factorized\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    SCformat *lstore = (SCformat *) sysmatrix->SLUMatrix_L.Store ;
+    NCformat *ustore = (NCformat *) sysmatrix->SLUMatrix_U.Store ;
+
+    int size = (int) sysmatrix->Size ;
+
+    FactorsCacheHeader_t header ;
+
+    memcpy (header.Magic, FACTORS_CACHE_MAGIC, sizeof (header.Magic)) ;
+
+    header.Version = FACTORS_CACHE_VERSION ;
+    header.Size    = sysmatrix->Size ;
+    header.Key     = get_factors_cache_key (sysmatrix) ;
+    header.LNNz    = lstore->nnz ;
+    header.LNSuper = lstore->nsuper ;
+    header.LNzval  = lstore->nzval_colptr  [size] ;
+    header.LRowind = lstore->rowind_colptr [size] ;
+    header.UNNz    = ustore->nnz ;
+    header.UNzval  = ustore->colptr [size] ;
+
+    String_t file_name = get_factors_cache_file_name (directory, header.Key) ;
+
+    if (file_name == NULL)
+
+        return TDICE_FAILURE ;
+
+    // The file is written with a unique temporary name, in the same
+    // directory, and then renamed so that other processes sharing the
+    // cache never read a partial file nor write the same temporary file
+
+    String_t tmp_name = (String_t) malloc (sizeof (char) * (strlen (file_name) + 8)) ;
+
+    if (tmp_name == NULL)
+    {
+        free (file_name) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    sprintf (tmp_name, "%s.XXXXXX", file_name) ;
+
+    int descriptor = mkstemp (tmp_name) ;
+
+    FILE *file = NULL ;
+
+    if (descriptor != -1)
+    {
+        // mkstemp creates the file readable only by its owner
+
+        fchmod (descriptor, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) ;
+
+        file = fdopen (descriptor, "wb") ;
+
+        if (file == NULL)
+        {
+            close (descriptor) ;
+
+            remove (tmp_name) ;
+        }
+    }
+
+    if (file == NULL)
+    {
+        fprintf (stderr, "Cannot create factorization cache %s\n", tmp_name) ;
+
+        free (tmp_name) ;
+        free (file_name) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    bool written =
+
+           write_block (file, &header, sizeof (header), 1u)
+
+        && write_block (file, sysmatrix->SLU_PermutationMatrixR, sizeof (int), size)
+        && write_block (file, sysmatrix->SLU_PermutationMatrixC, sizeof (int), size)
+        && write_block (file, sysmatrix->SLU_Etree,              sizeof (int), size)
+
+        && write_block (file, lstore->nzval,         sizeof (double), header.LNzval)
+        && write_block (file, lstore->nzval_colptr,  sizeof (int),    size + 1)
+        && write_block (file, lstore->rowind,        sizeof (int),    header.LRowind)
+        && write_block (file, lstore->rowind_colptr, sizeof (int),    size + 1)
+        && write_block (file, lstore->col_to_sup,    sizeof (int),    size + 1)
+        && write_block (file, lstore->sup_to_col,    sizeof (int),    header.LNSuper + 2)
+
+        && write_block (file, ustore->nzval,  sizeof (double), header.UNzval)
+        && write_block (file, ustore->rowind, sizeof (int),    header.UNzval)
+        && write_block (file, ustore->colptr, sizeof (int),    size + 1) ;
+
+    if (fclose (file) != 0)
+
+        written = false ;
+
+    if (written == false || rename (tmp_name, file_name) != 0)
+    {
+        fprintf (stderr, "Cannot write factorization cache %s\n", file_name) ;
+
+        remove (tmp_name) ;
+
+        free (tmp_name) ;
+        free (file_name) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    free (tmp_name) ;
+    free (file_name) ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+void system_matrix_destroy (SystemMatrix_t *sysmatrix)
+{
+    free (sysmatrix->ColumnPointers) ;
+    free (sysmatrix->RowIndices) ;
+    free (sysmatrix->Values) ;
+
+    free (sysmatrix->SLU_PermutationMatrixR) ;
+    free (sysmatrix->SLU_PermutationMatrixC) ;
+    free (sysmatrix->SLU_Etree) ;
+
+    StatFree (&sysmatrix->SLU_Stat) ;
+
+    krylov_solver_destroy (&sysmatrix->Krylov) ;
+
+    multifrontal_solver_destroy (&sysmatrix->Multifrontal) ;
+
+    free (sysmatrix->RefinementResiduals) ;
+    free (sysmatrix->RefinementRhs) ;
+
+    Destroy_SuperMatrix_Store (&sysmatrix->SLUMatrix_A) ;
+
+    if (sysmatrix->SLU_Options.Fact != DOFACT )
+    {
+        Destroy_CompCol_Permuted (&sysmatrix->SLUMatrix_A_Permuted) ;
+        Destroy_SuperNode_Matrix (&sysmatrix->SLUMatrix_L) ;
+        Destroy_CompCol_Matrix   (&sysmatrix->SLUMatrix_U) ;
+    }
+
+    system_matrix_init (sysmatrix) ;
+}
+
+/******************************************************************************/
+
+static SystemMatrix_t add_solid_column
+(
+    SystemMatrix_t  sysmatrix,
+    ThermalGrid_t  *thermal_grid,
+    Analysis_t     *analysis,
+    Dimensions_t   *dimensions,
+    CellIndex_t     layer_index,
+    CellIndex_t     row_index,
+    CellIndex_t     column_index
+)
+{
+    Conductance_t conductance = 0.0 ;
+    SystemMatrixCoeff_t  diagonal_value   = 0.0 ;
+    SystemMatrixCoeff_t *diagonal_pointer = NULL ;
+
+    Conductance_t g_bottom, g_top, g_north, g_south, g_east, g_west ;
+
+#ifdef PRINT_SYSTEM_MATRIX
+    fpos_t diag_fposition, last_fpos ;
+
+    fprintf (stderr,
+        "add_solid_column   l %2d r %4d c %4d [%7d]\n",
+        layer_index, row_index, column_index,
+        get_cell_offset_in_stack (dimensions, layer_index, row_index, column_index)) ;
+#endif
+
+    *sysmatrix.ColumnPointers = *(sysmatrix.ColumnPointers - 1) ;
+
+    /********************************* BOTTOM *********************************/
+
+    if (layer_index == first_layer (dimensions))
+
+        goto skip_bottom ;
+
+    *sysmatrix.RowIndices++ = get_cell_offset_in_stack
+
+        (dimensions, layer_index - 1, row_index, column_index) ;
+
+    g_bottom = get_conductance_bottom
+
+        (thermal_grid, dimensions, layer_index    , row_index, column_index) ;
+
+    g_top = get_conductance_top
+
+        (thermal_grid, dimensions, layer_index - 1, row_index, column_index) ;
+
+    if (g_top == 0)
+
+        conductance = g_bottom ;
+
+    else
+
+        conductance = PARALLEL (g_bottom, g_top) ;
+
+    *sysmatrix.Values++  = -conductance ;
+    diagonal_value +=  conductance ;
+
+    (*sysmatrix.ColumnPointers)++ ;
+
+#ifdef PRINT_SYSTEM_MATRIX
+    fprintf (stderr,
+        "  bottom  \t%d\t% .4e = % .4e (B) || % .4e (T)\n",
+        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_bottom, g_top) ;
+#endif
+
+skip_bottom :
+
+    /********************************* SOUTH **********************************/
+
+    if (row_index == first_row (dimensions))    goto skip_south ;
+
+    *sysmatrix.RowIndices++ = get_cell_offset_in_stack
+
+        (dimensions, layer_index, row_index - 1, column_index) ;
+
+    g_south = get_conductance_south
+
+        (thermal_grid, dimensions, layer_index, row_index    , column_index) ;
+
+    g_north = get_conductance_north
+
+        (thermal_grid, dimensions, layer_index, row_index - 1, column_index) ;
+
+    conductance = PARALLEL (g_south, g_north) ;
+
+    *sysmatrix.Values++  = -conductance ;
+    diagonal_value +=  conductance ;
+
+    (*sysmatrix.ColumnPointers)++ ;
+
+#ifdef PRINT_SYSTEM_MATRIX
+    fprintf (stderr,
+        "  south   \t%d\t% .4e = % .4e (S) || % .4e (N)\n",
+        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_south, g_north) ;
+#endif
+
+skip_south :
+
+    /********************************* WEST ***********************************/
+
+    if (column_index == first_column (dimensions))    goto skip_west ;
+
+    *sysmatrix.RowIndices++ = get_cell_offset_in_stack
+
+        (dimensions, layer_index, row_index, column_index - 1) ;
+
+    g_west = get_conductance_west
+
+        (thermal_grid, dimensions, layer_index, row_index, column_index    ) ;
+
+    g_east = get_conductance_east
+
+        (thermal_grid, dimensions, layer_index, row_index, column_index - 1) ;
+
+    conductance = PARALLEL (g_west, g_east) ;
+
+    *sysmatrix.Values++  = -conductance ;
+    diagonal_value +=  conductance ;
+
+    (*sysmatrix.ColumnPointers)++ ;
+
+#ifdef PRINT_SYSTEM_MATRIX
+    fprintf (stderr,
+        "  west    \t%d\t% .4e = % .4e (W) || % .4e (E)\n",
+        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_west, g_east) ;
+#endif
+
+skip_west :
+
+    /********************************* DIAGONAL *******************************/
+
+    *sysmatrix.RowIndices++ = get_cell_offset_in_stack
+
+        (dimensions, layer_index, row_index, column_index) ;
+
+    *sysmatrix.Values = 0.0 ;
+
+    if (analysis->AnalysisType == TDICE_ANALYSIS_TYPE_TRANSIENT)
+    {
+        *sysmatrix.Values = get_capacity
+
+            (thermal_grid, dimensions, layer_index, row_index, column_index) ;
+
+        *sysmatrix.Values /= get_matrix_step_time (analysis) ;
+    }
+
+    if (   thermal_grid->LayersTypeProfile [layer_index] == TDICE_LAYER_SOLID_CONNECTED_TO_AMBIENT
+        || thermal_grid->LayersTypeProfile [layer_index] == TDICE_LAYER_SOURCE_CONNECTED_TO_AMBIENT)
+    {
+        *sysmatrix.Values += get_conductance_top
+
+            (thermal_grid, dimensions, layer_index, row_index, column_index) ;
+    }
+    else if (   thermal_grid->LayersTypeProfile [layer_index] == TDICE_LAYER_SOLID_CONNECTED_TO_PCB
+             || thermal_grid->LayersTypeProfile [layer_index] == TDICE_LAYER_SOURCE_CONNECTED_TO_PCB)
+    {
+        *sysmatrix.Values += get_conductance_bottom
+
+            (thermal_grid, dimensions, layer_index, row_index, column_index) ;
+    }
+    
+    diagonal_pointer = sysmatrix.Values++ ;
+
+    (*sysmatrix.ColumnPointers)++ ;
+
+#ifdef PRINT_SYSTEM_MATRIX
+    fprintf (stderr, "  diagonal\t%d\t", *(sysmatrix.RowIndices-1)) ;
+    fgetpos (stderr, &diag_fposition) ;
+    fprintf (stderr, "            ( + % .4e [capacity] )\n", *(sysmatrix.Values-1)) ;
+#endif
+
+    /********************************* EAST ***********************************/
+
+    if (column_index == last_column (dimensions))    goto skip_east ;
+
+    *sysmatrix.RowIndices++ = get_cell_offset_in_stack
+
+        (dimensions, layer_index, row_index, column_index + 1) ;
+
+    g_east = get_conductance_east
+
+        (thermal_grid, dimensions, layer_index, row_index, column_index    ) ;
+
+    g_west = get_conductance_west
+
+        (thermal_grid, dimensions, layer_index, row_index, column_index + 1) ;
+
+    conductance = PARALLEL (g_east, g_west) ;
+
+    *sysmatrix.Values++  = -conductance ;
     diagonal_value +=  conductance ;
 
     (*sysmatrix.ColumnPointers)++ ;
@@ -687,7 +1345,7 @@ static SystemMatrix_t add_liquid_column_4rm
 
             (thermal_grid, dimensions, layer_index, row_index, column_index) ;
 
-        *sysmatrix.Values /= analysis->StepTime ;
+        *sysmatrix.Values /= get_matrix_step_time (analysis) ;
     }
 
     diagonal_pointer = sysmatrix.Values++ ;
@@ -887,7 +1545,7 @@ static SystemMatrix_t add_liquid_column_2rm
 
             (thermal_grid, dimensions, layer_index, row_index, column_index) ;
 
-        *sysmatrix.Values /= analysis->StepTime ;
+        *sysmatrix.Values /= get_matrix_step_time (analysis) ;
     }
 
     diagonal_pointer = sysmatrix.Values++ ;
@@ -1034,7 +1692,7 @@ static SystemMatrix_t add_bottom_wall_column_2rm
 
             (thermal_grid, dimensions, layer_index, row_index, column_index) ;
 
-        *sysmatrix.Values /= analysis->StepTime ;
+        *sysmatrix.Values /= get_matrix_step_time (analysis) ;
     }
 
     diagonal_pointer = sysmatrix.Values++ ;
@@ -1202,7 +1860,7 @@ static SystemMatrix_t add_top_wall_column_2rm
 
             (thermal_grid, dimensions, layer_index, row_index, column_index) ;
 
-        *sysmatrix.Values /= analysis->StepTime ;
+        *sysmatrix.Values /= get_matrix_step_time (analysis) ;
     }
 
     diagonal_pointer = sysmatrix.Values++ ;
@@ -1350,7 +2008,7 @@ static SystemMatrix_t add_virtual_wall_column_2rm
 
             (thermal_grid, dimensions, layer_index, row_index, column_index) ;
 
-        *sysmatrix.Values /= analysis->StepTime ;
+        *sysmatrix.Values /= get_matrix_step_time (analysis) ;
     }
 
     diagonal_pointer = sysmatrix.Values++ ;
@@ -1513,131 +2171,450 @@ skip_bottom :
         *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_south, g_north) ;
 #endif
 
-skip_south :
+skip_south :
+
+    /********************************* WEST ***********************************/
+
+    if (column_index == 0)    goto skip_west ;
+
+    *sysmatrix.RowIndices++ = get_spreader_cell_offset
+        (dimensions, sink, row_index, column_index - 1) ;
+
+    g_west = g_east = get_spreader_conductance_east_west(sink);
+
+    conductance = PARALLEL (g_west, g_east) ;
+
+    *sysmatrix.Values++  = -conductance ;
+    diagonal_value +=  conductance ;
+
+    (*sysmatrix.ColumnPointers)++ ;
+
+#ifdef PRINT_SYSTEM_MATRIX
+    fprintf (stderr,
+        "  west    \t%d\t% .4e = % .4e (W) || % .4e (E)\n",
+        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_west, g_east) ;
+#endif
+
+skip_west :
+
+    /********************************* DIAGONAL *******************************/
+
+    *sysmatrix.RowIndices++ = get_spreader_cell_offset
+        (dimensions, sink, row_index, column_index) ;
+
+    *sysmatrix.Values = 0.0 ;
+
+    if (analysis->AnalysisType == TDICE_ANALYSIS_TYPE_TRANSIENT)
+    {
+        *sysmatrix.Values = get_spreader_capacity(sink) / get_matrix_step_time (analysis);
+    }
+    
+    diagonal_pointer = sysmatrix.Values++ ;
+
+    (*sysmatrix.ColumnPointers)++ ;
+
+#ifdef PRINT_SYSTEM_MATRIX
+    fprintf (stderr, "  diagonal\t%d\t", *(sysmatrix.RowIndices-1)) ;
+    fgetpos (stderr, &diag_fposition) ;
+    fprintf (stderr, "            ( + % .4e [capacity] )\n", *(sysmatrix.Values-1)) ;
+#endif
+
+    /********************************* EAST ***********************************/
+
+    if (column_index == sink->NColumns - 1)    goto skip_east ;
+
+    *sysmatrix.RowIndices++ = get_spreader_cell_offset
+        (dimensions, sink, row_index, column_index + 1) ;
+
+    g_east = g_west = get_spreader_conductance_east_west(sink);
+
+    conductance = PARALLEL (g_east, g_west) ;
+
+    *sysmatrix.Values++  = -conductance ;
+    diagonal_value +=  conductance ;
+
+    (*sysmatrix.ColumnPointers)++ ;
+
+#ifdef PRINT_SYSTEM_MATRIX
+    fprintf (stderr,
+        "  east    \t%d\t% .4e = % .4e (E) || % .4e (W)\n",
+        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_east, g_west) ;
+#endif
+
+skip_east :
+
+    /********************************* NORTH **********************************/
+
+    if (row_index == sink->NRows - 1)    goto skip_north ;
+
+    *sysmatrix.RowIndices++ = get_spreader_cell_offset
+        (dimensions, sink, row_index + 1, column_index) ;
+
+    g_north = g_south = get_spreader_conductance_north_south(sink);
+
+    conductance = PARALLEL (g_north, g_south) ;
+
+    *sysmatrix.Values++  = -conductance ;
+    diagonal_value +=  conductance ;
+
+    (*sysmatrix.ColumnPointers)++ ;
+
+#ifdef PRINT_SYSTEM_MATRIX
+    fprintf (stderr,
+        "  north   \t%d\t% .4e = % .4e (N) || % .4e (S)\n",
+        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_north, g_south) ;
+#endif
+
+skip_north :
+
+    /********************************* TOP ************************************/
+
+    // The top of the spreader is connected with the pluggable heat sink,
+    // whose state variables are not part of the system matrix.
+    // Thus, no other nonzero element appears in the sysyem matrix, but
+    // a conductance term is summed to the diagonal element
+
+    g_top = get_spreader_sink_conductance(sink, row_index, column_index);
+    diagonal_value += g_top;
+#ifdef PRINT_SYSTEM_MATRIX
+    fprintf (stderr, "  top (to sink) % .4e\n", g_top);
+#endif
+
+    /************************** DIAGONAL ELEMENT ******************************/
+
+    *diagonal_pointer += diagonal_value ;
+
+#ifdef PRINT_SYSTEM_MATRIX
+    fgetpos (stderr, &last_fpos) ;
+    fsetpos (stderr, &diag_fposition) ;
+    fprintf (stderr, "% .4e", *diagonal_pointer) ;
+    fsetpos (stderr, &last_fpos) ;
+
+    fprintf (stderr, "  %d\n", *sysmatrix.ColumnPointers) ;
+#endif
+
+    sysmatrix.ColumnPointers++ ;
+
+    return sysmatrix ;
+}
+
+/******************************************************************************/
+
+/* Adds the column of the cell cell_index calling the add_*_column
+ * function that matches the type of its layer */
+
+static SystemMatrix_t add_column
+(
+    SystemMatrix_t  sysmatrix,
+    ThermalGrid_t  *thermal_grid,
+    Analysis_t     *analysis,
+    Dimensions_t   *dimensions,
+    CellIndex_t     cell_index
+)
+{
+    CellIndex_t ncolumns = get_number_of_columns (dimensions) ;
+    CellIndex_t lindex   = cell_index / get_layer_area (dimensions) ;
+
+    if (lindex >= thermal_grid->NLayers)
+    {
+        // Cells after the layers belong to the spreader of a pluggable sink
+
+        cell_index -= thermal_grid->NLayers * get_layer_area (dimensions) ;
+
+        return add_spreader_column
+
+            (sysmatrix, thermal_grid, analysis, dimensions,
+             cell_index / thermal_grid->TopHeatSink->NColumns,
+             cell_index % thermal_grid->TopHeatSink->NColumns) ;
+    }
+
+    CellIndex_t row    = (cell_index % get_layer_area (dimensions)) / ncolumns ;
+    CellIndex_t column = cell_index % ncolumns ;
+
+    switch (thermal_grid->LayersTypeProfile [lindex])
+    {
+        case TDICE_LAYER_SOLID :
+        case TDICE_LAYER_SOURCE :
+        case TDICE_LAYER_SOLID_CONNECTED_TO_AMBIENT :
+        case TDICE_LAYER_SOURCE_CONNECTED_TO_AMBIENT :
+        case TDICE_LAYER_SOLID_CONNECTED_TO_SPREADER :
+        case TDICE_LAYER_SOURCE_CONNECTED_TO_SPREADER :
+        case TDICE_LAYER_SOLID_CONNECTED_TO_PCB :
+        case TDICE_LAYER_SOURCE_CONNECTED_TO_PCB :
+
+            return add_solid_column
+
+                (sysmatrix, thermal_grid, analysis, dimensions,
+                 lindex, row, column) ;
+
+        case TDICE_LAYER_CHANNEL_4RM :
+
+            if (IS_CHANNEL_COLUMN (thermal_grid->Channel->ChannelModel, column) == true)
+
+                return add_liquid_column_4rm
+
+                    (sysmatrix, thermal_grid, analysis, dimensions,
+                     lindex, row, column) ;
+
+            else
+
+                return add_solid_column
+
+                    (sysmatrix, thermal_grid, analysis, dimensions,
+                     lindex, row, column) ;
+
+        case TDICE_LAYER_CHANNEL_2RM :
+        case TDICE_LAYER_PINFINS_INLINE :
+        case TDICE_LAYER_PINFINS_STAGGERED :
+
+            return add_liquid_column_2rm
+
+                (sysmatrix, thermal_grid, analysis, dimensions,
+                 lindex, row, column) ;
+
+        case TDICE_LAYER_VWALL_CHANNEL :
+        case TDICE_LAYER_VWALL_PINFINS :
+
+            return add_virtual_wall_column_2rm
+
+                (sysmatrix, thermal_grid, analysis, dimensions,
+                 thermal_grid->Channel->ChannelModel,
+                 lindex, row, column) ;
+
+        case TDICE_LAYER_TOP_WALL :
+
+            return add_top_wall_column_2rm
+
+                (sysmatrix, thermal_grid, analysis, dimensions,
+                 lindex, row, column) ;
+
+        case TDICE_LAYER_BOTTOM_WALL :
+
+            return add_bottom_wall_column_2rm
+
+                (sysmatrix, thermal_grid, analysis, dimensions,
+                 lindex, row, column) ;
+
+        case TDICE_LAYER_NONE :
+
+            fprintf (stderr, "ERROR: unset layer type\n") ;
+
+            return sysmatrix ;
+
+        default :
+
+            fprintf (stderr, "ERROR: unknown layer type %d\n", thermal_grid->LayersTypeProfile [lindex]) ;
+
+            return sysmatrix ;
+    }
+}
+
+/******************************************************************************/
+
+/* The cells of the grid assembled by one thread */
+
+struct FillTask_t
+{
+    SystemMatrix_t *SystemMatrix ;
+    ThermalGrid_t  *ThermalGrid ;
+    Analysis_t     *Analysis ;
+    Dimensions_t   *Dimensions ;
+    CellIndex_t     FirstCell ;
+    CellIndex_t     LastCell ;
+} ;
+
+typedef struct FillTask_t FillTask_t ;
+
+/* The maximum number of coefficients of a column: the diagonal and the
+ * six neighbours (bottom, south, west, east, north, top) */
+
+#define MAX_COLUMN_NNZ 7u
+
+/******************************************************************************/
+
+/* Runs the add_*_column functions on a scratch column to store, in
+ * ColumnPointers [cell + 1], the number of coefficients of each column */
+
+static void *count_columns (void *argument)
+{
+    FillTask_t *task = (FillTask_t *) argument ;
+
+    CellIndex_t         pointers [2] ;
+    CellIndex_t         rows     [MAX_COLUMN_NNZ] ;
+    SystemMatrixCoeff_t values   [MAX_COLUMN_NNZ] ;
+
+    SystemMatrix_t tmp_matrix ;
+    CellIndex_t    cell ;
+
+    for (cell = task->FirstCell ; cell != task->LastCell ; cell++)
+    {
+        pointers [0] = 0u ;
+
+        tmp_matrix.ColumnPointers = pointers + 1 ;
+        tmp_matrix.RowIndices     = rows ;
+        tmp_matrix.Values         = values ;
+
+        add_column (tmp_matrix, task->ThermalGrid, task->Analysis, task->Dimensions, cell) ;
+
+        task->SystemMatrix->ColumnPointers [cell + 1] = pointers [1] ;
+    }
+
+    return NULL ;
+}
 
-    /********************************* WEST ***********************************/
+/******************************************************************************/
 
-    if (column_index == 0)    goto skip_west ;
+/* Fills the columns of the cells of a task once the column pointers are
+ * known. The pointers written by the add_*_column functions go to a
+ * private copy, so tasks never write the same memory */
 
-    *sysmatrix.RowIndices++ = get_spreader_cell_offset
-        (dimensions, sink, row_index, column_index - 1) ;
+static void *fill_columns (void *argument)
+{
+    FillTask_t *task = (FillTask_t *) argument ;
 
-    g_west = g_east = get_spreader_conductance_east_west(sink);
+    SystemMatrix_t *sysmatrix = task->SystemMatrix ;
 
-    conductance = PARALLEL (g_west, g_east) ;
+    CellIndex_t    pointers [2] ;
+    SystemMatrix_t tmp_matrix ;
+    CellIndex_t    cell ;
 
-    *sysmatrix.Values++  = -conductance ;
-    diagonal_value +=  conductance ;
+    for (cell = task->FirstCell ; cell != task->LastCell ; cell++)
+    {
+        pointers [0] = sysmatrix->ColumnPointers [cell] ;
 
-    (*sysmatrix.ColumnPointers)++ ;
+        tmp_matrix.ColumnPointers = pointers + 1 ;
+        tmp_matrix.RowIndices     = sysmatrix->RowIndices + pointers [0] ;
+        tmp_matrix.Values         = sysmatrix->Values     + pointers [0] ;
 
-#ifdef PRINT_SYSTEM_MATRIX
-    fprintf (stderr,
-        "  west    \t%d\t% .4e = % .4e (W) || % .4e (E)\n",
-        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_west, g_east) ;
-#endif
+        add_column (tmp_matrix, task->ThermalGrid, task->Analysis, task->Dimensions, cell) ;
+    }
 
-skip_west :
+    return NULL ;
+}
 
-    /********************************* DIAGONAL *******************************/
+/******************************************************************************/
 
-    *sysmatrix.RowIndices++ = get_spreader_cell_offset
-        (dimensions, sink, row_index, column_index) ;
+/* Runs function on every task, each one in its own thread. A task whose
+ * thread cannot be created is run by the calling thread */
 
-    *sysmatrix.Values = 0.0 ;
+static void run_fill_tasks
 
-    if (analysis->AnalysisType == TDICE_ANALYSIS_TYPE_TRANSIENT)
-    {
-        *sysmatrix.Values = get_spreader_capacity(sink) / analysis->StepTime;
-    }
-    
-    diagonal_pointer = sysmatrix.Values++ ;
+    (void *(*function) (void *), FillTask_t *tasks, pthread_t *threads, Quantity_t ntasks)
+{
+    bool       *started = (bool *) calloc (ntasks, sizeof (bool)) ;
+    Quantity_t  index ;
 
-    (*sysmatrix.ColumnPointers)++ ;
+    for (index = 0u ; index != ntasks ; index++)
 
-#ifdef PRINT_SYSTEM_MATRIX
-    fprintf (stderr, "  diagonal\t%d\t", *(sysmatrix.RowIndices-1)) ;
-    fgetpos (stderr, &diag_fposition) ;
-    fprintf (stderr, "            ( + % .4e [capacity] )\n", *(sysmatrix.Values-1)) ;
-#endif
+        if (started == NULL || index == 0u
+            || pthread_create (threads + index, NULL, function, tasks + index) != 0)
 
-    /********************************* EAST ***********************************/
+            function (tasks + index) ;
 
-    if (column_index == sink->NColumns - 1)    goto skip_east ;
+        else
 
-    *sysmatrix.RowIndices++ = get_spreader_cell_offset
-        (dimensions, sink, row_index, column_index + 1) ;
+            started [index] = true ;
 
-    g_east = g_west = get_spreader_conductance_east_west(sink);
+    for (index = 0u ; index != ntasks ; index++)
 
-    conductance = PARALLEL (g_east, g_west) ;
+        if (started != NULL && started [index] == true)
 
-    *sysmatrix.Values++  = -conductance ;
-    diagonal_value +=  conductance ;
+            pthread_join (threads [index], NULL) ;
 
-    (*sysmatrix.ColumnPointers)++ ;
+    free (started) ;
+}
+
+/******************************************************************************/
 
+static void assemble_system_matrix
+(
+    SystemMatrix_t *sysmatrix,
+    ThermalGrid_t  *thermal_grid,
+    Analysis_t     *analysis,
+    Dimensions_t   *dimensions
+)
+{
 #ifdef PRINT_SYSTEM_MATRIX
     fprintf (stderr,
-        "  east    \t%d\t% .4e = % .4e (E) || % .4e (W)\n",
-        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_east, g_west) ;
+        "fill_system_matrix ( l %d r %d c %d )\n",
+        get_number_of_layers  (dimensions),
+        get_number_of_rows    (dimensions),
+        get_number_of_columns (dimensions)) ;
 #endif
 
-skip_east :
+    CellIndex_t ncells   = sysmatrix->Size ;
+    Quantity_t  nthreads = analysis->NThreads ;
 
-    /********************************* NORTH **********************************/
+    FillTask_t *tasks   = NULL ;
+    pthread_t  *threads = NULL ;
 
-    if (row_index == sink->NRows - 1)    goto skip_north ;
+    sysmatrix->ColumnPointers [0] = 0u ;
 
-    *sysmatrix.RowIndices++ = get_spreader_cell_offset
-        (dimensions, sink, row_index + 1, column_index) ;
+#ifndef PRINT_SYSTEM_MATRIX
+    if (nthreads > ncells)
 
-    g_north = g_south = get_spreader_conductance_north_south(sink);
+        nthreads = ncells ;
 
-    conductance = PARALLEL (g_north, g_south) ;
+    if (nthreads > 1u)
+    {
+        tasks   = (FillTask_t *) malloc (sizeof (FillTask_t) * nthreads) ;
+        threads = (pthread_t *)  malloc (sizeof (pthread_t)  * nthreads) ;
+    }
+#endif
 
-    *sysmatrix.Values++  = -conductance ;
-    diagonal_value +=  conductance ;
+    if (tasks == NULL || threads == NULL)
+    {
+        // Sequential assembly: every column starts where the previous ends
 
-    (*sysmatrix.ColumnPointers)++ ;
+        SystemMatrix_t tmp_matrix ;
+        CellIndex_t    cell ;
 
-#ifdef PRINT_SYSTEM_MATRIX
-    fprintf (stderr,
-        "  north   \t%d\t% .4e = % .4e (N) || % .4e (S)\n",
-        *(sysmatrix.RowIndices-1), *(sysmatrix.Values-1), g_north, g_south) ;
-#endif
+        tmp_matrix.Size = sysmatrix->Size ;
+        tmp_matrix.NNz  = sysmatrix->NNz ;
 
-skip_north :
+        tmp_matrix.ColumnPointers = sysmatrix->ColumnPointers + 1 ;
+        tmp_matrix.RowIndices     = sysmatrix->RowIndices ;
+        tmp_matrix.Values         = sysmatrix->Values ;
 
-    /********************************* TOP ************************************/
+        for (cell = 0u ; cell != ncells ; cell++)
 
-    // The top of the spreader is connected with the pluggable heat sink,
-    // whose state variables are not part of the system matrix.
-    // Thus, no other nonzero element appears in the sysyem matrix, but
-    // a conductance term is summed to the diagonal element
+            tmp_matrix = add_column
 
-    g_top = get_spreader_sink_conductance(sink, row_index, column_index);
-    diagonal_value += g_top;
-#ifdef PRINT_SYSTEM_MATRIX
-    fprintf (stderr, "  top (to sink) % .4e\n", g_top);
-#endif
+                (tmp_matrix, thermal_grid, analysis, dimensions, cell) ;
 
-    /************************** DIAGONAL ELEMENT ******************************/
+        free (tasks) ;
+        free (threads) ;
 
-    *diagonal_pointer += diagonal_value ;
+        return ;
+    }
 
-#ifdef PRINT_SYSTEM_MATRIX
-    fgetpos (stderr, &last_fpos) ;
-    fsetpos (stderr, &diag_fposition) ;
-    fprintf (stderr, "% .4e", *diagonal_pointer) ;
-    fsetpos (stderr, &last_fpos) ;
+    // Parallel assembly: the number of coefficients of every column is
+    // counted first (in parallel), then the column pointers are computed
+    // and the threads fill disjoint ranges of columns
 
-    fprintf (stderr, "  %d\n", *sysmatrix.ColumnPointers) ;
-#endif
+    Quantity_t  index ;
+    CellIndex_t cell ;
 
-    sysmatrix.ColumnPointers++ ;
+    for (index = 0u ; index != nthreads ; index++)
+    {
+        tasks [index].SystemMatrix = sysmatrix ;
+        tasks [index].ThermalGrid  = thermal_grid ;
+        tasks [index].Analysis     = analysis ;
+        tasks [index].Dimensions   = dimensions ;
+        tasks [index].FirstCell    = (CellIndex_t) ((uint64_t) ncells *  index       / nthreads) ;
+        tasks [index].LastCell     = (CellIndex_t) ((uint64_t) ncells * (index + 1u) / nthreads) ;
+    }
 
-    return sysmatrix ;
+    run_fill_tasks (count_columns, tasks, threads, nthreads) ;
+
+    for (cell = 0u ; cell != ncells ; cell++)
+
+        sysmatrix->ColumnPointers [cell + 1] += sysmatrix->ColumnPointers [cell] ;
+
+    run_fill_tasks (fill_columns, tasks, threads, nthreads) ;
+
+    free (tasks) ;
+    free (threads) ;
 }
 
 /******************************************************************************/
@@ -1650,198 +2627,267 @@ void fill_system_matrix
     Dimensions_t   *dimensions
 )
 {
-#ifdef PRINT_SYSTEM_MATRIX
-    fprintf (stderr,
-        "fill_system_matrix ( l %d r %d c %d )\n",
-        get_number_of_layers  (dimensions),
-        get_number_of_rows    (dimensions),
-        get_number_of_columns (dimensions)) ;
-#endif
+    assemble_system_matrix (sysmatrix, thermal_grid, analysis, dimensions) ;
+
+    // The convective terms of the liquid cells are the only unsymmetric ones
+
+    sysmatrix->SymmetricPositiveDefinite =
+
+           is_symmetric           (sysmatrix) == true
+        && is_diagonally_dominant (sysmatrix) == true ;
+}
+
+/******************************************************************************/
+
+// Returns a copy of sysmatrix with the pointers moved to the first coefficient
+// of the column cell_index, so that the add_*_column functions overwrite, in
+// place, the coefficients stored for that column when the matrix was filled.
 
+static SystemMatrix_t seek_column (SystemMatrix_t *sysmatrix, CellIndex_t cell_index)
+{
     SystemMatrix_t tmp_matrix ;
 
     tmp_matrix.Size = sysmatrix->Size ;
     tmp_matrix.NNz  = sysmatrix->NNz ;
 
-    tmp_matrix.ColumnPointers = sysmatrix->ColumnPointers ;
-    tmp_matrix.RowIndices     = sysmatrix->RowIndices ;
-    tmp_matrix.Values         = sysmatrix->Values ;
+    tmp_matrix.ColumnPointers = sysmatrix->ColumnPointers + cell_index + 1 ;
+    tmp_matrix.RowIndices     = sysmatrix->RowIndices + sysmatrix->ColumnPointers [cell_index] ;
+    tmp_matrix.Values         = sysmatrix->Values     + sysmatrix->ColumnPointers [cell_index] ;
 
-    tmp_matrix.ColumnPointers[0] = 0u ;
+    return tmp_matrix ;
+}
 
-    tmp_matrix.ColumnPointers++ ;
+/******************************************************************************/
 
+void update_system_matrix_channel
+(
+    SystemMatrix_t *sysmatrix,
+    ThermalGrid_t  *thermal_grid,
+    Analysis_t     *analysis,
+    Dimensions_t   *dimensions
+)
+{
     CellIndex_t lindex ;
+    CellIndex_t row ;
+    CellIndex_t column ;
 
     for (lindex = 0u ; lindex != thermal_grid->NLayers ; lindex++)
     {
         switch (thermal_grid->LayersTypeProfile [lindex])
         {
-            case TDICE_LAYER_SOLID :
-            case TDICE_LAYER_SOURCE :
-            case TDICE_LAYER_SOLID_CONNECTED_TO_AMBIENT :
-            case TDICE_LAYER_SOURCE_CONNECTED_TO_AMBIENT :
-            case TDICE_LAYER_SOLID_CONNECTED_TO_SPREADER :
-            case TDICE_LAYER_SOURCE_CONNECTED_TO_SPREADER :
-            case TDICE_LAYER_SOLID_CONNECTED_TO_PCB :
-            case TDICE_LAYER_SOURCE_CONNECTED_TO_PCB :
-            {
-
-                CellIndex_t row ;
-                CellIndex_t column ;
+            case TDICE_LAYER_CHANNEL_4RM :
 
                 for (row = first_row (dimensions) ; row <= last_row (dimensions) ; row++)
-                {
+
                     for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
-                    {
-                        tmp_matrix = add_solid_column
 
-                            (tmp_matrix, thermal_grid, analysis, dimensions,
-                             lindex, row, column) ;
+                        if (IS_CHANNEL_COLUMN (thermal_grid->Channel->ChannelModel, column) == true)
 
-                    } // FOR_EVERY_COLUMN
-                } // FOR_EVERY_ROW
+                            add_liquid_column_4rm
 
+                                (seek_column (sysmatrix, get_cell_offset_in_stack (dimensions, lindex, row, column)),
+                                 thermal_grid, analysis, dimensions,
+                                 lindex, row, column) ;
 
                 break ;
-            }
-            case TDICE_LAYER_CHANNEL_4RM :
-            {
-                CellIndex_t row ;
-                CellIndex_t column ;
+
+            case TDICE_LAYER_CHANNEL_2RM :
+            case TDICE_LAYER_PINFINS_INLINE :
+            case TDICE_LAYER_PINFINS_STAGGERED :
 
                 for (row = first_row (dimensions) ; row <= last_row (dimensions) ; row++)
-                {
+
                     for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
-                    {
-                        if (IS_CHANNEL_COLUMN (thermal_grid->Channel->ChannelModel, column) == true)
 
-                            tmp_matrix = add_liquid_column_4rm
+                        add_liquid_column_2rm
 
-                                (tmp_matrix, thermal_grid, analysis, dimensions,
-                                 lindex, row, column) ;
+                            (seek_column (sysmatrix, get_cell_offset_in_stack (dimensions, lindex, row, column)),
+                             thermal_grid, analysis, dimensions,
+                             lindex, row, column) ;
 
-                        else
+                break ;
 
-                            tmp_matrix = add_solid_column
+            default :
 
-                                (tmp_matrix, thermal_grid, analysis, dimensions,
-                                 lindex, row, column) ;
+                break ;
+        }
+    }
+}
 
-                    } // FOR_EVERY_COLUMN
-                }  // FOR_EVERY_ROW
+/******************************************************************************/
 
-                break ;
-            }
-            case TDICE_LAYER_CHANNEL_2RM :
-            case TDICE_LAYER_PINFINS_INLINE :
-            case TDICE_LAYER_PINFINS_STAGGERED :
-            {
-                CellIndex_t row ;
-                CellIndex_t column ;
+void update_system_matrix_spreader
+(
+    SystemMatrix_t *sysmatrix,
+    ThermalGrid_t  *thermal_grid,
+    Analysis_t     *analysis,
+    Dimensions_t   *dimensions
+)
+{
+    HeatSink_t *sink = thermal_grid->TopHeatSink ;
 
-                for (row = first_row (dimensions) ; row <= last_row (dimensions) ; row++)
-                {
-                    for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
-                    {
-                        tmp_matrix = add_liquid_column_2rm
+    if (sink == NULL || sink->SinkModel != TDICE_HEATSINK_TOP_PLUGGABLE)
 
-                            (tmp_matrix, thermal_grid, analysis, dimensions,
-                             lindex, row, column) ;
+        return ;
 
-                    } // FOR_EVERY_COLUMN
-                }  // FOR_EVERY_ROW
+    CellIndex_t row ;
+    CellIndex_t column ;
 
-                break ;
-            }
-            case TDICE_LAYER_VWALL_CHANNEL :
-            case TDICE_LAYER_VWALL_PINFINS :
-            {
-                CellIndex_t row ;
-                CellIndex_t column ;
+    for (row = 0 ; row < sink->NRows ; row++)
 
-                for (row = first_row (dimensions) ; row <= last_row (dimensions) ; row++)
-                {
-                    for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
-                    {
-                        tmp_matrix = add_virtual_wall_column_2rm
+        for (column = 0 ; column < sink->NColumns ; column++)
 
-                            (tmp_matrix, thermal_grid, analysis, dimensions,
-                             thermal_grid->Channel->ChannelModel,
-                             lindex, row, column) ;
+            add_spreader_column
 
-                    } // FOR_EVERY_COLUMN
-                }  // FOR_EVERY_ROW
+                (seek_column (sysmatrix, get_spreader_cell_offset (dimensions, sink, row, column)),
+                 thermal_grid, analysis, dimensions,
+                 row, column) ;
+}
 
-                break ;
-            }
-            case TDICE_LAYER_TOP_WALL :
-            {
-                CellIndex_t row ;
-                CellIndex_t column ;
+/******************************************************************************/
 
-                for (row = first_row (dimensions) ; row <= last_row (dimensions) ; row++)
-                {
-                    for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
-                    {
-                        tmp_matrix = add_top_wall_column_2rm
+#define REFINEMENT_MAX_ITERATIONS 30u
 
-                            (tmp_matrix, thermal_grid, analysis, dimensions,
-                             lindex, row, column) ;
+// Solves the linear systems with the factors in single precision and refines
+// the solutions computing the residuals with the matrix in double precision,
+// as LAPACK dsgesv, until their norm is below sqrt(n) eps |A| |x| . Returns
+// false if this does not happen (b must then be restored by the caller).
+// The work buffers and |A| are set by prepare_refinement
 
-                    } // FOR_EVERY_COLUMN
-                }  // FOR_EVERY_ROW
+static bool solve_refined
+(
+    SystemMatrix_t *sysmatrix,
+    double         *b,
+    Quantity_t      nrhs,
+    CellIndex_t     ldb,
+    double         *rhs
+)
+{
+    CellIndex_t size     = sysmatrix->Size ;
+    double     *residual = sysmatrix->RefinementResiduals ;
+    double      anorm    = sysmatrix->ANorm ;
+    bool        converged = false ;
 
-                break ;
-            }
-            case TDICE_LAYER_BOTTOM_WALL :
-            {
-                CellIndex_t row ;
-                CellIndex_t column ;
+    CellIndex_t cell, index ;
+    Quantity_t  column, iteration ;
 
-                for (row = first_row (dimensions) ; row <= last_row (dimensions) ; row++)
-                {
-                    for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
-                    {
-                        tmp_matrix = add_bottom_wall_column_2rm
+    multifrontal_solver_solve (&sysmatrix->Multifrontal, b, nrhs, ldb) ;
 
-                            (tmp_matrix, thermal_grid, analysis, dimensions,
-                             lindex, row, column) ;
+    for (iteration = 0u ; iteration != REFINEMENT_MAX_ITERATIONS ; iteration++)
+    {
+        converged = true ;
 
-                    } // FOR_EVERY_COLUMN
-                }  // FOR_EVERY_ROW
-                break ;
+        for (column = 0u ; column != nrhs ; column++)
+        {
+            double *x = b        + (size_t) column * ldb ;
+            double *r = residual + (size_t) column * size ;
 
-            }
-            case TDICE_LAYER_NONE :
-            {
-                fprintf (stderr, "ERROR: unset layer type\n") ;
+            double rnorm = 0.0, xnorm = 0.0 ;
 
-                break ;
+            memcpy (r, rhs + (size_t) column * size, sizeof (double) * size) ;
+
+            for (cell = 0u ; cell != size ; cell++)
+
+                for (index  = sysmatrix->ColumnPointers [cell] ;
+                     index != sysmatrix->ColumnPointers [cell + 1] ; index++)
+
+                    r [sysmatrix->RowIndices [index]] -= sysmatrix->Values [index] * x [cell] ;
+
+            for (cell = 0u ; cell != size ; cell++)
+            {
+                rnorm = MAX (rnorm, fabs (r [cell])) ;
+                xnorm = MAX (xnorm, fabs (x [cell])) ;
             }
-            default :
 
-                fprintf (stderr, "ERROR: unknown layer type %d\n", thermal_grid->LayersTypeProfile [lindex]) ;
+            if (rnorm > xnorm * anorm * DBL_EPSILON * sqrt ((double) size))
+
+                converged = false ;
         }
 
+        if (converged == true)
+
+            break ;
+
+        multifrontal_solver_solve (&sysmatrix->Multifrontal, residual, nrhs, size) ;
+
+        for (column = 0u ; column != nrhs ; column++)
+
+            for (cell = 0u ; cell != size ; cell++)
+
+                b [(size_t) column * ldb + cell] += residual [(size_t) column * size + cell] ;
     }
-    
-    if(thermal_grid->TopHeatSink && thermal_grid->TopHeatSink->SinkModel == TDICE_HEATSINK_TOP_PLUGGABLE)
-    {
-        CellIndex_t row ;
-        CellIndex_t column ;
-        for(row = 0; row < thermal_grid->TopHeatSink->NRows; row++)
-            for(column = 0; column < thermal_grid->TopHeatSink->NColumns; column++)
-                tmp_matrix = add_spreader_column
-                            (tmp_matrix, thermal_grid, analysis, dimensions,
-                             row, column);
-    }
+
+    return converged ;
 }
 
 /******************************************************************************/
 
 Error_t solve_sparse_linear_system (SystemMatrix_t *sysmatrix, SuperMatrix *b)
 {
+    if (use_multifrontal (sysmatrix) == true)
+    {
+        DNformat   *store = (DNformat *) b->Store ;
+        double     *x     = (double *) store->nzval ;
+        CellIndex_t size  = sysmatrix->Size ;
+        Quantity_t  column ;
+
+        if (sysmatrix->Multifrontal.SinglePrecision == false)
+        {
+            multifrontal_solver_solve
+
+                (&sysmatrix->Multifrontal, x, b->ncol, store->lda) ;
+
+            return TDICE_SUCCESS ;
+        }
+
+        if (reserve_refinement_buffers (sysmatrix, b->ncol) != TDICE_SUCCESS)
+
+            return TDICE_FAILURE ;
+
+        double *rhs = sysmatrix->RefinementRhs ;
+
+        for (column = 0u ; column != (Quantity_t) b->ncol ; column++)
+
+            memcpy (rhs + (size_t) column * size,
+                    x + (size_t) column * store->lda, sizeof (double) * size) ;
+
+        if (solve_refined (sysmatrix, x, b->ncol, store->lda, rhs) == true)
+
+            return TDICE_SUCCESS ;
+
+        // The matrix is too ill conditioned for the single precision:
+        // it is factorized again (also in the next steps) in double
+
+        fprintf (stderr, "WARNING: iterative refinement did not converge, "
+                         "factorizing in double precision\n") ;
+
+        for (column = 0u ; column != (Quantity_t) b->ncol ; column++)
+
+            memcpy (x + (size_t) column * store->lda,
+                    rhs + (size_t) column * size, sizeof (double) * size) ;
+
+        sysmatrix->Multifrontal.SinglePrecision = false ;
+
+        multifrontal_solver_destroy (&sysmatrix->Multifrontal) ;
+
+        if (do_factorization (sysmatrix) != TDICE_SUCCESS)
+
+            return TDICE_FAILURE ;
+
+        return solve_sparse_linear_system (sysmatrix, b) ;
+    }
+
+    if (sysmatrix->SolverType != TDICE_SOLVER_SUPERLU)
+    {
+        DNformat *store = (DNformat *) b->Store ;
+
+        return krylov_solver_solve
+
+            (&sysmatrix->Krylov,
+             sysmatrix->ColumnPointers, sysmatrix->RowIndices, sysmatrix->Values,
+             (double *) store->nzval, b->ncol, store->lda) ;
+    }
+
     dgstrs
 
         (NOTRANS, &sysmatrix->SLUMatrix_L, &sysmatrix->SLUMatrix_U,
@@ -0,0 +1,303 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <stdio.h>  // For the file type FILE
+#include <stdlib.h> // For the memory functions malloc/free
+#include <string.h> // For the memory function memcpy
+
+#include "thermal_batch.h"
+#include "macros.h"
+
+/******************************************************************************/
+
+void thermal_batch_init (ThermalBatch_t *batch)
+{
+    batch->NScenarios   = (Quantity_t) 0u ;
+    batch->Size         = (CellIndex_t) 0u ;
+    batch->Temperatures = NULL ;
+    batch->Sources      = NULL ;
+
+    batch->StepTemperatures = NULL ;
+
+    batch->SLUMatrix_B.Store = NULL ;
+}
+
+/******************************************************************************/
+
+Error_t thermal_batch_build
+(
+    ThermalBatch_t *batch,
+    ThermalData_t  *tdata,
+    Quantity_t      nscenarios,
+    Analysis_t     *analysis
+)
+{
+    HeatSink_t *sink = tdata->ThermalGrid.TopHeatSink ;
+
+    if (sink != NULL && sink->SinkModel == TDICE_HEATSINK_TOP_PLUGGABLE)
+    {
+        fprintf (stderr, "Batch simulations do not support pluggable heat sinks\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    // The scenarios always advance by StepTime, while an adaptive step
+    // would need its own step length and system matrix for each of them
+
+    if (analysis->StepTolerance > 0.0)
+    {
+        fprintf (stderr, "Batch simulations need a fixed time step\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    if (nscenarios == 0u)
+    {
+        fprintf (stderr, "Batch simulations need at least one scenario\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    batch->NScenarios = nscenarios ;
+    batch->Size       = tdata->Size ;
+
+    batch->Temperatures =
+
+        (Temperature_t *) malloc (sizeof (Temperature_t) * batch->Size * nscenarios) ;
+
+    if (batch->Temperatures == NULL)
+    {
+        fprintf (stderr, "Cannot malloc batch temperature array\n") ;
+
+        return TDICE_FAILURE ;
+    }
+
+    batch->Sources =
+
+        (Source_t *) malloc (sizeof (Source_t) * batch->Size * nscenarios) ;
+
+    if (batch->Sources == NULL)
+    {
+        fprintf (stderr, "Cannot malloc batch source array\n") ;
+
+        free (batch->Temperatures) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    if (analysis->IntegrationMethod == TDICE_INTEGRATION_TRAPEZOIDAL)
+    {
+        batch->StepTemperatures =
+
+            (Temperature_t *) malloc (sizeof (Temperature_t) * batch->Size * nscenarios) ;
+
+        if (batch->StepTemperatures == NULL)
+        {
+            fprintf (stderr, "Cannot malloc batch step temperature array\n") ;
+
+            free (batch->Temperatures) ;
+            free (batch->Sources) ;
+
+            return TDICE_FAILURE ;
+        }
+    }
+
+    Quantity_t scenario ;
+
+    for (scenario = 0u ; scenario != nscenarios ; scenario++)
+
+        memcpy (get_batch_sources (batch, scenario), tdata->PowerGrid.Sources,
+                sizeof (Source_t) * batch->Size) ;
+
+    reset_batch_thermal_state (batch, analysis) ;
+
+    dCreate_Dense_Matrix  /* Matrix B, one column for each scenario */
+
+        (&batch->SLUMatrix_B, batch->Size, nscenarios,
+         batch->Temperatures, batch->Size,
+         SLU_DN, SLU_D, SLU_GE) ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+void thermal_batch_destroy (ThermalBatch_t *batch)
+{
+    free (batch->Temperatures) ;
+    free (batch->Sources) ;
+    free (batch->StepTemperatures) ;
+
+    if (batch->SLUMatrix_B.Store != NULL)
+
+        Destroy_SuperMatrix_Store (&batch->SLUMatrix_B) ;
+
+    thermal_batch_init (batch) ;
+}
+
+/******************************************************************************/
+
+void reset_batch_thermal_state (ThermalBatch_t *batch, Analysis_t *analysis)
+{
+    Temperature_t *temperature = batch->Temperatures ;
+    Temperature_t *end         = batch->Temperatures + batch->Size * batch->NScenarios ;
+
+    while (temperature != end)
+
+        *temperature++ = analysis->InitialTemperature ;
+}
+
+/******************************************************************************/
+
+Error_t update_batch_sources
+(
+    ThermalBatch_t *batch,
+    ThermalData_t  *tdata,
+    Dimensions_t   *dimensions,
+    Quantity_t      scenario,
+    PowersQueue_t  *pvalues
+)
+{
+    if (scenario >= batch->NScenarios)
+    {
+        fprintf (stderr, "Scenario %d out of range\n", scenario) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    if (insert_power_values (&tdata->PowerGrid, pvalues) == TDICE_FAILURE)
+
+        return TDICE_FAILURE ;
+
+    if (update_source_vector (&tdata->PowerGrid, dimensions) == TDICE_FAILURE)
+
+        return TDICE_FAILURE ;
+
+    memcpy (get_batch_sources (batch, scenario), tdata->PowerGrid.Sources,
+            sizeof (Source_t) * batch->Size) ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+Temperature_t *get_batch_temperatures (ThermalBatch_t *batch, Quantity_t scenario)
+{
+    return batch->Temperatures + (size_t) scenario * batch->Size ;
+}
+
+/******************************************************************************/
+
+Source_t *get_batch_sources (ThermalBatch_t *batch, Quantity_t scenario)
+{
+    return batch->Sources + (size_t) scenario * batch->Size ;
+}
+
+/******************************************************************************/
+
+SimResult_t emulate_batch_step
+(
+    ThermalBatch_t *batch,
+    ThermalData_t  *tdata,
+    Analysis_t     *analysis
+)
+{
+    if (analysis->AnalysisType != TDICE_ANALYSIS_TYPE_TRANSIENT)
+
+        return TDICE_WRONG_CONFIG ;
+
+    // The right hand side of every scenario is built over its temperatures,
+    // as for a single simulation (see fill_system_vector in thermal_data.c)
+
+    Quantity_t  scenario ;
+    CellIndex_t cell ;
+    Time_t      step_time = get_matrix_step_time (analysis) ;
+
+    // The trapezoidal rule extrapolates the solution from the temperatures
+    // at the beginning of the step (see solve_time_step in thermal_data.c)
+
+    if (analysis->IntegrationMethod == TDICE_INTEGRATION_TRAPEZOIDAL)
+
+        memcpy (batch->StepTemperatures, batch->Temperatures,
+                sizeof (Temperature_t) * batch->Size * batch->NScenarios) ;
+
+    for (scenario = 0u ; scenario != batch->NScenarios ; scenario++)
+    {
+        Temperature_t *temperatures = get_batch_temperatures (batch, scenario) ;
+        Source_t      *sources      = get_batch_sources      (batch, scenario) ;
+        Capacity_t    *capacities   = tdata->PowerGrid.CellsCapacities ;
+
+        for (cell = 0u ; cell != batch->Size ; cell++)
+
+            temperatures [cell] =   sources [cell]
+                                  + (capacities [cell] / step_time)
+                                    * temperatures [cell] ;
+    }
+
+    Error_t res = solve_sparse_linear_system (&tdata->SM_A, &batch->SLUMatrix_B) ;
+
+    if (res != TDICE_SUCCESS)
+
+        return TDICE_SOLVER_ERROR ;
+
+    if (analysis->IntegrationMethod == TDICE_INTEGRATION_TRAPEZOIDAL)
+    {
+        Temperature_t *temperature = batch->Temperatures ;
+        Temperature_t *start       = batch->StepTemperatures ;
+        Temperature_t *end         = batch->Temperatures + batch->Size * batch->NScenarios ;
+
+        while (temperature != end)
+        {
+            *temperature = 2.0 * *temperature - *start++ ;
+
+            temperature++ ;
+        }
+    }
+
+    increase_by_step_time (analysis) ;
+
+    if (slot_completed (analysis) == false)
+
+        return TDICE_STEP_DONE ;
+
+    else
+
+        return TDICE_SLOT_DONE ;
+}
+
+/******************************************************************************/
@@ -37,7 +37,9 @@
  * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
  ******************************************************************************/
 
-#include <stdio.h> // For the file type FILE
+#include <stdio.h>  // For the file type FILE
+#include <string.h> // For the memory function memcpy
+#include <math.h>   // For the math function fabs
 
 #include "thermal_data.h"
 #include "macros.h"
@@ -62,6 +64,99 @@ void thermal_data_init (ThermalData_t *tdata)
     system_matrix_init (&tdata->SM_A) ;
 
     tdata->SLUMatrix_B.Store = NULL ;
+
+    tdata->StepTemperatures     = NULL ;
+    tdata->PreviousTemperatures = NULL ;
+    tdata->PreviousStepLength   = (Quantity_t) 0u ;
+    tdata->NextStepLength       = (Quantity_t) 1u ;
+    tdata->StepCounter          = (Quantity_t) 0u ;
+
+    Quantity_t index ;
+
+    for (index = 0u ; index != TDICE_STEP_CACHE_SIZE ; index++)
+    {
+        system_matrix_init (&tdata->StepMatrices [index]) ;
+
+        tdata->StepMatricesLength  [index] = (Quantity_t) 0u ;
+        tdata->StepMatricesLastUse [index] = (Quantity_t) 0u ;
+    }
+}
+
+/******************************************************************************/
+
+/* Sets the solver of a (filled) system matrix as requested in \a analysis
+ * and factorizes it, reading and storing the factors in the cache
+ * directory if there is one */
+
+static Error_t factorize_system_matrix
+(
+    SystemMatrix_t *sysmatrix,
+    ThermalGrid_t  *thermal_grid,
+    Dimensions_t   *dimensions,
+    Analysis_t     *analysis
+)
+{
+    Error_t result = TDICE_SUCCESS ;
+
+    sysmatrix->SolverType            = analysis->SolverType ;
+    sysmatrix->Krylov.Tolerance      = analysis->SolverTolerance ;
+    sysmatrix->Krylov.MaxIterations  = analysis->SolverMaxIterations ;
+    sysmatrix->Multifrontal.NThreads = analysis->NThreads ;
+
+    sysmatrix->Multifrontal.SinglePrecision = analysis->SinglePrecision ;
+
+    if (analysis->SolverType == TDICE_SOLVER_MULTIGRID)
+
+        multigrid_set_grid (&sysmatrix->Krylov.Multigrid, dimensions, thermal_grid) ;
+
+    set_column_ordering (sysmatrix, analysis->Ordering, dimensions, thermal_grid) ;
+
+    // A matrix already factorized by a previous run is read from the cache.
+    // Otherwise, the new factors are stored for later runs (if this fails
+    // the simulation can still go on). Only the LU factors of SuperLU are
+    // cached, not the Cholesky ones of the symmetric matrices nor those in
+    // single precision.
+
+    bool use_cache =
+
+           analysis->FactorizationCache != NULL
+        && analysis->SolverType == TDICE_SOLVER_SUPERLU
+        && analysis->SinglePrecision == false
+        && sysmatrix->SymmetricPositiveDefinite == false ;
+
+    if (   use_cache == false
+        || system_matrix_load_factors
+
+               (sysmatrix, analysis->FactorizationCache) == TDICE_FAILURE)
+    {
+        result = do_factorization (sysmatrix) ;
+
+        if (result == TDICE_SUCCESS && use_cache == true)
+
+            system_matrix_store_factors
+
+                (sysmatrix, analysis->FactorizationCache) ;
+    }
+
+    return result ;
+}
+
+/******************************************************************************/
+
+/* Destroys the system matrices built for the steps longer than StepTime */
+
+static void clear_step_matrices (ThermalData_t *tdata)
+{
+    Quantity_t index ;
+
+    for (index = 0u ; index != TDICE_STEP_CACHE_SIZE ; index++)
+    {
+        if (tdata->StepMatricesLength [index] != 0u)
+
+            system_matrix_destroy (&tdata->StepMatrices [index]) ;
+
+        tdata->StepMatricesLength [index] = (Quantity_t) 0u ;
+    }
 }
 
 /******************************************************************************/
@@ -116,7 +211,7 @@ Error_t thermal_data_build
         return TDICE_FAILURE ;
     }
 
-    result = thermal_grid_fill (&tdata->ThermalGrid, stack_elements_list) ;
+    result = thermal_grid_fill (&tdata->ThermalGrid, stack_elements_list, dimensions) ;
     
     if (result == TDICE_FAILURE)
     {
@@ -172,7 +267,9 @@ Error_t thermal_data_build
 
         (&tdata->SM_A, &tdata->ThermalGrid, analysis, dimensions) ;
 
-    result = do_factorization (&tdata->SM_A) ;
+    result = factorize_system_matrix
+
+        (&tdata->SM_A, &tdata->ThermalGrid, dimensions, analysis) ;
 
     if (result == TDICE_FAILURE)
     {
@@ -180,6 +277,45 @@ Error_t thermal_data_build
 
         return TDICE_FAILURE ;
     }
+
+    /* The adaptive time step needs the temperatures of the two previous
+     * steps while the trapezoidal rule needs the ones at the beginning of
+     * the current step */
+
+    if (   analysis->AnalysisType  == TDICE_ANALYSIS_TYPE_TRANSIENT
+        && (   analysis->StepTolerance > 0.0
+            || analysis->IntegrationMethod == TDICE_INTEGRATION_TRAPEZOIDAL))
+    {
+        tdata->StepTemperatures =
+
+            (Temperature_t*) malloc (sizeof(Temperature_t) * tdata->Size) ;
+
+        if (tdata->StepTemperatures == NULL)
+        {
+            fprintf (stderr, "Cannot malloc step temperature array\n") ;
+
+            thermal_data_destroy (tdata) ;
+
+            return TDICE_FAILURE ;
+        }
+    }
+
+    if (   analysis->AnalysisType  == TDICE_ANALYSIS_TYPE_TRANSIENT
+        && analysis->StepTolerance >  0.0)
+    {
+        tdata->PreviousTemperatures =
+
+            (Temperature_t*) malloc (sizeof(Temperature_t) * tdata->Size) ;
+
+        if (tdata->PreviousTemperatures == NULL)
+        {
+            fprintf (stderr, "Cannot malloc temperature arrays for the adaptive step\n") ;
+
+            thermal_data_destroy (tdata) ;
+
+            return TDICE_FAILURE ;
+        }
+    }
     
     /* Set the pluggable heatsing temperatures to initial thermal state */
     
@@ -205,6 +341,11 @@ void thermal_data_destroy (ThermalData_t *tdata)
 
     system_matrix_destroy (&tdata->SM_A) ;
 
+    clear_step_matrices (tdata) ;
+
+    free (tdata->StepTemperatures) ;
+    free (tdata->PreviousTemperatures) ;
+
     Destroy_SuperMatrix_Store (&tdata->SLUMatrix_B) ;
 
     thermal_data_init (tdata) ;
@@ -215,6 +356,9 @@ void thermal_data_destroy (ThermalData_t *tdata)
 void reset_thermal_state (ThermalData_t *tdata, Analysis_t *analysis)
 {
     init_data (tdata->Temperatures, tdata->Size, analysis->InitialTemperature) ;
+
+    tdata->PreviousStepLength = (Quantity_t) 0u ;
+    tdata->NextStepLength     = (Quantity_t) 1u ;
 }
 
 /******************************************************************************/
@@ -297,6 +441,7 @@ static void fill_system_vector
 static void fill_system_vector_steady
 (
     Dimensions_t *dimensions,
+    HeatSink_t   *topSink,
     double       *vector,
     Source_t     *sources
 )
@@ -324,20 +469,29 @@ static void fill_system_vector_steady
             } // FOR_EVERY_COLUMN
         } // FOR_EVERY_ROW
   } // FOR_EVERY_LAYER
+
+    // Copy the rest of the vector
+    if(topSink && topSink->SinkModel == TDICE_HEATSINK_TOP_PLUGGABLE)
+
+        memcpy (vector, sources,
+                sizeof(double) * topSink->NRows * topSink->NColumns) ;
 }
 
-Error_t pluggable_heatsink(ThermalData_t *tdata, Dimensions_t *dimensions,
-                           Analysis_t *analysis)
+/******************************************************************************/
+
+/* Calls the pluggable heat sink to compute the temperatures of the sink from
+ * those of the spreader. If the conductances between the spreader and the
+ * sink have changed the system matrix is factorized again */
+
+static Error_t simulate_pluggable_heatsink
+(
+    ThermalData_t *tdata,
+    Dimensions_t  *dimensions,
+    Analysis_t    *analysis
+)
 {
-    // If the previous temperatures differ too much from the current ones,
-    // the simulation may provide incorrect results
-    const double threshold = 2.0;
-    
-    // We have something to do only if we're using the pluggable heatsink model
     HeatSink_t *sink = tdata->ThermalGrid.TopHeatSink;
-    if(sink == NULL || sink->SinkModel != TDICE_HEATSINK_TOP_PLUGGABLE)
-            return TDICE_SUCCESS;
-    
+
     //Get a pointer to the spreader temperatures
     double *SpreaderTemperatures = tdata->Temperatures;
     SpreaderTemperatures += get_spreader_cell_offset(dimensions,sink,0,0);
@@ -351,24 +505,40 @@ Error_t pluggable_heatsink(ThermalData_t *tdata, Dimensions_t *dimensions,
     {
         case 0:
             //Everything ok
-            break;
+            return TDICE_SUCCESS;
         case 1:
         {
-            //Thermal conductances between spreader and sink have changed
-            //TODO: optimize? However update_coolant_flow_rate does the same...
-            fill_system_matrix
+            //Thermal conductances between spreader and sink have changed,
+            //only the spreader columns of the system matrix are affected
+            update_system_matrix_spreader
                 (&tdata->SM_A, &tdata->ThermalGrid, analysis, dimensions) ;
             if (do_factorization (&tdata->SM_A) == TDICE_FAILURE)
             {
                 fprintf(stderr, "Error: failed updating spreader-sink conductances\n");
                 return TDICE_FAILURE ;
             }
-            break;
+            return TDICE_SUCCESS;
         }
         default:
             fprintf(stderr, "Error: pluggable heatsink callback failed\n");
             return TDICE_FAILURE;
     }
+}
+
+Error_t pluggable_heatsink(ThermalData_t *tdata, Dimensions_t *dimensions,
+                           Analysis_t *analysis)
+{
+    // If the previous temperatures differ too much from the current ones,
+    // the simulation may provide incorrect results
+    const double threshold = 2.0;
+    
+    // We have something to do only if we're using the pluggable heatsink model
+    HeatSink_t *sink = tdata->ThermalGrid.TopHeatSink;
+    if(sink == NULL || sink->SinkModel != TDICE_HEATSINK_TOP_PLUGGABLE)
+            return TDICE_SUCCESS;
+    
+    if(simulate_pluggable_heatsink(tdata, dimensions, analysis) == TDICE_FAILURE)
+        return TDICE_FAILURE;
     
     unsigned int size = sink->NColumns * sink->NRows;
     
@@ -376,7 +546,7 @@ Error_t pluggable_heatsink(ThermalData_t *tdata, Dimensions_t *dimensions,
     unsigned int i;
     for(i = 0; i < size; i++)
     {
-        if(abs(sink->CurrentSinkTemperatures[i] - sink->PreviousSinkTemperatures[i]) <= threshold)
+        if(fabs(sink->CurrentSinkTemperatures[i] - sink->PreviousSinkTemperatures[i]) <= threshold)
             continue;
         fprintf(stderr, "Warning: the integration time step may be too large\n");
         break;
@@ -396,6 +566,233 @@ Error_t pluggable_heatsink(ThermalData_t *tdata, Dimensions_t *dimensions,
 
 /******************************************************************************/
 
+/* Returns the (factorized) system matrix for a time step of \a length times
+ * StepTime. The matrices are kept in a small cache and, when a new one is
+ * needed, the least recently used one is replaced. */
+
+static SystemMatrix_t *get_step_matrix
+(
+    ThermalData_t *tdata,
+    Dimensions_t  *dimensions,
+    Analysis_t    *analysis,
+    Quantity_t     length
+)
+{
+    if (length == 1u)
+
+        return &tdata->SM_A ;
+
+    tdata->StepCounter++ ;
+
+    Quantity_t index, victim = 0u ;
+
+    for (index = 0u ; index != TDICE_STEP_CACHE_SIZE ; index++)
+    {
+        if (tdata->StepMatricesLength [index] == length)
+        {
+            tdata->StepMatricesLastUse [index] = tdata->StepCounter ;
+
+            return &tdata->StepMatrices [index] ;
+        }
+
+        if (   tdata->StepMatricesLength  [victim] != 0u
+            && (   tdata->StepMatricesLength  [index] == 0u
+                || tdata->StepMatricesLastUse [index] < tdata->StepMatricesLastUse [victim]))
+
+            victim = index ;
+    }
+
+    SystemMatrix_t *sysmatrix = &tdata->StepMatrices [victim] ;
+
+    if (tdata->StepMatricesLength [victim] != 0u)
+
+        system_matrix_destroy (sysmatrix) ;
+
+    tdata->StepMatricesLength [victim] = (Quantity_t) 0u ;
+
+    if (system_matrix_build
+
+            (sysmatrix, tdata->Size, get_number_of_connections (dimensions))
+        == TDICE_FAILURE)
+    {
+        fprintf (stderr, "Cannot malloc system matrix\n") ;
+
+        return NULL ;
+    }
+
+    // Only the step time changes (the copy shares the strings of analysis)
+
+    Analysis_t step_analysis = *analysis ;
+
+    step_analysis.StepTime = analysis->StepTime * length ;
+
+    fill_system_matrix
+
+        (sysmatrix, &tdata->ThermalGrid, &step_analysis, dimensions) ;
+
+    if (factorize_system_matrix
+
+            (sysmatrix, &tdata->ThermalGrid, dimensions, &step_analysis)
+        == TDICE_FAILURE)
+    {
+        system_matrix_destroy (sysmatrix) ;
+
+        return NULL ;
+    }
+
+    tdata->StepMatricesLength  [victim] = length ;
+    tdata->StepMatricesLastUse [victim] = tdata->StepCounter ;
+
+    return sysmatrix ;
+}
+
+/******************************************************************************/
+
+/* Advances the temperatures from \a start by a step of \a length times
+ * StepTime solving the system \a sysmatrix . With the trapezoidal rule the
+ * system is a backward Euler step of half the length and the temperatures
+ * at the end of the step are extrapolated as 2 T(n+1/2) - T(n), i.e.
+ * \a start must not be the Temperatures array itself. */
+
+static Error_t solve_time_step
+(
+    ThermalData_t  *tdata,
+    Dimensions_t   *dimensions,
+    Analysis_t     *analysis,
+    SystemMatrix_t *sysmatrix,
+    Temperature_t  *start,
+    Quantity_t      length
+)
+{
+    fill_system_vector
+
+        (dimensions, tdata->ThermalGrid.TopHeatSink, tdata->Temperatures,
+         tdata->PowerGrid.Sources, tdata->PowerGrid.CellsCapacities,
+         start, get_matrix_step_time (analysis) * length) ;
+
+    if (solve_sparse_linear_system (sysmatrix, &tdata->SLUMatrix_B) != TDICE_SUCCESS)
+
+        return TDICE_FAILURE ;
+
+    if (analysis->IntegrationMethod == TDICE_INTEGRATION_TRAPEZOIDAL)
+    {
+        CellIndex_t cell ;
+
+        for (cell = 0u ; cell != tdata->Size ; cell++)
+
+            tdata->Temperatures [cell] = 2.0 * tdata->Temperatures [cell] - start [cell] ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+/* Simulates one adaptive time step, i.e. one or more backward Euler steps
+ * of length StepTime times a power of two. The local truncation error is
+ * estimated with the change of the temperature derivative between the
+ * previous and the current step. */
+
+static SimResult_t emulate_adaptive_step
+(
+    ThermalData_t  *tdata,
+    Dimensions_t   *dimensions,
+    Analysis_t     *analysis
+)
+{
+    Quantity_t steps_left = get_steps_to_slot_end (analysis) ;
+    Quantity_t length     = tdata->NextStepLength ;
+    Quantity_t previous   = tdata->PreviousStepLength ;
+
+    while (length > steps_left)
+
+        length /= 2u ;
+
+    memcpy (tdata->StepTemperatures, tdata->Temperatures,
+            sizeof(Temperature_t) * tdata->Size) ;
+
+    Temperature_t error = 0.0 ;
+
+    while (true)
+    {
+        SystemMatrix_t *sysmatrix =
+
+            get_step_matrix (tdata, dimensions, analysis, length) ;
+
+        if (sysmatrix == NULL)
+
+            return TDICE_SOLVER_ERROR ;
+
+        if (solve_time_step (tdata, dimensions, analysis, sysmatrix,
+                             tdata->StepTemperatures, length) != TDICE_SUCCESS)
+
+            return TDICE_SOLVER_ERROR ;
+
+        // The first step of a slot has no previous step (or it is before a
+        // change of the power values) and the error cannot be estimated
+
+        if (previous == 0u)
+
+            break ;
+
+        Temperature_t ratio  = (Temperature_t) length / (Temperature_t) previous ;
+        Temperature_t weight = (Temperature_t) length / (Temperature_t) (length + previous) ;
+
+        CellIndex_t cell ;
+
+        error = 0.0 ;
+
+        for (cell = 0u ; cell != tdata->Size ; cell++)
+        {
+            Temperature_t change = tdata->Temperatures [cell] - tdata->StepTemperatures [cell] ;
+            Temperature_t last   = tdata->StepTemperatures [cell] - tdata->PreviousTemperatures [cell] ;
+
+            error = MAX (error, weight * fabs (change - ratio * last)) ;
+        }
+
+        if (error <= analysis->StepTolerance || length == 1u)
+
+            break ;
+
+        length /= 2u ;
+    }
+
+    // The error of a backward Euler step grows with the square of its
+    // length, so the step is doubled only if the error is well below the
+    // tolerance
+
+    if (previous != 0u && error > analysis->StepTolerance)
+
+        tdata->NextStepLength = MAX (length / 2u, 1u) ;
+
+    else if (   previous != 0u && 4.0 * error <= analysis->StepTolerance
+             && 2u * length <= analysis->SlotLength)
+
+        tdata->NextStepLength = 2u * length ;
+
+    else
+
+        tdata->NextStepLength = length ;
+
+    Temperature_t *tmp          = tdata->PreviousTemperatures ;
+    tdata->PreviousTemperatures = tdata->StepTemperatures ;
+    tdata->StepTemperatures     = tmp ;
+
+    tdata->PreviousStepLength = length ;
+
+    increase_by_steps (analysis, length) ;
+
+    if (slot_completed (analysis) == false)
+
+        return TDICE_STEP_DONE ;
+
+    else
+
+        return TDICE_SLOT_DONE ;
+}
+
+/******************************************************************************/
+
 SimResult_t emulate_step
 (
     ThermalData_t  *tdata,
@@ -413,18 +810,37 @@ SimResult_t emulate_step
 
         if (result == TDICE_FAILURE)
 
-            return TDICE_END_OF_SIMULATION ;
+            return power_values_failed (&tdata->PowerGrid) == true ?
+
+                TDICE_POWER_ERROR : TDICE_END_OF_SIMULATION ;
+
+        tdata->PreviousStepLength = (Quantity_t) 0u ;
+        tdata->NextStepLength     = (Quantity_t) 1u ;
     }
+
+    if (analysis->StepTolerance > 0.0)
+
+        return emulate_adaptive_step (tdata, dimensions, analysis) ;
     
     if(pluggable_heatsink(tdata, dimensions, analysis) == TDICE_FAILURE)
         return TDICE_SOLVER_ERROR ;
 
-    fill_system_vector
+    // Backward Euler overwrites the temperatures in place while the
+    // trapezoidal rule needs them also after the system has been solved
 
-        (dimensions, tdata->ThermalGrid.TopHeatSink, tdata->Temperatures, tdata->PowerGrid.Sources,
-         tdata->PowerGrid.CellsCapacities, tdata->Temperatures, analysis->StepTime) ;
+    Temperature_t *start = tdata->Temperatures ;
 
-    Error_t res = solve_sparse_linear_system (&tdata->SM_A, &tdata->SLUMatrix_B) ;
+    if (analysis->IntegrationMethod == TDICE_INTEGRATION_TRAPEZOIDAL)
+    {
+        memcpy (tdata->StepTemperatures, tdata->Temperatures,
+                sizeof(Temperature_t) * tdata->Size) ;
+
+        start = tdata->StepTemperatures ;
+    }
+
+    Error_t res = solve_time_step
+
+        (tdata, dimensions, analysis, &tdata->SM_A, start, 1u) ;
 
     if (res != TDICE_SUCCESS)
 
@@ -464,6 +880,103 @@ SimResult_t emulate_slot
 
 /******************************************************************************/
 
+/* Steady state with a pluggable heat sink. The temperatures of the stack and
+ * those computed by the plugin are iterated to a fixed point, under-relaxing
+ * the sink temperatures that set the sources of the spreader cells.
+ *
+ * A plugin that integrates its own transient moves the sink temperatures
+ * only a little at every call, so a small change does not mean that the
+ * fixed point is near. The change of the sink temperatures (the residual
+ * of the fixed point) decreases by a factor rho at every iteration, and
+ * the distance from the fixed point is estimated by the sum of the changes
+ * still to come, RELAXATION x change / (1 - rho) */
+
+static SimResult_t emulate_steady_pluggable
+(
+    ThermalData_t  *tdata,
+    Dimensions_t   *dimensions,
+    Analysis_t     *analysis
+)
+{
+    HeatSink_t *sink    = tdata->ThermalGrid.TopHeatSink ;
+    Source_t   *sources = tdata->PowerGrid.Sources
+
+                          + get_spreader_cell_offset (dimensions, sink, 0, 0) ;
+
+    CellIndex_t size = sink->NRows * sink->NColumns ;
+    CellIndex_t cell ;
+    Quantity_t  iteration ;
+
+    Temperature_t previous_change = 0.0 ;
+
+    for (iteration = 0u ; iteration != TDICE_STEADY_SINK_MAX_ITERATIONS ; iteration++)
+    {
+        if (simulate_pluggable_heatsink (tdata, dimensions, analysis) == TDICE_FAILURE)
+
+            return TDICE_SOLVER_ERROR ;
+
+        // PreviousSinkTemperatures stores the relaxed temperatures, the
+        // ones set by the plugin are not modified
+
+        Temperature_t change = 0.0 ;
+
+        for (cell = 0u ; cell != size ; cell++)
+        {
+            Temperature_t difference =
+
+                sink->CurrentSinkTemperatures [cell] - sink->PreviousSinkTemperatures [cell] ;
+
+            change = MAX (change, fabs (difference)) ;
+
+            sink->PreviousSinkTemperatures [cell] += TDICE_STEADY_SINK_RELAXATION * difference ;
+
+            sources [cell] =
+
+                sink->SpreaderSinkConductances [cell] * sink->PreviousSinkTemperatures [cell] ;
+        }
+
+        // The first call starts from the initial temperature of the spreader
+
+        if (iteration != 0u)
+        {
+            if (change == 0.0)
+
+                return TDICE_END_OF_SIMULATION ;
+
+            // Estimate of the distance from the fixed point, only when the
+            // changes decrease
+
+            if (iteration > 1u && change < previous_change)
+            {
+                double rho = change / previous_change ;
+
+                if (  TDICE_STEADY_SINK_RELAXATION * change / (1.0 - rho)
+                    <= TDICE_STEADY_SINK_TOLERANCE)
+
+                    return TDICE_END_OF_SIMULATION ;
+            }
+        }
+
+        previous_change = change ;
+
+        fill_system_vector_steady
+
+            (dimensions, sink, tdata->Temperatures, tdata->PowerGrid.Sources) ;
+
+        if (solve_sparse_linear_system (&tdata->SM_A, &tdata->SLUMatrix_B) != TDICE_SUCCESS)
+
+            return TDICE_SOLVER_ERROR ;
+    }
+
+    fprintf (stderr, "Error: the steady state of the pluggable heatsink "
+                     "did not converge in %d iterations (last change %g K)\n",
+                     TDICE_STEADY_SINK_MAX_ITERATIONS, previous_change) ;
+
+    return TDICE_SOLVER_ERROR ;
+}
+
+/******************************************************************************/
+
 SimResult_t emulate_steady
 (
     ThermalData_t  *tdata,
@@ -475,15 +988,14 @@ SimResult_t emulate_steady
 
         return TDICE_WRONG_CONFIG ;
 
-    if(tdata->ThermalGrid.TopHeatSink &&
-       tdata->ThermalGrid.TopHeatSink->SinkModel == TDICE_HEATSINK_TOP_PLUGGABLE)
-
-        return TDICE_SOLVER_ERROR ; //TODO: support steady state pluggable sink
-
     Error_t result = update_source_vector (&tdata->PowerGrid, dimensions) ;
 
     if (result == TDICE_FAILURE)
     {
+        if (power_values_failed (&tdata->PowerGrid) == true)
+
+            return TDICE_POWER_ERROR ;
+
         fprintf (stderr,
 
             "Warning: no power trace given for steady state simulation\n") ;
@@ -491,7 +1003,15 @@ SimResult_t emulate_steady
         return TDICE_END_OF_SIMULATION ;
     }
 
-    fill_system_vector_steady (dimensions, tdata->Temperatures, tdata->PowerGrid.Sources) ;
+    if(tdata->ThermalGrid.TopHeatSink &&
+       tdata->ThermalGrid.TopHeatSink->SinkModel == TDICE_HEATSINK_TOP_PLUGGABLE)
+
+        return emulate_steady_pluggable (tdata, dimensions, analysis) ;
+
+    fill_system_vector_steady
+
+        (dimensions, tdata->ThermalGrid.TopHeatSink,
+         tdata->Temperatures, tdata->PowerGrid.Sources) ;
 
     Error_t res = solve_sparse_linear_system (&tdata->SM_A, &tdata->SLUMatrix_B) ;
 
@@ -516,14 +1036,16 @@ Error_t update_coolant_flow_rate
 
         FLOW_RATE_FROM_MLMIN_TO_UM3SEC(new_flow_rate) ;
 
-    // TODO replace with "update"
-
-    fill_system_matrix (&tdata->SM_A, &tdata->ThermalGrid, analysis, dimensions) ;
+    update_system_matrix_channel (&tdata->SM_A, &tdata->ThermalGrid, analysis, dimensions) ;
 
     if (do_factorization (&tdata->SM_A) == TDICE_FAILURE)
 
         return TDICE_FAILURE ;
 
+    // The matrices of the adaptive steps are built again when needed
+
+    clear_step_matrices (tdata) ;
+
     update_channel_sources (&tdata->PowerGrid, dimensions) ;
 
     return TDICE_SUCCESS ;
@@ -53,6 +53,14 @@ void thermal_grid_init (ThermalGrid_t *tgrid)
     tgrid->Channel           = NULL ;
     tgrid->TopHeatSink       = NULL ;
     tgrid->BottomHeatSink    = NULL ;
+
+    tgrid->Capacities         = NULL ;
+    tgrid->ConductancesTop    = NULL ;
+    tgrid->ConductancesBottom = NULL ;
+    tgrid->ConductancesNorth  = NULL ;
+    tgrid->ConductancesSouth  = NULL ;
+    tgrid->ConductancesEast   = NULL ;
+    tgrid->ConductancesWest   = NULL ;
 }
 
 /******************************************************************************/
@@ -110,12 +118,86 @@ void thermal_grid_destroy (ThermalGrid_t *tgrid)
         free (tgrid->LayersProfile) ;
     }
 
+    free (tgrid->Capacities) ;
+    free (tgrid->ConductancesTop) ;
+    free (tgrid->ConductancesBottom) ;
+    free (tgrid->ConductancesNorth) ;
+    free (tgrid->ConductancesSouth) ;
+    free (tgrid->ConductancesEast) ;
+    free (tgrid->ConductancesWest) ;
+
     thermal_grid_init (tgrid) ;
 }
 
 /******************************************************************************/
 
-Error_t thermal_grid_fill (ThermalGrid_t *tgrid, StackElementList_t *list)
+/* Computes once the capacity and the six conductances of every cell of the
+ * layers. The get_* functions fall back to compute_* while the cache is
+ * not set, so they are used here to fill it. */
+
+static Error_t fill_cache (ThermalGrid_t *tgrid, Dimensions_t *dimensions)
+{
+    CellIndex_t ncells = tgrid->NLayers * get_layer_area (dimensions) ;
+
+    Capacity_t    *capacities = (Capacity_t *)    malloc (sizeof (Capacity_t)    * ncells) ;
+    Conductance_t *top        = (Conductance_t *) malloc (sizeof (Conductance_t) * ncells) ;
+    Conductance_t *bottom     = (Conductance_t *) malloc (sizeof (Conductance_t) * ncells) ;
+    Conductance_t *north      = (Conductance_t *) malloc (sizeof (Conductance_t) * ncells) ;
+    Conductance_t *south      = (Conductance_t *) malloc (sizeof (Conductance_t) * ncells) ;
+    Conductance_t *east       = (Conductance_t *) malloc (sizeof (Conductance_t) * ncells) ;
+    Conductance_t *west       = (Conductance_t *) malloc (sizeof (Conductance_t) * ncells) ;
+
+    if (   capacities == NULL || top   == NULL || bottom == NULL
+        || north      == NULL || south == NULL || east   == NULL || west == NULL)
+    {
+        fprintf (stderr, "Cannot malloc thermal grid conductances\n") ;
+
+        free (capacities) ;
+        free (top) ;
+        free (bottom) ;
+        free (north) ;
+        free (south) ;
+        free (east) ;
+        free (west) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    CellIndex_t layer, row, column, cell = 0u ;
+
+    for (layer = first_layer (dimensions) ; layer <= last_layer (dimensions) ; layer++)
+
+        for (row = first_row (dimensions) ; row <= last_row (dimensions) ; row++)
+
+            for (column = first_column (dimensions) ; column <= last_column (dimensions) ; column++)
+            {
+                capacities [cell] = get_capacity           (tgrid, dimensions, layer, row, column) ;
+                top        [cell] = get_conductance_top    (tgrid, dimensions, layer, row, column) ;
+                bottom     [cell] = get_conductance_bottom (tgrid, dimensions, layer, row, column) ;
+                north      [cell] = get_conductance_north  (tgrid, dimensions, layer, row, column) ;
+                south      [cell] = get_conductance_south  (tgrid, dimensions, layer, row, column) ;
+                east       [cell] = get_conductance_east   (tgrid, dimensions, layer, row, column) ;
+                west       [cell] = get_conductance_west   (tgrid, dimensions, layer, row, column) ;
+
+                cell++ ;
+            }
+
+    tgrid->Capacities         = capacities ;
+    tgrid->ConductancesTop    = top ;
+    tgrid->ConductancesBottom = bottom ;
+    tgrid->ConductancesNorth  = north ;
+    tgrid->ConductancesSouth  = south ;
+    tgrid->ConductancesEast   = east ;
+    tgrid->ConductancesWest   = west ;
+
+    return TDICE_SUCCESS ;
+}
+
+/******************************************************************************/
+
+Error_t thermal_grid_fill
+
+    (ThermalGrid_t *tgrid, StackElementList_t *list, Dimensions_t *dimensions)
 {
     StackElementListNode_t *stkeln ;
     bool has_4RM_layers = false;
@@ -315,13 +397,24 @@ Error_t thermal_grid_fill (ThermalGrid_t *tgrid, StackElementList_t *list)
         }
    }
    
-    return TDICE_SUCCESS;
+    // The layouts are rasterized once, before the cells are visited
+
+    CellIndex_t lindex ;
+
+    for (lindex = 0u ; lindex != tgrid->NLayers ; lindex++)
+
+        if (layer_build_material_map (tgrid->LayersProfile + lindex, dimensions) == TDICE_FAILURE)
+
+            return TDICE_FAILURE ;
+
+    return fill_cache (tgrid, dimensions) ;
 }
 
 /******************************************************************************/
 
+/* Computes the capacity of a cell from the materials of its layer */
 
-Capacity_t get_capacity
+static Capacity_t compute_capacity
 (
     ThermalGrid_t *tgrid,
     Dimensions_t  *dimensions,
@@ -422,7 +515,7 @@ Capacity_t get_capacity
 
 /******************************************************************************/
 
-Conductance_t get_conductance_top
+static Conductance_t compute_conductance_top
 (
     ThermalGrid_t *tgrid,
     Dimensions_t  *dimensions,
@@ -588,7 +681,7 @@ Conductance_t get_conductance_top
 
 /******************************************************************************/
 
-Conductance_t get_conductance_bottom
+static Conductance_t compute_conductance_bottom
 (
     ThermalGrid_t *tgrid,
     Dimensions_t  *dimensions,
@@ -740,7 +833,7 @@ Conductance_t get_conductance_bottom
 
 /******************************************************************************/
 
-Conductance_t get_conductance_north
+static Conductance_t compute_conductance_north
 (
     ThermalGrid_t *tgrid,
     Dimensions_t  *dimensions,
@@ -836,7 +929,7 @@ Conductance_t get_conductance_north
 
 /******************************************************************************/
 
-Conductance_t get_conductance_south
+static Conductance_t compute_conductance_south
 (
     ThermalGrid_t *tgrid,
     Dimensions_t  *dimensions,
@@ -932,7 +1025,7 @@ Conductance_t get_conductance_south
 
 /******************************************************************************/
 
-Conductance_t get_conductance_east
+static Conductance_t compute_conductance_east
 (
     ThermalGrid_t *tgrid,
     Dimensions_t  *dimensions,
@@ -1013,7 +1106,7 @@ Conductance_t get_conductance_east
 
 /******************************************************************************/
 
-Conductance_t get_conductance_west
+static Conductance_t compute_conductance_west
 (
     ThermalGrid_t *tgrid,
     Dimensions_t  *dimensions,
@@ -1093,3 +1186,143 @@ Conductance_t get_conductance_west
 }
 
 /******************************************************************************/
+
+Capacity_t get_capacity
+(
+    ThermalGrid_t *tgrid,
+    Dimensions_t  *dimensions,
+    CellIndex_t    layer_index,
+    CellIndex_t    row_index,
+    CellIndex_t    column_index
+)
+{
+    if (tgrid->Capacities != NULL && layer_index < tgrid->NLayers)
+
+        return tgrid->Capacities
+
+            [get_cell_offset_in_stack (dimensions, layer_index, row_index, column_index)] ;
+
+    return compute_capacity (tgrid, dimensions, layer_index, row_index, column_index) ;
+}
+
+/******************************************************************************/
+
+Conductance_t get_conductance_top
+(
+    ThermalGrid_t *tgrid,
+    Dimensions_t  *dimensions,
+    CellIndex_t    layer_index,
+    CellIndex_t    row_index,
+    CellIndex_t    column_index
+)
+{
+    if (tgrid->ConductancesTop != NULL && layer_index < tgrid->NLayers)
+
+        return tgrid->ConductancesTop
+
+            [get_cell_offset_in_stack (dimensions, layer_index, row_index, column_index)] ;
+
+    return compute_conductance_top (tgrid, dimensions, layer_index, row_index, column_index) ;
+}
+
+/******************************************************************************/
+
+Conductance_t get_conductance_bottom
+(
+    ThermalGrid_t *tgrid,
+    Dimensions_t  *dimensions,
+    CellIndex_t    layer_index,
+    CellIndex_t    row_index,
+    CellIndex_t    column_index
+)
+{
+    if (tgrid->ConductancesBottom != NULL && layer_index < tgrid->NLayers)
+
+        return tgrid->ConductancesBottom
+
+            [get_cell_offset_in_stack (dimensions, layer_index, row_index, column_index)] ;
+
+    return compute_conductance_bottom (tgrid, dimensions, layer_index, row_index, column_index) ;
+}
+
+/******************************************************************************/
+
+Conductance_t get_conductance_north
+(
+    ThermalGrid_t *tgrid,
+    Dimensions_t  *dimensions,
+    CellIndex_t    layer_index,
+    CellIndex_t    row_index,
+    CellIndex_t    column_index
+)
+{
+    if (tgrid->ConductancesNorth != NULL && layer_index < tgrid->NLayers)
+
+        return tgrid->ConductancesNorth
+
+            [get_cell_offset_in_stack (dimensions, layer_index, row_index, column_index)] ;
+
+    return compute_conductance_north (tgrid, dimensions, layer_index, row_index, column_index) ;
+}
+
+/******************************************************************************/
+
+Conductance_t get_conductance_south
+(
+    ThermalGrid_t *tgrid,
+    Dimensions_t  *dimensions,
+    CellIndex_t    layer_index,
+    CellIndex_t    row_index,
+    CellIndex_t    column_index
+)
+{
+    if (tgrid->ConductancesSouth != NULL && layer_index < tgrid->NLayers)
+
+        return tgrid->ConductancesSouth
+
+            [get_cell_offset_in_stack (dimensions, layer_index, row_index, column_index)] ;
+
+    return compute_conductance_south (tgrid, dimensions, layer_index, row_index, column_index) ;
+}
+
+/******************************************************************************/
+
+Conductance_t get_conductance_east
+(
+    ThermalGrid_t *tgrid,
+    Dimensions_t  *dimensions,
+    CellIndex_t    layer_index,
+    CellIndex_t    row_index,
+    CellIndex_t    column_index
+)
+{
+    if (tgrid->ConductancesEast != NULL && layer_index < tgrid->NLayers)
+
+        return tgrid->ConductancesEast
+
+            [get_cell_offset_in_stack (dimensions, layer_index, row_index, column_index)] ;
+
+    return compute_conductance_east (tgrid, dimensions, layer_index, row_index, column_index) ;
+}
+
+/******************************************************************************/
+
+Conductance_t get_conductance_west
+(
+    ThermalGrid_t *tgrid,
+    Dimensions_t  *dimensions,
+    CellIndex_t    layer_index,
+    CellIndex_t    row_index,
+    CellIndex_t    column_index
+)
+{
+    if (tgrid->ConductancesWest != NULL && layer_index < tgrid->NLayers)
+
+        return tgrid->ConductancesWest
+
+            [get_cell_offset_in_stack (dimensions, layer_index, row_index, column_index)] ;
+
+    return compute_conductance_west (tgrid, dimensions, layer_index, row_index, column_index) ;
+}
+
+/******************************************************************************/
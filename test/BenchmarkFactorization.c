@@ -0,0 +1,292 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <time.h>
+#include <math.h>
+
+#include "stack_file_parser.h"
+
+#include "stack_description.h"
+#include "thermal_data.h"
+#include "analysis.h"
+#include "output.h"
+#include "macros.h"
+
+/* Compares, on the system matrix of a stack file and for both the minimum
+ * degree and the nested dissection orderings, the (sequential) SuperLU
+ * factorization with the multifrontal factorization run with one thread
+ * and with the number of threads given in the command line (or declared
+ * in the stack file). The factorizations are repeated to report the time
+ * of the numerical phase, which is what changes the flow rate, the
+ * pluggable heat sink and the adaptive time step. */
+
+#define NREPEAT 5
+
+#define NRUNS 6
+
+static double elapsed (struct timespec *from)
+{
+    struct timespec now ;
+
+    clock_gettime (CLOCK_MONOTONIC, &now) ;
+
+    return   (double) (now.tv_sec  - from->tv_sec)
+           + (double) (now.tv_nsec - from->tv_nsec) * 1e-9 ;
+}
+
+/* Factorizes the matrix NREPEAT times and solves a linear system whose
+ * solution is stored in x. Returns the time of the first factorization
+ * in first_time, the average time of the others in time and the size and
+ * the floating point operations of the factors in fill and flops */
+
+static Error_t run_factorization
+(
+    SystemMatrix_t *sysmatrix,
+    double         *x,
+    double         *first_time,
+    double         *time,
+    double         *fill,
+    double         *flops
+)
+{
+    struct timespec start ;
+    SuperMatrix     b ;
+    CellIndex_t     cell ;
+    int             repeat ;
+
+    *time = 0.0 ;
+
+    for (repeat = 0 ; repeat != NREPEAT ; repeat++)
+    {
+        // SuperLU accumulates the operations of all the factorizations
+
+        memset (sysmatrix->SLU_Stat.ops, 0, sizeof (flops_t) * NPHASES) ;
+
+        clock_gettime (CLOCK_MONOTONIC, &start) ;
+
+        if (do_factorization (sysmatrix) != TDICE_SUCCESS)
+
+            return TDICE_FAILURE ;
+
+        if (repeat == 0)
+
+            *first_time = elapsed (&start) ;
+
+        else
+
+            *time += elapsed (&start) / (NREPEAT - 1) ;
+    }
+
+    if (sysmatrix->SolverType == TDICE_SOLVER_MULTIFRONTAL)
+    {
+        *fill  = (double) sysmatrix->Multifrontal.FactorSize ;
+        *flops = sysmatrix->Multifrontal.Flops ;
+    }
+    else
+    {
+        SCformat *lstore = (SCformat *) sysmatrix->SLUMatrix_L.Store ;
+        NCformat *ustore = (NCformat *) sysmatrix->SLUMatrix_U.Store ;
+
+        *fill  = (double) lstore->nnz + (double) ustore->nnz ;
+        *flops = (double) sysmatrix->SLU_Stat.ops [FACT] ;
+    }
+
+    for (cell = 0u ; cell != sysmatrix->Size ; cell++)
+
+        x [cell] = 1.0 ;
+
+    dCreate_Dense_Matrix
+
+        (&b, sysmatrix->Size, 1, x, sysmatrix->Size, SLU_DN, SLU_D, SLU_GE) ;
+
+    Error_t result = solve_sparse_linear_system (sysmatrix, &b) ;
+
+    Destroy_SuperMatrix_Store (&b) ;
+
+    return result ;
+}
+
+int main(int argc, char** argv)
+{
+    StackDescription_t stkd ;
+    Analysis_t         analysis ;
+    Output_t           output ;
+    ThermalGrid_t      thermal_grid ;
+    SystemMatrix_t     sysmatrix ;
+    double            *x [NRUNS] ;
+    int                run, result = EXIT_FAILURE ;
+
+    // Checks if there are the all the arguments
+    ////////////////////////////////////////////////////////////////////////////
+
+    if (argc != 2 && argc != 3)
+    {
+        fprintf(stderr, "Usage: \"%s file.stk [threads]\"\n", argv[0]) ;
+        return EXIT_FAILURE ;
+    }
+
+    // Init StackDescription and parse the input file
+    ////////////////////////////////////////////////////////////////////////////
+
+    stack_description_init (&stkd) ;
+    analysis_init          (&analysis) ;
+    output_init            (&output) ;
+    thermal_grid_init      (&thermal_grid) ;
+    system_matrix_init     (&sysmatrix) ;
+
+    for (run = 0 ; run != NRUNS ; run++)
+
+        x [run] = NULL ;
+
+    if (parse_stack_description_file (argv[1], &stkd, &analysis, &output) != 0)
+
+        goto failure ;
+
+    Quantity_t nthreads = argc == 3 ? (Quantity_t) atoi (argv[2]) : analysis.NThreads ;
+
+    if (nthreads < 1u)
+
+        nthreads = 1u ;
+
+    // Fill the thermal grid using the StackDescription
+    ////////////////////////////////////////////////////////////////////////////
+
+    CellIndex_t size = get_number_of_cells (stkd.Dimensions) ;
+
+    if (   thermal_grid_build (&thermal_grid, stkd.Dimensions) != TDICE_SUCCESS
+        || thermal_grid_fill  (&thermal_grid, &stkd.StackElements, stkd.Dimensions) != TDICE_SUCCESS)
+
+        goto failure ;
+
+    fprintf (stdout, "%d cells, %d nonzeros\n\n", size, get_number_of_connections (stkd.Dimensions)) ;
+
+    fprintf (stdout, "ordering           solver        threads      factors        flops"
+                     "   first (ms)   again (ms)   difference\n") ;
+
+    // Every run factorizes a new system matrix, with SuperLU and with the
+    // multifrontal solver (one thread and nthreads), first with the minimum
+    // degree ordering and then with nested dissection
+    ////////////////////////////////////////////////////////////////////////////
+
+    for (run = 0 ; run != NRUNS ; run++)
+    {
+        OrderingType_t ordering = run < NRUNS / 2 ?
+
+            TDICE_ORDERING_MINIMUM_DEGREE : TDICE_ORDERING_NESTED_DISSECTION ;
+
+        double first_time, time, fill, flops ;
+
+        x [run] = (double *) malloc (sizeof (double) * size) ;
+
+        if (   x [run] == NULL
+            || system_matrix_build
+
+                   (&sysmatrix, size, get_number_of_connections (stkd.Dimensions))
+               != TDICE_SUCCESS)
+
+            goto failure ;
+
+        fill_system_matrix (&sysmatrix, &thermal_grid, &analysis, stkd.Dimensions) ;
+
+        set_column_ordering (&sysmatrix, ordering, stkd.Dimensions, &thermal_grid) ;
+
+        // SuperLU computes the reference LU decomposition also when the
+        // matrix is symmetric, the multifrontal solver its Cholesky one
+
+        if (run % 3 == 0)
+
+            sysmatrix.SymmetricPositiveDefinite = false ;
+
+        else
+        {
+            sysmatrix.SolverType            = TDICE_SOLVER_MULTIFRONTAL ;
+            sysmatrix.Multifrontal.NThreads = run % 3 == 1 ? 1u : nthreads ;
+        }
+
+        if (run_factorization
+
+                (&sysmatrix, x [run], &first_time, &time, &fill, &flops)
+            != TDICE_SUCCESS)
+        {
+            fprintf (stderr, "Factorization %d failed\n", run) ;
+
+            goto failure ;
+        }
+
+        // Difference from the solution of SuperLU with minimum degree
+
+        double difference = 0.0, norm = 0.0 ;
+        CellIndex_t cell ;
+
+        for (cell = 0u ; cell != size ; cell++)
+        {
+            difference = MAX (difference, fabs (x [run][cell] - x [0][cell])) ;
+            norm       = MAX (norm,       fabs (x [0][cell])) ;
+        }
+
+        fprintf (stdout, "%-18s %-13s %7d %12.0f %12.3e %12.3f %12.3f %12.2e\n",
+                 ordering == TDICE_ORDERING_MINIMUM_DEGREE ?
+                     "minimum degree" : "nested dissection",
+                 run % 3 == 0 ? "SuperLU" :
+                     sysmatrix.SymmetricPositiveDefinite ? "cholesky" : "multifrontal",
+                 run % 3 == 0 ? 1u : sysmatrix.Multifrontal.NThreads,
+                 fill, flops, 1e3 * first_time, 1e3 * time,
+                 difference / norm) ;
+
+        system_matrix_destroy (&sysmatrix) ;
+    }
+
+    result = EXIT_SUCCESS ;
+
+    // free all data
+    ////////////////////////////////////////////////////////////////////////////
+
+failure :
+
+    for (run = 0 ; run != NRUNS ; run++)
+
+        free (x [run]) ;
+
+    system_matrix_destroy     (&sysmatrix) ;
+    thermal_grid_destroy      (&thermal_grid) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
+
+    return result ;
+}
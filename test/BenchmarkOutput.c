@@ -0,0 +1,192 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <time.h>
+
+#include "stack_file_parser.h"
+
+#include "stack_description.h"
+#include "thermal_data.h"
+#include "analysis.h"
+#include "output.h"
+
+/* Reports, for a transient simulation, the time spent per step to solve
+ * the thermal model and the time spent to generate the step (and slot)
+ * outputs of the inspection points declared in the stack file. */
+
+static double elapsed (struct timespec *from)
+{
+    struct timespec now ;
+
+    clock_gettime (CLOCK_MONOTONIC, &now) ;
+
+    return   (double) (now.tv_sec  - from->tv_sec)
+           + (double) (now.tv_nsec - from->tv_nsec) * 1e-9 ;
+}
+
+int main(int argc, char** argv)
+{
+    StackDescription_t stkd ;
+    Analysis_t         analysis ;
+    Output_t           output ;
+    ThermalData_t      tdata ;
+
+    // Checks if there are the all the arguments
+    ////////////////////////////////////////////////////////////////////////////
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: \"%s file.stk\"\n", argv[0]) ;
+        return EXIT_FAILURE ;
+    }
+
+    // Init StackDescription and parse the input file
+    ////////////////////////////////////////////////////////////////////////////
+
+    stack_description_init (&stkd) ;
+    analysis_init          (&analysis) ;
+    output_init            (&output) ;
+
+    if (parse_stack_description_file (argv[1], &stkd, &analysis, &output) != 0)
+
+        return EXIT_FAILURE ;
+
+    if (analysis.AnalysisType != TDICE_ANALYSIS_TYPE_TRANSIENT)
+    {
+        fprintf (stderr, "%s is not a transient simulation\n", argv[1]) ;
+
+        goto failure ;
+    }
+
+    if (generate_output_headers (&output, stkd.Dimensions, (String_t)"% ") != TDICE_SUCCESS)
+
+        goto failure ;
+
+    // Init thermal data and fill it using the StackDescription
+    ////////////////////////////////////////////////////////////////////////////
+
+    thermal_data_init (&tdata) ;
+
+    if (thermal_data_build (&tdata, &stkd.StackElements, stkd.Dimensions, &analysis) != TDICE_SUCCESS)
+
+        goto failure ;
+
+    // Run the simulation timing separately the solver and the outputs
+    ////////////////////////////////////////////////////////////////////////////
+
+    struct timespec start ;
+
+    double solver_time = 0.0, output_time = 0.0 ;
+
+    Quantity_t nsteps = 0u ;
+
+    SimResult_t sim_result ;
+
+    do
+    {
+        clock_gettime (CLOCK_MONOTONIC, &start) ;
+
+        sim_result = emulate_step (&tdata, stkd.Dimensions, &analysis) ;
+
+        solver_time += elapsed (&start) ;
+
+        if (sim_result != TDICE_STEP_DONE && sim_result != TDICE_SLOT_DONE)
+
+            break ;
+
+        nsteps++ ;
+
+        clock_gettime (CLOCK_MONOTONIC, &start) ;
+
+        generate_output (&output, stkd.Dimensions,
+                         tdata.Temperatures, tdata.PowerGrid.Sources,
+                         get_simulated_time (&analysis),
+                         TDICE_OUTPUT_INSTANT_STEP) ;
+
+        if (sim_result == TDICE_SLOT_DONE)
+
+            generate_output (&output, stkd.Dimensions,
+                             tdata.Temperatures, tdata.PowerGrid.Sources,
+                             get_simulated_time (&analysis),
+                             TDICE_OUTPUT_INSTANT_SLOT) ;
+
+        output_time += elapsed (&start) ;
+
+    } while (1) ;
+
+    // Closing the files writes what is still buffered
+
+    clock_gettime (CLOCK_MONOTONIC, &start) ;
+
+    generate_output (&output, stkd.Dimensions,
+                     tdata.Temperatures, tdata.PowerGrid.Sources,
+                     get_simulated_time (&analysis),
+                     TDICE_OUTPUT_INSTANT_FINAL) ;
+
+    output_destroy (&output) ;
+
+    output_time += elapsed (&start) ;
+
+    fprintf (stdout, "steps           : %d\n", nsteps) ;
+
+    if (nsteps == 0u)
+
+        nsteps = 1u ;
+
+    fprintf (stdout, "solver per step : %.3f ms\n", 1e3 * solver_time / nsteps) ;
+    fprintf (stdout, "output per step : %.3f ms\n", 1e3 * output_time / nsteps) ;
+    fprintf (stdout, "output overhead : %.1f %%\n",
+             100.0 * output_time / (solver_time + output_time)) ;
+
+    // free all data
+    ////////////////////////////////////////////////////////////////////////////
+
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    analysis_destroy          (&analysis) ;
+
+    return EXIT_SUCCESS ;
+
+failure :
+
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
+
+    return EXIT_FAILURE ;
+}
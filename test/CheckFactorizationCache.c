@@ -0,0 +1,331 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "stack_file_parser.h"
+
+#include "stack_description.h"
+#include "thermal_data.h"
+#include "analysis.h"
+#include "output.h"
+#include "macros.h"
+
+/* Checks the factorization cache of the SuperLU solver on a stack with a
+ * liquid channel (whose system matrix is not symmetric, so that its LU
+ * factors are cached). It is run twice on an empty cache directory: with
+ * "store" the factors must be computed and written, with "load" (a new
+ * run) they must be read from the files written by the first one.
+ *
+ * For both the minimum degree and the nested dissection (MY_PERMC)
+ * orderings, the solutions given by the factors of the cache are compared
+ * with those of a fresh dgstrf. Then the flow rate changes and the matrix
+ * is factorized again: factors read from the cache are refactorized with
+ * SamePattern, keeping the cached column permutation and elimination tree. */
+
+#define TOLERANCE 1e-10 /* Relative */
+
+#define NEW_FLOW_RATE 24.0 /* ml/min */
+
+/* Parses the stack file and builds (and factorizes) its system matrix,
+ * with the factorization cache in directory if it is not NULL */
+
+static Error_t build
+(
+    char               *filename,
+    char               *directory,
+    OrderingType_t      ordering,
+    StackDescription_t *stkd,
+    Analysis_t         *analysis,
+    Output_t           *output,
+    ThermalData_t      *tdata
+)
+{
+    if (parse_stack_description_file (filename, stkd, analysis, output) != 0)
+
+        return TDICE_FAILURE ;
+
+    if (stkd->Channel == NULL)
+    {
+        fprintf (stderr, "%s has no channel\n", filename) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    analysis->SolverType = TDICE_SOLVER_SUPERLU ;
+    analysis->Ordering   = ordering ;
+
+    string_destroy (&analysis->FactorizationCache) ;
+
+    if (directory != NULL)
+
+        string_copy (&analysis->FactorizationCache, &directory) ;
+
+    return thermal_data_build (tdata, &stkd->StackElements, stkd->Dimensions, analysis) ;
+}
+
+/* Solves A x = b with the factors of sysmatrix */
+
+static Error_t solve (SystemMatrix_t *sysmatrix, double *b, double *x)
+{
+    SuperMatrix B ;
+
+    memcpy (x, b, sizeof (double) * sysmatrix->Size) ;
+
+    dCreate_Dense_Matrix
+
+        (&B, sysmatrix->Size, 1, x, sysmatrix->Size, SLU_DN, SLU_D, SLU_GE) ;
+
+    Error_t result = solve_sparse_linear_system (sysmatrix, &B) ;
+
+    Destroy_SuperMatrix_Store (&B) ;
+
+    return result ;
+}
+
+/* Returns max |b - A x| / max |b| */
+
+static double residual (SystemMatrix_t *sysmatrix, double *b, double *x)
+{
+    CellIndex_t size = sysmatrix->Size, column, index ;
+
+    double *r = (double *) malloc (sizeof (double) * size) ;
+
+    if (r == NULL)
+
+        return INFINITY ;
+
+    memcpy (r, b, sizeof (double) * size) ;
+
+    for (column = 0u ; column != size ; column++)
+
+        for (index  = sysmatrix->ColumnPointers [column] ;
+             index != sysmatrix->ColumnPointers [column + 1] ; index++)
+
+            r [sysmatrix->RowIndices [index]] -= sysmatrix->Values [index] * x [column] ;
+
+    double rnorm = 0.0, bnorm = 0.0 ;
+
+    for (index = 0u ; index != size ; index++)
+    {
+        rnorm = MAX (rnorm, fabs (r [index])) ;
+        bnorm = MAX (bnorm, fabs (b [index])) ;
+    }
+
+    free (r) ;
+
+    return rnorm / bnorm ;
+}
+
+/* Solves the same system with the fresh and with the cached factors and
+ * returns the number of errors */
+
+static Quantity_t compare_solutions
+(
+    SystemMatrix_t *fresh,
+    SystemMatrix_t *cached,
+    const char     *label
+)
+{
+    CellIndex_t size = fresh->Size, cell ;
+
+    double *b         = (double *) malloc (sizeof (double) * size) ;
+    double *x_fresh   = (double *) malloc (sizeof (double) * size) ;
+    double *x_cached  = (double *) malloc (sizeof (double) * size) ;
+    Quantity_t errors = 0u ;
+
+    if (b == NULL || x_fresh == NULL || x_cached == NULL || cached->Size != size)
+    {
+        fprintf (stderr, "%s: cannot compare the solutions\n", label) ;
+
+        errors++ ;
+
+        goto failure ;
+    }
+
+    for (cell = 0u ; cell != size ; cell++)
+
+        b [cell] = 1.0 + (double) (cell % 7u) ;
+
+    if (   solve (fresh,  b, x_fresh)  != TDICE_SUCCESS
+        || solve (cached, b, x_cached) != TDICE_SUCCESS)
+    {
+        fprintf (stderr, "%s: solve failed\n", label) ;
+
+        errors++ ;
+
+        goto failure ;
+    }
+
+    double diff = 0.0, norm = 0.0 ;
+
+    for (cell = 0u ; cell != size ; cell++)
+    {
+        diff = MAX (diff, fabs (x_cached [cell] - x_fresh [cell])) ;
+        norm = MAX (norm, fabs (x_fresh [cell])) ;
+    }
+
+    double res = residual (cached, b, x_cached) ;
+
+    if (diff > TOLERANCE * norm || res > TOLERANCE)
+    {
+        fprintf (stderr, "%s: difference %g, residual %g\n", label, diff / norm, res) ;
+
+        errors++ ;
+    }
+
+failure :
+
+    free (b) ;
+    free (x_fresh) ;
+    free (x_cached) ;
+
+    return errors ;
+}
+
+/* Runs the check for one ordering and returns the number of errors */
+
+static Quantity_t check_ordering
+(
+    char           *filename,
+    char           *directory,
+    bool            load,
+    OrderingType_t  ordering,
+    const char     *label
+)
+{
+    StackDescription_t fstkd,     cstkd ;
+    Analysis_t         fanalysis, canalysis ;
+    Output_t           foutput,   coutput ;
+    ThermalData_t      fresh,     cached ;
+    Quantity_t         errors = 0u ;
+
+    stack_description_init (&fstkd) ;
+    analysis_init          (&fanalysis) ;
+    output_init            (&foutput) ;
+    thermal_data_init      (&fresh) ;
+
+    stack_description_init (&cstkd) ;
+    analysis_init          (&canalysis) ;
+    output_init            (&coutput) ;
+    thermal_data_init      (&cached) ;
+
+    if (   build (filename, NULL,      ordering, &fstkd, &fanalysis, &foutput, &fresh)  != TDICE_SUCCESS
+        || build (filename, directory, ordering, &cstkd, &canalysis, &coutput, &cached) != TDICE_SUCCESS)
+    {
+        fprintf (stderr, "%s: build failed\n", label) ;
+
+        errors++ ;
+
+        goto failure ;
+    }
+
+    if (cached.SM_A.FactorsFromCache != load)
+    {
+        fprintf (stderr, load == true ? "%s: factors not read from the cache\n"
+                                      : "%s: factors read from a cache that must be empty\n",
+                 label) ;
+
+        errors++ ;
+
+        goto failure ;
+    }
+
+    errors += compare_solutions (&fresh.SM_A, &cached.SM_A, label) ;
+
+    // A new flow rate changes the values but not the pattern of the matrix
+
+    if (   update_coolant_flow_rate (&fresh,  fstkd.Dimensions, &fanalysis, NEW_FLOW_RATE) != TDICE_SUCCESS
+        || update_coolant_flow_rate (&cached, cstkd.Dimensions, &canalysis, NEW_FLOW_RATE) != TDICE_SUCCESS)
+    {
+        fprintf (stderr, "%s: refactorization failed\n", label) ;
+
+        errors++ ;
+
+        goto failure ;
+    }
+
+    if (cached.SM_A.FactorsFromCache == true)
+    {
+        fprintf (stderr, "%s: cached factors not released\n", label) ;
+
+        errors++ ;
+    }
+
+    errors += compare_solutions (&fresh.SM_A, &cached.SM_A, label) ;
+
+failure :
+
+    thermal_data_destroy      (&fresh) ;
+    stack_description_destroy (&fstkd) ;
+    output_destroy            (&foutput) ;
+    analysis_destroy          (&fanalysis) ;
+
+    thermal_data_destroy      (&cached) ;
+    stack_description_destroy (&cstkd) ;
+    output_destroy            (&coutput) ;
+    analysis_destroy          (&canalysis) ;
+
+    return errors ;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 4 || (strcmp (argv[3], "store") != 0 && strcmp (argv[3], "load") != 0))
+    {
+        fprintf(stderr, "Usage: \"%s file.stk directory store|load\"\n", argv[0]) ;
+        return EXIT_FAILURE ;
+    }
+
+    bool load = strcmp (argv[3], "load") == 0 ;
+
+    Quantity_t errors = 0u ;
+
+    errors += check_ordering (argv[1], argv[2], load,
+                              TDICE_ORDERING_MINIMUM_DEGREE,     "minimum degree") ;
+
+    errors += check_ordering (argv[1], argv[2], load,
+                              TDICE_ORDERING_NESTED_DISSECTION,  "nested dissection") ;
+
+    fprintf (stdout, errors == 0u ? "ok\n" : "FAILED\n") ;
+
+    return errors == 0u ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
@@ -0,0 +1,303 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <math.h>
+
+#include "stack_file_parser.h"
+
+#include "stack_description.h"
+#include "thermal_data.h"
+#include "analysis.h"
+#include "output.h"
+#include "network_message.h"
+
+/* Checks that the floorplan statistics reported by the Tflp inspection
+ * points follow the temperatures when the public per inspection point
+ * functions are called directly, step after step, with the same
+ * temperature array. The reference values are computed from scratch
+ * with get_all_*_temperatures_floorplan, for the four quantities: with
+ * floorplan elements made of rectangles sharing thermal cells (see
+ * output/shared_cells.flp) the average of each rectangle is over all its
+ * cells, also the ones of another rectangle. */
+
+#define NSTEPS 2
+
+static Temperature_t *reference
+(
+    Floorplan_t      *floorplan,
+    Dimensions_t     *dimensions,
+    Temperature_t    *temperatures,
+    OutputQuantity_t  quantity,
+    Quantity_t       *n
+)
+{
+    if (quantity == TDICE_OUTPUT_QUANTITY_MAXIMUM)
+
+        return get_all_max_temperatures_floorplan (floorplan, dimensions, temperatures, n, NULL) ;
+
+    else if (quantity == TDICE_OUTPUT_QUANTITY_MINIMUM)
+
+        return get_all_min_temperatures_floorplan (floorplan, dimensions, temperatures, n, NULL) ;
+
+    else if (quantity == TDICE_OUTPUT_QUANTITY_AVERAGE)
+
+        return get_all_avg_temperatures_floorplan (floorplan, dimensions, temperatures, n, NULL) ;
+
+    else
+
+        return get_all_gradient_temperatures_floorplan (floorplan, dimensions, temperatures, n, NULL) ;
+}
+
+/* Compares the message filled by fill_message_inspection_point
+ * (one float per floorplan element) with the reference values */
+
+static Quantity_t check_message
+(
+    InspectionPoint_t *ipoint,
+    Dimensions_t      *dimensions,
+    Temperature_t     *temperatures,
+    Temperature_t     *layer_temperatures,
+    Source_t          *sources,
+    OutputQuantity_t   quantity
+)
+{
+    Floorplan_t *floorplan = &ipoint->StackElement->Pointer.Die->Floorplan ;
+
+    Quantity_t n, nflp, index, errors = 0u ;
+
+    Temperature_t *ref = reference
+
+        (floorplan, dimensions, layer_temperatures, quantity, &n) ;
+
+    NetworkMessage_t message ;
+
+    network_message_init (&message) ;
+    build_message_head   (&message, TDICE_SEND_OUTPUT) ;
+
+    fill_message_inspection_point
+
+        (ipoint, quantity, dimensions, temperatures, sources, &message) ;
+
+    extract_message_word (&message, &nflp, 0) ;
+
+    if (nflp != n)
+
+        errors++ ;
+
+    for (index = 0u ; index != n && errors == 0u ; index++)
+    {
+        float t ;
+
+        extract_message_word (&message, &t, index + 1u) ;
+
+        if (fabs (t - ref [index]) > 1e-3)
+        {
+            fprintf (stderr, "quantity %d element %d: message %.4f reference %.4f\n",
+                     quantity, index, t, ref [index]) ;
+
+            errors++ ;
+        }
+    }
+
+    network_message_destroy (&message) ;
+
+    free (ref) ;
+
+    return errors ;
+}
+
+int main(int argc, char** argv)
+{
+    StackDescription_t stkd ;
+    Analysis_t         analysis ;
+    Output_t           output ;
+    ThermalData_t      tdata ;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: \"%s file.stk\"\n", argv[0]) ;
+        return EXIT_FAILURE ;
+    }
+
+    stack_description_init (&stkd) ;
+    analysis_init          (&analysis) ;
+    output_init            (&output) ;
+
+    if (parse_stack_description_file (argv[1], &stkd, &analysis, &output) != 0)
+
+        return EXIT_FAILURE ;
+
+    if (generate_output_headers (&output, stkd.Dimensions, (String_t)"% ") != TDICE_SUCCESS)
+
+        goto failure ;
+
+    // The first Tflp inspection point (printed at every step)
+
+    InspectionPoint_t         *ipoint = NULL ;
+    InspectionPointListNode_t *ipn ;
+
+    for (ipn  = inspection_point_list_begin (&output.InspectionPointListStep) ;
+         ipn != NULL && ipoint == NULL ;
+         ipn  = inspection_point_list_next (ipn))
+
+        if (inspection_point_list_data (ipn)->OType == TDICE_OUTPUT_TYPE_TFLP)
+
+            ipoint = inspection_point_list_data (ipn) ;
+
+    if (ipoint == NULL)
+    {
+        fprintf (stderr, "%s has no Tflp inspection point at every step\n", argv[1]) ;
+
+        goto failure ;
+    }
+
+    thermal_data_init (&tdata) ;
+
+    if (thermal_data_build (&tdata, &stkd.StackElements, stkd.Dimensions, &analysis) != TDICE_SUCCESS)
+
+        goto failure ;
+
+    Floorplan_t *floorplan = &ipoint->StackElement->Pointer.Die->Floorplan ;
+
+    Temperature_t *layer_temperatures = tdata.Temperatures
+
+        + get_cell_offset_in_stack
+
+              (stkd.Dimensions, get_source_layer_offset (ipoint->StackElement),
+               first_row (stkd.Dimensions), first_column (stkd.Dimensions)) ;
+
+    OutputQuantity_t quantities [4] =
+    {
+        TDICE_OUTPUT_QUANTITY_MAXIMUM, TDICE_OUTPUT_QUANTITY_MINIMUM,
+        TDICE_OUTPUT_QUANTITY_AVERAGE, TDICE_OUTPUT_QUANTITY_GRADIENT
+    } ;
+
+    Quantity_t step, quantity, index, n, errors = 0u ;
+
+    Temperature_t previous_max = 0.0 ;
+
+    for (step = 0u ; step != NSTEPS ; step++)
+    {
+        SimResult_t result = emulate_step (&tdata, stkd.Dimensions, &analysis) ;
+
+        if (result != TDICE_STEP_DONE && result != TDICE_SLOT_DONE)
+        {
+            fprintf (stderr, "error %d: emulate step\n", result) ;
+
+            goto failure_tdata ;
+        }
+
+        // The statistics left in the floorplan by the inspection point
+        // must be the ones of the current temperatures
+
+        generate_inspection_point_output
+
+            (ipoint, stkd.Dimensions, tdata.Temperatures,
+             tdata.PowerGrid.Sources, get_simulated_time (&analysis)) ;
+
+        for (quantity = 0u ; quantity != 4u ; quantity++)
+        {
+            Temperature_t *ref = reference
+
+                (floorplan, stkd.Dimensions, layer_temperatures,
+                 quantities [quantity], &n) ;
+
+            Temperature_t *cached = get_temperature_statistics_floorplan
+
+                (floorplan, layer_temperatures, quantities [quantity]) ;
+
+            for (index = 0u ; index != n ; index++)
+
+                if (fabs (cached [index] - ref [index]) > 1e-9)
+                {
+                    fprintf (stderr, "step %d quantity %d element %d: output %.6f reference %.6f\n",
+                             step, quantities [quantity], index, cached [index], ref [index]) ;
+
+                    errors++ ;
+                }
+
+            free (ref) ;
+        }
+
+        Temperature_t *max = reference
+
+            (floorplan, stkd.Dimensions, layer_temperatures,
+             TDICE_OUTPUT_QUANTITY_MAXIMUM, &n) ;
+
+        // Otherwise the test could not tell the two steps apart
+
+        if (step != 0u && max [0] == previous_max)
+        {
+            fprintf (stderr, "the temperatures did not change between the steps\n") ;
+
+            errors++ ;
+        }
+
+        previous_max = max [0] ;
+
+        free (max) ;
+
+        for (quantity = 0u ; quantity != 4u ; quantity++)
+
+            errors += check_message
+
+                (ipoint, stkd.Dimensions, tdata.Temperatures, layer_temperatures,
+                 tdata.PowerGrid.Sources, quantities [quantity]) ;
+    }
+
+    fprintf (stdout, errors == 0u ? "ok\n" : "FAILED\n") ;
+
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
+
+    return errors == 0u ? EXIT_SUCCESS : EXIT_FAILURE ;
+
+failure_tdata :
+
+    thermal_data_destroy (&tdata) ;
+
+failure :
+
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
+
+    return EXIT_FAILURE ;
+}
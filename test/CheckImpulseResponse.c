@@ -0,0 +1,184 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <math.h>
+
+#include "stack_file_parser.h"
+
+#include "stack_description.h"
+#include "thermal_data.h"
+#include "impulse_response.h"
+#include "analysis.h"
+#include "output.h"
+#include "macros.h"
+
+#include "PowerValues.h"
+
+/* Compares, at the end of every slot of the power values of a transient
+ * stack file, the temperatures computed by convolution with the impulse
+ * responses with the ones computed by emulate_slot, on the thermal cells
+ * read by the inspection points. The responses are stored for all the
+ * slots of the trace, so that they are not truncated and the two results
+ * must agree to TOLERANCE. */
+
+#define TOLERANCE 1e-6 /* K */
+
+int main(int argc, char** argv)
+{
+    StackDescription_t stkd ;
+    Analysis_t         analysis ;
+    Output_t           output ;
+    ThermalData_t      tdata ;
+    ImpulseResponse_t  iresponse ;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: \"%s file.stk\"\n", argv[0]) ;
+        return EXIT_FAILURE ;
+    }
+
+    stack_description_init (&stkd) ;
+    analysis_init          (&analysis) ;
+    output_init            (&output) ;
+
+    if (parse_stack_description_file (argv[1], &stkd, &analysis, &output) != 0)
+
+        return EXIT_FAILURE ;
+
+    thermal_data_init     (&tdata) ;
+    impulse_response_init (&iresponse) ;
+
+    if (thermal_data_build (&tdata, &stkd.StackElements, stkd.Dimensions, &analysis) != TDICE_SUCCESS)
+
+        goto failure ;
+
+    Quantity_t nelements, nslots ;
+
+    Power_t *powers = take_power_values (&tdata.PowerGrid, &nelements, &nslots) ;
+
+    if (powers == NULL || nslots == 0u)
+    {
+        fprintf (stderr, "%s has no power values\n", argv[1]) ;
+
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    if (impulse_response_build
+
+            (&iresponse, &tdata, stkd.Dimensions, &analysis, &output, nslots, 0.0)
+
+        != TDICE_SUCCESS)
+    {
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    Temperature_t *temperatures = (Temperature_t *) malloc (sizeof (Temperature_t) * tdata.Size) ;
+
+    if (temperatures == NULL)
+    {
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    Quantity_t  slot, errors = 0u ;
+    CellIndex_t cell ;
+
+    for (slot = 0u ; slot != nslots ; slot++)
+    {
+        emulate_slot_convolution (&iresponse, powers, slot, temperatures) ;
+
+        if (give_power_values (&tdata.PowerGrid, powers + slot * nelements, nelements) != TDICE_SUCCESS)
+        {
+            errors++ ;
+
+            break ;
+        }
+
+        SimResult_t result = emulate_slot (&tdata, stkd.Dimensions, &analysis) ;
+
+        if (result != TDICE_SLOT_DONE)
+        {
+            fprintf (stderr, "error %d: emulate slot\n", result) ;
+
+            errors++ ;
+
+            break ;
+        }
+
+        for (cell = 0u ; cell != iresponse.NCells ; cell++)
+        {
+            CellIndex_t offset = iresponse.Cells [cell] ;
+
+            if (fabs (temperatures [offset] - tdata.Temperatures [offset]) > TOLERANCE)
+            {
+                fprintf (stderr, "slot %d cell %d: convolution %.6f slot %.6f\n",
+                         slot, offset, temperatures [offset], tdata.Temperatures [offset]) ;
+
+                errors++ ;
+            }
+        }
+    }
+
+    fprintf (stdout, errors == 0u ? "ok\n" : "FAILED\n") ;
+
+    free (temperatures) ;
+    free (powers) ;
+
+    impulse_response_destroy  (&iresponse) ;
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
+
+    return errors == 0u ? EXIT_SUCCESS : EXIT_FAILURE ;
+
+failure :
+
+    impulse_response_destroy  (&iresponse) ;
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
+
+    return EXIT_FAILURE ;
+}
@@ -0,0 +1,180 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <math.h>
+
+#include "stack_file_parser.h"
+
+#include "stack_description.h"
+#include "thermal_data.h"
+#include "influence_matrix.h"
+#include "analysis.h"
+#include "output.h"
+#include "macros.h"
+
+#include "PowerValues.h"
+
+/* Compares, for every slot of the power values of a steady state stack
+ * file, the temperatures of the influence matrix with the ones computed by
+ * emulate_steady, on the thermal cells read by the inspection points. Both
+ * solve the same linear system, so they must agree to TOLERANCE. */
+
+#define TOLERANCE 1e-6 /* K */
+
+int main(int argc, char** argv)
+{
+    StackDescription_t stkd ;
+    Analysis_t         analysis ;
+    Output_t           output ;
+    ThermalData_t      tdata ;
+    InfluenceMatrix_t  imatrix ;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: \"%s file.stk\"\n", argv[0]) ;
+        return EXIT_FAILURE ;
+    }
+
+    stack_description_init (&stkd) ;
+    analysis_init          (&analysis) ;
+    output_init            (&output) ;
+
+    if (parse_stack_description_file (argv[1], &stkd, &analysis, &output) != 0)
+
+        return EXIT_FAILURE ;
+
+    thermal_data_init    (&tdata) ;
+    influence_matrix_init (&imatrix) ;
+
+    if (thermal_data_build (&tdata, &stkd.StackElements, stkd.Dimensions, &analysis) != TDICE_SUCCESS)
+
+        goto failure ;
+
+    Quantity_t nelements, nslots ;
+
+    Power_t *powers = take_power_values (&tdata.PowerGrid, &nelements, &nslots) ;
+
+    if (powers == NULL || nslots == 0u)
+    {
+        fprintf (stderr, "%s has no power values\n", argv[1]) ;
+
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    if (influence_matrix_build (&imatrix, &tdata, stkd.Dimensions, &analysis, &output) != TDICE_SUCCESS)
+    {
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    Temperature_t *temperatures = (Temperature_t *) malloc (sizeof (Temperature_t) * tdata.Size) ;
+
+    if (temperatures == NULL)
+    {
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    Quantity_t  slot, errors = 0u ;
+    CellIndex_t cell ;
+
+    for (slot = 0u ; slot != nslots ; slot++)
+    {
+        Power_t *slot_powers = powers + slot * nelements ;
+
+        emulate_steady_influence (&imatrix, slot_powers, temperatures) ;
+
+        if (give_power_values (&tdata.PowerGrid, slot_powers, nelements) != TDICE_SUCCESS)
+        {
+            errors++ ;
+
+            break ;
+        }
+
+        SimResult_t result = emulate_steady (&tdata, stkd.Dimensions, &analysis) ;
+
+        if (result != TDICE_END_OF_SIMULATION)
+        {
+            fprintf (stderr, "error %d: emulate steady\n", result) ;
+
+            errors++ ;
+
+            break ;
+        }
+
+        for (cell = 0u ; cell != imatrix.NCells ; cell++)
+        {
+            CellIndex_t offset = imatrix.Cells [cell] ;
+
+            if (fabs (temperatures [offset] - tdata.Temperatures [offset]) > TOLERANCE)
+            {
+                fprintf (stderr, "slot %d cell %d: influence %.6f steady %.6f\n",
+                         slot, offset, temperatures [offset], tdata.Temperatures [offset]) ;
+
+                errors++ ;
+            }
+        }
+    }
+
+    fprintf (stdout, errors == 0u ? "ok\n" : "FAILED\n") ;
+
+    free (temperatures) ;
+    free (powers) ;
+
+    influence_matrix_destroy  (&imatrix) ;
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
+
+    return errors == 0u ? EXIT_SUCCESS : EXIT_FAILURE ;
+
+failure :
+
+    influence_matrix_destroy  (&imatrix) ;
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
+
+    return EXIT_FAILURE ;
+}
@@ -0,0 +1,414 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "stack_file_parser.h"
+
+#include "stack_description.h"
+#include "thermal_data.h"
+#include "analysis.h"
+#include "output.h"
+#include "power_trace.h"
+#include "macros.h"
+
+#include "PowerValues.h"
+
+/* Simulates a reference stack whose floorplan lists its power values and
+ * checks that the same powers read from power traces (CSV or binary) or
+ * from a per-cell power map give the same temperatures, slot after slot.
+ * The stacks given after -fail use a bad trace or power map and must be
+ * rejected, when parsed or while they are simulated.
+ *
+ * The binary traces are written from the power values of the reference
+ * stack (they store native numbers): the stack files in trace/ refer to
+ * them with the names below. */
+
+#define BINARY_TRACE    "trace/elements.bin"
+#define TRUNCATED_TRACE "trace/truncated.bin"
+
+#define TOLERANCE 1e-9 /* K */
+
+/* Reads the power values of the reference stack, slot after slot */
+
+static Power_t *reference_powers
+
+    (char *filename, Quantity_t *nelements, Quantity_t *nslots)
+{
+    StackDescription_t stkd ;
+    Analysis_t         analysis ;
+    Output_t           output ;
+    ThermalData_t      tdata ;
+    Power_t           *powers = NULL ;
+
+    stack_description_init (&stkd) ;
+    analysis_init          (&analysis) ;
+    output_init            (&output) ;
+    thermal_data_init      (&tdata) ;
+
+    if (   parse_stack_description_file (filename, &stkd, &analysis, &output) == 0
+        && thermal_data_build (&tdata, &stkd.StackElements, stkd.Dimensions, &analysis) == TDICE_SUCCESS)
+
+        powers = take_power_values (&tdata.PowerGrid, nelements, nslots) ;
+
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
+
+    return powers ;
+}
+
+/* Writes the powers as a binary trace, without its last value if truncated */
+
+static Error_t write_binary_trace
+(
+    char       *filename,
+    Power_t    *powers,
+    Quantity_t  nelements,
+    Quantity_t  nslots,
+    bool        truncated
+)
+{
+    PowerTraceHeader_t header ;
+
+    memset (&header, 0, sizeof (PowerTraceHeader_t)) ;
+
+    memcpy (header.Magic, TDICE_POWER_TRACE_MAGIC, sizeof (header.Magic)) ;
+
+    header.Version  = TDICE_POWER_TRACE_VERSION ;
+    header.NColumns = nelements ;
+    header.NSlots   = nslots ;
+
+    size_t nvalues = (size_t) nelements * nslots - (truncated == true ? 1u : 0u) ;
+
+    FILE *file = fopen (filename, "wb") ;
+
+    if (file == NULL)
+    {
+        fprintf (stderr, "Cannot create %s\n", filename) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    bool written =    fwrite (&header, sizeof (PowerTraceHeader_t), 1u, file) == 1u
+                   && fwrite (powers, sizeof (Power_t), nvalues, file) == nvalues ;
+
+    if (fclose (file) != 0 || written == false)
+    {
+        fprintf (stderr, "Cannot write %s\n", filename) ;
+
+        return TDICE_FAILURE ;
+    }
+
+    return TDICE_SUCCESS ;
+}
+
+/* Copies every power trace of the stack at the slot it has reached and
+ * checks that the copy gives the remaining reference powers */
+
+static Quantity_t check_trace_copy
+(
+    PowerGrid_t *pgrid,
+    Power_t     *reference,
+    Quantity_t   nelements,
+    Quantity_t   nslots
+)
+{
+    Quantity_t layer, offset = 0u, errors = 0u ;
+
+    for (layer = 0u ; layer != pgrid->NLayers ; layer++)
+    {
+        Floorplan_t *floorplan = pgrid->FloorplansProfile [layer] ;
+
+        if (floorplan == NULL)
+
+            continue ;
+
+        Quantity_t nvalues = get_number_of_power_values_floorplan (floorplan) ;
+
+        if (floorplan->PowerTrace != NULL && floorplan->NMapCells == 0u)
+        {
+            PowerTrace_t *copy   = power_trace_clone (floorplan->PowerTrace) ;
+            Power_t      *powers = (Power_t *) malloc (sizeof (Power_t) * nvalues) ;
+
+            if (copy == NULL || powers == NULL || copy->FileName == NULL
+                || copy->NextSlot != floorplan->PowerTrace->NextSlot)
+            {
+                fprintf (stderr, "power trace copy failed\n") ;
+
+                errors++ ;
+            }
+            else
+            {
+                Quantity_t slot, index ;
+
+                for (slot = (Quantity_t) copy->NextSlot ; slot != nslots ; slot++)
+                {
+                    if (power_trace_read (copy, powers) == TDICE_FAILURE)
+                    {
+                        fprintf (stderr, "power trace copy: slot %d missing\n", slot) ;
+
+                        errors++ ;
+
+                        break ;
+                    }
+
+                    for (index = 0u ; index != nvalues ; index++)
+
+                        if (powers [index] != reference [slot * nelements + offset + index])
+                        {
+                            fprintf (stderr, "power trace copy: slot %d value %d\n", slot, index) ;
+
+                            errors++ ;
+                        }
+                }
+
+                if (slot == nslots && power_trace_read (copy, powers) == TDICE_SUCCESS)
+                {
+                    fprintf (stderr, "power trace copy: too many slots\n") ;
+
+                    errors++ ;
+                }
+            }
+
+            free (powers) ;
+
+            power_trace_free (copy) ;
+        }
+
+        offset += nvalues ;
+    }
+
+    return errors ;
+}
+
+/* Runs the transient simulation of a stack until its powers end and
+ * returns the temperatures of its thermal cells after every slot (NULL
+ * on failure). Halfway, the power traces are checked against reference,
+ * if given */
+
+static Temperature_t *simulate
+(
+    char        *filename,
+    CellIndex_t *size,
+    Quantity_t  *nslots,
+    Power_t     *reference,
+    Quantity_t   nelements,
+    Quantity_t   nreference
+)
+{
+    StackDescription_t stkd ;
+    Analysis_t         analysis ;
+    Output_t           output ;
+    ThermalData_t      tdata ;
+    Temperature_t     *temperatures = NULL ;
+
+    stack_description_init (&stkd) ;
+    analysis_init          (&analysis) ;
+    output_init            (&output) ;
+    thermal_data_init      (&tdata) ;
+
+    *nslots = 0u ;
+
+    if (parse_stack_description_file (filename, &stkd, &analysis, &output) != 0)
+
+        goto failure ;
+
+    if (thermal_data_build (&tdata, &stkd.StackElements, stkd.Dimensions, &analysis) != TDICE_SUCCESS)
+
+        goto failure ;
+
+    *size = tdata.Size ;
+
+    while (1)
+    {
+        if (reference != NULL && *nslots == nreference / 2u
+            && check_trace_copy (&tdata.PowerGrid, reference, nelements, nreference) != 0u)
+        {
+            free (temperatures) ;
+
+            temperatures = NULL ;
+
+            goto failure ;
+        }
+
+        SimResult_t result = emulate_slot (&tdata, stkd.Dimensions, &analysis) ;
+
+        if (result == TDICE_END_OF_SIMULATION)
+
+            break ;
+
+        Temperature_t *tmp = NULL ;
+
+        if (result == TDICE_SLOT_DONE)
+
+            tmp = (Temperature_t *) realloc
+
+                (temperatures, sizeof (Temperature_t) * tdata.Size * (*nslots + 1u)) ;
+
+        if (tmp == NULL)
+        {
+            fprintf (stderr, "%s: error %d at slot %d\n", filename, result, *nslots) ;
+
+            free (temperatures) ;
+
+            temperatures = NULL ;
+
+            goto failure ;
+        }
+
+        temperatures = tmp ;
+
+        memcpy (temperatures + tdata.Size * *nslots, tdata.Temperatures,
+                sizeof (Temperature_t) * tdata.Size) ;
+
+        (*nslots)++ ;
+    }
+
+failure :
+
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
+
+    return temperatures ;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: \"%s reference.stk [ trace.stk ... ] [ -fail bad.stk ... ]\"\n", argv[0]) ;
+        return EXIT_FAILURE ;
+    }
+
+    Quantity_t nelements, nslots, errors = 0u ;
+
+    Power_t *powers = reference_powers (argv[1], &nelements, &nslots) ;
+
+    if (powers == NULL || nslots == 0u
+        || write_binary_trace (BINARY_TRACE,    powers, nelements, nslots, false) == TDICE_FAILURE
+        || write_binary_trace (TRUNCATED_TRACE, powers, nelements, nslots, true)  == TDICE_FAILURE)
+    {
+        fprintf (stdout, "FAILED\n") ;
+
+        free (powers) ;
+
+        return EXIT_FAILURE ;
+    }
+
+    CellIndex_t ref_size = 0u, size = 0u, cell ;
+    Quantity_t  ref_nslots, trace_nslots ;
+
+    Temperature_t *ref = simulate (argv[1], &ref_size, &ref_nslots, NULL, 0u, 0u) ;
+
+    if (ref == NULL || ref_nslots != nslots)
+
+        errors++ ;
+
+    bool fail = false ;
+
+    int arg ;
+
+    for (arg = 2 ; arg < argc && ref != NULL ; arg++)
+    {
+        if (strcmp (argv[arg], "-fail") == 0)
+        {
+            fail = true ;
+
+            continue ;
+        }
+
+        // The copies of a bad trace are not checked: it must fail anyway
+
+        Temperature_t *temperatures = simulate
+
+            (argv[arg], &size, &trace_nslots, fail == true ? NULL : powers, nelements, nslots) ;
+
+        if (fail == true)
+        {
+            if (temperatures != NULL)
+            {
+                fprintf (stderr, "%s: bad power values accepted\n", argv[arg]) ;
+
+                errors++ ;
+            }
+        }
+        else if (temperatures == NULL)
+        {
+            fprintf (stderr, "%s: simulation failed\n", argv[arg]) ;
+
+            errors++ ;
+        }
+        else if (size != ref_size || trace_nslots != ref_nslots)
+        {
+            fprintf (stderr, "%s: %d slots simulated, %d expected\n",
+                     argv[arg], trace_nslots, ref_nslots) ;
+
+            errors++ ;
+        }
+        else
+
+            for (cell = 0u ; cell != size * ref_nslots ; cell++)
+
+                if (fabs (temperatures [cell] - ref [cell]) > TOLERANCE)
+                {
+                    fprintf (stderr, "%s: slot %d cell %d: %.6f instead of %.6f\n",
+                             argv[arg], cell / size, cell % size,
+                             temperatures [cell], ref [cell]) ;
+
+                    errors++ ;
+
+                    break ;
+                }
+
+        free (temperatures) ;
+    }
+
+    fprintf (stdout, errors == 0u ? "ok\n" : "FAILED\n") ;
+
+    free (ref) ;
+    free (powers) ;
+
+    return errors == 0u ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
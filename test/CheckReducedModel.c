@@ -0,0 +1,220 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <math.h>
+
+#include "stack_file_parser.h"
+
+#include "stack_description.h"
+#include "thermal_data.h"
+#include "reduced_model.h"
+#include "analysis.h"
+#include "output.h"
+#include "macros.h"
+
+#include "PowerValues.h"
+
+/* Compares, at the end of every slot of the power values of a transient
+ * stack file, the temperatures of the reduced model with the ones computed
+ * by emulate_slot, on the thermal cells read by the inspection points. The
+ * error must stay below the bound measured by reduced_model_build for the
+ * largest power of the trace, and the bound must be below TOLERANCE. */
+
+#define NMOMENTS 4
+
+#define TOLERANCE 0.01 /* K */
+
+int main(int argc, char** argv)
+{
+    StackDescription_t stkd ;
+    Analysis_t         analysis ;
+    Analysis_t         reduced_analysis ;
+    Output_t           output ;
+    ThermalData_t      tdata ;
+    ReducedModel_t     rmodel ;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: \"%s file.stk\"\n", argv[0]) ;
+        return EXIT_FAILURE ;
+    }
+
+    stack_description_init (&stkd) ;
+    analysis_init          (&analysis) ;
+    analysis_init          (&reduced_analysis) ;
+    output_init            (&output) ;
+
+    if (parse_stack_description_file (argv[1], &stkd, &analysis, &output) != 0)
+
+        return EXIT_FAILURE ;
+
+    thermal_data_init  (&tdata) ;
+    reduced_model_init (&rmodel) ;
+
+    if (thermal_data_build (&tdata, &stkd.StackElements, stkd.Dimensions, &analysis) != TDICE_SUCCESS)
+
+        goto failure ;
+
+    Quantity_t nelements, nslots ;
+
+    Power_t *powers = take_power_values (&tdata.PowerGrid, &nelements, &nslots) ;
+
+    if (powers == NULL || nslots == 0u)
+    {
+        fprintf (stderr, "%s has no power values\n", argv[1]) ;
+
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    if (reduced_model_build
+
+            (&rmodel, &tdata, stkd.Dimensions, &analysis, &output, NMOMENTS, nslots)
+
+        != TDICE_SUCCESS)
+    {
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    Temperature_t *temperatures = (Temperature_t *) malloc (sizeof (Temperature_t) * tdata.Size) ;
+
+    if (temperatures == NULL)
+    {
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    // The error bound of reduced_model_build for the largest power
+
+    Power_t    max_power = 0.0 ;
+    Quantity_t index ;
+
+    for (index = 0u ; index != nelements * nslots ; index++)
+
+        max_power = MAX (max_power, fabs (powers [index])) ;
+
+    Temperature_t bound = rmodel.OffsetError + rmodel.ResponseError * max_power ;
+
+    Quantity_t  slot, errors = 0u ;
+    CellIndex_t cell ;
+
+    if (bound > TOLERANCE)
+    {
+        fprintf (stderr, "order %d: error bound %.3g K\n", rmodel.Order, bound) ;
+
+        errors++ ;
+    }
+
+    analysis_copy (&reduced_analysis, &analysis) ;
+
+    for (slot = 0u ; slot != nslots ; slot++)
+    {
+        SimResult_t result = emulate_reduced_slot
+
+            (&rmodel, &reduced_analysis, powers + slot * nelements, temperatures) ;
+
+        if (result != TDICE_SLOT_DONE)
+        {
+            fprintf (stderr, "error %d: emulate reduced slot\n", result) ;
+
+            errors++ ;
+
+            break ;
+        }
+
+        if (give_power_values (&tdata.PowerGrid, powers + slot * nelements, nelements) != TDICE_SUCCESS)
+        {
+            errors++ ;
+
+            break ;
+        }
+
+        result = emulate_slot (&tdata, stkd.Dimensions, &analysis) ;
+
+        if (result != TDICE_SLOT_DONE)
+        {
+            fprintf (stderr, "error %d: emulate slot\n", result) ;
+
+            errors++ ;
+
+            break ;
+        }
+
+        for (cell = 0u ; cell != rmodel.NCells ; cell++)
+        {
+            CellIndex_t offset = rmodel.Cells [cell] ;
+
+            if (fabs (temperatures [offset] - tdata.Temperatures [offset]) > bound)
+            {
+                fprintf (stderr, "slot %d cell %d: reduced %.6f slot %.6f\n",
+                         slot, offset, temperatures [offset], tdata.Temperatures [offset]) ;
+
+                errors++ ;
+            }
+        }
+    }
+
+    fprintf (stdout, errors == 0u ? "ok\n" : "FAILED\n") ;
+
+    free (temperatures) ;
+    free (powers) ;
+
+    reduced_model_destroy     (&rmodel) ;
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&reduced_analysis) ;
+    analysis_destroy          (&analysis) ;
+
+    return errors == 0u ? EXIT_SUCCESS : EXIT_FAILURE ;
+
+failure :
+
+    reduced_model_destroy     (&rmodel) ;
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&reduced_analysis) ;
+    analysis_destroy          (&analysis) ;
+
+    return EXIT_FAILURE ;
+}
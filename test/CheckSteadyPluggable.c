@@ -0,0 +1,193 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "stack_file_parser.h"
+
+#include "stack_description.h"
+#include "thermal_data.h"
+#include "analysis.h"
+#include "output.h"
+#include "macros.h"
+
+#include "PowerValues.h"
+
+/* Compares the steady state of a stack with a pluggable heat sink with the
+ * temperatures reached by a long transient simulation of the same stack,
+ * on every thermal cell. The transient runs for NSLOTS slots with the power
+ * values of its first slot, long enough to settle within TOLERANCE. */
+
+#define NSLOTS    60
+
+#define TOLERANCE 1e-2 /* K */
+
+/* Runs the simulation of a stack file, steady or transient, and returns
+ * the temperatures of its thermal cells (NULL on failure) */
+
+static Temperature_t *simulate (char *filename, CellIndex_t *size)
+{
+    StackDescription_t stkd ;
+    Analysis_t         analysis ;
+    Output_t           output ;
+    ThermalData_t      tdata ;
+    Temperature_t     *temperatures = NULL ;
+
+    stack_description_init (&stkd) ;
+    analysis_init          (&analysis) ;
+    output_init            (&output) ;
+    thermal_data_init      (&tdata) ;
+
+    if (parse_stack_description_file (filename, &stkd, &analysis, &output) != 0)
+
+        goto failure ;
+
+    if (thermal_data_build (&tdata, &stkd.StackElements, stkd.Dimensions, &analysis) != TDICE_SUCCESS)
+
+        goto failure ;
+
+    if (analysis.AnalysisType == TDICE_ANALYSIS_TYPE_STEADY)
+    {
+        SimResult_t result = emulate_steady (&tdata, stkd.Dimensions, &analysis) ;
+
+        if (result != TDICE_END_OF_SIMULATION)
+        {
+            fprintf (stderr, "error %d: emulate steady\n", result) ;
+
+            goto failure ;
+        }
+    }
+    else
+    {
+        Quantity_t nelements, nslots, slot ;
+
+        Power_t *powers = take_power_values (&tdata.PowerGrid, &nelements, &nslots) ;
+
+        if (powers == NULL || nslots == 0u)
+        {
+            fprintf (stderr, "%s has no power values\n", filename) ;
+
+            free (powers) ;
+
+            goto failure ;
+        }
+
+        for (slot = 0u ; slot != NSLOTS ; slot++)
+        {
+            SimResult_t result = TDICE_SOLVER_ERROR ;
+
+            if (give_power_values (&tdata.PowerGrid, powers, nelements) == TDICE_SUCCESS)
+
+                result = emulate_slot (&tdata, stkd.Dimensions, &analysis) ;
+
+            if (result != TDICE_SLOT_DONE)
+            {
+                fprintf (stderr, "error %d: emulate slot %d\n", result, slot) ;
+
+                free (powers) ;
+
+                goto failure ;
+            }
+        }
+
+        free (powers) ;
+    }
+
+    temperatures = (Temperature_t *) malloc (sizeof (Temperature_t) * tdata.Size) ;
+
+    if (temperatures != NULL)
+    {
+        memcpy (temperatures, tdata.Temperatures, sizeof (Temperature_t) * tdata.Size) ;
+
+        *size = tdata.Size ;
+    }
+
+failure :
+
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
+
+    return temperatures ;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: \"%s steady.stk transient.stk\"\n", argv[0]) ;
+        return EXIT_FAILURE ;
+    }
+
+    CellIndex_t steady_size = 0u, transient_size = 0u, cell ;
+
+    // The plugin keeps its state in static variables: the two simulations
+    // run one after the other, each one initializing the plugin again
+
+    Temperature_t *steady    = simulate (argv[1], &steady_size) ;
+    Temperature_t *transient = simulate (argv[2], &transient_size) ;
+
+    Quantity_t errors = 0u ;
+
+    if (steady == NULL || transient == NULL || steady_size != transient_size)
+
+        errors++ ;
+
+    else
+
+        for (cell = 0u ; cell != steady_size ; cell++)
+
+            if (fabs (steady [cell] - transient [cell]) > TOLERANCE)
+            {
+                if (errors++ < 10u)
+
+                    fprintf (stderr, "cell %d: steady %.4f transient %.4f\n",
+                             cell, steady [cell], transient [cell]) ;
+            }
+
+    fprintf (stdout, errors == 0u ? "ok\n" : "FAILED\n") ;
+
+    free (steady) ;
+    free (transient) ;
+
+    return errors == 0u ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
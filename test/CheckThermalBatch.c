@@ -0,0 +1,271 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#include <math.h>
+#include <string.h>
+
+#include "stack_file_parser.h"
+
+#include "stack_description.h"
+#include "thermal_data.h"
+#include "thermal_batch.h"
+#include "analysis.h"
+#include "output.h"
+#include "macros.h"
+
+#include "PowerValues.h"
+
+/* Compares, at the end of every slot, the temperatures of a batch of
+ * transient simulations with the ones computed by emulate_slot, scenario
+ * after scenario. The first scenario uses the power values of the stack
+ * file and the second one the same slots starting from the middle of the
+ * trace. The batch solves all the scenarios with the same factors of the
+ * system matrix, so the temperatures of every thermal cell must agree to
+ * TOLERANCE. */
+
+#define NSCENARIOS 2
+
+#define TOLERANCE 1e-6 /* K */
+
+/* The power values of a scenario in a slot */
+
+static Power_t *scenario_powers
+(
+    Power_t    *powers,
+    Quantity_t  nelements,
+    Quantity_t  nslots,
+    Quantity_t  scenario,
+    Quantity_t  slot
+)
+{
+    if (scenario == 0u)
+
+        return powers + slot * nelements ;
+
+    else
+
+        return powers + ((slot + nslots / 2u) % nslots) * nelements ;
+}
+
+int main(int argc, char** argv)
+{
+    StackDescription_t stkd ;
+    Analysis_t         analysis ;
+    Analysis_t         step_analysis ;
+    Output_t           output ;
+    ThermalData_t      tdata ;
+    ThermalBatch_t     batch ;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: \"%s file.stk\"\n", argv[0]) ;
+        return EXIT_FAILURE ;
+    }
+
+    stack_description_init (&stkd) ;
+    analysis_init          (&analysis) ;
+    analysis_init          (&step_analysis) ;
+    output_init            (&output) ;
+
+    if (parse_stack_description_file (argv[1], &stkd, &analysis, &output) != 0)
+
+        return EXIT_FAILURE ;
+
+    thermal_data_init  (&tdata) ;
+    thermal_batch_init (&batch) ;
+
+    if (thermal_data_build (&tdata, &stkd.StackElements, stkd.Dimensions, &analysis) != TDICE_SUCCESS)
+
+        goto failure ;
+
+    Quantity_t nelements, nslots ;
+
+    Power_t *powers = take_power_values (&tdata.PowerGrid, &nelements, &nslots) ;
+
+    if (powers == NULL || nslots == 0u)
+    {
+        fprintf (stderr, "%s has no power values\n", argv[1]) ;
+
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    // The temperatures of the batch at the end of every slot
+
+    Temperature_t *results = (Temperature_t *) malloc
+
+        (sizeof (Temperature_t) * tdata.Size * NSCENARIOS * nslots) ;
+
+    if (results == NULL)
+    {
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    Quantity_t  scenario, slot, errors = 0u ;
+    CellIndex_t cell ;
+    SimResult_t result ;
+
+    analysis_copy (&step_analysis, &analysis) ;
+
+    if (thermal_batch_build (&batch, &tdata, NSCENARIOS, &step_analysis) != TDICE_SUCCESS)
+    {
+        free (results) ;
+        free (powers) ;
+
+        goto failure ;
+    }
+
+    for (slot = 0u ; slot != nslots && errors == 0u ; slot++)
+    {
+        for (scenario = 0u ; scenario != NSCENARIOS ; scenario++)
+        {
+            PowersQueue_t queue ;
+            Quantity_t    element ;
+            Power_t      *slot_powers = scenario_powers (powers, nelements, nslots, scenario, slot) ;
+
+            powers_queue_init  (&queue) ;
+            powers_queue_build (&queue, nelements) ;
+
+            for (element = 0u ; element != nelements ; element++)
+
+                put_into_powers_queue (&queue, slot_powers [element]) ;
+
+            if (update_batch_sources (&batch, &tdata, stkd.Dimensions, scenario, &queue) != TDICE_SUCCESS)
+
+                errors++ ;
+
+            powers_queue_destroy (&queue) ;
+        }
+
+        do
+
+            result = emulate_batch_step (&batch, &tdata, &step_analysis) ;
+
+        while (result == TDICE_STEP_DONE) ;
+
+        if (result != TDICE_SLOT_DONE)
+        {
+            fprintf (stderr, "error %d: emulate batch step\n", result) ;
+
+            errors++ ;
+        }
+
+        memcpy (results + slot * NSCENARIOS * tdata.Size, batch.Temperatures,
+                sizeof (Temperature_t) * tdata.Size * NSCENARIOS) ;
+    }
+
+    // The reference simulations, one scenario at a time
+
+    for (scenario = 0u ; scenario != NSCENARIOS && errors == 0u ; scenario++)
+    {
+        analysis_copy       (&step_analysis, &analysis) ;
+        reset_thermal_state (&tdata, &step_analysis) ;
+
+        for (slot = 0u ; slot != nslots && errors == 0u ; slot++)
+        {
+            if (give_power_values
+
+                    (&tdata.PowerGrid,
+                     scenario_powers (powers, nelements, nslots, scenario, slot),
+                     nelements)
+
+                != TDICE_SUCCESS)
+            {
+                errors++ ;
+
+                break ;
+            }
+
+            result = emulate_slot (&tdata, stkd.Dimensions, &step_analysis) ;
+
+            if (result != TDICE_SLOT_DONE)
+            {
+                fprintf (stderr, "error %d: emulate slot\n", result) ;
+
+                errors++ ;
+
+                break ;
+            }
+
+            Temperature_t *batch_temperatures =
+
+                results + (slot * NSCENARIOS + scenario) * tdata.Size ;
+
+            for (cell = 0u ; cell != tdata.Size ; cell++)
+
+                if (fabs (batch_temperatures [cell] - tdata.Temperatures [cell]) > TOLERANCE)
+                {
+                    fprintf (stderr, "scenario %d slot %d cell %d: batch %.6f slot %.6f\n",
+                             scenario, slot, cell,
+                             batch_temperatures [cell], tdata.Temperatures [cell]) ;
+
+                    errors++ ;
+
+                    break ;
+                }
+        }
+    }
+
+    fprintf (stdout, errors == 0u ? "ok\n" : "FAILED\n") ;
+
+    free (results) ;
+    free (powers) ;
+
+    thermal_batch_destroy     (&batch) ;
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&step_analysis) ;
+    analysis_destroy          (&analysis) ;
+
+    return errors == 0u ? EXIT_SUCCESS : EXIT_FAILURE ;
+
+failure :
+
+    thermal_batch_destroy     (&batch) ;
+    thermal_data_destroy      (&tdata) ;
+    stack_description_destroy (&stkd) ;
+    output_destroy            (&output) ;
+    analysis_destroy          (&step_analysis) ;
+    analysis_destroy          (&analysis) ;
+
+    return EXIT_FAILURE ;
+}
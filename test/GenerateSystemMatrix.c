@@ -101,6 +101,7 @@ int main(int argc, char** argv)
     thermal_data_destroy      (&tdata) ;
     stack_description_destroy (&stkd) ;
     output_destroy            (&output) ;
+    analysis_destroy          (&analysis) ;
 
     return EXIT_SUCCESS ;
 }
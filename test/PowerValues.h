@@ -0,0 +1,148 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+#ifndef _3DICE_TEST_POWER_VALUES_H_
+#define _3DICE_TEST_POWER_VALUES_H_
+
+/* Power values of the floorplan elements of a stack, shared by the tests
+ * that compare a simulation engine with the reference emulation */
+
+#include <stdlib.h>
+
+#include "power_grid.h"
+#include "powers_queue.h"
+
+/* Moves the power values of every floorplan element from its queue to an
+ * array, slot after slot, with the elements counted as in
+ * insert_power_values . The queues are left empty, so that the values can
+ * be given back one slot at a time with insert_power_values . */
+
+static Power_t *take_power_values
+(
+    PowerGrid_t *pgrid,
+    Quantity_t  *nelements,
+    Quantity_t  *nslots
+)
+{
+    Quantity_t layer, element, slot ;
+
+    *nelements = get_number_of_floorplan_elements_power_grid (pgrid) ;
+    *nslots    = 0u ;
+
+    for (layer = 0u ; layer != pgrid->NLayers ; layer++)
+    {
+        if (pgrid->FloorplansProfile [layer] == NULL)
+
+            continue ;
+
+        FloorplanElementListNode_t *flpeln ;
+
+        for (flpeln  = floorplan_element_list_begin (&pgrid->FloorplansProfile [layer]->ElementsList) ;
+             flpeln != NULL ;
+             flpeln  = floorplan_element_list_next (flpeln))
+        {
+            Quantity_t size = floorplan_element_list_data (flpeln)->PowerValues->Size ;
+
+            if (*nslots == 0u || size < *nslots)
+
+                *nslots = size ;
+        }
+    }
+
+    Power_t *powers = (Power_t *) malloc (sizeof (Power_t) * *nelements * *nslots) ;
+
+    if (powers == NULL)
+
+        return NULL ;
+
+    element = 0u ;
+
+    for (layer = 0u ; layer != pgrid->NLayers ; layer++)
+    {
+        if (pgrid->FloorplansProfile [layer] == NULL)
+
+            continue ;
+
+        FloorplanElementListNode_t *flpeln ;
+
+        for (flpeln  = floorplan_element_list_begin (&pgrid->FloorplansProfile [layer]->ElementsList) ;
+             flpeln != NULL ;
+             flpeln  = floorplan_element_list_next (flpeln), element++)
+        {
+            PowersQueue_t *queue = floorplan_element_list_data (flpeln)->PowerValues ;
+
+            for (slot = 0u ; slot != *nslots ; slot++)
+
+                powers [slot * *nelements + element] = get_from_powers_queue (queue) ;
+
+            while (is_empty_powers_queue (queue) == false)
+
+                get_from_powers_queue (queue) ;
+        }
+    }
+
+    return powers ;
+}
+
+/* Gives to the floorplans of the stack the power values of one slot */
+
+static Error_t give_power_values
+(
+    PowerGrid_t *pgrid,
+    Power_t     *powers,
+    Quantity_t   nelements
+)
+{
+    PowersQueue_t queue ;
+    Quantity_t    element ;
+
+    powers_queue_init  (&queue) ;
+    powers_queue_build (&queue, nelements) ;
+
+    for (element = 0u ; element != nelements ; element++)
+
+        put_into_powers_queue (&queue, powers [element]) ;
+
+    Error_t result = insert_power_values (pgrid, &queue) ;
+
+    powers_queue_destroy (&queue) ;
+
+    return result ;
+}
+
+#endif /* _3DICE_TEST_POWER_VALUES_H_ */
@@ -0,0 +1,125 @@
+/******************************************************************************
+ * This file is part of 3D-ICE, version 2.2.7 .                               *
+ *                                                                            *
+ * 3D-ICE is free software: you can  redistribute it and/or  modify it  under *
+ * the terms of the  GNU General  Public  License as  published by  the  Free *
+ * Software  Foundation, either  version  3  of  the License,  or  any  later *
+ * version.                                                                   *
+ *                                                                            *
+ * 3D-ICE is  distributed  in the hope  that it will  be useful, but  WITHOUT *
+ * ANY  WARRANTY; without  even the  implied warranty  of MERCHANTABILITY  or *
+ * FITNESS  FOR A PARTICULAR  PURPOSE. See the GNU General Public License for *
+ * more details.                                                              *
+ *                                                                            *
+ * You should have  received a copy of  the GNU General  Public License along *
+ * with 3D-ICE. If not, see <http://www.gnu.org/licenses/>.                   *
+ *                                                                            *
+ *                             Copyright (C) 2010                             *
+ *   Embedded Systems Laboratory - Ecole Polytechnique Federale de Lausanne   *
+ *                            All Rights Reserved.                            *
+ *                                                                            *
+ * Authors: Arvind Sridhar                                                    *
+ *          Alessandro Vincenzi                                               *
+ *          Giseong Bak                                                       *
+ *          Martino Ruggiero                                                  *
+ *          Thomas Brunschwiler                                               *
+ *          David Atienza                                                     *
+ *                                                                            *
+ * For any comment, suggestion or request  about 3D-ICE, please  register and *
+ * write to the mailing list (see http://listes.epfl.ch/doc.cgi?liste=3d-ice) *
+ * Any usage  of 3D-ICE  for research,  commercial or other  purposes must be *
+ * properly acknowledged in the resulting products or publications.           *
+ *                                                                            *
+ * EPFL-STI-IEL-ESL                                                           *
+ * Batiment ELG, ELG 130                Mail : 3d-ice@listes.epfl.ch          *
+ * Station 11                                  (SUBSCRIPTION IS NECESSARY)    *
+ * 1015 Lausanne, Switzerland           Url  : http://esl.epfl.ch/3d-ice.html *
+ ******************************************************************************/
+
+/* Heatsink plugin used by the tests: every cell of the sink is a lumped
+ * thermal capacity, connected to the spreader cell below and to the
+ * ambient, integrated with backward Euler and a time step given by
+ * heatsink_init . With a capacity much larger than the one of the spreader
+ * the sink temperatures move slowly, at every call, towards the steady
+ * state, the case in which the steady state iterations are slow. */
+
+#include <stdlib.h>
+
+/* Total conductance (W/K) from the sink to the ambient, split among the
+ * cells, and time constant (s) of a cell of the sink towards the ambient */
+
+#define AMBIENT_CONDUCTANCE 1.0
+#define TIME_CONSTANT       20.0
+
+/* Conductance from the bottom face of a sink cell to its center, as a
+ * multiple of the conductance towards the ambient */
+
+#define SINK_CONDUCTANCE    10.0
+
+static unsigned int ncells ;
+static double       ambient_temperature ;
+static double       conductance ;         /* spreader center to sink center */
+static double       ambient_conductance ; /* sink center to ambient */
+static double       capacity_over_step ;
+static int          first_call ;
+
+int heatsink_init
+(
+    unsigned int nrows,   unsigned int ncols,
+    double cellwidth,     double celllength,
+    double initialtemperature,
+    double spreaderconductance,
+    double timestep
+)
+{
+    (void) cellwidth ; (void) celllength ;
+
+    if (nrows == 0u || ncols == 0u || timestep <= 0.0)
+
+        return -1 ;
+
+    double sink_conductance ;
+
+    ncells              = nrows * ncols ;
+    ambient_temperature = initialtemperature ;
+    ambient_conductance = AMBIENT_CONDUCTANCE / ncells ;
+    sink_conductance    = SINK_CONDUCTANCE * ambient_conductance ;
+    conductance         = spreaderconductance * sink_conductance
+                          / (spreaderconductance + sink_conductance) ;
+    capacity_over_step  = TIME_CONSTANT * ambient_conductance / timestep ;
+    first_call          = 1 ;
+
+    return 0 ;
+}
+
+int heatsink_simulate_step
+(
+    const double *spreadertemperatures,
+          double *sinktemperatures,
+          double *conductances
+)
+{
+    unsigned int cell ;
+
+    for (cell = 0u ; cell != ncells ; cell++)
+
+        sinktemperatures [cell] =
+
+            (  capacity_over_step  * sinktemperatures [cell]
+             + conductance         * spreadertemperatures [cell]
+             + ambient_conductance * ambient_temperature)
+
+            / (capacity_over_step + conductance + ambient_conductance) ;
+
+    if (first_call == 0)
+
+        return 0 ;
+
+    for (cell = 0u ; cell != ncells ; cell++)
+
+        conductances [cell] = conductance ;
+
+    first_call = 0 ;
+
+    return 1 ;
+}